@@ -26,12 +26,15 @@
 #include "stdafx.h"
 
 #include "../util/string_util.h"
+#include "../exceptions/exceptions.h"
 
 #include "console_manager.h"
 
 using namespace mariachi;
 using namespace mariachi::console;
 using namespace mariachi::util;
+using namespace mariachi::debugging;
+using namespace mariachi::exceptions;
 
 /**
  * Constructor of the class.
@@ -297,6 +300,81 @@ void ConsoleManager::processScript(std::vector<std::string> &commandTokens, Writ
     consoleManager->currentScriptEngineName = scriptEngineName;
 }
 
+void ConsoleManager::processStats(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager) {
+    // in case the number of arguments is invalid
+    if(commandTokens.size() > 3 || (commandTokens.size() == 3 && commandTokens[1] != "trace") || (commandTokens.size() == 2 && commandTokens[1] != "reset")) {
+        // writes the invalid number of arguments text
+        outputFunction(CONSOLE_INVALID_NUMBER_ARGUMENTS_MESSAGE, true);
+
+        // returns in error
+        return;
+    }
+
+    // retrieves the profiler
+    Profiler *profiler = consoleManager->engine->getProfiler();
+
+    // in case the profiler is not available
+    if(!profiler) {
+        // writes the profiler not available message
+        outputFunction("profiler not available", true);
+
+        // returns in error
+        return;
+    }
+
+    // in case the reset is requested
+    if(commandTokens.size() == 2) {
+        // resets the profiler
+        profiler->reset();
+
+        // returns immediately
+        return;
+    }
+
+    // in case the trace dump is requested
+    if(commandTokens.size() == 3) {
+        try {
+            // dumps the trace to the file
+            profiler->dumpTrace(commandTokens[2]);
+        } catch(const RuntimeException &exception) {
+            // writes the exception message
+            outputFunction(exception.getMessage().c_str(), true);
+        }
+
+        // returns immediately
+        return;
+    }
+
+    // retrieves the statistics map
+    std::map<std::string, ProfilerStatistics_t> statisticsMap;
+    profiler->getStatisticsMap(statisticsMap);
+
+    // creates the stats string stream
+    std::stringstream statsStream;
+
+    // writes the stats header
+    statsStream << std::left << std::setw(32) << "name" << std::right << std::setw(10) << "count" << std::setw(10) << "min" << std::setw(10) << "avg" << std::setw(10) << "p99" << std::setw(10) << "max" << " (ms)";
+
+    // retrieves the statistics map iterator
+    std::map<std::string, ProfilerStatistics_t>::iterator statisticsMapIterator = statisticsMap.begin();
+
+    // iterates over all the statistics
+    while(statisticsMapIterator != statisticsMap.end()) {
+        // retrieves the statistics
+        ProfilerStatistics_t &statistics = statisticsMapIterator->second;
+
+        // writes the statistics line
+        statsStream << std::endl << std::left << std::setw(32) << statisticsMapIterator->first << std::right << std::setw(10) << statistics.count;
+        statsStream << std::fixed << std::setprecision(3) << std::setw(10) << statistics.minimum << std::setw(10) << statistics.average << std::setw(10) << statistics.percentile99 << std::setw(10) << statistics.maximum;
+
+        // increments the statistics map iterator
+        statisticsMapIterator++;
+    }
+
+    // writes the stats
+    outputFunction(statsStream.str().c_str(), true);
+}
+
 void ConsoleManager::processExit(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager) {
     // in case the number of arguments is invalid
     if(commandTokens.size() != 1) {
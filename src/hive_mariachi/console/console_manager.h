@@ -44,6 +44,8 @@ remove <plugin-id>   - removes a plugin\n\
 load <plugin-id>     - loads a plugin\n\
 unload <plugin-id>   - unloads a plugin\n\
 script <engine-name> - enters in script execution with the given engine name\n\
+stats [reset]        - shows (or resets) the stage timings and lock waits\n\
+stats trace <file>   - dumps the profiler trace to the file (chrome trace format)\n\
 exit                 - exits the system"
 
 /**
@@ -64,7 +66,7 @@ exit                 - exits the system"
 /**
  * The commands list, mapping the
  */
-#define COMMANDS_LIST { { "help", ConsoleManager::processHelp }, { "script", ConsoleManager::processScript }, { "exit", ConsoleManager::processExit }, { NULL, NULL } }
+#define COMMANDS_LIST { { "help", ConsoleManager::processHelp }, { "script", ConsoleManager::processScript }, { "stats", ConsoleManager::processStats }, { "exit", ConsoleManager::processExit }, { NULL, NULL } }
 
 namespace mariachi {
     namespace console {
@@ -105,6 +107,7 @@ namespace mariachi {
                 static void write(const char *text, bool newline = true);
                 static void processHelp(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager);
                 static void processScript(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager);
+                static void processStats(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager);
                 static void processExit(std::vector<std::string> &commandTokens, WriteOuputFunction_t outputFunction, ConsoleManager *consoleManager);
         };
 
@@ -26,5 +26,6 @@
 #pragma once
 
 #include "debug_engine.h"
+#include "profiler.h"
 
 #include "devices/devices.h"
@@ -0,0 +1,672 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "../exceptions/exceptions.h"
+
+#include "profiler.h"
+
+using namespace mariachi::debugging;
+using namespace mariachi::exceptions;
+
+/**
+ * The active profiler, used by the instrumentation
+ * that has no access to the engine.
+ */
+Profiler *Profiler::activeProfiler = NULL;
+
+/**
+ * The names of the timers registered by default
+ * (indexed by the timer id).
+ */
+static const char *defaultTimerNames[PROFILER_DEFAULT_TIMER_COUNT] = {
+    NODE_LOCK_TIMER,
+    RENDER_INFORMATION_LOCK_TIMER,
+    MAIN_FRAME_TIMER,
+    RENDER_FRAME_TIMER
+};
+
+/**
+ * The names of the registered timers (the ids follow
+ * the ids of the default timers).
+ */
+static std::vector<std::string> timerNamesList;
+
+/**
+ * The read write lock used in the access to the
+ * names of the registered timers.
+ */
+static RWLOCK_HANDLE timerNamesLockHandle = RWLOCK_INITIALIZER;
+
+/**
+ * The number of profilers created, used to identify
+ * the profiler of the current thread buffer.
+ */
+static ATOMIC_VALUE profilerCount = 0;
+
+/**
+ * The number of threads that have been assigned
+ * an index in the profiler.
+ */
+static ATOMIC_VALUE threadCount = 0;
+
+/**
+ * The index of the current thread in the profiler
+ * (zero in case it was not yet assigned).
+ */
+static THREAD_LOCAL unsigned int currentThreadIndex = 0;
+
+/**
+ * The time of the last frame marker in the current thread.
+ */
+static THREAD_LOCAL double currentThreadFrameTime = 0.0;
+
+/**
+ * The buffer of the current thread in the profiler with
+ * the current thread profiler id.
+ */
+static THREAD_LOCAL ProfilerThreadBuffer_t *currentThreadBuffer = NULL;
+
+/**
+ * The id of the profiler of the current thread buffer
+ * (zero in case there is no buffer).
+ */
+static THREAD_LOCAL unsigned long currentThreadProfilerId = 0;
+
+/**
+ * Compares two trace events by timestamp, used to
+ * merge the trace events of the threads.
+ *
+ * @param first The first trace event.
+ * @param second The second trace event.
+ * @return If the first trace event is older than the second.
+ */
+static bool compareTraceEvents(const ProfilerTraceEvent_t &first, const ProfilerTraceEvent_t &second) {
+    return first.timestamp < second.timestamp;
+}
+
+/**
+ * Constructor of the class.
+ */
+Profiler::Profiler() {
+    this->initEnabled();
+    this->initTimers();
+}
+
+/**
+ * Destructor of the class.
+ */
+Profiler::~Profiler() {
+    // unsets the active profiler in case it's this one
+    if(Profiler::activeProfiler == this) {
+        Profiler::activeProfiler = NULL;
+    }
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // retrieves the thread buffer
+        ProfilerThreadBuffer_t *threadBuffer = this->threadBuffersList[index];
+
+        // closes the buffer critical section and deletes the buffer
+        CRITICAL_SECTION_CLOSE(threadBuffer->bufferCriticalSection);
+        delete threadBuffer;
+    }
+
+    // closes the profiler critical section
+    CRITICAL_SECTION_CLOSE(this->profilerCriticalSection);
+}
+
+inline void Profiler::initEnabled() {
+    this->enabled = 0;
+}
+
+inline void Profiler::initTimers() {
+    // sets the (unique) id of the profiler
+    this->profilerId = ATOMIC_INCREMENT(profilerCount);
+
+    // retrieves the start time (trace time origin)
+    MONOTONIC_CLOCK(this->startTime);
+
+    // creates the profiler critical section
+    CRITICAL_SECTION_CREATE(this->profilerCriticalSection);
+}
+
+/**
+ * Stops the profiler, disabling it and releasing the samples
+ * and the trace events of all the thread buffers.
+ * The profiler (and the thread buffers) remain valid for the
+ * recorders that may still hold it (the samples they add
+ * are discarded).
+ */
+void Profiler::stop() {
+    // disables the profiler (no more samples are recorded)
+    this->setEnabled(false);
+
+    // enters the profiler critical section
+    CRITICAL_SECTION_ENTER(this->profilerCriticalSection);
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // retrieves the thread buffer
+        ProfilerThreadBuffer_t *threadBuffer = this->threadBuffersList[index];
+
+        // enters the buffer critical section
+        CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+        // releases the timers and the trace events
+        std::vector<ProfilerTimer_t>().swap(threadBuffer->timersList);
+        std::vector<ProfilerTraceEvent_t>().swap(threadBuffer->traceEventsList);
+        threadBuffer->traceEventIndex = 0;
+
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+    }
+
+    // leaves the profiler critical section
+    CRITICAL_SECTION_LEAVE(this->profilerCriticalSection);
+}
+
+/**
+ * Adds a sample to the timer with the given id, in the
+ * buffer of the current thread.
+ *
+ * @param timerId The id of the timer.
+ * @param startTime The start time of the sample (in seconds).
+ * @param endTime The end time of the sample (in seconds).
+ * @param trace If a trace event should be created for the sample.
+ */
+void Profiler::addSample(unsigned int timerId, double startTime, double endTime, bool trace) {
+    // in case the profiler is not enabled
+    if(!this->enabled) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the buffer of the current thread
+    ProfilerThreadBuffer_t *threadBuffer = this->getThreadBuffer();
+
+    // enters the buffer critical section
+    CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+    // in case the profiler was stopped meanwhile
+    if(!this->enabled) {
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+
+        // returns immediately
+        return;
+    }
+
+    // in case the timer does not exist in the buffer
+    if(timerId >= threadBuffer->timersList.size()) {
+        // adds the (empty) timers up to the timer
+        threadBuffer->timersList.resize(timerId + 1, ProfilerTimer_t());
+    }
+
+    // retrieves the timer
+    ProfilerTimer_t &timer = threadBuffer->timersList[timerId];
+
+    // adds the sample (in miliseconds) to the rolling window
+    timer.samples[timer.sampleIndex] = (float) ((endTime - startTime) * 1000.0);
+    timer.sampleIndex = (timer.sampleIndex + 1) % PROFILER_SAMPLE_COUNT;
+    timer.sampleCount = timer.sampleCount < PROFILER_SAMPLE_COUNT ? timer.sampleCount + 1 : PROFILER_SAMPLE_COUNT;
+    timer.totalCount++;
+
+    // in case the sample should be traced
+    if(trace) {
+        // adds the complete trace event
+        this->addTraceEvent(threadBuffer, timerId, 'X', startTime, endTime - startTime);
+    }
+
+    // leaves the buffer critical section
+    CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+}
+
+/**
+ * Marks the end of a frame in the current thread, adding the
+ * time since the previous marker (of the thread) to the timer
+ * with the given id.
+ *
+ * @param timerId The id of the frame timer.
+ */
+void Profiler::markFrame(unsigned int timerId) {
+    // in case the profiler is not enabled
+    if(!this->enabled) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the current time
+    double currentTime;
+    MONOTONIC_CLOCK(currentTime);
+
+    // in case there is a previous frame marker in the thread
+    if(currentThreadFrameTime > 0.0) {
+        // adds the frame time sample (not traced)
+        this->addSample(timerId, currentThreadFrameTime, currentTime, false);
+    }
+
+    // sets the current thread frame time
+    currentThreadFrameTime = currentTime;
+
+    // retrieves the buffer of the current thread
+    ProfilerThreadBuffer_t *threadBuffer = this->getThreadBuffer();
+
+    // enters the buffer critical section
+    CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+    // in case the profiler was stopped meanwhile
+    if(!this->enabled) {
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+
+        // returns immediately
+        return;
+    }
+
+    // adds the instant trace event
+    this->addTraceEvent(threadBuffer, timerId, 'i', currentTime, 0.0);
+
+    // leaves the buffer critical section
+    CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+}
+
+/**
+ * Resets the profiler, clearing all the samples and trace events.
+ */
+void Profiler::reset() {
+    // enters the profiler critical section
+    CRITICAL_SECTION_ENTER(this->profilerCriticalSection);
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // retrieves the thread buffer
+        ProfilerThreadBuffer_t *threadBuffer = this->threadBuffersList[index];
+
+        // enters the buffer critical section
+        CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+        // iterates over all the timers of the buffer
+        for(unsigned int timerId = 0; timerId < threadBuffer->timersList.size(); timerId++) {
+            // retrieves the timer
+            ProfilerTimer_t &timer = threadBuffer->timersList[timerId];
+
+            // resets the timer samples
+            timer.sampleIndex = 0;
+            timer.sampleCount = 0;
+            timer.totalCount = 0;
+        }
+
+        // clears the trace events
+        threadBuffer->traceEventsList.clear();
+        threadBuffer->traceEventIndex = 0;
+
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+    }
+
+    // leaves the profiler critical section
+    CRITICAL_SECTION_LEAVE(this->profilerCriticalSection);
+}
+
+/**
+ * Retrieves the statistics (over the rolling windows) of all
+ * the timers, merging the samples of all the threads, the
+ * values are in miliseconds.
+ *
+ * @param statisticsMap The map to be filled with the statistics
+ * associated with the timer name.
+ */
+void Profiler::getStatisticsMap(std::map<std::string, ProfilerStatistics_t> &statisticsMap) {
+    // allocates space for the (merged) samples and total
+    // counts of the timers (by timer id)
+    std::vector<std::vector<float> > samplesList;
+    std::vector<unsigned long> totalCountsList;
+
+    // enters the profiler critical section
+    CRITICAL_SECTION_ENTER(this->profilerCriticalSection);
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // retrieves the thread buffer
+        ProfilerThreadBuffer_t *threadBuffer = this->threadBuffersList[index];
+
+        // enters the buffer critical section
+        CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+        // in case there are more timers in the buffer
+        if(threadBuffer->timersList.size() > samplesList.size()) {
+            // resizes the samples and total counts lists
+            samplesList.resize(threadBuffer->timersList.size());
+            totalCountsList.resize(threadBuffer->timersList.size(), 0);
+        }
+
+        // iterates over all the timers of the buffer
+        for(unsigned int timerId = 0; timerId < threadBuffer->timersList.size(); timerId++) {
+            // retrieves the timer
+            ProfilerTimer_t &timer = threadBuffer->timersList[timerId];
+
+            // merges the timer samples and total count
+            samplesList[timerId].insert(samplesList[timerId].end(), timer.samples, timer.samples + timer.sampleCount);
+            totalCountsList[timerId] += timer.totalCount;
+        }
+
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+    }
+
+    // leaves the profiler critical section
+    CRITICAL_SECTION_LEAVE(this->profilerCriticalSection);
+
+    // iterates over all the timers
+    for(unsigned int timerId = 0; timerId < samplesList.size(); timerId++) {
+        // retrieves the timer samples
+        std::vector<float> &samples = samplesList[timerId];
+
+        // in case the timer contains no samples
+        if(samples.empty()) {
+            // continues the loop
+            continue;
+        }
+
+        // sorts the samples
+        std::sort(samples.begin(), samples.end());
+
+        // computes the sum of the samples
+        float sum = 0.0f;
+        for(unsigned int index = 0; index < samples.size(); index++) {
+            sum += samples[index];
+        }
+
+        // computes the index of the 99th percentile
+        unsigned int percentileIndex = (unsigned int) ceil(samples.size() * 0.99) - 1;
+
+        // sets the timer statistics
+        ProfilerStatistics_t &statistics = statisticsMap[Profiler::getTimerName(timerId)];
+        statistics.count = totalCountsList[timerId];
+        statistics.minimum = samples[0];
+        statistics.average = sum / samples.size();
+        statistics.percentile99 = samples[percentileIndex];
+        statistics.maximum = samples[samples.size() - 1];
+    }
+}
+
+/**
+ * Dumps the trace events to the file in the given path, using
+ * the chrome trace (json) format.
+ * The trace events of all the threads are merged in time order.
+ *
+ * @param filePath The path to the file to be written.
+ */
+void Profiler::dumpTrace(const std::string &filePath) {
+    // opens the trace file
+    std::ofstream traceFile(filePath.c_str());
+
+    // in case the file could not be opened
+    if(!traceFile.is_open()) {
+        // throws a runtime exception
+        throw RuntimeException("Problem while opening file: " + filePath);
+    }
+
+    // retrieves the current process id
+    PID_TYPE pid = GET_PID();
+
+    // allocates space for the (merged) trace events
+    std::vector<ProfilerTraceEvent_t> traceEventsList;
+
+    // enters the profiler critical section
+    CRITICAL_SECTION_ENTER(this->profilerCriticalSection);
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // retrieves the thread buffer
+        ProfilerThreadBuffer_t *threadBuffer = this->threadBuffersList[index];
+
+        // enters the buffer critical section
+        CRITICAL_SECTION_ENTER(threadBuffer->bufferCriticalSection);
+
+        // copies the trace events of the buffer
+        traceEventsList.insert(traceEventsList.end(), threadBuffer->traceEventsList.begin(), threadBuffer->traceEventsList.end());
+
+        // leaves the buffer critical section
+        CRITICAL_SECTION_LEAVE(threadBuffer->bufferCriticalSection);
+    }
+
+    // leaves the profiler critical section
+    CRITICAL_SECTION_LEAVE(this->profilerCriticalSection);
+
+    // sorts the trace events (older first)
+    std::stable_sort(traceEventsList.begin(), traceEventsList.end(), compareTraceEvents);
+
+    // writes the trace header
+    traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // iterates over all the trace events
+    for(unsigned int index = 0; index < traceEventsList.size(); index++) {
+        // retrieves the trace event
+        ProfilerTraceEvent_t &traceEvent = traceEventsList[index];
+
+        // writes the trace event (times in microseconds)
+        traceFile << (index ? "," : "") << "\n{\"name\":\"" << Profiler::getTimerName(traceEvent.timerId) << "\",\"ph\":\"" << traceEvent.phase << "\"";
+        traceFile << ",\"pid\":" << pid << ",\"tid\":" << traceEvent.threadIndex;
+        traceFile << std::fixed << ",\"ts\":" << (traceEvent.timestamp - this->startTime) * 1000000.0;
+
+        // in case the trace event is complete (contains duration)
+        if(traceEvent.phase == 'X') {
+            // writes the trace event duration
+            traceFile << ",\"dur\":" << traceEvent.duration * 1000000.0;
+        } else {
+            // writes the trace event scope (thread)
+            traceFile << ",\"s\":\"t\"";
+        }
+
+        // closes the trace event
+        traceFile << "}";
+    }
+
+    // writes the trace footer
+    traceFile << "\n]}\n";
+
+    // closes the trace file
+    traceFile.close();
+}
+
+bool Profiler::isEnabled() {
+    return this->enabled != 0;
+}
+
+void Profiler::setEnabled(bool enabled) {
+    // sets the enabled flag (atomically, the flag is
+    // read by the recorders in other threads)
+    ATOMIC_COMPARE_AND_SWAP(this->enabled, enabled ? 0 : 1, enabled ? 1 : 0);
+}
+
+/**
+ * Registers a timer with the given name, returning its id,
+ * in case a timer with the name is already registered its id
+ * is returned.
+ * Should be called once (eg: when the stage is created) and
+ * the id used in the recording of the samples.
+ *
+ * @param name The name of the timer.
+ * @return The id of the timer.
+ */
+unsigned int Profiler::registerTimer(const std::string &name) {
+    // iterates over all the default timers
+    for(unsigned int index = 0; index < PROFILER_DEFAULT_TIMER_COUNT; index++) {
+        // in case the name is the default timer name
+        if(name == defaultTimerNames[index]) {
+            // returns the default timer id
+            return index;
+        }
+    }
+
+    // locks the timer names for writing
+    RWLOCK_WRITE_LOCK(timerNamesLockHandle);
+
+    // retrieves the position of the name in the timer names
+    unsigned int index = std::find(timerNamesList.begin(), timerNamesList.end(), name) - timerNamesList.begin();
+
+    // in case the name is not registered
+    if(index == timerNamesList.size()) {
+        // adds the name to the timer names
+        timerNamesList.push_back(name);
+    }
+
+    // unlocks the timer names
+    RWLOCK_WRITE_UNLOCK(timerNamesLockHandle);
+
+    // returns the timer id
+    return PROFILER_DEFAULT_TIMER_COUNT + index;
+}
+
+/**
+ * Retrieves the name of the timer with the given id.
+ *
+ * @param timerId The id of the timer.
+ * @return The name of the timer.
+ */
+std::string Profiler::getTimerName(unsigned int timerId) {
+    // in case the timer is a default timer
+    if(timerId < PROFILER_DEFAULT_TIMER_COUNT) {
+        // returns the default timer name
+        return defaultTimerNames[timerId];
+    }
+
+    // locks the timer names for reading
+    RWLOCK_READ_LOCK(timerNamesLockHandle);
+
+    // retrieves the timer name
+    std::string name = timerNamesList[timerId - PROFILER_DEFAULT_TIMER_COUNT];
+
+    // unlocks the timer names
+    RWLOCK_READ_UNLOCK(timerNamesLockHandle);
+
+    // returns the timer name
+    return name;
+}
+
+/**
+ * Retrieves the index of the current thread in the profiler,
+ * the index is assigned in the first call.
+ *
+ * @return The index of the current thread.
+ */
+unsigned int Profiler::getThreadIndex() {
+    // in case the current thread index is not assigned
+    if(!currentThreadIndex) {
+        // assigns the current thread index
+        currentThreadIndex = ATOMIC_INCREMENT(threadCount);
+    }
+
+    // returns the current thread index
+    return currentThreadIndex;
+}
+
+/**
+ * Retrieves the active profiler.
+ *
+ * @return The active profiler.
+ */
+Profiler *Profiler::getActiveProfiler() {
+    return Profiler::activeProfiler;
+}
+
+/**
+ * Sets the active profiler.
+ *
+ * @param profiler The active profiler.
+ */
+void Profiler::setActiveProfiler(Profiler *profiler) {
+    Profiler::activeProfiler = profiler;
+}
+
+inline ProfilerThreadBuffer_t *Profiler::getThreadBuffer() {
+    // in case the current thread buffer is of the profiler
+    if(currentThreadProfilerId == this->profilerId) {
+        // returns the current thread buffer
+        return currentThreadBuffer;
+    }
+
+    // retrieves the index of the current thread
+    unsigned int threadIndex = Profiler::getThreadIndex();
+
+    // allocates space for the thread buffer
+    ProfilerThreadBuffer_t *threadBuffer = NULL;
+
+    // enters the profiler critical section
+    CRITICAL_SECTION_ENTER(this->profilerCriticalSection);
+
+    // iterates over all the thread buffers
+    for(unsigned int index = 0; index < this->threadBuffersList.size(); index++) {
+        // in case the thread buffer is of the current thread
+        if(this->threadBuffersList[index]->threadIndex == threadIndex) {
+            // sets the thread buffer
+            threadBuffer = this->threadBuffersList[index];
+
+            // breaks the loop
+            break;
+        }
+    }
+
+    // in case there is no buffer for the current thread
+    if(!threadBuffer) {
+        // creates the thread buffer
+        threadBuffer = new ProfilerThreadBuffer_t();
+        threadBuffer->threadIndex = threadIndex;
+        threadBuffer->traceEventIndex = 0;
+        CRITICAL_SECTION_CREATE(threadBuffer->bufferCriticalSection);
+
+        // adds the thread buffer to the thread buffers list
+        this->threadBuffersList.push_back(threadBuffer);
+    }
+
+    // leaves the profiler critical section
+    CRITICAL_SECTION_LEAVE(this->profilerCriticalSection);
+
+    // sets the thread buffer as the current one
+    currentThreadBuffer = threadBuffer;
+    currentThreadProfilerId = this->profilerId;
+
+    // returns the thread buffer
+    return threadBuffer;
+}
+
+inline void Profiler::addTraceEvent(ProfilerThreadBuffer_t *threadBuffer, unsigned int timerId, char phase, double timestamp, double duration) {
+    // creates the trace event
+    ProfilerTraceEvent_t traceEvent = { timerId, phase, threadBuffer->threadIndex, timestamp, duration };
+
+    // in case the trace events list is not full
+    if(threadBuffer->traceEventsList.size() < PROFILER_TRACE_EVENT_COUNT) {
+        // adds the trace event
+        threadBuffer->traceEventsList.push_back(traceEvent);
+    } else {
+        // overwrites the oldest trace event
+        threadBuffer->traceEventsList[threadBuffer->traceEventIndex] = traceEvent;
+        threadBuffer->traceEventIndex = (threadBuffer->traceEventIndex + 1) % PROFILER_TRACE_EVENT_COUNT;
+    }
+}
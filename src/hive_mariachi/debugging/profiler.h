@@ -0,0 +1,275 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../system/thread.h"
+#include "../system/system_util.h"
+
+/**
+ * The number of samples kept (rolling window) in
+ * each profiler timer (per thread).
+ */
+#define PROFILER_SAMPLE_COUNT 256
+
+/**
+ * The maximum number of trace events kept in the
+ * profiler for each thread (the older events are
+ * overwritten).
+ */
+#define PROFILER_TRACE_EVENT_COUNT 65536
+
+/**
+ * The name of the timer used for the node lock wait.
+ */
+#define NODE_LOCK_TIMER "lock/node"
+
+/**
+ * The name of the timer used for the render information
+ * mutex lock wait.
+ */
+#define RENDER_INFORMATION_LOCK_TIMER "lock/render_information"
+
+/**
+ * The name of the timer used for the main (simulation)
+ * frame time.
+ */
+#define MAIN_FRAME_TIMER "frame/main"
+
+/**
+ * The name of the timer used for the render (presentation)
+ * frame time.
+ */
+#define RENDER_FRAME_TIMER "frame/render"
+
+namespace mariachi {
+    namespace debugging {
+        /**
+         * The identifiers of the timers registered by
+         * default in the profiler, the other timers are
+         * registered (by name) with the following identifiers.
+         */
+        typedef enum ProfilerTimerId_t {
+            NODE_LOCK_TIMER_ID = 0,
+            RENDER_INFORMATION_LOCK_TIMER_ID,
+            MAIN_FRAME_TIMER_ID,
+            RENDER_FRAME_TIMER_ID,
+            PROFILER_DEFAULT_TIMER_COUNT
+        } ProfilerTimerId;
+
+        typedef struct ProfilerTimer_t {
+            float samples[PROFILER_SAMPLE_COUNT];
+            unsigned int sampleIndex;
+            unsigned int sampleCount;
+            unsigned long totalCount;
+        } ProfilerTimer;
+
+        typedef struct ProfilerStatistics_t {
+            unsigned long count;
+            float minimum;
+            float average;
+            float percentile99;
+            float maximum;
+        } ProfilerStatistics;
+
+        typedef struct ProfilerTraceEvent_t {
+            unsigned int timerId;
+            char phase;
+            unsigned int threadIndex;
+            double timestamp;
+            double duration;
+        } ProfilerTraceEvent;
+
+        /**
+         * The samples and trace events recorded by a single
+         * thread, the critical section is only contended by the
+         * merges (statistics and trace dump).
+         *
+         * @param threadIndex The index of the thread in the profiler.
+         * @param timersList The timers of the thread (by timer identifier).
+         * @param traceEventsList The (bounded) trace events of the thread.
+         * @param traceEventIndex The index of the oldest trace event
+         * (once the list is full).
+         * @param bufferCriticalSection The critical section of the buffer.
+         */
+        typedef struct ProfilerThreadBuffer_t {
+            unsigned int threadIndex;
+            std::vector<ProfilerTimer_t> timersList;
+            std::vector<ProfilerTraceEvent_t> traceEventsList;
+            unsigned int traceEventIndex;
+            CRITICAL_SECTION_HANDLE bufferCriticalSection;
+        } ProfilerThreadBuffer;
+
+        /**
+         * Collects timing samples (in miliseconds) for timers,
+         * keeping a rolling window for the statistics, and a bounded
+         * list of trace events that may be dumped in the chrome
+         * trace (json) format.
+         * The timers are registered by name once and identified
+         * by id, the samples are recorded in per thread buffers
+         * that are merged in the statistics and in the trace dump.
+         */
+        class Profiler {
+            private:
+                static Profiler *activeProfiler;
+                ATOMIC_VALUE enabled;
+                unsigned long profilerId;
+                double startTime;
+                std::vector<ProfilerThreadBuffer_t *> threadBuffersList;
+                CRITICAL_SECTION_HANDLE profilerCriticalSection;
+
+                inline void initEnabled();
+                inline void initTimers();
+                inline ProfilerThreadBuffer_t *getThreadBuffer();
+                inline void addTraceEvent(ProfilerThreadBuffer_t *threadBuffer, unsigned int timerId, char phase, double timestamp, double duration);
+
+            public:
+                Profiler();
+                ~Profiler();
+                void stop();
+                void addSample(unsigned int timerId, double startTime, double endTime, bool trace = true);
+                void markFrame(unsigned int timerId);
+                void reset();
+                void getStatisticsMap(std::map<std::string, ProfilerStatistics_t> &statisticsMap);
+                void dumpTrace(const std::string &filePath);
+                bool isEnabled();
+                void setEnabled(bool enabled);
+                static unsigned int registerTimer(const std::string &name);
+                static std::string getTimerName(unsigned int timerId);
+                static unsigned int getThreadIndex();
+                static Profiler *getActiveProfiler();
+                static void setActiveProfiler(Profiler *profiler);
+
+                /**
+                 * Locks the given mutex, adding the time spent waiting
+                 * for it to the timer with the given id (in case there
+                 * is an active profiler enabled).
+                 *
+                 * @param mutexHandle The mutex to be locked.
+                 * @param timerId The id of the lock wait timer.
+                 */
+                static inline void lockMutex(MUTEX_HANDLE mutexHandle, unsigned int timerId) {
+                    // retrieves the active profiler
+                    Profiler *profiler = Profiler::activeProfiler;
+
+                    // in case there is no active profiler enabled
+                    if(!profiler || !profiler->enabled) {
+                        // locks the mutex
+                        MUTEX_LOCK(mutexHandle);
+
+                        // returns immediately
+                        return;
+                    }
+
+                    // allocates space for the lock times
+                    double lockStartTime;
+                    double lockEndTime;
+
+                    // locks the mutex (measuring the wait)
+                    MONOTONIC_CLOCK(lockStartTime);
+                    MUTEX_LOCK(mutexHandle);
+                    MONOTONIC_CLOCK(lockEndTime);
+
+                    // adds the lock wait sample (not traced)
+                    profiler->addSample(timerId, lockStartTime, lockEndTime, false);
+                }
+
+                /**
+                 * Locks the given read write lock for reading, adding the
+                 * time spent waiting for it to the timer with the given id
+                 * (in case there is an active profiler enabled).
+                 *
+                 * @param rwlockHandle The read write lock to be locked.
+                 * @param timerId The id of the lock wait timer.
+                 */
+                static inline void lockRead(RWLOCK_HANDLE &rwlockHandle, unsigned int timerId) {
+                    // retrieves the active profiler
+                    Profiler *profiler = Profiler::activeProfiler;
+
+                    // in case there is no active profiler enabled
+                    if(!profiler || !profiler->enabled) {
+                        // locks the read write lock
+                        RWLOCK_READ_LOCK(rwlockHandle);
+
+                        // returns immediately
+                        return;
+                    }
+
+                    // allocates space for the lock times
+                    double lockStartTime;
+                    double lockEndTime;
+
+                    // locks the read write lock (measuring the wait)
+                    MONOTONIC_CLOCK(lockStartTime);
+                    RWLOCK_READ_LOCK(rwlockHandle);
+                    MONOTONIC_CLOCK(lockEndTime);
+
+                    // adds the lock wait sample (not traced)
+                    profiler->addSample(timerId, lockStartTime, lockEndTime, false);
+                }
+        };
+
+        /**
+         * Scoped timer, adds a sample with the time elapsed between
+         * its construction and destruction.
+         */
+        class ProfilerScope {
+            private:
+                Profiler *profiler;
+                unsigned int timerId;
+                double startTime;
+
+            public:
+                ProfilerScope(Profiler *profiler, unsigned int timerId) {
+                    // sets the profiler (only in case it is enabled)
+                    // and the timer id
+                    this->profiler = profiler && profiler->isEnabled() ? profiler : NULL;
+                    this->timerId = timerId;
+
+                    // in case the profiler is set
+                    if(this->profiler) {
+                        // retrieves the start time
+                        MONOTONIC_CLOCK(this->startTime);
+                    }
+                }
+
+                ~ProfilerScope() {
+                    // in case the profiler is not set
+                    if(!this->profiler) {
+                        // returns immediately
+                        return;
+                    }
+
+                    // retrieves the end time
+                    double endTime;
+                    MONOTONIC_CLOCK(endTime);
+
+                    // adds the sample to the profiler
+                    this->profiler->addSample(this->timerId, this->startTime, endTime);
+                }
+        };
+    }
+}
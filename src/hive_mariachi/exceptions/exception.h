@@ -36,7 +36,7 @@ namespace mariachi {
                 Exception(const std::string &message);
                 ~Exception() throw();
                 inline void initMessage(const std::string &message);
-                std::string &getMessage() { return this->message; };
+                const std::string &getMessage() const { return this->message; };
                 virtual void setMessage(const std::string &message) { this->message = message; };
         };
     }
@@ -25,10 +25,14 @@
 
 #include "stdafx.h"
 
+#include <climits>
+
+#include "../util/util.h"
 #include "../exceptions/exceptions.h"
 
 #include "md2_importer.h"
 
+using namespace mariachi::util;
 using namespace mariachi::nodes;
 using namespace mariachi::importers;
 using namespace mariachi::exceptions;
@@ -38,8 +42,15 @@ using namespace mariachi::structures;
  * Constructor fo the class.
  */
 Md2Importer::Md2Importer() : ModelImporter() {
-    // invalidates the frame count
+    // invalidates the frame and vertex count
     this->frameCount = -1;
+    this->vertexCount = -1;
+
+    // resets the indexed mesh
+    memset(&this->indexedMesh, 0, sizeof(Mesh_t));
+
+    // resets the animation
+    memset(&this->animation, 0, sizeof(KeyframeAnimation_t));
 }
 
 /**
@@ -51,11 +62,19 @@ Md2Importer::~Md2Importer() {
 
     // cleans the md2 frame list
     this->cleanMd2FrameList();
+
+    // cleans the animation
+    this->cleanAnimation();
 }
 
 /**
  * Generates the model information from the model file in the
  * given file path.
+ * The file is mapped in memory and the header and tables
+ * are read in place (no intermediate buffers), the frames
+ * are kept in quantized form (as keyframes).
+ * The gl commands (strips and fans) are converted into a single
+ * indexed mesh shared by all the frames.
  *
  * @param filePath The file path to the file to be used to generate
  * the model.
@@ -67,76 +86,98 @@ void Md2Importer::generateModel(const std::string &filePath) {
     // cleans the previous frame information (in case there is one)
     this->cleanMd2FrameList();
 
-    // creates the file stream to be used
-    std::fstream md2File(filePath.c_str(), std::fstream::in | std::fstream::binary);
+    // cleans the previous animation information (in case there is one)
+    this->cleanAnimation();
+
+    // maps the file in memory
+    MappedFile_t md2File;
 
-    // in case the opening of the file fails
-    if(md2File.fail()) {
+    // in case the mapping of the file fails
+    if(!FileUtil::mapFile(filePath, md2File)) {
         // throws a runtime exception
         throw RuntimeException("Problem while loading file: " + filePath);
     }
 
-    // seeks to the end of the file
-    md2File.seekg(0, std::fstream::end);
-
-    // get length of file
-    std::streamoff md2FileLength = md2File.tellg();
+    // retrieves the md2 header and contents (in place)
+    Md2Header_t *md2Header = (Md2Header_t *) md2File.contents;
+    char *md2Contents = md2File.contents + MD2_HEADER_SIZE;
 
-    // seeks to the beginning of the file
-    md2File.seekg(0, std::fstream::beg);
+    // in case the header or the tables are not contained in the file
+    if(!this->isValidFile(md2Header, md2File.size)) {
+        // unmaps the file
+        FileUtil::unmapFile(md2File);
 
-    // allocates space for the md2 header
-    Md2Header_t *md2Header = (Md2Header_t *) malloc(MD2_HEADER_SIZE);
-
-    // reads the header data
-    md2File.read((char *) md2Header, MD2_HEADER_SIZE);
+        // throws a runtime exception
+        throw RuntimeException("Problem reading the file");
+    }
 
-    // calculates the md2 contents length
-    std::streamoff md2ContentsLength = md2FileLength - MD2_HEADER_SIZE;
+    // sets the frame count as the value of the number of frames
+    // in the md2 header
+    this->frameCount = md2Header->numberFrames;
 
-    // allocates space for the md2 contents
-    char *md2Contents = (char *) malloc(md2ContentsLength);
+    // sets the vertex count as the value of the number of vertices
+    // in the md2 header
+    this->vertexCount = md2Header->numberVertices;
 
-    // reads the contents data
-    md2File.read((char *) md2Contents, md2ContentsLength);
+    // generates the keyframes list
+    this->generateKeyframesList(md2Header, md2Contents);
 
-    // closes the file
-    md2File.close();
+    // generates the gl commands list, in case the
+    // gl commands are not valid
+    if(!this->generateGlCommandsList(md2Header, md2Contents)) {
+        // unmaps the file
+        FileUtil::unmapFile(md2File);
 
-    // in case the reading of the file fails
-    if(md2File.fail()) {
         // throws a runtime exception
         throw RuntimeException("Problem reading the file");
     }
 
-    // sets the frame count as the value of the number of frames
-    // in the md2 header
-    this->frameCount = md2Header->numberFrames;
+    // unmaps the file
+    FileUtil::unmapFile(md2File);
 
-    // generates the coordinates list
-    this->generateCoordinatesList(md2Header, md2Contents);
+    // generates the indexed mesh from the gl commands
+    this->generateIndexedMesh();
+}
 
-    // generates the gl commands list
-    this->generateGlCommandsList(md2Header, md2Contents);
+inline bool Md2Importer::isValidFile(Md2Header_t *md2Header, size_t md2FileSize) {
+    // in case the file does not contain the header
+    if(md2FileSize < MD2_HEADER_SIZE) {
+        // returns false
+        return false;
+    }
 
-    // releases the md2 header buffer
-    free(md2Header);
+    // in case the counts or the offsets are negative
+    if(md2Header->numberFrames < 0 || md2Header->numberVertices < 0 || md2Header->numberGlCommands < 0 || md2Header->offsetFrames < MD2_HEADER_SIZE || md2Header->offsetGlCommands < MD2_HEADER_SIZE) {
+        // returns false
+        return false;
+    }
 
-    // releases the md2 contents buffer
-    free(md2Contents);
+    // computes the end of the frames and gl commands tables
+    size_t framesEnd = (size_t) md2Header->offsetFrames + (size_t) md2Header->numberFrames * (MD2_FRAME_HEADER_SIZE + (size_t) md2Header->numberVertices * MD2_VERTEX_VALUE_SIZE);
+    size_t glCommandsEnd = (size_t) md2Header->offsetGlCommands + (size_t) md2Header->numberGlCommands * MD2_FLOAT_SIZE;
+
+    // returns if the tables are contained in the file
+    return framesEnd <= md2FileSize && glCommandsEnd <= md2FileSize;
 }
 
 /**
- * Generates the coordinates list for each of the frames contained in
- * the md2 model.
+ * Generates the (quantized) keyframes list for each of the frames
+ * contained in the md2 model, the quantized vertices are copied
+ * as they are in the file (a byte per coordinate).
  *
  * @param md2Header The md2 model header to be used.
  * @param md2Contents The contents of the md2 model file.
  */
-inline void Md2Importer::generateCoordinatesList(Md2Header_t *md2Header, char *md2Contents) {
+inline void Md2Importer::generateKeyframesList(Md2Header_t *md2Header, char *md2Contents) {
     // starts the frame contents pointer
     unsigned int frameContentsPointer = md2Header->offsetFrames - MD2_HEADER_SIZE;
 
+    // calculates the size of the vertices of each frame
+    size_t frameVerticesSize = md2Header->numberVertices * MD2_VERTEX_VALUE_SIZE;
+
+    // allocates the vertices of all the keyframes
+    this->keyframeVerticesList.resize(this->frameCount * frameVerticesSize + 1);
+
     // iterates over all the frames in the model
     for(int index = 0; index < this->frameCount; index++) {
         // retrieves the frame header
@@ -145,34 +186,41 @@ inline void Md2Importer::generateCoordinatesList(Md2Header_t *md2Header, char *m
         // increments the frame contents pointer
         frameContentsPointer += MD2_FRAME_HEADER_SIZE;
 
-        // creates a new md2 frame
-        Md2Frame *md2Frame = new Md2Frame();
+        // creates the keyframe with the frame scale and translation
+        QuantizedKeyframe_t keyframe;
+        memcpy(keyframe.scale, frameHeader->scale, sizeof(keyframe.scale));
+        memcpy(keyframe.translate, frameHeader->translate, sizeof(keyframe.translate));
+        keyframe.vertices = &this->keyframeVerticesList[index * frameVerticesSize];
 
-        // adds the frame to the md2 frames list
-        this->md2FramesList.push_back(md2Frame);
+        // copies the quantized vertices (the md2 vertex contents
+        // match the quantized vertex layout)
+        memcpy(keyframe.vertices, &md2Contents[frameContentsPointer], frameVerticesSize);
 
-        // iterates over all the vertices
-        for(int _index = 0; _index < md2Header->numberVertices; _index++) {
-            // retrieves the vertex contents
-            Md2VertexContents_t *vertexContents = (Md2VertexContents_t *) &md2Contents[frameContentsPointer];
+        // adds the keyframe to the keyframes list
+        this->keyframesList.push_back(keyframe);
 
-            // calculates the vertex coordinates with the scale and translation
-            float vertexX = (vertexContents->vertex[0] * frameHeader->scale[0]) + frameHeader->translate[0];
-            float vertexY = (vertexContents->vertex[1] * frameHeader->scale[1]) + frameHeader->translate[1];
-            float vertexZ = (vertexContents->vertex[2] * frameHeader->scale[2]) + frameHeader->translate[2];
+        // adds the frame name (not necessarily null terminated)
+        // to the keyframe names list
+        this->keyframeNamesList.push_back(std::string(frameHeader->name, std::find(frameHeader->name, frameHeader->name + sizeof(frameHeader->name), '\0')));
 
-            // adds the vertex coordinates in the coordinates list
-            md2Frame->coordinatesList.push_back(vertexX);
-            md2Frame->coordinatesList.push_back(vertexY);
-            md2Frame->coordinatesList.push_back(vertexZ);
+        // creates a new md2 frame and adds it to the md2 frames list
+        // (the coordinates are decoded in the vertex list generation)
+        this->md2FramesList.push_back(new Md2Frame());
 
-            // increments the frame contents pointer
-            frameContentsPointer += MD2_VERTEX_VALUE_SIZE;
-        }
+        // increments the frame contents pointer
+        frameContentsPointer += frameVerticesSize;
     }
 }
 
-inline void Md2Importer::generateGlCommandsList(Md2Header_t *md2Header, char *md2Contents) {
+/**
+ * Generates the gl commands list from the gl commands block, the
+ * commands are validated against the end of the block.
+ *
+ * @param md2Header The header of the md2 file.
+ * @param md2Contents The contents of the md2 file (after the header).
+ * @return If the gl commands are valid.
+ */
+inline bool Md2Importer::generateGlCommandsList(Md2Header_t *md2Header, char *md2Contents) {
     // calculates the gl contents length
     unsigned int glContentsLength = md2Header->numberGlCommands * MD2_FLOAT_SIZE;
 
@@ -183,27 +231,53 @@ inline void Md2Importer::generateGlCommandsList(Md2Header_t *md2Header, char *md
     unsigned int glContentsEndPointer = glContentsPointer + glContentsLength;
 
     // iterates until reaching the end
-    while(glContentsPointer < glContentsEndPointer) {
+    while(glContentsPointer + MD2_FLOAT_SIZE <= glContentsEndPointer) {
         // retrieves the number of vertices
         int numberVertices = *(int *) &md2Contents[glContentsPointer];
 
-        // adds the number of vertices to the gl commands list
-        this->glCommandsList.push_back((void *) numberVertices);
-
         // increments the gl contents pointer
         glContentsPointer += 4;
 
-        // in case the number of vertices is negative
-        if(numberVertices < 0) {
-            // uses the negationof the value
-            numberVertices = numberVertices * -1;
+        // in case the end command was reached
+        if(numberVertices == 0) {
+            // in case the end command is not the last
+            // value of the block
+            if(glContentsPointer != glContentsEndPointer) {
+                // returns false (invalid)
+                return false;
+            }
+
+            // adds the end command to the gl commands list
+            this->glCommandsList.push_back((void *) 0);
+
+            // returns true (valid)
+            return true;
+        }
+
+        // in case the number of vertices can not be negated
+        if(numberVertices == INT_MIN) {
+            // returns false (invalid)
+            return false;
         }
 
+        // retrieves the absolute number of vertices (the negative
+        // values are used for the fans)
+        unsigned int absoluteNumberVertices = numberVertices < 0 ? -numberVertices : numberVertices;
+
+        // in case the vertices extend past the end of the block
+        if(absoluteNumberVertices > (glContentsEndPointer - glContentsPointer) / sizeof(Md2VertexTextureInformation_t)) {
+            // returns false (invalid)
+            return false;
+        }
+
+        // adds the number of vertices to the gl commands list
+        this->glCommandsList.push_back((void *) numberVertices);
+
         // allocates space for the vertex texture information copy buffer
-        Md2VertexTextureInformation_t *vertexTextureInformationCopyBuffer = (Md2VertexTextureInformation_t *) malloc(numberVertices * sizeof(Md2VertexTextureInformation_t));
+        Md2VertexTextureInformation_t *vertexTextureInformationCopyBuffer = (Md2VertexTextureInformation_t *) malloc(absoluteNumberVertices * sizeof(Md2VertexTextureInformation_t));
 
         // iterates over all the vertices
-        for(int index = 0; index < numberVertices; index++) {
+        for(unsigned int index = 0; index < absoluteNumberVertices; index++) {
             // retrieves the vertex texture information
             Md2VertexTextureInformation_t *vertexTextureInformation = (Md2VertexTextureInformation_t *) &md2Contents[glContentsPointer];
 
@@ -225,6 +299,112 @@ inline void Md2Importer::generateGlCommandsList(Md2Header_t *md2Header, char *md
             glContentsPointer += 12;
         }
     }
+
+    // adds the end command to the gl commands list
+    // (the block is not terminated)
+    this->glCommandsList.push_back((void *) 0);
+
+    // returns true (valid)
+    return true;
+}
+
+/**
+ * Generates the indexed (triangle list) mesh from the gl commands,
+ * the vertices are identified by the keyframe vertex and the texture
+ * coordinates (the vertices shared by the strips and fans are welded)
+ * and the triangles are ordered for the vertex cache.
+ * The vertices of the mesh are set for each of the frames from
+ * the (indexed) vertex indexes list.
+ */
+inline void Md2Importer::generateIndexedMesh() {
+    // allocates the list of vertices (texture coordinates and
+    // keyframe vertex index) and the list of triangle indexes
+    std::vector<float> vertexList;
+    std::vector<unsigned int> triangleIndexesList;
+
+    // starts the gl command index
+    unsigned int glCommandIndex = 0;
+
+    // iterates over all the gl commands in the gl commands
+    // list (until the end command)
+    while(glCommandIndex < this->glCommandsList.size() && this->glCommandsList[glCommandIndex] != 0) {
+        // retrieves the number of vertices
+        int numberVertices = (long long) this->glCommandsList[glCommandIndex];
+
+        // retrieves the type (strip or fan) and the number of vertices
+        MeshType_t meshType = numberVertices > 0 ? TRIANGLE_STRIP : TRIANGLE_FAN;
+        unsigned int meshNumberVertices = numberVertices > 0 ? numberVertices : numberVertices * -1;
+
+        // increments the gl command index
+        glCommandIndex++;
+
+        // in case the gl commands are not complete
+        if(glCommandIndex + meshNumberVertices * 3 > this->glCommandsList.size()) {
+            // throws a runtime exception
+            throw RuntimeException("Invalid gl commands");
+        }
+
+        // generates the triangles of the strip or fan
+        MeshUtil::generateTriangles(meshType, meshNumberVertices, vertexList.size() / 3, triangleIndexesList);
+
+        // iterates over all the vertices
+        for(unsigned int index = 0; index < meshNumberVertices; index++) {
+            // retrieves the vertex index
+            int vertexIndex = *(int *) this->glCommandsList[glCommandIndex + 2];
+
+            // in case the vertex index is not valid
+            if(vertexIndex < 0 || vertexIndex >= this->vertexCount) {
+                // throws a runtime exception
+                throw RuntimeException("Invalid vertex index in the gl commands");
+            }
+
+            // adds the texture vertex and the vertex index
+            vertexList.push_back(*(float *) this->glCommandsList[glCommandIndex]);
+            vertexList.push_back(*(float *) this->glCommandsList[glCommandIndex + 1]);
+            vertexList.push_back((float) vertexIndex);
+
+            // increments the gl command index
+            glCommandIndex += 3;
+        }
+    }
+
+    // welds and orders the vertices and the triangles
+    MeshUtil::indexMesh(vertexList, 3, triangleIndexesList);
+
+    // retrieves the number of (indexed) vertices and indexes
+    unsigned int numberVertices = vertexList.size() / 3;
+    unsigned int numberIndexes = triangleIndexesList.size();
+
+    // iterates over all the indexed vertices
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        // adds the texture vertex and the vertex index
+        this->indexedTextureVerticesList.push_back(vertexList[index * 3]);
+        this->indexedTextureVerticesList.push_back(vertexList[index * 3 + 1]);
+        this->indexedVertexIndexesList.push_back((unsigned int) vertexList[index * 3 + 2]);
+    }
+
+    // retrieves the index type (the smallest for the vertices)
+    // and converts the indexes
+    MeshIndexType_t indexType = MeshUtil::getIndexType(numberVertices);
+    this->indexesList.resize(numberIndexes * MeshUtil::getIndexSize(indexType) + 1);
+    if(numberIndexes) {
+        MeshUtil::setIndexes(&triangleIndexesList[0], numberIndexes, indexType, &this->indexesList[0]);
+    }
+
+    // sets the indexed mesh values (the vertices are set
+    // by each of the frames)
+    this->indexedMesh.type = TRIANGLE;
+    this->indexedMesh.position.x = 0.0f;
+    this->indexedMesh.position.y = 0.0f;
+    this->indexedMesh.position.z = 0.0f;
+    this->indexedMesh.numberVertices = numberVertices;
+    this->indexedMesh.vertexList = NULL;
+    this->indexedMesh.textureVertexList = this->indexedTextureVerticesList.empty() ? NULL : &this->indexedTextureVerticesList[0];
+    this->indexedMesh.dynamic = false;
+    this->indexedMesh.numberIndexes = numberIndexes;
+    this->indexedMesh.indexType = indexType;
+    this->indexedMesh.indexList = &this->indexesList[0];
+    this->indexedMesh.generation = MeshUtil::createGeneration();
 }
 
 /**
@@ -238,22 +418,33 @@ Md2Frame *Md2Importer::getMainMd2Frame() {
 }
 
 /**
- * Generates the vertex list from the list of coordinates.
+ * Generates the vertex list (for each of the frames) decoding
+ * the coordinates list from the quantized keyframes.
  */
 void Md2Importer::generateVertexList() {
-    // retrieves the md2 frames list iterator
-    std::vector<Md2Frame *>::iterator md2FramesListIterator = this->md2FramesList.begin();
-
     // iterates over all the md2 frames
-    while(md2FramesListIterator != this->md2FramesList.end()) {
-        // retrieves the current frame
-        Md2Frame *currentMd2Frame = *md2FramesListIterator;
+    for(unsigned int index = 0; index < this->md2FramesList.size(); index++) {
+        // retrieves the current md2 frame and keyframe
+        Md2Frame *currentMd2Frame = this->md2FramesList[index];
+        QuantizedKeyframe_t &keyframe = this->keyframesList[index];
+
+        // clears the coordinates list of the md2 frame
+        currentMd2Frame->coordinatesList.clear();
+
+        // iterates over all the vertices
+        for(int vertexIndex = 0; vertexIndex < this->vertexCount; vertexIndex++) {
+            // retrieves the quantized vertex
+            unsigned char *vertex = &keyframe.vertices[vertexIndex * MD2_VERTEX_VALUE_SIZE];
+
+            // calculates the vertex coordinates with the scale and translation
+            // and adds them to the coordinates list
+            currentMd2Frame->coordinatesList.push_back((vertex[0] * keyframe.scale[0]) + keyframe.translate[0]);
+            currentMd2Frame->coordinatesList.push_back((vertex[1] * keyframe.scale[1]) + keyframe.translate[1]);
+            currentMd2Frame->coordinatesList.push_back((vertex[2] * keyframe.scale[2]) + keyframe.translate[2]);
+        }
 
         // generates the vertex list for the current md2 frame
         currentMd2Frame->generateVertexList();
-
-        // increments the md2 frames list iterator
-        md2FramesListIterator++;
     }
 }
 
@@ -271,7 +462,7 @@ void Md2Importer::generateMeshList() {
         Md2Frame *currentMd2Frame = *md2FramesListIterator;
 
         // generates the mesh list for the current md2 frame
-        currentMd2Frame->generateMeshList(this->glCommandsList);
+        currentMd2Frame->generateMeshList(this->indexedMesh, this->indexedVertexIndexesList);
 
         // increments the md2 frames list iterator
         md2FramesListIterator++;
@@ -302,6 +493,54 @@ void Md2Importer::generateFrameList() {
     }
 }
 
+/**
+ * Generates the keyframe animation, the (indexed) mesh is described
+ * once (type, texture vertices, indexes and keyframe vertex indexes)
+ * and decoded from the quantized keyframes by each of the actors.
+ * The animation clips are generated from the frame names.
+ * This is an alternative to the vertex, mesh and frame lists
+ * generation (that expand all the frames).
+ */
+void Md2Importer::generateAnimation() {
+    // cleans the previous animation information (in case there is one)
+    this->cleanAnimation();
+
+    // in case the indexed mesh has triangles
+    if(this->indexedMesh.numberIndexes) {
+        // adds the indexed mesh (with the vertices changing
+        // in each frame) to the animation meshes list
+        this->animationMeshesList.push_back(this->indexedMesh);
+        this->animationMeshesList.back().dynamic = true;
+    }
+
+    // generates the animation clips from the keyframe names
+    AnimationUtil::generateClips(this->keyframeNamesList, this->animationClipsList);
+
+    // sets the animation values
+    this->animation.format = QUANTIZED_BYTE;
+    this->animation.numberVertices = this->vertexCount;
+    this->animation.numberKeyframes = this->keyframesList.size();
+    this->animation.keyframes = this->keyframesList.empty() ? NULL : &this->keyframesList[0];
+    this->animation.frameRate = DEFAULT_KEYFRAME_RATE;
+    this->animation.numberMeshes = this->animationMeshesList.size();
+    this->animation.meshes = this->animationMeshesList.empty() ? NULL : &this->animationMeshesList[0];
+    this->animation.numberMeshVertices = this->animationMeshesList.empty() ? 0 : this->indexedVertexIndexesList.size();
+    this->animation.meshVertexIndexes = this->animationMeshesList.empty() ? NULL : &this->indexedVertexIndexesList[0];
+    this->animation.numberClips = this->animationClipsList.size();
+    this->animation.clips = this->animationClipsList.empty() ? NULL : &this->animationClipsList[0];
+}
+
+/**
+ * Retrieves the keyframe animation.
+ *
+ * @return The keyframe animation (null in case it was
+ * not generated).
+ */
+KeyframeAnimation_t *Md2Importer::getAnimation() {
+    // returns the animation in case it was generated
+    return this->animationMeshesList.empty() ? NULL : &this->animation;
+}
+
 ModelNode *Md2Importer::getModelNode() {
     // retrieves the main md2 frame
     Md2Frame *mainMd2Frame = this->getMainMd2Frame();
@@ -329,11 +568,22 @@ ActorNode *Md2Importer::getActorNode() {
     // sets the frame list in the actor node
     actorNode->setFrameList(&this->framesList);
 
+    // sets the animation in the actor node (in case it was generated)
+    actorNode->setAnimation(this->getAnimation());
+
     // returns the actor node
     return actorNode;
 }
 
 void Md2Importer::cleanModel() {
+    // clears the indexed mesh lists
+    this->indexedVertexIndexesList.clear();
+    this->indexedTextureVerticesList.clear();
+    this->indexesList.clear();
+
+    // resets the indexed mesh
+    memset(&this->indexedMesh, 0, sizeof(Mesh_t));
+
     // in case the gl commands list is empty
     // there is nothing to clean
     if(this->glCommandsList.empty())
@@ -393,16 +643,29 @@ void Md2Importer::cleanMd2FrameList() {
         md2FramesListIterator++;
     }
 
-    // clears the frames list
+    // clears the md2 frames and the frames list
+    this->md2FramesList.clear();
     this->framesList.clear();
+
+    // clears the keyframes lists
+    this->keyframesList.clear();
+    this->keyframeVerticesList.clear();
+    this->keyframeNamesList.clear();
+}
+
+void Md2Importer::cleanAnimation() {
+    // clears the animation lists
+    this->animationMeshesList.clear();
+    this->animationClipsList.clear();
+
+    // resets the animation
+    memset(&this->animation, 0, sizeof(KeyframeAnimation_t));
 }
 
 /**
  * Constructor of the class
  */
 Md2Frame::Md2Frame() {
-    // invalidates the mesh count
-    this->meshCount = -1;
 }
 
 /**
@@ -464,127 +727,44 @@ void Md2Frame::generateVertexList() {
 }
 
 /**
- * Generates the mesh list for the current vertex information
- * in the importer.
+ * Generates the mesh list for the current vertex information,
+ * the (indexed) mesh shares the texture vertices and the indexes
+ * with the given indexed mesh.
+ *
+ * @param indexedMesh The indexed mesh (without the vertices).
+ * @param vertexIndexesList The frame vertex index of each of the
+ * indexed mesh vertices.
  */
-void Md2Frame::generateMeshList(const std::vector<void *> &glCommandsList) {
+void Md2Frame::generateMeshList(const Mesh_t &indexedMesh, const std::vector<unsigned int> &vertexIndexesList) {
     // cleans the previous mesh list information (in case there is one)
     this->cleanMeshList();
 
-    // in case the mesh count is invalid
-    if(this->meshCount < 0) {
-        // counts the meshes
-        this->countMeshes(glCommandsList);
+    // in case the indexed mesh has no triangles
+    if(!indexedMesh.numberIndexes) {
+        // returns immediately
+        return;
     }
 
-    // creates the mesh buffer
-    Mesh_t *meshBuffer = (Mesh_t *) malloc(sizeof(Mesh_t) * this->meshCount);
-
-    // creates the mesh pointer
-    unsigned int meshPointer = 0;
-
-    // starts the gl command index
-    unsigned int glCommandIndex = 0;
-
-    // iterates over all the gl commands in
-    // the gl commands list
-    while(glCommandsList[glCommandIndex] != 0) {
-        // start the mesh type
-        MeshType_t meshType = TRIANGLE_STRIP;
-
-        // retrieves the number of vertices
-        int numberVertices = (long long) glCommandsList[glCommandIndex];
-
-        // in case the number of vertices is bigger than zero
-        if(numberVertices > 0) {
-            // sets the triangle strip as mesh type
-            meshType = TRIANGLE_STRIP;
-        } else {
-            // sets the triangle fan as mesh type
-            meshType = TRIANGLE_FAN;
-            numberVertices = numberVertices * -1;
-        }
-
-        // increments the gl command index
-        glCommandIndex++;
-
-        // retrieves the current mesh
-        Mesh *mesh = &meshBuffer[meshPointer];
-
-        // sets the type in the mesh
-        mesh->type = meshType;
-
-        // sets the number of vertices in the mesh
-        mesh->numberVertices = numberVertices;
-
-        // allocates the vertex buffer
-        float *vertexBuffer = (float *) malloc(sizeof(float) * numberVertices * 5);
-
-        // sets the inital position of the texture vertex buffer (part of the vertex buffer)
-        float *textureVertexBuffer = vertexBuffer + numberVertices * 3;
-
-        // sets the vertex list in the mesh
-        mesh->vertexList = vertexBuffer;
-
-        // sets the texture vertex list in the mesh
-        mesh->textureVertexList = textureVertexBuffer;
-
-        // iterates over all the vertices
-        for(int index = 0; index < numberVertices; index++) {
-            // retrieves the vertex index
-            int vertexIndex = *(int *) glCommandsList[glCommandIndex + 2];
-
-            // retrieves the vertex
-            float *vertex = this->vertexList[vertexIndex];
-
-            // copies the vertex information to the vertex buffer
-            memcpy(vertexBuffer, vertex, sizeof(float) * 3);
-
-            // copes the texture vertex information to the vertex texture buffer
-            memcpy(textureVertexBuffer, glCommandsList[glCommandIndex], sizeof(float) * 2);
-
-            // increments the gl command index
-            glCommandIndex += 3;
-
-            // increments the vertex buffer position
-            vertexBuffer += 3;
+    // creates the mesh from the indexed mesh
+    Mesh_t *mesh = (Mesh_t *) malloc(sizeof(Mesh_t));
+    memcpy(mesh, &indexedMesh, sizeof(Mesh_t));
+    mesh->generation = MeshUtil::createGeneration();
 
-            // increments the texture vertex buffer position
-            textureVertexBuffer += 2;
-        }
+    // allocates the vertex buffer and sets it in the mesh
+    float *vertexBuffer = (float *) malloc(sizeof(float) * mesh->numberVertices * 3);
+    mesh->vertexList = vertexBuffer;
 
-        // adds the mesh to the mesh list
-        this->meshList.push_back(mesh);
+    // iterates over all the vertices
+    for(unsigned int index = 0; index < mesh->numberVertices; index++) {
+        // retrieves the vertex
+        float *vertex = this->vertexList[vertexIndexesList[index]];
 
-        // increments the mesh pointer
-        meshPointer++;
+        // copies the vertex information to the vertex buffer
+        memcpy(&vertexBuffer[index * 3], vertex, sizeof(float) * 3);
     }
-}
-
-void Md2Frame::countMeshes(const std::vector<void *> &glCommandsList) {
-    // resets the mesh count
-    this->meshCount = 0;
-
-    // starts the gl command index
-    unsigned int glCommandIndex = 0;
-
-    // iterates over all the gl commands in
-    // the gl commands list
-    while(glCommandsList[glCommandIndex] != 0) {
-        // retrieves the number of vertices
-        int numberVertices = (long long) glCommandsList[glCommandIndex];
-
-        // in case the number of vertices is smaller than zero
-        if(numberVertices < 0) {
-            numberVertices = numberVertices * -1;
-        }
 
-        // increments the gl command index
-        glCommandIndex += numberVertices * 3 + 1;
-
-        // increments the mesh count
-        this->meshCount++;
-    }
+    // adds the mesh to the mesh list
+    this->meshList.push_back(mesh);
 }
 
 /*
@@ -694,13 +874,13 @@ void Md2Frame::cleanMeshList() {
         // releases the vertex buffer
         free(vertexBuffer);
 
+        // releases the mesh
+        free(mesh);
+
         // increments the mesh list iterator
         meshListIterator++;
     }
 
-    // retrieves the mesh buffer
-    Mesh_t *meshBuffer = this->meshList[0];
-
-    // releases the mesh buffer
-    free(meshBuffer);
+    // clears the mesh list
+    this->meshList.clear();
 }
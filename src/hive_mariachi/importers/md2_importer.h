@@ -26,6 +26,7 @@
 #pragma once
 
 #include "../structures/mesh.h"
+#include "../structures/keyframe.h"
 #include "model_importer.h"
 
 /**
@@ -151,13 +152,11 @@ namespace mariachi {
                 std::vector<structures::Mesh_t *> meshList;
                 structures::Frame_t frame;
                 int vertexCount;
-                int meshCount;
 
                 Md2Frame();
                 ~Md2Frame();
                 void generateVertexList();
-                void generateMeshList(const std::vector<void *> &glCommandsList);
-                void countMeshes(const std::vector<void *> &glCommandsList);
+                void generateMeshList(const structures::Mesh_t &indexedMesh, const std::vector<unsigned int> &vertexIndexesList);
                 void compileDisplayList();
                 structures::Frame_t *getFrame();
                 void cleanVertextList();
@@ -175,10 +174,23 @@ namespace mariachi {
                 std::vector<structures::Frame_t *> framesList;
                 std::vector<Md2Frame *> md2FramesList;
                 std::vector<void *> glCommandsList;
+                std::vector<structures::QuantizedKeyframe_t> keyframesList;
+                std::vector<unsigned char> keyframeVerticesList;
+                std::vector<std::string> keyframeNamesList;
+                std::vector<structures::AnimationClip_t> animationClipsList;
+                std::vector<structures::Mesh_t> animationMeshesList;
+                std::vector<unsigned int> indexedVertexIndexesList;
+                std::vector<float> indexedTextureVerticesList;
+                std::vector<unsigned char> indexesList;
+                structures::Mesh_t indexedMesh;
+                structures::KeyframeAnimation_t animation;
                 int frameCount;
+                int vertexCount;
 
-                inline void generateCoordinatesList(Md2Header_t *md2Header, char *md2Contents);
-                inline void generateGlCommandsList(Md2Header_t *md2Header, char *md2Contents);
+                inline void generateKeyframesList(Md2Header_t *md2Header, char *md2Contents);
+                inline bool generateGlCommandsList(Md2Header_t *md2Header, char *md2Contents);
+                inline void generateIndexedMesh();
+                inline bool isValidFile(Md2Header_t *md2Header, size_t md2FileSize);
                 Md2Frame *getMainMd2Frame();
 
             public:
@@ -188,10 +200,13 @@ namespace mariachi {
                 void generateVertexList();
                 void generateMeshList();
                 void generateFrameList();
+                void generateAnimation();
+                structures::KeyframeAnimation_t *getAnimation();
                 nodes::ModelNode *getModelNode();
                 nodes::ActorNode *getActorNode();
                 void cleanModel();
                 void cleanMd2FrameList();
+                void cleanAnimation();
         };
     }
 }
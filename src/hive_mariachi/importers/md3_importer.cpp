@@ -25,77 +25,84 @@
 
 #include "stdafx.h"
 
+#include "../util/util.h"
 #include "../exceptions/exceptions.h"
 
 #include "md3_importer.h"
 
+using namespace mariachi::util;
+using namespace mariachi::nodes;
 using namespace mariachi::importers;
 using namespace mariachi::exceptions;
+using namespace mariachi::structures;
 
 /**
  * Constructor fo the class.
  */
 Md3Importer::Md3Importer() : ModelImporter() {
+    // invalidates the frame, tag, surface and vertex count
+    this->frameCount = -1;
+    this->tagCount = -1;
+    this->surfaceCount = -1;
+    this->vertexCount = -1;
+
+    // resets the animation
+    memset(&this->animation, 0, sizeof(KeyframeAnimation_t));
 }
 
 /**
  * Destructor of the class.
  */
 Md3Importer::~Md3Importer() {
+    // cleans the model
+    this->cleanModel();
+
+    // cleans the md3 frame list
+    this->cleanMd3FrameList();
+
+    // cleans the animation
+    this->cleanAnimation();
 }
 
 /**
  * Generates the model information from the model file in the
  * given file path.
+ * The file is mapped in memory and the header and tables
+ * are read in place (no intermediate buffers), the vertices
+ * of the frames are kept in quantized form (as keyframes) and
+ * the surfaces as indexed triangle lists.
  *
  * @param filePath The file path to the file to be used to generate
  * the model.
  */
 void Md3Importer::generateModel(const std::string &filePath) {
     // cleans the previous model information (in case there is one)
-    //this->cleanModel();
+    this->cleanModel();
 
     // cleans the previous frame information (in case there is one)
-    //this->cleanMd3FrameList();
+    this->cleanMd3FrameList();
+
+    // cleans the previous animation information (in case there is one)
+    this->cleanAnimation();
 
-    // creates the file stream to be used
-    std::fstream md3File(filePath.c_str(), std::fstream::in | std::fstream::binary);
+    // maps the file in memory
+    MappedFile_t md3File;
 
-    // in case the opening of the file fails
-    if(md3File.fail()) {
+    // in case the mapping of the file fails
+    if(!FileUtil::mapFile(filePath, md3File)) {
         // throws a runtime exception
         throw RuntimeException("Problem while loading file: " + filePath);
     }
 
-    // seeks to the end of the file
-    md3File.seekg(0, std::fstream::end);
-
-    // get length of file
-    std::streamoff md3FileLength = md3File.tellg();
-
-    // seeks to the beginning of the file
-    md3File.seekg(0, std::fstream::beg);
-
-    // allocates space for the md3 header
-    Md3Header_t *md3Header = (Md3Header_t *) malloc(MD3_HEADER_SIZE);
-
-    // reads the header data
-    md3File.read((char *) md3Header, MD3_HEADER_SIZE);
-
-    // calculates the md3 contents length
-    std::streamoff md3ContentsLength = md3FileLength - MD3_HEADER_SIZE;
-
-    // allocates space for the md3 contents
-    char *md3Contents = (char *) malloc(md3ContentsLength);
+    // retrieves the md3 header and contents (in place)
+    Md3Header_t *md3Header = (Md3Header_t *) md3File.contents;
+    char *md3Contents = md3File.contents + MD3_HEADER_SIZE;
 
-    // reads the contents data
-    md3File.read((char *) md3Contents, md3ContentsLength);
+    // in case the header or the tables are not contained in the file
+    if(!this->isValidFile(md3Header, md3File.size)) {
+        // unmaps the file
+        FileUtil::unmapFile(md3File);
 
-    // closes the file
-    md3File.close();
-
-    // in case the reading of the file fails
-    if(md3File.fail()) {
         // throws a runtime exception
         throw RuntimeException("Problem reading the file");
     }
@@ -108,39 +115,391 @@ void Md3Importer::generateModel(const std::string &filePath) {
     // in the md3 header
     this->tagCount = md3Header->numberTags;
 
-
     // sets the surface count as the value of the number of surfaces
     // in the md3 header
     this->surfaceCount = md3Header->numberSurfaces;
 
+    // generates the frames list
+    this->generateFramesList(md3Header, md3Contents);
 
+    // generates the tags list
+    this->generateTagsList(md3Header, md3Contents);
 
+    // generates the surfaces list (and the vertex and index streams)
+    this->generateSurfacesList(md3Header, md3Contents);
 
+    // generates the clips list
+    this->generateClipsList();
 
+    // unmaps the file
+    FileUtil::unmapFile(md3File);
+}
 
+/**
+ * Generates the (static) mesh list of the model, decoded from
+ * the first frame, with an indexed mesh per surface.
+ */
+void Md3Importer::generateMeshList() {
+    // clears the previous mesh list
+    this->meshesList.clear();
+    this->meshList.clear();
+    this->vertexList.clear();
+
+    // in case there are no frames or vertices
+    if(this->keyframesList.empty() || this->vertexCount <= 0) {
+        // returns immediately
+        return;
+    }
 
-    // generates the coordinates list
-    //this->generateCoordinatesList(md3Header, md3Contents);
+    // allocates the vertex list and the identity vertex indexes
+    this->vertexList.resize(this->vertexCount * 3);
+    std::vector<unsigned int> vertexIndexesList(this->vertexCount);
+    for(int index = 0; index < this->vertexCount; index++) {
+        vertexIndexesList[index] = index;
+    }
 
-    // generates the gl commands list
-    //this->generateGlCommandsList(md2Header, md2Contents);
+    // decodes the vertices of the first keyframe
+    const QuantizedKeyframe_t *keyframe = &this->keyframesList[0];
+    float weight = 1.0f;
+    AnimationUtil::blendShortKeyframes(&keyframe, &weight, 1, &vertexIndexesList[0], this->vertexCount, &this->vertexList[0]);
+
+    // iterates over all the surfaces
+    for(unsigned int index = 0; index < this->surfacesList.size(); index++) {
+        // retrieves the surface
+        Md3Surface_t &surface = this->surfacesList[index];
+
+        // in case the surface is empty
+        if(!surface.numberVertices || !surface.numberIndexes) {
+            // continues the loop
+            continue;
+        }
+
+        // creates the (static) indexed mesh for the surface
+        Mesh_t mesh;
+        mesh.type = TRIANGLE;
+        mesh.position.x = 0.0f;
+        mesh.position.y = 0.0f;
+        mesh.position.z = 0.0f;
+        mesh.numberVertices = surface.numberVertices;
+        mesh.vertexList = surface.numberVertices ? &this->vertexList[surface.vertexOffset * 3] : NULL;
+        mesh.textureVertexList = surface.numberVertices ? &this->textureVerticesList[surface.vertexOffset * 2] : NULL;
+        mesh.dynamic = false;
+        mesh.numberIndexes = surface.numberIndexes;
+        mesh.indexType = SHORT_INDEX;
+        mesh.indexList = surface.numberIndexes ? &this->indexesList[surface.indexOffset] : NULL;
+        mesh.generation = MeshUtil::createGeneration();
+
+        // adds the mesh to the meshes list
+        this->meshesList.push_back(mesh);
+    }
 
+    // iterates over all the meshes (the mesh list is only
+    // set once the meshes list is complete)
+    for(unsigned int index = 0; index < this->meshesList.size(); index++) {
+        // adds the mesh to the mesh list
+        this->meshList.push_back(&this->meshesList[index]);
+    }
+}
 
-    // generates the frames list
-    this->generateFramesList(md3Header, md3Contents);
+/**
+ * Generates the keyframe animation of the model, the template
+ * meshes are indexed meshes (one per surface) and the vertices
+ * are decoded from the short quantized keyframes.
+ */
+void Md3Importer::generateAnimation() {
+    // cleans the previous animation (in case there is one)
+    this->cleanAnimation();
+
+    // in case there are no frames or vertices
+    if(this->keyframesList.empty() || this->vertexCount <= 0) {
+        // returns immediately
+        return;
+    }
 
-    // generates the tags list
-    this->generateTagsList(md3Header, md3Contents);
+    // iterates over all the surfaces
+    for(unsigned int index = 0; index < this->surfacesList.size(); index++) {
+        // retrieves the surface
+        Md3Surface_t &surface = this->surfacesList[index];
+
+        // in case the surface is empty
+        if(!surface.numberVertices || !surface.numberIndexes) {
+            // continues the loop
+            continue;
+        }
+
+        // creates the template (indexed) mesh for the surface
+        Mesh_t mesh;
+        mesh.type = TRIANGLE;
+        mesh.position.x = 0.0f;
+        mesh.position.y = 0.0f;
+        mesh.position.z = 0.0f;
+        mesh.numberVertices = surface.numberVertices;
+        mesh.vertexList = NULL;
+        mesh.textureVertexList = surface.numberVertices ? &this->textureVerticesList[surface.vertexOffset * 2] : NULL;
+        mesh.dynamic = true;
+        mesh.numberIndexes = surface.numberIndexes;
+        mesh.indexType = SHORT_INDEX;
+        mesh.indexList = surface.numberIndexes ? &this->indexesList[surface.indexOffset] : NULL;
+        mesh.generation = MeshUtil::createGeneration();
+
+        // iterates over all the surface vertices
+        for(unsigned int vertexIndex = 0; vertexIndex < surface.numberVertices; vertexIndex++) {
+            // adds the keyframe vertex index (the surface vertices
+            // are contiguous in the keyframes)
+            this->animationVertexIndexesList.push_back(surface.vertexOffset + vertexIndex);
+        }
+
+        // adds the mesh to the animation meshes list
+        this->animationMeshesList.push_back(mesh);
+    }
 
-    // generates the surfaces list
-    this->generateSurfacesList(md3Header, md3Contents);
+    // sets the animation values
+    this->animation.format = QUANTIZED_SHORT;
+    this->animation.numberVertices = this->vertexCount;
+    this->animation.numberKeyframes = this->keyframesList.size();
+    this->animation.keyframes = &this->keyframesList[0];
+    this->animation.frameRate = DEFAULT_KEYFRAME_RATE;
+    this->animation.numberMeshes = this->animationMeshesList.size();
+    this->animation.meshes = this->animationMeshesList.empty() ? NULL : &this->animationMeshesList[0];
+    this->animation.numberMeshVertices = this->animationVertexIndexesList.size();
+    this->animation.meshVertexIndexes = this->animationVertexIndexesList.empty() ? NULL : &this->animationVertexIndexesList[0];
+    this->animation.numberClips = this->clipsList.size();
+    this->animation.clips = this->clipsList.empty() ? NULL : &this->clipsList[0];
+    this->animation.numberTags = this->tagNamesList.size();
+    this->animation.tagNames = this->tagNamesList.empty() ? NULL : &this->tagNamesList[0];
+    this->animation.tags = this->tagsList.empty() ? NULL : &this->tagsList[0];
+}
+
+/**
+ * Retrieves the keyframe animation.
+ *
+ * @return The keyframe animation (null in case it was
+ * not generated).
+ */
+KeyframeAnimation_t *Md3Importer::getAnimation() {
+    // returns the animation in case it was generated
+    return this->animationMeshesList.empty() ? NULL : &this->animation;
+}
+
+ModelNode *Md3Importer::getModelNode() {
+    // in case the mesh list is not generated
+    if(this->meshList.empty()) {
+        // generates the mesh list
+        this->generateMeshList();
+    }
+
+    // creates a new model node
+    ModelNode *modelNode = new ModelNode();
+
+    // sets the model node position
+    modelNode->setPosition(0.0, 0.0, 0.0);
+
+    // sets the mesh list in the model node
+    modelNode->setMeshList(&this->meshList);
+
+    // returns the model node
+    return modelNode;
+}
+
+ActorNode *Md3Importer::getActorNode() {
+    // in case the animation is not generated
+    if(!this->getAnimation()) {
+        // generates the animation
+        this->generateAnimation();
+    }
+
+    // creates a new actor node
+    ActorNode *actorNode = new ActorNode();
+
+    // sets the actor node position
+    actorNode->setPosition(0.0, 0.0, 0.0);
+
+    // sets the animation in the actor node (in case it was generated)
+    actorNode->setAnimation(this->getAnimation());
+
+    // returns the actor node
+    return actorNode;
+}
+
+/**
+ * Retrieves the surfaces list.
+ *
+ * @return The surfaces list.
+ */
+std::vector<Md3Surface_t> &Md3Importer::getSurfacesList() {
+    return this->surfacesList;
+}
+
+/**
+ * Retrieves the tag names list.
+ *
+ * @return The tag names list.
+ */
+std::vector<std::string> &Md3Importer::getTagNamesList() {
+    return this->tagNamesList;
+}
+
+/**
+ * Retrieves the animation clips list.
+ *
+ * @return The animation clips list.
+ */
+std::vector<AnimationClip_t> &Md3Importer::getClipsList() {
+    return this->clipsList;
+}
 
+void Md3Importer::cleanModel() {
+    // clears the surfaces, tags and keyframes lists
+    this->surfacesList.clear();
+    this->tagNamesList.clear();
+    this->tagsList.clear();
+    this->keyframesList.clear();
+    this->keyframeVerticesList.clear();
+
+    // clears the texture vertices, indexes and clips lists
+    this->textureVerticesList.clear();
+    this->indexesList.clear();
+    this->clipsList.clear();
+
+    // clears the (static) mesh lists
+    this->meshesList.clear();
+    this->meshList.clear();
+    this->vertexList.clear();
+}
+
+void Md3Importer::cleanMd3FrameList() {
+    // iterates over all the md3 frames
+    for(unsigned int index = 0; index < this->md3FramesList.size(); index++) {
+        // deletes the md3 frame
+        delete this->md3FramesList[index];
+    }
+
+    // clears the md3 frames list
+    this->md3FramesList.clear();
+}
+
+void Md3Importer::cleanAnimation() {
+    // clears the animation lists
+    this->animationMeshesList.clear();
+    this->animationVertexIndexesList.clear();
+
+    // resets the animation
+    memset(&this->animation, 0, sizeof(KeyframeAnimation_t));
+}
+
+inline bool Md3Importer::isValidFile(Md3Header_t *md3Header, size_t md3FileSize) {
+    // in case the file does not contain the header
+    if(md3FileSize < MD3_HEADER_SIZE) {
+        // returns false
+        return false;
+    }
+
+    // in case the counts or the offsets are negative
+    if(md3Header->numberFrames < 0 || md3Header->numberTags < 0 || md3Header->numberSurfaces < 0 || md3Header->offsetFrames < MD3_HEADER_SIZE || md3Header->offsetTags < MD3_HEADER_SIZE || md3Header->offsetSurfaces < MD3_HEADER_SIZE) {
+        // returns false
+        return false;
+    }
+
+    // in case the frames or the tags (for each of the frames) do
+    // not fit in the file (bounded before the multiplication)
+    if((size_t) md3Header->numberFrames > md3FileSize / MD3_FRAME_HEADER_SIZE || (md3Header->numberTags > 0 && (size_t) md3Header->numberFrames > md3FileSize / MD3_TAG_SIZE / (size_t) md3Header->numberTags)) {
+        // returns false
+        return false;
+    }
+
+    // computes the end of the frames and tags tables (there
+    // are tags for each of the frames)
+    size_t framesEnd = (size_t) md3Header->offsetFrames + (size_t) md3Header->numberFrames * MD3_FRAME_HEADER_SIZE;
+    size_t tagsEnd = (size_t) md3Header->offsetTags + (size_t) md3Header->numberFrames * (size_t) md3Header->numberTags * MD3_TAG_SIZE;
+
+    // in case the tables are not contained in the file
+    if(framesEnd > md3FileSize || tagsEnd > md3FileSize) {
+        // returns false
+        return false;
+    }
+
+    // starts the surface offset
+    size_t surfaceOffset = md3Header->offsetSurfaces;
+
+    // iterates over all the surfaces in the model
+    for(int index = 0; index < md3Header->numberSurfaces; index++) {
+        // in case the surface header is not contained in the file
+        if(surfaceOffset + MD3_SURFACE_HEADER_SIZE > md3FileSize) {
+            // returns false
+            return false;
+        }
+
+        // retrieves the surface header
+        Md3SurfaceHeader_t *surfaceHeader = (Md3SurfaceHeader_t *) ((char *) md3Header + surfaceOffset);
+
+        // in case the surface is not valid
+        if(!this->isValidSurface(surfaceHeader, md3FileSize - surfaceOffset, md3Header->numberFrames)) {
+            // returns false
+            return false;
+        }
+
+        // increments the surface offset
+        surfaceOffset += surfaceHeader->offsetEnd;
+    }
+
+    // returns true
+    return true;
+}
+
+inline bool Md3Importer::isValidSurface(Md3SurfaceHeader_t *surfaceHeader, size_t surfaceSize, int numberFrames) {
+    // in case the counts or the offsets are not valid (the frames
+    // must be the same of the model)
+    if(surfaceHeader->numberFrames != numberFrames || surfaceHeader->numberShaders < 0 || surfaceHeader->numberVertices < 0 || surfaceHeader->numberVertices > MD3_MAXIMUM_SURFACE_VERTICES || surfaceHeader->numberTriangles < 0
+        || surfaceHeader->offsetTriangles < MD3_SURFACE_HEADER_SIZE || surfaceHeader->offsetShaders < MD3_SURFACE_HEADER_SIZE || surfaceHeader->offsetTextureCoordinates < MD3_SURFACE_HEADER_SIZE
+        || surfaceHeader->offsetXYZNormal < MD3_SURFACE_HEADER_SIZE || surfaceHeader->offsetEnd < MD3_SURFACE_HEADER_SIZE || (size_t) surfaceHeader->offsetEnd > surfaceSize) {
+        // returns false
+        return false;
+    }
+
+    // in case the triangles, the shaders or the vertices (for each of
+    // the frames) do not fit in the surface (bounded before the multiplication)
+    if((size_t) surfaceHeader->numberTriangles > surfaceSize / MD3_TRIANGLE_SIZE || (size_t) surfaceHeader->numberShaders > surfaceSize / MD3_SHADER_SIZE
+        || (surfaceHeader->numberVertices > 0 && (size_t) numberFrames > surfaceSize / MD3_VERTEX_SIZE / (size_t) surfaceHeader->numberVertices)) {
+        // returns false
+        return false;
+    }
+
+    // computes the end of the triangles, shaders, texture coordinates
+    // and vertices tables
+    size_t trianglesEnd = (size_t) surfaceHeader->offsetTriangles + (size_t) surfaceHeader->numberTriangles * MD3_TRIANGLE_SIZE;
+    size_t shadersEnd = (size_t) surfaceHeader->offsetShaders + (size_t) surfaceHeader->numberShaders * MD3_SHADER_SIZE;
+    size_t textureCoordinatesEnd = (size_t) surfaceHeader->offsetTextureCoordinates + (size_t) surfaceHeader->numberVertices * MD3_TEXTURE_COORDINATE_SIZE;
+    size_t verticesEnd = (size_t) surfaceHeader->offsetXYZNormal + (size_t) numberFrames * (size_t) surfaceHeader->numberVertices * MD3_VERTEX_SIZE;
+
+    // retrieves the surface end
+    size_t surfaceEnd = surfaceHeader->offsetEnd;
+
+    // in case the tables are not contained in the surface
+    if(trianglesEnd > surfaceEnd || shadersEnd > surfaceEnd || textureCoordinatesEnd > surfaceEnd || verticesEnd > surfaceEnd) {
+        // returns false
+        return false;
+    }
 
-    // releases the md3 header buffer
-    free(md3Header);
+    // retrieves the triangles
+    Md3Triangle_t *triangles = (Md3Triangle_t *) ((char *) surfaceHeader + surfaceHeader->offsetTriangles);
+
+    // iterates over all the triangles
+    for(int index = 0; index < surfaceHeader->numberTriangles; index++) {
+        // iterates over all the triangle indexes
+        for(unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++) {
+            // retrieves the index
+            int triangleIndex = triangles[index].indexes[vertexIndex];
+
+            // in case the index is not a surface vertex
+            if(triangleIndex < 0 || triangleIndex >= surfaceHeader->numberVertices) {
+                // returns false
+                return false;
+            }
+        }
+    }
 
-    // releases the md3 contents buffer
-    free(md3Contents);
+    // returns true
+    return true;
 }
 
 /**
@@ -165,33 +524,22 @@ inline void Md3Importer::generateFramesList(Md3Header_t *md3Header, char *md3Con
         // creates a new md3 frame
         Md3Frame *md3Frame = new Md3Frame();
 
-        // adds the frame to the md3 frames list
-        this->md3FramesList.push_back(md3Frame);
-
-        // iterates over all the vertices
-     /*   for(int _index = 0; _index < md2Header->numberVertices; _index++) {
-            // retrieves the vertex contents
-            Md2VertexContents_t *vertexContents = (Md2VertexContents_t *) &md2Contents[frameContentsPointer];
+        // sets the frame name (not necessarily null terminated)
+        md3Frame->name = std::string(frameHeader->name, std::find(frameHeader->name, frameHeader->name + sizeof(frameHeader->name), '\0'));
 
-            // calculates the vertex coordinates with the scale and translation
-            float vertexX = (vertexContents->vertex[0] * frameHeader->scale[0]) + frameHeader->translate[0];
-            float vertexY = (vertexContents->vertex[1] * frameHeader->scale[1]) + frameHeader->translate[1];
-            float vertexZ = (vertexContents->vertex[2] * frameHeader->scale[2]) + frameHeader->translate[2];
+        // sets the frame bounds and radius
+        md3Frame->minimumBounds = frameHeader->minimumBounds;
+        md3Frame->maximumBounds = frameHeader->maximumBounds;
+        md3Frame->radius = frameHeader->radius;
 
-            // adds the vertex coordinates in the coordinates list
-            md2Frame->coordinatesList.push_back(vertexX);
-            md2Frame->coordinatesList.push_back(vertexY);
-            md2Frame->coordinatesList.push_back(vertexZ);
-
-            // increments the frame contents pointer
-            frameContentsPointer += MD2_VERTEX_VALUE_SIZE;
-        }*/
+        // adds the frame to the md3 frames list
+        this->md3FramesList.push_back(md3Frame);
     }
 }
 
 /**
  * Generates the tags list for each of the frames contained in
- * the md3 model.
+ * the md3 model, the tag names are retrieved from the first frame.
  *
  * @param md3Header The md3 model header to be used.
  * @param md3Contents The contents of the md3 model file.
@@ -200,31 +548,206 @@ inline void Md3Importer::generateTagsList(Md3Header_t *md3Header, char *md3Conte
     // starts the tag contents pointer
     unsigned int tagContentsPointer = md3Header->offsetTags - MD3_HEADER_SIZE;
 
-    // iterates over all the tags in the model
-    for(int index = 0; index < this->tagCount; index++) {
+    // iterates over all the tags in all the frames
+    for(int index = 0; index < this->frameCount * this->tagCount; index++) {
         // retrieves the tag header
         Md3TagHeader_t *tagHeader = (Md3TagHeader_t *) &md3Contents[tagContentsPointer];
 
-
+        // increments the tag contents pointer
+        tagContentsPointer += MD3_TAG_SIZE;
+
+        // in case the tag is in the first frame
+        if(index < this->tagCount) {
+            // adds the tag name (not necessarily null terminated)
+            // to the tag names list
+            this->tagNamesList.push_back(std::string(tagHeader->name, std::find(tagHeader->name, tagHeader->name + sizeof(tagHeader->name), '\0')));
+        }
+
+        // creates the keyframe tag with the origin and axis
+        KeyframeTag_t tag;
+        tag.origin = tagHeader->origin;
+        tag.axis[0] = tagHeader->axis[0];
+        tag.axis[1] = tagHeader->axis[1];
+        tag.axis[2] = tagHeader->axis[2];
+
+        // adds the tag to the tags list
+        this->tagsList.push_back(tag);
     }
 }
 
-
+/**
+ * Generates the surfaces list, the vertices of the surfaces are
+ * copied (in quantized form) into the vertex stream of each of the
+ * keyframes and the triangles and texture coordinates into the
+ * index and texture vertex streams.
+ * The triangles of each surface are ordered for the vertex cache
+ * and the vertices in the order of their first use.
+ *
+ * @param md3Header The md3 model header to be used.
+ * @param md3Contents The contents of the md3 model file.
+ */
 inline void Md3Importer::generateSurfacesList(Md3Header_t *md3Header, char *md3Contents) {
     // starts the surface contents pointer
     unsigned int surfaceContentsPointer = md3Header->offsetSurfaces - MD3_HEADER_SIZE;
 
+    // resets the vertex count
+    this->vertexCount = 0;
+
+    // allocates the list of the new position (in the surface)
+    // of each of the vertices of the surfaces
+    std::vector<unsigned int> remapList;
+
     // iterates over all the surfaces in the model
     for(int index = 0; index < this->surfaceCount; index++) {
         // retrieves the surface header
         Md3SurfaceHeader_t *surfaceHeader = (Md3SurfaceHeader_t *) &md3Contents[surfaceContentsPointer];
 
+        // retrieves the surface contents
+        char *surfaceContents = (char *) surfaceHeader;
+
+        // creates the surface in the current end of the streams
+        Md3Surface_t surface;
+        surface.name = std::string(surfaceHeader->name, std::find(surfaceHeader->name, surfaceHeader->name + sizeof(surfaceHeader->name), '\0'));
+        surface.vertexOffset = this->vertexCount;
+        surface.numberVertices = surfaceHeader->numberVertices;
+        surface.indexOffset = this->indexesList.size();
+        surface.numberIndexes = surfaceHeader->numberTriangles * 3;
+
+        // in case the surface has shaders
+        if(surfaceHeader->numberShaders > 0) {
+            // retrieves the first shader
+            Md3Shader_t *shader = (Md3Shader_t *) &surfaceContents[surfaceHeader->offsetShaders];
+
+            // sets the surface shader name (not necessarily null terminated)
+            surface.shaderName = std::string(shader->name, std::find(shader->name, shader->name + sizeof(shader->name), '\0'));
+        }
+
+        // retrieves the triangles
+        Md3Triangle_t *triangles = (Md3Triangle_t *) &surfaceContents[surfaceHeader->offsetTriangles];
+
+        // copies the triangle indexes (in the surface)
+        std::vector<unsigned int> triangleIndexesList((unsigned int *) triangles, (unsigned int *) (triangles + surfaceHeader->numberTriangles));
+
+        // retrieves the surface remap list
+        remapList.resize(surface.vertexOffset + surface.numberVertices);
+        unsigned int *surfaceRemapList = surface.numberVertices ? &remapList[surface.vertexOffset] : NULL;
+
+        // in case the surface has triangles
+        if(!triangleIndexesList.empty()) {
+            // orders the triangles and the vertices
+            MeshUtil::optimizeVertexCache(&triangleIndexesList[0], surface.numberIndexes, surface.numberVertices);
+            MeshUtil::optimizeVertexFetch(&triangleIndexesList[0], surface.numberIndexes, surface.numberVertices, surfaceRemapList);
+        } else {
+            // keeps the vertices in order
+            for(unsigned int vertexIndex = 0; vertexIndex < surface.numberVertices; vertexIndex++) {
+                surfaceRemapList[vertexIndex] = vertexIndex;
+            }
+        }
+
+        // adds the (16 bit) triangle indexes
+        this->indexesList.resize(surface.indexOffset + surface.numberIndexes);
+        if(surface.numberIndexes) {
+            MeshUtil::setIndexes(&triangleIndexesList[0], surface.numberIndexes, SHORT_INDEX, &this->indexesList[surface.indexOffset]);
+        }
+
+        // retrieves the texture coordinates
+        float *textureCoordinates = (float *) &surfaceContents[surfaceHeader->offsetTextureCoordinates];
+
+        // adds the texture coordinates (two per vertex) in
+        // the new position of the vertices
+        this->textureVerticesList.resize((surface.vertexOffset + surface.numberVertices) * 2);
+        if(surface.numberVertices) {
+            MeshUtil::remapVertices(textureCoordinates, 2, surface.numberVertices, surfaceRemapList, &this->textureVerticesList[surface.vertexOffset * 2]);
+        }
+
+        // adds the surface to the surfaces list
+        this->surfacesList.push_back(surface);
+
+        // increments the vertex count
+        this->vertexCount += surfaceHeader->numberVertices;
+
+        // increments the surface contents pointer
+        surfaceContentsPointer += surfaceHeader->offsetEnd;
+    }
+
+    // calculates the number of quantized values of each
+    // keyframe (four per vertex)
+    size_t keyframeValues = this->vertexCount * (MD3_VERTEX_SIZE / sizeof(short));
 
+    // allocates the vertices of all the keyframes
+    this->keyframeVerticesList.resize(this->frameCount * keyframeValues + 1);
+
+    // iterates over all the frames in the model
+    for(int index = 0; index < this->frameCount; index++) {
+        // creates the keyframe (the coordinates are
+        // stored in 1/64 units)
+        QuantizedKeyframe_t keyframe;
+        keyframe.scale[0] = MD3_VERTEX_SCALE;
+        keyframe.scale[1] = MD3_VERTEX_SCALE;
+        keyframe.scale[2] = MD3_VERTEX_SCALE;
+        keyframe.translate[0] = 0.0f;
+        keyframe.translate[1] = 0.0f;
+        keyframe.translate[2] = 0.0f;
+        keyframe.vertices = (unsigned char *) &this->keyframeVerticesList[index * keyframeValues];
+
+        // adds the keyframe to the keyframes list
+        this->keyframesList.push_back(keyframe);
     }
-}
 
+    // restarts the surface contents pointer
+    surfaceContentsPointer = md3Header->offsetSurfaces - MD3_HEADER_SIZE;
 
+    // iterates over all the surfaces in the model
+    for(int index = 0; index < this->surfaceCount; index++) {
+        // retrieves the surface header and contents
+        Md3SurfaceHeader_t *surfaceHeader = (Md3SurfaceHeader_t *) &md3Contents[surfaceContentsPointer];
+        char *surfaceContents = (char *) surfaceHeader;
+
+        // retrieves the surface
+        Md3Surface_t &surface = this->surfacesList[index];
+
+        // calculates the size of the vertices of the surface
+        // in each frame
+        size_t surfaceVerticesSize = surfaceHeader->numberVertices * MD3_VERTEX_SIZE;
+
+        // iterates over all the frames in the model
+        for(int frameIndex = 0; frameIndex < this->frameCount; frameIndex++) {
+            // retrieves the surface frame vertices and the keyframe
+            // surface vertices
+            char *surfaceVertices = &surfaceContents[surfaceHeader->offsetXYZNormal + frameIndex * surfaceVerticesSize];
+            unsigned char *keyframeVertices = this->keyframesList[frameIndex].vertices + surface.vertexOffset * MD3_VERTEX_SIZE;
+
+            // iterates over all the surface vertices
+            for(unsigned int vertexIndex = 0; vertexIndex < surface.numberVertices; vertexIndex++) {
+                // copies the quantized vertex into its new position in
+                // the keyframe (the md3 vertex layout matches the short
+                // quantized vertex layout)
+                memcpy(keyframeVertices + remapList[surface.vertexOffset + vertexIndex] * MD3_VERTEX_SIZE, surfaceVertices + vertexIndex * MD3_VERTEX_SIZE, MD3_VERTEX_SIZE);
+            }
+        }
+
+        // increments the surface contents pointer
+        surfaceContentsPointer += surfaceHeader->offsetEnd;
+    }
+}
+
+/**
+ * Generates the animation clips list from the names of
+ * the frames.
+ */
+inline void Md3Importer::generateClipsList() {
+    // allocates the frame names list
+    std::vector<std::string> frameNamesList;
+
+    // iterates over all the md3 frames
+    for(unsigned int index = 0; index < this->md3FramesList.size(); index++) {
+        // adds the frame name to the frame names list
+        frameNamesList.push_back(this->md3FramesList[index]->name);
+    }
 
+    // generates the clips from the frame names
+    AnimationUtil::generateClips(frameNamesList, this->clipsList);
+}
 
 /**
  * Constructor of the class.
@@ -26,18 +26,61 @@
 #pragma once
 
 #include "../structures/position.h"
+#include "../structures/keyframe.h"
 #include "model_importer.h"
 
 /**
  * The md3 header size.
  */
-#define MD3_HEADER_SIZE 112
+#define MD3_HEADER_SIZE 108
 
 /**
  * The md3 frame header size.
  */
 #define MD3_FRAME_HEADER_SIZE 56
 
+/**
+ * The md3 tag size.
+ */
+#define MD3_TAG_SIZE 112
+
+/**
+ * The md3 surface header size.
+ */
+#define MD3_SURFACE_HEADER_SIZE 108
+
+/**
+ * The md3 shader size.
+ */
+#define MD3_SHADER_SIZE 68
+
+/**
+ * The md3 triangle size.
+ */
+#define MD3_TRIANGLE_SIZE 12
+
+/**
+ * The md3 texture coordinate size.
+ */
+#define MD3_TEXTURE_COORDINATE_SIZE 8
+
+/**
+ * The md3 vertex size.
+ */
+#define MD3_VERTEX_SIZE 8
+
+/**
+ * The scale of the md3 vertex coordinates (the
+ * coordinates are stored in 1/64 units).
+ */
+#define MD3_VERTEX_SCALE (1.0f / 64.0f)
+
+/**
+ * The maximum number of vertices of an md3 surface
+ * (the surface vertices are indexed with 16 bit indexes).
+ */
+#define MD3_MAXIMUM_SURFACE_VERTICES 4096
+
 namespace mariachi {
     namespace importers {
         /**
@@ -103,25 +146,94 @@ namespace mariachi {
             structures::Coordinate3d_t axis[3];
         } Md3TagHeader;
 
+        /**
+         * The md3 shader information structure.
+         *
+         * @param name The name (path) of the shader.
+         * @param shaderIndex The index of the shader.
+         */
         typedef struct Md3Shader_t {
             char name[64];
             int shaderIndex;
         } Md3Shader;
 
+        /**
+         * The md3 surface header information structure, all
+         * the offsets are relative to the start of the surface.
+         *
+         * @param identifier The surface magic number (IDP3).
+         * @param name The name of the surface.
+         * @param flags The flags of the surface.
+         * @param numberFrames The number of frames (the same of the model).
+         * @param numberShaders The number of shaders.
+         * @param numberVertices The number of vertices.
+         * @param numberTriangles The number of triangles.
+         * @param offsetTriangles The offset address to the triangles.
+         * @param offsetShaders The offset address to the shaders.
+         * @param offsetTextureCoordinates The offset address to the
+         * texture coordinates.
+         * @param offsetXYZNormal The offset address to the vertices
+         * (of all the frames).
+         * @param offsetEnd The offset address to the end (the next surface).
+         */
         typedef struct Md3SurfaceHeader_t {
-            int indentation;
+            char identifier[4];
             char name[64];
             int flags;
             int numberFrames;
             int numberShaders;
             int numberVertices;
             int numberTriangles;
+            int offsetTriangles;
             int offsetShaders;
-            int offsetStart;
+            int offsetTextureCoordinates;
             int offsetXYZNormal;
             int offsetEnd;
         } Md3SurfaceHeader;
 
+        /**
+         * The md3 triangle information structure.
+         *
+         * @param indexes The indexes of the triangle vertices
+         * (in the surface).
+         */
+        typedef struct Md3Triangle_t {
+            int indexes[3];
+        } Md3Triangle;
+
+        /**
+         * The md3 vertex information structure.
+         *
+         * @param coordinates The coordinates of the vertex
+         * (in 1/64 units).
+         * @param normal The encoded normal (latitude and longitude).
+         */
+        typedef struct Md3Vertex_t {
+            short coordinates[3];
+            short normal;
+        } Md3Vertex;
+
+        /**
+         * The md3 surface, a range of the vertex and index
+         * streams of the model.
+         *
+         * @param name The name of the surface.
+         * @param shaderName The name (path) of the first shader of the
+         * surface (empty in case there are no shaders).
+         * @param vertexOffset The offset of the surface in the vertex stream.
+         * @param numberVertices The number of vertices.
+         * @param indexOffset The offset of the surface in the index stream.
+         * @param numberIndexes The number of indexes (three per triangle).
+         */
+        typedef struct Md3Surface_t {
+            std::string name;
+            std::string shaderName;
+            unsigned int vertexOffset;
+            unsigned int numberVertices;
+            unsigned int indexOffset;
+            unsigned int numberIndexes;
+        } Md3Surface;
+
         /**
          * Class that represents an md3 (quake 3) frame.
          *
@@ -131,31 +243,68 @@ namespace mariachi {
             private:
 
             public:
+                std::string name;
+                structures::Coordinate3d_t minimumBounds;
+                structures::Coordinate3d_t maximumBounds;
+                float radius;
+
                 Md3Frame();
                 ~Md3Frame();
         };
 
         /**
-         * Class that represents an md3 (quake 3) frame, the contents
-         * include coordinates list, vertex list and mesh list.
+         * The md3 importer class.
+         * Allows the importing to the mariachi engine of the quake 3 models,
+         * the surfaces are imported as indexed triangle lists sharing the
+         * (short quantized) vertex stream of each frame and the tags are
+         * kept per frame (for the attachment of sub models).
          *
          * @see wikipedia - http://en.wikipedia.org/wiki/MD3_(file_format)
          */
         class Md3Importer : public ModelImporter {
             private:
                 std::vector<Md3Frame *> md3FramesList;
+                std::vector<Md3Surface_t> surfacesList;
+                std::vector<std::string> tagNamesList;
+                std::vector<structures::KeyframeTag_t> tagsList;
+                std::vector<structures::QuantizedKeyframe_t> keyframesList;
+                std::vector<short> keyframeVerticesList;
+                std::vector<float> textureVerticesList;
+                std::vector<unsigned short> indexesList;
+                std::vector<structures::AnimationClip_t> clipsList;
+                std::vector<structures::Mesh_t> animationMeshesList;
+                std::vector<unsigned int> animationVertexIndexesList;
+                std::vector<structures::Mesh_t> meshesList;
+                std::vector<structures::Mesh_t *> meshList;
+                std::vector<float> vertexList;
+                structures::KeyframeAnimation_t animation;
                 int frameCount;
                 int tagCount;
                 int surfaceCount;
+                int vertexCount;
 
                 inline void generateFramesList(Md3Header_t *md3Header, char *md3Contents);
                 inline void generateTagsList(Md3Header_t *md3Header, char *md3Contents);
                 inline void generateSurfacesList(Md3Header_t *md3Header, char *md3Contents);
+                inline void generateClipsList();
+                inline bool isValidFile(Md3Header_t *md3Header, size_t md3FileSize);
+                inline bool isValidSurface(Md3SurfaceHeader_t *surfaceHeader, size_t surfaceSize, int numberFrames);
 
             public:
                 Md3Importer();
                 ~Md3Importer();
                 void generateModel(const std::string &filePath);
+                void generateMeshList();
+                void generateAnimation();
+                structures::KeyframeAnimation_t *getAnimation();
+                nodes::ModelNode *getModelNode();
+                nodes::ActorNode *getActorNode();
+                std::vector<Md3Surface_t> &getSurfacesList();
+                std::vector<std::string> &getTagNamesList();
+                std::vector<structures::AnimationClip_t> &getClipsList();
+                void cleanModel();
+                void cleanMd3FrameList();
+                void cleanAnimation();
         };
     }
 }
@@ -85,6 +85,12 @@ THREAD_RETURN mariachi::mainRunnerThread(THREAD_ARGUMENTS parameters) {
         // starts the logger in the engine
         engine->startLogger(DEBUG, true);
 
+        // starts the profiler in the engine
+        engine->startProfiler();
+
+        // starts the task pool in the engine
+        engine->startTaskPool();
+
         // starts the input devices in the engine
         engine->startInputDevices();
 
@@ -94,6 +100,9 @@ THREAD_RETURN mariachi::mainRunnerThread(THREAD_ARGUMENTS parameters) {
         // starts the physics engines in the engine
         engine->startPhysicsEngines();
 
+        // starts the job scheduler in the engine
+        engine->startJobScheduler();
+
         // starts the stages in the engine
         engine->startStages();
 
@@ -103,6 +112,15 @@ THREAD_RETURN mariachi::mainRunnerThread(THREAD_ARGUMENTS parameters) {
         // stops the stages in the engine
         engine->stopStages();
 
+        // stops the job scheduler in the engine
+        engine->stopJobScheduler();
+
+        // stops the task pool in the engine
+        engine->stopTaskPool();
+
+        // stops the profiler in the engine
+        engine->stopProfiler();
+
         // returns valid value
         return THREAD_INVALID_RETURN_VALUE;
     } catch(Exception exception) {
@@ -115,8 +133,8 @@ THREAD_RETURN mariachi::mainRunnerThread(THREAD_ARGUMENTS parameters) {
 }
 
 /**
- * Thread than runs a new stage. It controls the frequency of the loading
- * and manages it.
+ * Thread than runs a stage that requires a dedicated thread (the
+ * stage update blocks and so can not be run as a job).
  *
  * @param parameters The thread parameters.
  * @return The thread result.
@@ -155,6 +173,9 @@ THREAD_RETURN mariachi::stageRunnerThread(THREAD_ARGUMENTS parameters) {
 Engine::Engine() {
     this->initRunningFlag();
     this->initRenders();
+    this->initTaskPool();
+    this->initProfiler();
+    this->initFramePacing();
 }
 
 /**
@@ -167,6 +188,9 @@ Engine::Engine(int argc, char** argv) {
     this->initRunningFlag();
     this->initLogger();
     this->initRenders();
+    this->initTaskPool();
+    this->initProfiler();
+    this->initFramePacing();
     this->initArgs(argc, argv);
 }
 
@@ -174,6 +198,11 @@ Engine::Engine(int argc, char** argv) {
  * Destructor of the class.
  */
 Engine::~Engine() {
+    // in case the profiler is set
+    if(this->profiler) {
+        // deletes the profiler
+        delete this->profiler;
+    }
 }
 
 /**
@@ -200,6 +229,36 @@ inline void Engine::initRenders() {
 
     // creates the render 2d node
     this->render2d = new Scene2dNode(std::string("render2d"));
+
+    // unsets the transform store (transforms kept in the nodes)
+    this->transformStore = NULL;
+}
+
+/**
+ * Initializes the task pool.
+ */
+inline void Engine::initTaskPool() {
+    this->taskPool = NULL;
+}
+
+/**
+ * Initializes the profiler.
+ */
+inline void Engine::initProfiler() {
+    this->profiler = NULL;
+}
+
+/**
+ * Initializes the frame pacing values.
+ */
+inline void Engine::initFramePacing() {
+    // sets the default timestep and maximum steps
+    this->timestep = 1.0 / DEFAULT_SIMULATION_RATE;
+    this->maximumSteps = DEFAULT_MAXIMUM_STEPS;
+
+    // resets the interpolation time and the missed deadlines
+    this->interpolationTime = 0.0;
+    this->missedDeadlines = 0;
 }
 
 /**
@@ -219,11 +278,9 @@ void Engine::start(void *arguments) {
     // prints the information
     this->printInformation();
 
-    // creates the task list mutex
-    MUTEX_CREATE(this->taskListMutex);
-
-    // creates the task list ready event
-    EVENT_CREATE(this->taskListReadyEvent);
+    // creates the task list critical section and condition
+    CRITICAL_SECTION_CREATE(this->taskListCriticalSection);
+    CONDITION_CREATE(this->taskListCondition);
 
     // allocates space for the thread id
     THREAD_IDENTIFIER threadId;
@@ -231,30 +288,45 @@ void Engine::start(void *arguments) {
     // creates the engine runnner thread
     THREAD_HANDLE mainRunnerThreadHandle = THREAD_CREATE_BASE(threadId, mainRunnerThread, this);
 
-    // iterates while the running flag is active
-    while(this->runningFlag) {
-        // iterates while the task list contains
-        // valid task elements
-        while(this->taskList.size()) {
-            // retrieves the current task
-            Task *currentTask = this->taskList.front();
+    // iterates continuously (running the main thread tasks)
+    while(true) {
+        // enters the task list critical section
+        CRITICAL_SECTION_ENTER(this->taskListCriticalSection);
+
+        // iterates while the task list is empty and the running flag is active
+        while(this->taskList.empty() && this->runningFlag) {
+            CONDITION_WAIT(this->taskListCondition, this->taskListCriticalSection);
+        }
 
-            // pops the task list
-            this->taskList.pop_front();
+        // in case the running flag is not active
+        if(!this->runningFlag) {
+            // leaves the task list critical section
+            CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
 
-            // starts the current task
-            currentTask->start(NULL);
+            // breaks the loop
+            break;
         }
 
-        // waits for the task list ready event
-        EVENT_WAIT(this->taskListReadyEvent);
+        // retrieves the current task (highest priority)
+        Task *currentTask = this->taskList.front();
 
-        // resets the event
-        EVENT_RESET(this->taskListReadyEvent);
+        // pops the task list
+        this->taskList.pop_front();
+
+        // leaves the task list critical section
+        CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
+
+        // runs the current task
+        currentTask->run();
     }
 
-    // closes the task list ready event
-    EVENT_CLOSE(this->taskListReadyEvent);
+    // waits for the main runner thread to exit (the teardown
+    // uses the task list critical section)
+    THREAD_JOIN_BASE(mainRunnerThreadHandle, threadId);
+
+    // closes the task list critical section and condition
+    CRITICAL_SECTION_CLOSE(this->taskListCriticalSection);
+    CONDITION_CLOSE(this->taskListCondition);
 }
 
 /**
@@ -263,38 +335,88 @@ void Engine::start(void *arguments) {
  * @param arguments The arguments for the engine stop.
  */
 void Engine::stop(void *arguments) {
+    // enters the task list critical section
+    CRITICAL_SECTION_ENTER(this->taskListCriticalSection);
+
     // unsets the running flag
     this->runningFlag = false;
 
-    // signals the task list ready event (to unblock the thread)
-    EVENT_SIGNAL(this->taskListReadyEvent);
+    // signals the task list condition (to unblock the thread)
+    CONDITION_SIGNAL(this->taskListCondition);
+
+    // leaves the task list critical section
+    CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
+}
+
+/**
+ * Starts a new engine frame, updating the stages that are
+ * pipelined (not synchronized with the presentation).
+ */
+void Engine::startFrame() {
+    // starts the frame in the frame graph
+    this->frameGraph->startFrame();
 }
 
 /**
- * Updates the engine state, running the main thread stages and any other
- * recursive engine operations.
+ * Updates the engine state, running the stages synchronized
+ * with the presentation and any other recursive engine operations.
  */
 void Engine::update() {
-    // retrieves the main thread stages list iterator
-    std::list<Stage *>::iterator mainThreadStagesListIterator = this->mainThreadStagesList.begin();
+    // updates the frame graph (synchronized stages)
+    this->frameGraph->update();
+}
 
-    // iterates over all the main thread stages
-    while(mainThreadStagesListIterator != this->mainThreadStagesList.end()) {
-        // retrieves the main thread stage
-        Stage *mainThreadStage = *mainThreadStagesListIterator;
+/**
+ * Ends the current engine frame, waiting for the pipelined stages.
+ */
+void Engine::endFrame() {
+    // ends the frame in the frame graph
+    this->frameGraph->endFrame();
+}
 
-        // starts the dependency sync
-        //mainThreadStage->startDependencySync();
+/**
+ * Runs a single simulation step (tick), running all the stages
+ * for the frame.
+ * The synchronized stages are run in lockstep with the presentation.
+ */
+void Engine::tick() {
+    // in case the profiler is available
+    if(this->profiler) {
+        // marks the main frame
+        this->profiler->markFrame(MAIN_FRAME_TIMER_ID);
+    }
 
-        // updates the current main thread stage
-        mainThreadStage->update(NULL);
+    // starts the frame (pipelined stages)
+    this->startFrame();
 
-        // ends the dependency sync
-        //mainThreadStage->endDependencySync();
+#if defined(MARIACHI_ASSYNC_PARALLEL_PROCESSING)
+    // updates the engine state
+    this->update();
+#elif defined(MARIACHI_SYNC_PARALLEL_PROCESSING)
+    // enters the critical section
+    CRITICAL_SECTION_ENTER(this->fifo->queueCriticalSection);
 
-        // increments the main thread stages list iterator
-        mainThreadStagesListIterator++;
+    // iterates while the queue is full, the stop flag is not set
+    // and the running flag is active
+    while(this->fifo->queue.size() == this->fifo->size && !this->fifo->stopFlag && this->runningFlag) {
+        CONDITION_WAIT(this->fifo->notFullCondition, this->fifo->queueCriticalSection);
     }
+
+    // updates the engine state
+    this->update();
+
+    // adds the true value to the fifo
+    this->fifo->queue.push_back(true);
+
+    // leaves the critical section
+    CRITICAL_SECTION_LEAVE(this->fifo->queueCriticalSection);
+
+    // sends the condition signal
+    CONDITION_SIGNAL(this->fifo->notEmptyCondition);
+#endif
+
+    // ends the frame (pipelined stages)
+    this->endFrame();
 }
 
 /**
@@ -371,6 +493,10 @@ void Engine::startConfigurationManager() {
     // updates the paths list using the information
     // provided in the configuration manager
     this->updatePathsListConfiguration();
+
+    // updates the frame pacing using the information
+    // provided in the configuration manager
+    this->updateFramePacingConfiguration();
 }
 
 /**
@@ -541,10 +667,125 @@ void Engine::startPhysicsEngines() {
     this->setActivePhysicsEngine(bulletPhysicsEngine);
 }
 
+/**
+ * Starts the profiler in the engine, setting it as the active
+ * profiler (the profiler may be disabled in the configuration).
+ */
+void Engine::startProfiler() {
+    // retrieves the profiler enabled value
+    ConfigurationValue_t *profilerEnabledProperty = this->configurationManager->getProperty("profiler/enabled");
+
+    // creates the profiler
+    this->profiler = new Profiler();
+
+    // in case the enabled value is defined in the configuration
+    if(profilerEnabledProperty) {
+        // sets the profiler enabled flag
+        this->profiler->setEnabled(profilerEnabledProperty->structure.booleanValue);
+    }
+
+    // sets the profiler as the active profiler
+    Profiler::setActiveProfiler(this->profiler);
+}
+
+/**
+ * Stops the profiler in the engine.
+ */
+void Engine::stopProfiler() {
+    // unsets the active profiler
+    Profiler::setActiveProfiler(NULL);
+
+    // stops the profiler (releasing the samples under its lock),
+    // the profiler is only deleted with the engine as recorders
+    // in other threads may still hold it
+    this->profiler->stop();
+}
+
+/**
+ * Starts the task pool in the engine, the number of workers
+ * is retrieved from the configuration.
+ */
+void Engine::startTaskPool() {
+    // retrieves the tasks workers value
+    ConfigurationValue_t *tasksWorkersProperty = this->configurationManager->getProperty("tasks/workers");
+
+    // in case a number of workers is defined in the configuration
+    if(tasksWorkersProperty) {
+        // creates a task pool with the configured number of workers
+        this->taskPool = new TaskPool(tasksWorkersProperty->structure.intValue);
+    } else {
+        // creates a task pool with the default number of workers
+        this->taskPool = new TaskPool();
+    }
+
+    // starts the task pool
+    this->taskPool->start(NULL);
+}
+
+/**
+ * Stops the task pool in the engine, the pending tasks
+ * are canceled.
+ */
+void Engine::stopTaskPool() {
+    // enters the task list critical section
+    CRITICAL_SECTION_ENTER(this->taskListCriticalSection);
+
+    // retrieves the task pool
+    TaskPool *taskPool = this->taskPool;
+
+    // unsets the task pool (the new tasks are
+    // run in the main thread)
+    this->taskPool = NULL;
+
+    // leaves the task list critical section (no task
+    // is being submitted to the task pool)
+    CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
+
+    // stops the task pool
+    taskPool->stop(NULL);
+
+    // deletes the task pool
+    delete taskPool;
+}
+
+/**
+ * Starts the job scheduler in the engine.
+ * The number of workers may be set in the configuration, otherwise
+ * it's computed from the number of available processors.
+ */
+void Engine::startJobScheduler() {
+    // retrieves the scheduler workers value
+    ConfigurationValue_t *schedulerWorkersProperty = this->configurationManager->getProperty("scheduler/workers");
+
+    // in case a number of workers is defined in the configuration
+    if(schedulerWorkersProperty) {
+        // creates a job scheduler with the configured number of workers
+        this->jobScheduler = new JobScheduler(schedulerWorkersProperty->structure.intValue);
+    } else {
+        // creates a job scheduler with the default number of workers
+        this->jobScheduler = new JobScheduler();
+    }
+
+    // starts the job scheduler
+    this->jobScheduler->start(NULL);
+}
+
+/**
+ * Stops the job scheduler in the engine.
+ */
+void Engine::stopJobScheduler() {
+    // stops the job scheduler
+    this->jobScheduler->stop(NULL);
+
+    // deletes the job scheduler
+    delete this->jobScheduler;
+}
+
 /**
  * Starts the stages in the engine.
- * Starting the stages implies loading them and creating new threads
- * for the ones than require a new thread to be created.
+ * Starting the stages implies loading them, creating the frame graph
+ * with the stage runners and creating new threads for the ones
+ * than require a dedicated thread.
  */
 void Engine::startStages() {
     // retrieves the stages list
@@ -553,6 +794,15 @@ void Engine::startStages() {
     // includes the stages initialization
     #include "../stages/stages_init.h"
 
+    // creates the frame graph
+    this->frameGraph = new FrameGraph(this->jobScheduler);
+
+    // adds the resources read by the presentation, the stages
+    // writing them are synchronized with the presentation
+    this->frameGraph->addPresentationRead(SCENE_GRAPH_RESOURCE);
+    this->frameGraph->addPresentationRead(CAMERA_STATE_RESOURCE);
+    this->frameGraph->addPresentationRead(RENDER_INFORMATION_RESOURCE);
+
     // retrieves the stages list iterator
     std::list<Stage *>::iterator stagesListIterator = stagesList->begin();
 
@@ -564,8 +814,8 @@ void Engine::startStages() {
         // retrieves the current stage name
         std::string &currentStageName = currentStage->getName();
 
-        // in case the current stage requires a thread to run
-        if(currentStage->requiresThread()) {
+        // in case the current stage requires a dedicated thread to run
+        if(currentStage->requiresDedicatedThread()) {
             // allocates space for the thread id
             THREAD_IDENTIFIER threadId;
 
@@ -574,12 +824,25 @@ void Engine::startStages() {
 
             // sets the current stage in the thread handle stage map
             threadHandleStageMapPut(threadHandle, threadId, currentStage);
-        } else {
+        }
+        else {
+            // creates a new stage runner
+            StageRunner *stageRunner = new StageRunner(currentStage);
+
+            // registers the stage runner
+            this->setStageRunner(currentStage, stageRunner);
+
             // starts the current stage
             currentStage->start(NULL);
 
-            // adds the current stage to the list of main thread stages
-            this->mainThreadStagesList.push_back(currentStage);
+            // adds the stage runner to the frame graph
+            this->frameGraph->addStageRunner(stageRunner);
+
+            // in case the current stage does not require a thread
+            if(!currentStage->requiresThread()) {
+                // adds the current stage to the list of main thread stages
+                this->mainThreadStagesList.push_back(currentStage);
+            }
         }
 
         // sets the stage in the stages registry
@@ -588,6 +851,49 @@ void Engine::startStages() {
         // increments the stages list iterator
         stagesListIterator++;
     }
+
+    // retrieves the frame graph stage runners list
+    std::vector<StageRunner *> &frameGraphStageRunnersList = this->frameGraph->getStageRunnersList();
+
+    // iterates over all the frame graph stage runners
+    // to resolve their explicit dependencies
+    for(unsigned int index = 0; index < frameGraphStageRunnersList.size(); index++) {
+        // retrieves the frame graph stage runner
+        StageRunner *frameGraphStageRunner = frameGraphStageRunnersList[index];
+
+        // retrieves the dependency names for the stage
+        std::list<std::string> &dependencyNamesList = this->stageDependenciesMap[frameGraphStageRunner->getStage()->getName()];
+
+        // retrieves the dependency names list iterator
+        std::list<std::string>::iterator dependencyNamesListIterator = dependencyNamesList.begin();
+
+        // iterates over all the dependency names
+        while(dependencyNamesListIterator != dependencyNamesList.end()) {
+            // retrieves the dependency stage
+            Stage *dependencyStage = this->getStage(*dependencyNamesListIterator);
+
+            // in case the dependency stage is invalid
+            if(!dependencyStage) {
+                // throws a runtime exception
+                throw RuntimeException("Invalid stage dependency: " + *dependencyNamesListIterator);
+            }
+
+            // in case the dependency stage runs in a dedicated thread
+            if(dependencyStage->requiresDedicatedThread()) {
+                // throws a runtime exception
+                throw RuntimeException("Invalid dedicated thread stage dependency: " + *dependencyNamesListIterator);
+            }
+
+            // adds the dependency to the frame graph stage runner
+            frameGraphStageRunner->addDependency(this->getStageRunner(dependencyStage));
+
+            // increments the dependency names list iterator
+            dependencyNamesListIterator++;
+        }
+    }
+
+    // compiles the frame graph (computing the stages ordering)
+    this->frameGraph->compile();
 }
 
 /**
@@ -628,20 +934,23 @@ void Engine::stopStages() {
         threadHandleStageMapIterator++;
     }
 
-    // retrieves the main thread stages list iterator
-    std::list<Stage *>::iterator mainThreadStagesListIterator = this->mainThreadStagesList.begin();
+    // retrieves the frame graph stage runners list
+    std::vector<StageRunner *> &frameGraphStageRunnersList = this->frameGraph->getStageRunnersList();
 
-    // iterates over all the main thread stages
-    while(mainThreadStagesListIterator != this->mainThreadStagesList.end()) {
-        // retrieves the main thread stage
-        Stage *mainThreadStage = *mainThreadStagesListIterator;
+    // iterates over all the frame graph stage runners
+    for(unsigned int index = 0; index < frameGraphStageRunnersList.size(); index++) {
+        // retrieves the frame graph stage runner
+        StageRunner *frameGraphStageRunner = frameGraphStageRunnersList[index];
 
-        // stops the current main thread stage
-        mainThreadStage->stop(NULL);
+        // stops the frame graph stage
+        frameGraphStageRunner->getStage()->stop(NULL);
 
-        // increments the main thread stages list iterator
-        mainThreadStagesListIterator++;
+        // deletes the frame graph stage runner
+        delete frameGraphStageRunner;
     }
+
+    // deletes the frame graph
+    delete this->frameGraph;
 }
 
 /**
@@ -670,35 +979,102 @@ void Engine::stopDebugEngine() {
  * Starts the engine run loop (where it runs the main stages).
  */
 void Engine::startRunLoop() {
+    // allocates the current and previous time values
+    double currentTime;
+    double previousTime;
+
+    // retrieves the initial time
+    MONOTONIC_CLOCK(previousTime);
+
+    // starts the accumulator (time not yet simulated) and the
+    // time of the last missed deadlines report
+    double accumulator = 0.0;
+    double reportTime = previousTime;
+
     // iterates while the running flag is active
     while(this->runningFlag) {
-#if defined(MARIACHI_ASSYNC_PARALLEL_PROCESSING)
-        // updates the engine state
-        this->update();
+        // retrieves the current time
+        MONOTONIC_CLOCK(currentTime);
 
-        SLEEP(1.0f / 60.0f * 1000.0f);
-#elif defined(MARIACHI_SYNC_PARALLEL_PROCESSING)
-        // enters the critical section
-        CRITICAL_SECTION_ENTER(this->fifo->queueCriticalSection);
+        // adds the elapsed time to the accumulator
+        accumulator += currentTime - previousTime;
+        previousTime = currentTime;
+
+        // in case the accumulator exceeds the maximum number of steps
+        // (the simulation is not able to catch up)
+        if(accumulator > this->maximumSteps * this->timestep) {
+            // counts the dropped steps as missed deadlines
+            this->missedDeadlines += (unsigned int) (accumulator / this->timestep) - this->maximumSteps;
 
-        // iterates while the queue is full, the stop flag is not set
-        // and the running flag is active
-        while(this->fifo->queue.size() == this->fifo->size && !this->fifo->stopFlag && this->runningFlag) {
-            CONDITION_WAIT(this->fifo->notFullCondition, this->fifo->queueCriticalSection);
+            // clamps the accumulator to the maximum number of steps
+            accumulator = this->maximumSteps * this->timestep;
         }
 
-        // updates the engine state
-        this->update();
+        // starts the steps counter
+        unsigned int steps = 0;
 
-        // adds the true value to the fifo
-        this->fifo->queue.push_back(true);
+        // iterates while there is a complete timestep
+        // in the accumulator and the running flag is active
+        while(accumulator >= this->timestep && this->runningFlag) {
+            // runs a simulation step
+            this->tick();
 
-        // leaves the critical section
-        CRITICAL_SECTION_LEAVE(this->fifo->queueCriticalSection);
+            // removes the timestep from the accumulator
+            accumulator -= this->timestep;
 
-        // sends the condition signal
-        CONDITION_SIGNAL(this->fifo->notEmptyCondition);
-#endif
+            // increments the steps counter
+            steps++;
+        }
+
+        // in case more than one step was run (the previous
+        // iterations missed their deadline)
+        if(steps > 1) {
+            // increments the missed deadlines
+            this->missedDeadlines += steps - 1;
+        }
+
+        // sets the interpolation time (time at which the accumulator
+        // was empty), the render adapter derives the interpolation
+        // alpha from it at presentation time
+        this->interpolationTime = currentTime - accumulator;
+
+        // in case the missed deadlines report interval has passed
+        if(currentTime - reportTime >= MISSED_DEADLINES_REPORT_INTERVAL) {
+            // in case there are missed deadlines and a logger is available
+            if(this->missedDeadlines && this->logger) {
+                // creates the message string stream
+                std::stringstream messageStream;
+
+                // writes the missed deadlines message
+                messageStream << "Missed " << this->missedDeadlines << " simulation deadlines";
+
+                // prints a warning message
+                this->logger->warning(messageStream.str());
+            }
+
+            // resets the missed deadlines and the report time
+            this->missedDeadlines = 0;
+            reportTime = currentTime;
+        }
+
+        // retrieves the time after the steps
+        MONOTONIC_CLOCK(currentTime);
+
+        // calculates the remaining time until the next deadline
+        double remainingTime = this->timestep - accumulator - (currentTime - previousTime);
+
+        // in case there is enough remaining time to sleep
+        if(remainingTime > 0.002) {
+            // calculates the sleep time in miliseconds (waking up
+            // one milisecond early to compensate for the sleep precision)
+            unsigned int sleepTime = (unsigned int) (remainingTime * 1000.0) - 1;
+
+            // sleeps until the next deadline
+            SLEEP(sleepTime);
+        } else {
+            // yields the processor
+            THREAD_YIELD();
+        }
     }
 }
 
@@ -766,6 +1142,28 @@ void Engine::updatePathsListConfiguration() {
     }
 }
 
+/**
+ * Updates the frame pacing (simulation rate and maximum steps)
+ * using the information provided in the configuration.
+ */
+void Engine::updateFramePacingConfiguration() {
+    // retrieves the simulation rate and maximum steps values from the configuration
+    ConfigurationValue_t *simulationRate = this->configurationManager->getProperty("main_loop/simulation_rate");
+    ConfigurationValue_t *maximumSteps = this->configurationManager->getProperty("main_loop/maximum_steps");
+
+    // in case a valid simulation rate is defined in the configuration
+    if(simulationRate && simulationRate->structure.intValue > 0) {
+        // sets the timestep
+        this->timestep = 1.0 / simulationRate->structure.intValue;
+    }
+
+    // in case a valid maximum steps value is defined in the configuration
+    if(maximumSteps && maximumSteps->structure.intValue > 0) {
+        // sets the maximum steps
+        this->maximumSteps = maximumSteps->structure.intValue;
+    }
+}
+
 /**
  * Adds a path to the paths list.
  *
@@ -915,38 +1313,81 @@ void Engine::removeMainThreadStage(Stage *stage) {
 }
 
 /**
- * Adds the given task to the task list.
+ * Adds an explicit dependency between two stages, the stage is only
+ * updated after the dependency stage (in the same frame), in addition
+ * to the dependencies computed from the stages resources.
+ * The dependency stage must be registered before the stage.
+ *
+ * @param stageName The name of the dependent stage.
+ * @param dependencyStageName The name of the stage to be updated first.
+ */
+void Engine::addStageDependency(const std::string &stageName, const std::string &dependencyStageName) {
+    // adds the dependency stage name to the stage dependencies
+    this->stageDependenciesMap[stageName].push_back(dependencyStageName);
+}
+
+/**
+ * Adds the given task to be run by the engine, the task is run
+ * in the task pool or in the main thread (in case it requires it
+ * or the task pool is not available).
+ * The task may be used to wait for its completion or to cancel it.
  *
- * @param task The task to be added to the task list.
+ * @param task The task to be added.
  */
 void Engine::addTask(Task *task) {
-    // locks the list mutex
-    MUTEX_LOCK(this->taskListMutex);
+    // enters the task list critical section (the task
+    // pool is not stopped while the task is submitted)
+    CRITICAL_SECTION_ENTER(this->taskListCriticalSection);
+
+    // in case the task is not to be run in the main thread
+    // and the task pool is available
+    if(!task->isMainThread() && this->taskPool) {
+        // submits the task to the task pool
+        this->taskPool->submit(task);
+
+        // leaves the task list critical section
+        CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
+
+        // returns immediately
+        return;
+    }
+
+    // retrieves the task list iterator
+    std::list<Task *>::iterator taskListIterator = this->taskList.begin();
+
+    // iterates while the current task has the same or higher priority
+    while(taskListIterator != this->taskList.end() && (*taskListIterator)->getPriority() >= task->getPriority()) {
+        // increments the task list iterator
+        taskListIterator++;
+    }
 
-    // adds the task to the task list
-    this->taskList.push_back(task);
+    // inserts the task in the task list (ordered by priority)
+    this->taskList.insert(taskListIterator, task);
 
-    // signals the task list ready event
-    EVENT_SIGNAL(this->taskListReadyEvent);
+    // signals the task list condition
+    CONDITION_SIGNAL(this->taskListCondition);
 
-    // unlocks the task list mutex
-    MUTEX_UNLOCK(this->taskListMutex);
+    // leaves the task list critical section
+    CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
 }
 
 /**
- * Adds the given task from the task list.
+ * Removes the given task from the engine, canceling it.
  *
- * @param task The task to be removed from the task list.
+ * @param task The task to be removed.
  */
 void Engine::removeTask(Task *task) {
-    // locks the task list mutex
-    MUTEX_LOCK(this->taskListMutex);
+    // enters the task list critical section
+    CRITICAL_SECTION_ENTER(this->taskListCriticalSection);
 
     // removes the task from the task list
     this->taskList.remove(task);
 
-    // unlocks the task list mutex
-    MUTEX_UNLOCK(this->taskListMutex);
+    // leaves the task list critical section
+    CRITICAL_SECTION_LEAVE(this->taskListCriticalSection);
+
+    // cancels the task (a task in the task pool is not run)
+    task->cancel();
 }
 
 /**
@@ -1132,6 +1573,78 @@ void Engine::setConfigurationManager(ConfigurationManager *configurationManager)
     this->configurationManager = configurationManager;
 }
 
+/**
+ * Retrieves the profiler.
+ *
+ * @return The profiler.
+ */
+Profiler *Engine::getProfiler() {
+    return this->profiler;
+}
+
+/**
+ * Sets the profiler.
+ *
+ * @param profiler The profiler.
+ */
+void Engine::setProfiler(Profiler *profiler) {
+    this->profiler = profiler;
+}
+
+/**
+ * Retrieves the task pool.
+ *
+ * @return The task pool.
+ */
+TaskPool *Engine::getTaskPool() {
+    return this->taskPool;
+}
+
+/**
+ * Sets the task pool.
+ *
+ * @param taskPool The task pool.
+ */
+void Engine::setTaskPool(TaskPool *taskPool) {
+    this->taskPool = taskPool;
+}
+
+/**
+ * Retrieves the job scheduler.
+ *
+ * @return The job scheduler.
+ */
+JobScheduler *Engine::getJobScheduler() {
+    return this->jobScheduler;
+}
+
+/**
+ * Sets the job scheduler.
+ *
+ * @param jobScheduler The job scheduler.
+ */
+void Engine::setJobScheduler(JobScheduler *jobScheduler) {
+    this->jobScheduler = jobScheduler;
+}
+
+/**
+ * Retrieves the frame graph.
+ *
+ * @return The frame graph.
+ */
+FrameGraph *Engine::getFrameGraph() {
+    return this->frameGraph;
+}
+
+/**
+ * Sets the frame graph.
+ *
+ * @param frameGraph The frame graph.
+ */
+void Engine::setFrameGraph(FrameGraph *frameGraph) {
+    this->frameGraph = frameGraph;
+}
+
 /**
  * Retrieves the camera manager.
  *
@@ -1240,6 +1753,25 @@ void Engine::setRender2d(Scene2dNode *render2d) {
     this->render2d = render2d;
 }
 
+/**
+ * Retrieves the transform store.
+ *
+ * @return The transform store.
+ */
+TransformStore *Engine::getTransformStore() {
+    return this->transformStore;
+}
+
+/**
+ * Sets the transform store, the store is updated by the
+ * render stage before the scene transforms.
+ *
+ * @param transformStore The transform store.
+ */
+void Engine::setTransformStore(TransformStore *transformStore) {
+    this->transformStore = transformStore;
+}
+
 /**
  * Retrieves the current active camera.
  *
@@ -1276,6 +1808,56 @@ void Engine::setActivePhysicsEngine(PhysicsEngine *activePhysicsEngine) {
     this->activePhysicsEngine = activePhysicsEngine;
 }
 
+/**
+ * Retrieves the fixed simulation timestep (in seconds).
+ *
+ * @return The fixed simulation timestep.
+ */
+double Engine::getTimestep() {
+    return this->timestep;
+}
+
+/**
+ * Retrieves the interpolation alpha, the fraction of the timestep
+ * elapsed since the last simulation step (clamped to the unit range).
+ * This method is meant to be called by the render adapter at
+ * presentation time to blend the last two simulation states.
+ *
+ * @return The interpolation alpha.
+ */
+float Engine::getInterpolationAlpha() {
+    // in case no simulation step was run
+    if(this->interpolationTime == 0.0) {
+        // returns the latest state
+        return 1.0f;
+    }
+
+    // retrieves the current time
+    double currentTime;
+    MONOTONIC_CLOCK(currentTime);
+
+    // calculates the fraction of the timestep elapsed
+    // since the accumulator was empty
+    double interpolationAlpha = (currentTime - this->interpolationTime) / this->timestep;
+
+    // clamps the interpolation alpha to the unit range
+    interpolationAlpha = interpolationAlpha < 0.0 ? 0.0 : interpolationAlpha;
+    interpolationAlpha = interpolationAlpha > 1.0 ? 1.0 : interpolationAlpha;
+
+    // returns the interpolation alpha
+    return (float) interpolationAlpha;
+}
+
+/**
+ * Retrieves the number of missed simulation deadlines (since
+ * the last report).
+ *
+ * @return The number of missed simulation deadlines.
+ */
+unsigned int Engine::getMissedDeadlines() {
+    return this->missedDeadlines;
+}
+
 int Engine::getArgc() {
     return this->argc;
 }
@@ -32,6 +32,8 @@
 #include "../nodes/nodes.h"
 #include "../user_interface/user_interface.h"
 #include "../tasks/task.h"
+#include "../tasks/job_scheduler.h"
+#include "../tasks/task_pool.h"
 #include "../debugging/debugging.h"
 #include "../structures/fifo.h"
 
@@ -71,6 +73,23 @@
  */
 #define MARIACHI_HELP_TEXT "Type \"help\" for more information."
 
+/**
+ * The default simulation rate (in updates per second).
+ */
+#define DEFAULT_SIMULATION_RATE 60
+
+/**
+ * The default maximum number of simulation steps
+ * run in a single main loop iteration.
+ */
+#define DEFAULT_MAXIMUM_STEPS 5
+
+/**
+ * The interval (in seconds) between the reports
+ * of missed simulation deadlines.
+ */
+#define MISSED_DEADLINES_REPORT_INTERVAL 1.0
+
 namespace mariachi {
     namespace camera {
         class CameraManager;
@@ -93,6 +112,7 @@ namespace mariachi {
     }
 
     namespace stages {
+        class FrameGraph;
         class StageRunner;
         class Stage;
     }
@@ -149,20 +169,38 @@ namespace mariachi {
              */
             nodes::Scene2dNode *render2d;
 
+            /**
+             * The (optional) store used to keep the transforms
+             * of the nodes in contiguous lists.
+             */
+            structures::TransformStore *transformStore;
+
             /**
              * The engine used for debuging provisioning.
              */
             debugging::DebugEngine *debugEngine;
 
             /**
-             * The mutex that controls the task list access.
+             * The profiler used to collect the stage timings
+             * and the lock waits.
+             */
+            debugging::Profiler *profiler;
+
+            /**
+             * The critical section that controls the task list access.
              */
-            MUTEX_HANDLE taskListMutex;
+            CRITICAL_SECTION_HANDLE taskListCriticalSection;
 
             /**
-             * The task list ready event.
+             * The condition signaled when a task is added to the
+             * task list (or the engine is stopped).
              */
-            EVENT_HANDLE taskListReadyEvent;
+            CONDITION_HANDLE taskListCondition;
+
+            /**
+             * The pool used to run the (non main thread) tasks.
+             */
+            tasks::TaskPool *taskPool;
 
             /**
              * The map associating the stage with the
@@ -170,6 +208,24 @@ namespace mariachi {
              */
             std::map<stages::Stage *, stages::StageRunner *> stageRunnersMap;
 
+            /**
+             * The scheduler used to run the (non main thread)
+             * stages as jobs.
+             */
+            tasks::JobScheduler *jobScheduler;
+
+            /**
+             * The frame graph used to order and run the
+             * stages in each frame.
+             */
+            stages::FrameGraph *frameGraph;
+
+            /**
+             * The map associating the stage name with the
+             * names of the stages it depends on.
+             */
+            std::map<std::string, std::list<std::string> > stageDependenciesMap;
+
             /**
              * The list containing all the stages to be used.
              */
@@ -200,7 +256,8 @@ namespace mariachi {
             std::map<std::string, physics::PhysicsEngine *> physicsEnginesMap;
 
             /**
-             * The list of currently available tasks.
+             * The list of currently available tasks to be run in
+             * the main thread (ordered by priority).
              */
             std::list<tasks::Task *> taskList;
 
@@ -219,9 +276,35 @@ namespace mariachi {
              */
             physics::PhysicsEngine *activePhysicsEngine;
 
+            /**
+             * The fixed simulation timestep (in seconds).
+             */
+            double timestep;
+
+            /**
+             * The (monotonic) time at which the accumulator of the
+             * last simulation step was empty, used to compute the
+             * interpolation alpha at presentation time.
+             */
+            double interpolationTime;
+
+            /**
+             * The maximum number of simulation steps run in a
+             * single main loop iteration (spiral of death protection).
+             */
+            unsigned int maximumSteps;
+
+            /**
+             * The number of missed simulation deadlines.
+             */
+            unsigned int missedDeadlines;
+
             inline void initRunningFlag();
             inline void initLogger();
             inline void initRenders();
+            inline void initTaskPool();
+            inline void initProfiler();
+            inline void initFramePacing();
             inline void initArgs(int argc, char** argv);
 
         public:
@@ -233,7 +316,10 @@ namespace mariachi {
             ~Engine();
             void start(void *arguments);
             void stop(void *arguments);
+            void startFrame();
             void update();
+            void endFrame();
+            void tick();
             void printInformation();
             void handleException(exceptions::Exception *exception);
             void startPathsList();
@@ -247,6 +333,12 @@ namespace mariachi {
             void startInputDevices();
             void startScriptEngines();
             void startPhysicsEngines();
+            void startProfiler();
+            void stopProfiler();
+            void startTaskPool();
+            void stopTaskPool();
+            void startJobScheduler();
+            void stopJobScheduler();
             void startStages();
             void stopStages();
             void startDebugEngine();
@@ -254,6 +346,7 @@ namespace mariachi {
             void startRunLoop();
             void updatePathsListEnvironment();
             void updatePathsListConfiguration();
+            void updateFramePacingConfiguration();
             void addPath(const std::string &path);
             void removePath(const std::string &path);
             void addPaths(std::vector<std::string *> &pathsList);
@@ -263,6 +356,7 @@ namespace mariachi {
             void removeStage(stages::Stage *stage);
             void addMainThreadStage(stages::Stage *stage);
             void removeMainThreadStage(stages::Stage *stage);
+            void addStageDependency(const std::string &stageName, const std::string &dependencyStageName);
             void addTask(tasks::Task *task);
             void removeTask(tasks::Task *task);
             void startCameraTransition(const std::string &cameraName, int duration);
@@ -280,6 +374,14 @@ namespace mariachi {
             void setPhysicsEngine(const std::string &physicsEngineName, physics::PhysicsEngine *physicsEngine);
             nodes::CameraNode *getCamera(const std::string &cameraName);
             void setCamera(const std::string &cameraName, nodes::CameraNode *camera);
+            debugging::Profiler *getProfiler();
+            void setProfiler(debugging::Profiler *profiler);
+            tasks::TaskPool *getTaskPool();
+            void setTaskPool(tasks::TaskPool *taskPool);
+            tasks::JobScheduler *getJobScheduler();
+            void setJobScheduler(tasks::JobScheduler *jobScheduler);
+            stages::FrameGraph *getFrameGraph();
+            void setFrameGraph(stages::FrameGraph *frameGraph);
             configuration::ConfigurationManager *getConfigurationManager();
             void setConfigurationManager(configuration::ConfigurationManager *configurationManager);
             camera::CameraManager *getCameraManager();
@@ -294,10 +396,15 @@ namespace mariachi {
             void setRender(nodes::SceneNode *render);
             nodes::Scene2dNode *getRender2d();
             void setRender2d(nodes::Scene2dNode *render2d);
+            structures::TransformStore *getTransformStore();
+            void setTransformStore(structures::TransformStore *transformStore);
             nodes::CameraNode *getActiveCamera();
             void setActiveCamera(nodes::CameraNode *activeCamera);
             physics::PhysicsEngine *getActivePhysicsEngine();
             void setActivePhysicsEngine(physics::PhysicsEngine *activePhysicsEngine);
+            double getTimestep();
+            float getInterpolationAlpha();
+            unsigned int getMissedDeadlines();
             int getArgc();
             char **getArgv();
     };
@@ -25,8 +25,13 @@
 
 #include "stdafx.h"
 
+#include "../util/matrix_util.h"
+#include "../util/animation_util.h"
+#include "../util/mesh_util.h"
+
 #include "actor_node.h"
 
+using namespace mariachi::util;
 using namespace mariachi::nodes;
 using namespace mariachi::structures;
 
@@ -36,17 +41,20 @@ using namespace mariachi::structures;
 ActorNode::ActorNode() : ModelNode() {
     this->initRenderable();
     this->initCurrentFrame();
+    this->initAnimation();
 }
 
 ActorNode::ActorNode(const std::string &name) : ModelNode(name) {
     this->initRenderable();
     this->initCurrentFrame();
+    this->initAnimation();
 }
 
 /**
  * Destructor of the class.
  */
 ActorNode::~ActorNode() {
+    this->cleanAnimation();
 }
 
 inline void ActorNode::initRenderable() {
@@ -57,6 +65,16 @@ inline void ActorNode::initCurrentFrame() {
     this->currentFrame = 0;
 }
 
+inline void ActorNode::initAnimation() {
+    this->animation = NULL;
+    this->animationRate = 1.0f;
+    this->blendTime = 0.0f;
+    this->blendDuration = 0.0f;
+    this->animationBuffer = 0;
+    this->animationMeshes = NULL;
+    this->animationVertexBuffer = NULL;
+}
+
 inline Frame_t *ActorNode::getCurrentFrame() {
     return (*this->frameList)[this->currentFrame];
 }
@@ -77,6 +95,12 @@ inline void ActorNode::incrementFrame() {
 }
 
 std::vector<Mesh_t *> *ActorNode::getMeshList() {
+    // in case the actor is animated from keyframes
+    if(this->animation) {
+        // returns the last decoded mesh list
+        return &this->animationMeshLists[this->animationBuffer];
+    }
+
     // retrieves the current frame
     Frame_t *currentFrame = this->getCurrentFrame();
 
@@ -93,9 +117,516 @@ void ActorNode::setFrameList(std::vector<Frame_t *> *frameList) {
 }
 
 void ActorNode::updateFrame() {
+    // in case the actor is animated from keyframes
+    if(this->animation) {
+        // advances the animation by one keyframe
+        this->updateAnimation(1.0f / this->animation->frameRate);
+
+        // returns immediately
+        return;
+    }
+
     this->incrementFrame();
 }
 
+/**
+ * Advances the keyframe animation by the given time and
+ * updates the attached nodes with the decoded tags.
+ *
+ * @param delta The time to advance the animation (in seconds).
+ */
+void ActorNode::updateAnimation(float delta) {
+    // advances the animation
+    this->advanceAnimation(delta);
+
+    // updates the attached nodes
+    this->updateAttachments();
+}
+
+/**
+ * Advances the keyframe animation by the given time (scaled by
+ * the animation rate), the meshes are decoded from the quantized
+ * keyframes and interpolated between the two keyframes around the
+ * clip time (smooth at any update rate).
+ * During a cross fade the previous clip is also advanced and
+ * blended with the current one.
+ * Only the actor is changed (the attached nodes are not), so
+ * several actors may be advanced concurrently.
+ *
+ * @param delta The time to advance the animation (in seconds).
+ */
+void ActorNode::advanceAnimation(float delta) {
+    // in case there is no animation
+    if(!this->animation) {
+        // returns immediately
+        return;
+    }
+
+    // scales the delta with the animation rate
+    delta *= this->animationRate;
+
+    // advances the current clip
+    this->advanceClip(this->clipState, delta);
+
+    // in case there is a cross fade running
+    if(this->blendDuration > 0.0f) {
+        // advances the previous clip and the cross fade
+        this->advanceClip(this->previousClipState, delta);
+        this->blendTime += fabs(delta);
+
+        // in case the cross fade is complete
+        if(this->blendTime >= this->blendDuration) {
+            // stops the cross fade
+            this->blendDuration = 0.0f;
+        }
+    }
+
+    // decodes the meshes for the clip time
+    this->decodeAnimation();
+}
+
+KeyframeAnimation_t *ActorNode::getAnimation() {
+    return this->animation;
+}
+
+/**
+ * Sets the keyframe animation of the actor, the animation is
+ * shared between the actors and only the decoded meshes are
+ * kept per actor.
+ * The whole animation is played in loop until a clip is played.
+ *
+ * @param animation The keyframe animation (or null to use the
+ * frame list).
+ */
+void ActorNode::setAnimation(KeyframeAnimation_t *animation) {
+    // cleans the previous animation (in case there is one)
+    this->cleanAnimation();
+
+    // sets the animation
+    this->animation = animation;
+
+    // in case there is no animation or it is empty
+    if(!animation || !animation->numberKeyframes) {
+        // unsets the animation and returns immediately
+        this->animation = NULL;
+        return;
+    }
+
+    // allocates the meshes and the vertex buffer for all the buffers
+    this->animationMeshes = (Mesh_t *) malloc(sizeof(Mesh_t) * animation->numberMeshes * ACTOR_NODE_ANIMATION_BUFFERS);
+    this->animationVertexBuffer = (float *) malloc(sizeof(float) * animation->numberMeshVertices * 3 * ACTOR_NODE_ANIMATION_BUFFERS);
+
+    // iterates over all the buffers
+    for(unsigned int buffer = 0; buffer < ACTOR_NODE_ANIMATION_BUFFERS; buffer++) {
+        // retrieves the buffer meshes and vertex buffer
+        Mesh_t *meshes = &this->animationMeshes[buffer * animation->numberMeshes];
+        float *vertexBuffer = &this->animationVertexBuffer[buffer * animation->numberMeshVertices * 3];
+
+        // iterates over all the meshes
+        for(unsigned int index = 0; index < animation->numberMeshes; index++) {
+            // copies the template mesh (sharing the texture vertex list)
+            // and sets the decoded vertex list
+            meshes[index] = animation->meshes[index];
+            meshes[index].vertexList = vertexBuffer;
+            meshes[index].dynamic = true;
+            meshes[index].generation = MeshUtil::createGeneration();
+
+            // adds the mesh to the buffer mesh list
+            this->animationMeshLists[buffer].push_back(&meshes[index]);
+
+            // increments the vertex buffer position
+            vertexBuffer += meshes[index].numberVertices * 3;
+        }
+    }
+
+    // sets the whole animation as the (looped) clip
+    this->clipState.start = 0;
+    this->clipState.count = animation->numberKeyframes;
+    this->clipState.time = 0.0f;
+    this->clipState.loop = true;
+
+    // decodes the first keyframe
+    this->decodeAnimation();
+}
+
+float ActorNode::getAnimationRate() {
+    return this->animationRate;
+}
+
+/**
+ * Sets the animation rate, the factor applied to the time
+ * advanced in each update (a negative rate plays backwards).
+ *
+ * @param animationRate The animation rate.
+ */
+void ActorNode::setAnimationRate(float animationRate) {
+    this->animationRate = animationRate;
+}
+
+/**
+ * Plays the animation clip with the given name, cross fading
+ * from the current clip during the given duration.
+ *
+ * @param animationName The name of the clip to be played.
+ * @param loop If the clip should be played in loop.
+ * @param blendDuration The duration of the cross fade (in seconds),
+ * zero to switch immediately.
+ * @return If the clip was found in the animation.
+ */
+bool ActorNode::play(const std::string &animationName, bool loop, float blendDuration) {
+    // in case there is no animation
+    if(!this->animation) {
+        // returns false
+        return false;
+    }
+
+    // iterates over all the clips
+    for(unsigned int index = 0; index < this->animation->numberClips; index++) {
+        // retrieves the clip
+        AnimationClip_t &clip = this->animation->clips[index];
+
+        // in case the clip name is not the requested one
+        if(clip.name != animationName) {
+            // continues the loop
+            continue;
+        }
+
+        // in case there is a cross fade
+        if(blendDuration > 0.0f) {
+            // sets the current clip as the previous one
+            // and starts the cross fade
+            this->previousClipState = this->clipState;
+            this->blendTime = 0.0f;
+        }
+
+        // sets the cross fade duration
+        this->blendDuration = blendDuration > 0.0f ? blendDuration : 0.0f;
+
+        // sets the clip as the current one
+        this->clipState.start = clip.start;
+        this->clipState.count = clip.count;
+        this->clipState.time = 0.0f;
+        this->clipState.loop = loop;
+
+        // decodes the first keyframe of the clip
+        this->decodeAnimation();
+
+        // updates the attached nodes
+        this->updateAttachments();
+
+        // returns true
+        return true;
+    }
+
+    // returns false
+    return false;
+}
+
+/**
+ * Plays the animation clip with the given name in loop, cross
+ * fading from the current clip.
+ *
+ * @param animationName The name of the clip to be played.
+ */
 void ActorNode::loop(const std::string &animationName) {
+    this->play(animationName, true, ACTOR_NODE_BLEND_DURATION);
+}
+
+/**
+ * Retrieves the tag with the given name for the current (blended)
+ * animation time.
+ *
+ * @param tagName The name of the tag to be retrieved.
+ * @param tag The tag to be set with the (blended) tag values.
+ * @return If the tag was found in the animation.
+ */
+bool ActorNode::getTag(const std::string &tagName, KeyframeTag_t &tag) {
+    // retrieves the tag index
+    int tagIndex = this->getTagIndex(tagName);
+
+    // in case the tag was not found
+    if(tagIndex < 0) {
+        // returns false
+        return false;
+    }
+
+    // allocates the keyframes and the weights
+    const QuantizedKeyframe_t *keyframes[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+    float weights[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+
+    // samples the animation and blends the tag
+    unsigned int numberKeyframes = this->sampleAnimation(keyframes, weights);
+    this->blendTag(keyframes, weights, numberKeyframes, tagIndex, tag);
+
+    // returns true
+    return true;
+}
+
+/**
+ * Attaches the given node to the tag with the given name, the
+ * node is added as a child of the actor and its position and
+ * rotation follow the tag in every animation update (eg: a weapon
+ * attached to the hand or the head attached to the torso).
+ * The attachments are removed when the animation is changed.
+ *
+ * @param tagName The name of the tag to attach the node.
+ * @param node The node to be attached.
+ * @return If the tag was found in the animation.
+ */
+bool ActorNode::attach(const std::string &tagName, CubeNode *node) {
+    // retrieves the tag index
+    int tagIndex = this->getTagIndex(tagName);
+
+    // in case the tag was not found
+    if(tagIndex < 0) {
+        // returns false
+        return false;
+    }
+
+    // creates the attachment
+    ActorAttachment_t attachment;
+    attachment.tagIndex = tagIndex;
+    attachment.node = node;
+
+    // adds the node as a child node
+    this->addChild(node);
+
+    // retrieves the current tag of the attachment
+    this->getTag(tagName, attachment.tag);
+
+    // adds the attachment to the attachments list
+    this->attachmentsList.push_back(attachment);
+
+    // updates the attached node
+    this->updateAttachment(this->attachmentsList.back());
+
+    // returns true
+    return true;
+}
+
+/**
+ * Detaches the given node from the actor, removing it from
+ * the child nodes.
+ *
+ * @param node The node to be detached.
+ */
+void ActorNode::detach(CubeNode *node) {
+    // iterates over all the attachments
+    for(unsigned int index = 0; index < this->attachmentsList.size(); index++) {
+        // in case the attachment is not for the node
+        if(this->attachmentsList[index].node != node) {
+            // continues the loop
+            continue;
+        }
+
+        // removes the attachment and the child node
+        this->attachmentsList.erase(this->attachmentsList.begin() + index);
+        this->removeChild(node);
+
+        // returns immediately
+        return;
+    }
+}
+
+inline void ActorNode::advanceClip(ActorClipState_t &clipState, float delta) {
+    // calculates the clip duration
+    float duration = (float) clipState.count / this->animation->frameRate;
+
+    // advances the clip time
+    clipState.time += delta;
+
+    // in case the clip is played in loop
+    if(clipState.loop) {
+        // wraps the clip time in the clip duration
+        clipState.time = fmod(clipState.time, duration);
+        if(clipState.time < 0.0f) {
+            clipState.time += duration;
+        }
+    } else {
+        // clamps the clip time to the last keyframe
+        float lastTime = (float) (clipState.count - 1) / this->animation->frameRate;
+        clipState.time = clipState.time < 0.0f ? 0.0f : clipState.time > lastTime ? lastTime : clipState.time;
+    }
+}
+
+inline unsigned int ActorNode::sampleClip(ActorClipState_t &clipState, float weight, const QuantizedKeyframe_t **keyframes, float *weights) {
+    // calculates the keyframe position for the clip time
+    float position = clipState.time * this->animation->frameRate;
+
+    // retrieves the keyframe (in the clip)
+    unsigned int keyframeIndex = (unsigned int) position;
+    keyframeIndex = keyframeIndex < clipState.count ? keyframeIndex : clipState.count - 1;
+
+    // retrieves the next keyframe (looping or stopping in the last one)
+    unsigned int nextKeyframeIndex = keyframeIndex + 1;
+    nextKeyframeIndex = nextKeyframeIndex < clipState.count ? nextKeyframeIndex : clipState.loop ? 0 : clipState.count - 1;
+
+    // calculates the interpolation between the keyframes
+    float interpolation = position - (float) keyframeIndex;
+    interpolation = interpolation < 1.0f ? interpolation : 1.0f;
+
+    // sets the keyframes and the weights
+    keyframes[0] = &this->animation->keyframes[clipState.start + keyframeIndex];
+    keyframes[1] = &this->animation->keyframes[clipState.start + nextKeyframeIndex];
+    weights[0] = weight * (1.0f - interpolation);
+    weights[1] = weight * interpolation;
+
+    // returns the number of keyframes
+    return 2;
+}
+
+inline unsigned int ActorNode::sampleAnimation(const QuantizedKeyframe_t **keyframes, float *weights) {
+    // calculates the weight of the current clip (in
+    // case there is a cross fade running)
+    float weight = this->blendDuration > 0.0f ? this->blendTime / this->blendDuration : 1.0f;
+
+    // samples the current clip
+    unsigned int numberKeyframes = this->sampleClip(this->clipState, weight, keyframes, weights);
+
+    // in case there is a cross fade running
+    if(this->blendDuration > 0.0f) {
+        // samples the previous clip
+        numberKeyframes += this->sampleClip(this->previousClipState, 1.0f - weight, &keyframes[numberKeyframes], &weights[numberKeyframes]);
+    }
+
+    // returns the number of keyframes
+    return numberKeyframes;
+}
+
+inline void ActorNode::blendTag(const QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, unsigned int tagIndex, KeyframeTag_t &tag) {
+    // allocates the keyframe tags
+    const KeyframeTag_t *tags[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+
+    // iterates over all the keyframes
+    for(unsigned int index = 0; index < numberKeyframes; index++) {
+        // retrieves the index of the keyframe in the animation
+        unsigned int keyframeIndex = keyframes[index] - this->animation->keyframes;
+
+        // retrieves the tag of the keyframe
+        tags[index] = &this->animation->tags[keyframeIndex * this->animation->numberTags + tagIndex];
+    }
+
+    // blends the keyframe tags
+    AnimationUtil::blendTags(tags, weights, numberKeyframes, tag);
+}
+
+inline int ActorNode::getTagIndex(const std::string &tagName) {
+    // in case there is no animation
+    if(!this->animation) {
+        // returns invalid
+        return -1;
+    }
+
+    // iterates over all the tags
+    for(unsigned int index = 0; index < this->animation->numberTags; index++) {
+        // in case the tag name is the requested one
+        if(this->animation->tagNames[index] == tagName) {
+            // returns the index
+            return index;
+        }
+    }
+
+    // returns invalid
+    return -1;
+}
+
+/**
+ * Updates the attached nodes with the tags of the last
+ * decoded animation.
+ * The attached nodes mark their ancestors as dirty, so the
+ * attachments must be updated serially (out of the jobs
+ * advancing the animations).
+ */
+void ActorNode::updateAttachments() {
+    // iterates over all the attachments
+    for(unsigned int index = 0; index < this->attachmentsList.size(); index++) {
+        // updates the attached node
+        this->updateAttachment(this->attachmentsList[index]);
+    }
+}
+
+inline void ActorNode::updateAttachment(ActorAttachment_t &attachment) {
+    // retrieves the attachment tag
+    KeyframeTag_t &tag = attachment.tag;
+
+    // creates the rotation matrix from the tag axis (the
+    // axis are the columns of the matrix)
+    float matrix[3][3] = {
+        { tag.axis[0].x, tag.axis[1].x, tag.axis[2].x },
+        { tag.axis[0].y, tag.axis[1].y, tag.axis[2].y },
+        { tag.axis[0].z, tag.axis[1].z, tag.axis[2].z }
+    };
+
+    // creates the rotation from the rotation matrix
+    Rotation3d_t rotation = MatrixUtil::createRotation(matrix);
+
+    // sets the tag origin and rotation as the (local)
+    // position and rotation of the attached node
+    attachment.node->setPosition(tag.origin);
+    attachment.node->setRotation(rotation);
+}
+
+inline void ActorNode::decodeAnimation() {
+    // allocates the keyframes and the weights
+    const QuantizedKeyframe_t *keyframes[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+    float weights[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+
+    // samples the animation (current and previous clips)
+    unsigned int numberKeyframes = this->sampleAnimation(keyframes, weights);
+
+    // retrieves the next buffer (not used by the render)
+    unsigned int buffer = (this->animationBuffer + 1) % ACTOR_NODE_ANIMATION_BUFFERS;
+    float *vertexBuffer = &this->animationVertexBuffer[buffer * this->animation->numberMeshVertices * 3];
+
+    // in case the keyframes are short quantized
+    if(this->animation->format == QUANTIZED_SHORT) {
+        // decodes all the mesh vertices into the next buffer
+        AnimationUtil::blendShortKeyframes(keyframes, weights, numberKeyframes, this->animation->meshVertexIndexes, this->animation->numberMeshVertices, vertexBuffer);
+    } else {
+        // decodes all the mesh vertices into the next buffer
+        AnimationUtil::blendKeyframes(keyframes, weights, numberKeyframes, this->animation->meshVertexIndexes, this->animation->numberMeshVertices, vertexBuffer);
+    }
+
+    // sets the decoded buffer as the current one
+    this->animationBuffer = buffer;
+
+    // iterates over all the attachments
+    for(unsigned int index = 0; index < this->attachmentsList.size(); index++) {
+        // retrieves the attachment
+        ActorAttachment_t &attachment = this->attachmentsList[index];
+
+        // blends the attachment tag (the attached node
+        // is updated in the attachments update)
+        this->blendTag(keyframes, weights, numberKeyframes, attachment.tagIndex, attachment.tag);
+    }
+}
+
+inline void ActorNode::cleanAnimation() {
+    // in case there is no animation
+    // there is nothing to clean
+    if(!this->animation)
+        return;
+
+    // releases the meshes and the vertex buffer
+    free(this->animationMeshes);
+    free(this->animationVertexBuffer);
+
+    // iterates over all the buffers
+    for(unsigned int buffer = 0; buffer < ACTOR_NODE_ANIMATION_BUFFERS; buffer++) {
+        // clears the buffer mesh list
+        this->animationMeshLists[buffer].clear();
+    }
+
+    // iterates over all the attachments
+    for(unsigned int index = 0; index < this->attachmentsList.size(); index++) {
+        // removes the attached node from the child nodes
+        this->removeChild(this->attachmentsList[index].node);
+    }
+
+    // clears the attachments (the tags are
+    // specific to the animation)
+    this->attachmentsList.clear();
 
+    // resets the animation
+    this->initAnimation();
 }
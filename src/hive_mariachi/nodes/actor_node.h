@@ -29,12 +29,78 @@
 
 #include "model_node.h"
 
+/**
+ * The number of buffers used to decode the animation
+ * meshes (the render stage may still be copying the previous
+ * one into the render snapshot, the render adapter only
+ * draws the copies).
+ */
+#define ACTOR_NODE_ANIMATION_BUFFERS 2
+
+/**
+ * The default duration of the cross fade between
+ * looped clips (in seconds).
+ */
+#define ACTOR_NODE_BLEND_DURATION 0.2f
+
 namespace mariachi {
     namespace nodes {
+        /**
+         * The playback state of an animation clip.
+         *
+         * @param start The index of the first keyframe of the clip.
+         * @param count The number of keyframes of the clip.
+         * @param time The playback time in the clip (in seconds).
+         * @param loop If the clip is played in loop (otherwise it
+         * stops in the last keyframe).
+         */
+        typedef struct ActorClipState_t {
+            unsigned int start;
+            unsigned int count;
+            float time;
+            bool loop;
+        } ActorClipState;
+
+        /**
+         * The attachment of a node to a tag of the
+         * actor animation.
+         *
+         * @param tagIndex The index of the tag in the animation.
+         * @param node The attached node.
+         * @param tag The (blended) tag of the last decoded animation,
+         * set in the attached node in the attachments update.
+         */
+        typedef struct ActorAttachment_t {
+            unsigned int tagIndex;
+            CubeNode *node;
+            structures::KeyframeTag_t tag;
+        } ActorAttachment;
+
         class ActorNode : public ModelNode {
             private:
                 std::vector<structures::Frame_t *> *frameList;
                 unsigned int currentFrame;
+                structures::KeyframeAnimation_t *animation;
+                float animationRate;
+                ActorClipState_t clipState;
+                ActorClipState_t previousClipState;
+                float blendTime;
+                float blendDuration;
+                unsigned int animationBuffer;
+                structures::Mesh_t *animationMeshes;
+                float *animationVertexBuffer;
+                std::vector<structures::Mesh_t *> animationMeshLists[ACTOR_NODE_ANIMATION_BUFFERS];
+                std::vector<ActorAttachment_t> attachmentsList;
+
+                inline void initAnimation();
+                inline void advanceClip(ActorClipState_t &clipState, float delta);
+                inline unsigned int sampleClip(ActorClipState_t &clipState, float weight, const structures::QuantizedKeyframe_t **keyframes, float *weights);
+                inline unsigned int sampleAnimation(const structures::QuantizedKeyframe_t **keyframes, float *weights);
+                inline void blendTag(const structures::QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, unsigned int tagIndex, structures::KeyframeTag_t &tag);
+                inline int getTagIndex(const std::string &tagName);
+                inline void updateAttachment(ActorAttachment_t &attachment);
+                inline void decodeAnimation();
+                inline void cleanAnimation();
 
             public:
                 ActorNode();
@@ -48,7 +114,18 @@ namespace mariachi {
                 std::vector<structures::Frame_t *> *getFrameList();
                 void setFrameList(std::vector<structures::Frame_t *> *frameList);
                 void updateFrame();
+                void updateAnimation(float delta);
+                void advanceAnimation(float delta);
+                void updateAttachments();
+                structures::KeyframeAnimation_t *getAnimation();
+                void setAnimation(structures::KeyframeAnimation_t *animation);
+                float getAnimationRate();
+                void setAnimationRate(float animationRate);
+                bool play(const std::string &animationName, bool loop, float blendDuration);
                 void loop(const std::string &animationName);
+                bool getTag(const std::string &tagName, structures::KeyframeTag_t &tag);
+                bool attach(const std::string &tagName, CubeNode *node);
+                void detach(CubeNode *node);
                 virtual inline unsigned int getNodeType() { return ACTOR_NODE_TYPE; };
         };
     }
@@ -25,8 +25,11 @@
 
 #include "stdafx.h"
 
+#include "../util/matrix_util.h"
+
 #include "cube_node.h"
 
+using namespace mariachi::util;
 using namespace mariachi::nodes;
 using namespace mariachi::structures;
 
@@ -47,6 +50,11 @@ CubeNode::CubeNode(const std::string &name) : Node(name) {
  * Destructor of the class.
  */
 CubeNode::~CubeNode() {
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // releases the transform handle
+        this->transformStore->releaseHandle(this->transformHandle);
+    }
 }
 
 inline void CubeNode::initTransforms() {
@@ -67,34 +75,71 @@ inline void CubeNode::initTransforms() {
 
     // initializes the node's scale
     this->scale = initialScale;
+
+    // initializes the node's (world) transform
+    this->transform = MatrixUtil::IDENTITY_MATRIX;
+
+    // unsets the transform store (local transform)
+    this->transformStore = NULL;
+    this->transformHandle = TRANSFORM_STORE_INVALID_HANDLE;
 }
 
-Coordinate3d_t &CubeNode::getPosition() {
+Coordinate3d_t CubeNode::getPosition() {
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // returns the position from the transform store
+        return this->transformStore->getPosition(this->transformHandle);
+    }
+
     return this->position;
 }
 
 void CubeNode::setPosition(Coordinate3d_t &position) {
-    this->position = position;
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // sets the position in the transform store
+        this->transformStore->setPosition(this->transformHandle, position);
+    } else {
+        // sets the position in the node
+        this->position = position;
+    }
+
+    this->setTransformDirty();
 }
 
 void CubeNode::setPosition(float x, float y, float z) {
     Coordinate3d_t position = {x, y, z};
 
-    this->position = position;
+    this->setPosition(position);
 }
 
-Rotation3d_t &CubeNode::getRotation() {
+Rotation3d_t CubeNode::getRotation() {
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // returns the rotation from the transform store
+        return this->transformStore->getRotation(this->transformHandle);
+    }
+
     return this->rotation;
 }
 
 void CubeNode::setRotation(Rotation3d_t &rotation) {
-    this->rotation = rotation;
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // sets the rotation in the transform store
+        this->transformStore->setRotation(this->transformHandle, rotation);
+    } else {
+        // sets the rotation in the node
+        this->rotation = rotation;
+    }
+
+    this->setTransformDirty();
 }
 
 void CubeNode::setRotation(float angle, float x, float y, float z) {
     Rotation3d_t rotation = {angle, x, y, z};
 
-    this->rotation = rotation;
+    this->setRotation(rotation);
 }
 
 /**
@@ -152,16 +197,134 @@ void CubeNode::setRotation(float xAxisDegrees, float yAxisDegrees, float zAxisDe
     this->setRotation(angleDegrees, x, y, z);
 }
 
-Coordinate3d_t &CubeNode::getScale() {
+Coordinate3d_t CubeNode::getScale() {
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // returns the scale from the transform store
+        return this->transformStore->getScale(this->transformHandle);
+    }
+
     return this->scale;
 }
 
 void CubeNode::setScale(Coordinate3d_t &scale) {
-    this->scale = scale;
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // sets the scale in the transform store
+        this->transformStore->setScale(this->transformHandle, scale);
+    } else {
+        // sets the scale in the node
+        this->scale = scale;
+    }
+
+    this->setTransformDirty();
 }
 
 void CubeNode::setScale(float scaleX, float scaleY, float scaleZ) {
     Coordinate3d_t scale = {scaleX, scaleY, scaleZ};
 
-    this->scale = scale;
+    this->setScale(scale);
+}
+
+/**
+ * Retrieves the (world) transform of the node, the transform
+ * is only valid after the transforms update of the scene.
+ *
+ * @return The (world) transform of the node.
+ */
+Matrix4d_t &CubeNode::getTransform() {
+    return this->transform;
+}
+
+TransformStore *CubeNode::getTransformStore() {
+    return this->transformStore;
+}
+
+/**
+ * Sets the transform store used to keep the node's position,
+ * rotation and scale, in case the store is full the transform
+ * is kept in the node.
+ * While the transform is in the store the node keeps no copy
+ * of it, the components may be written by handle (the store
+ * marks the node as dirty in its transforms update).
+ *
+ * @param transformStore The transform store to be used or null
+ * to keep the transform in the node.
+ */
+void CubeNode::setTransformStore(TransformStore *transformStore) {
+    // in case the transform is in a transform store
+    if(this->transformStore) {
+        // copies the transform components back into the node
+        this->position = this->transformStore->getPosition(this->transformHandle);
+        this->rotation = this->transformStore->getRotation(this->transformHandle);
+        this->scale = this->transformStore->getScale(this->transformHandle);
+
+        // releases the transform handle
+        this->transformStore->releaseHandle(this->transformHandle);
+
+        // unsets the transform store
+        this->transformStore = NULL;
+        this->transformHandle = TRANSFORM_STORE_INVALID_HANDLE;
+    }
+
+    // in case the transform store is not set
+    if(!transformStore) {
+        // returns immediately
+        return;
+    }
+
+    // creates the transform handle (of the node) in the store
+    this->transformHandle = transformStore->createHandle(this);
+
+    // in case the handle is not valid (full store)
+    if(this->transformHandle == TRANSFORM_STORE_INVALID_HANDLE) {
+        // returns immediately (local transform)
+        return;
+    }
+
+    // sets the transform store
+    this->transformStore = transformStore;
+
+    // copies the transform components into the store
+    this->transformStore->setPosition(this->transformHandle, this->position);
+    this->transformStore->setRotation(this->transformHandle, this->rotation);
+    this->transformStore->setScale(this->transformHandle, this->scale);
+}
+
+/**
+ * Retrieves the handle of the node transform in the transform
+ * store, used to write the transform components directly in
+ * the store.
+ *
+ * @return The handle of the node transform (invalid in case
+ * the transform is kept in the node).
+ */
+unsigned int CubeNode::getTransformHandle() {
+    return this->transformHandle;
+}
+
+/**
+ * Updates the (world) transform of the node, composing the
+ * parent transform with the local position, rotation and scale.
+ *
+ * @param parentTransform The (world) transform of the parent node.
+ * @param changed If the transform must be recomputed.
+ * @return The (world) transform of the node.
+ */
+const Matrix4d_t &CubeNode::updateTransform(const Matrix4d_t &parentTransform, bool changed) {
+    // in case the transform changed and is in a transform store
+    if(changed && this->transformStore) {
+        // composes the (stored) local transform with the
+        // parent transform
+        this->transform = MatrixUtil::multiply(parentTransform, this->transformStore->getTransform(this->transformHandle));
+    }
+    // in case the transform changed
+    else if(changed) {
+        // creates the local transform and composes it with
+        // the parent transform
+        this->transform = MatrixUtil::multiply(parentTransform, MatrixUtil::createTransform(this->position, this->rotation, this->scale));
+    }
+
+    // returns the transform
+    return this->transform;
 }
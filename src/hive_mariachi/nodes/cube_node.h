@@ -26,7 +26,9 @@
 #pragma once
 
 #include "../structures/position.h"
+#include "../structures/matrix.h"
 #include "../structures/rotation.h"
+#include "../structures/transform_store.h"
 
 #include "node.h"
 
@@ -37,22 +39,32 @@ namespace mariachi {
                 structures::Coordinate3d_t position;
                 structures::Rotation3d_t rotation;
                 structures::Coordinate3d_t scale;
+                structures::Matrix4d_t transform;
+                structures::TransformStore *transformStore;
+                unsigned int transformHandle;
+
+            protected:
+                const structures::Matrix4d_t &updateTransform(const structures::Matrix4d_t &parentTransform, bool changed);
 
             public:
                 CubeNode();
                 CubeNode(const std::string &name);
                 ~CubeNode();
                 inline void initTransforms();
-                structures::Coordinate3d_t &getPosition();
+                structures::Coordinate3d_t getPosition();
                 void setPosition(structures::Coordinate3d_t &position);
                 void setPosition(float x, float y, float z);
-                structures::Rotation3d_t &getRotation();
+                structures::Rotation3d_t getRotation();
                 void setRotation(structures::Rotation3d_t &rotation);
                 void setRotation(float angle, float x, float y, float z);
                 void setRotation(float xAxisDegrees, float yAxisDegrees, float zAxisDegrees);
-                structures::Coordinate3d_t &getScale();
+                structures::Coordinate3d_t getScale();
                 void setScale(structures::Coordinate3d_t &scale);
                 void setScale(float scaleX, float scaleY, float scaleZ);
+                structures::Matrix4d_t &getTransform();
+                structures::TransformStore *getTransformStore();
+                void setTransformStore(structures::TransformStore *transformStore);
+                unsigned int getTransformHandle();
                 virtual inline unsigned int getNodeType() { return CUBE_NODE_TYPE; };
         };
     }
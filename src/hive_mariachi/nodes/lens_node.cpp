@@ -33,9 +33,11 @@ using namespace mariachi::nodes;
  * Constructor of the class.
  */
 LensNode::LensNode() : CubeNode() {
+    this->initLens();
 }
 
 LensNode::LensNode(const std::string &name) : CubeNode(name) {
+    this->initLens();
 }
 
 /**
@@ -43,3 +45,63 @@ LensNode::LensNode(const std::string &name) : CubeNode(name) {
  */
 LensNode::~LensNode() {
 }
+
+inline void LensNode::initLens() {
+    this->fieldOfView = DEFAULT_LENS_FIELD_OF_VIEW;
+    this->nearDistance = DEFAULT_LENS_NEAR_DISTANCE;
+    this->farDistance = DEFAULT_LENS_FAR_DISTANCE;
+}
+
+/**
+ * Retrieves the (vertical) field of view of the lens.
+ *
+ * @return The field of view of the lens (in degrees).
+ */
+float LensNode::getFieldOfView() {
+    return this->fieldOfView;
+}
+
+/**
+ * Sets the (vertical) field of view of the lens.
+ *
+ * @param fieldOfView The field of view of the lens (in degrees).
+ */
+void LensNode::setFieldOfView(float fieldOfView) {
+    this->fieldOfView = fieldOfView;
+}
+
+/**
+ * Retrieves the distance to the near plane of the lens.
+ *
+ * @return The distance to the near plane of the lens.
+ */
+float LensNode::getNearDistance() {
+    return this->nearDistance;
+}
+
+/**
+ * Sets the distance to the near plane of the lens.
+ *
+ * @param nearDistance The distance to the near plane of the lens.
+ */
+void LensNode::setNearDistance(float nearDistance) {
+    this->nearDistance = nearDistance;
+}
+
+/**
+ * Retrieves the distance to the far plane of the lens.
+ *
+ * @return The distance to the far plane of the lens.
+ */
+float LensNode::getFarDistance() {
+    return this->farDistance;
+}
+
+/**
+ * Sets the distance to the far plane of the lens.
+ *
+ * @param farDistance The distance to the far plane of the lens.
+ */
+void LensNode::setFarDistance(float farDistance) {
+    this->farDistance = farDistance;
+}
@@ -27,15 +27,44 @@
 
 #include "cube_node.h"
 
+/**
+ * The default (vertical) field of view of
+ * the lens (in degrees).
+ */
+#define DEFAULT_LENS_FIELD_OF_VIEW 45.0f
+
+/**
+ * The default distance to the near plane
+ * of the lens.
+ */
+#define DEFAULT_LENS_NEAR_DISTANCE 0.3f
+
+/**
+ * The default distance to the far plane
+ * of the lens.
+ */
+#define DEFAULT_LENS_FAR_DISTANCE 1000.0f
+
 namespace mariachi {
     namespace nodes {
         class LensNode : public CubeNode {
             private:
+                float fieldOfView;
+                float nearDistance;
+                float farDistance;
+
+                inline void initLens();
 
             public:
                 LensNode();
                 LensNode(const std::string &name);
                 ~LensNode();
+                float getFieldOfView();
+                void setFieldOfView(float fieldOfView);
+                float getNearDistance();
+                void setNearDistance(float nearDistance);
+                float getFarDistance();
+                void setFarDistance(float farDistance);
                 virtual inline unsigned int getNodeType() { return LENS_NODE_TYPE; };
         };
     }
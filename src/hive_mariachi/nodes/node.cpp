@@ -25,21 +25,28 @@
 
 #include "stdafx.h"
 
+#include "../util/matrix_util.h"
+
 #include "node.h"
 
+using namespace mariachi::util;
 using namespace mariachi::nodes;
+using namespace mariachi::structures;
+
+RWLOCK_HANDLE Node::sceneLockHandle = RWLOCK_INITIALIZER;
+ATOMIC_VALUE Node::sceneVersion = 0;
 
 /**
  * Constructor of the class.
  */
 Node::Node() {
-    this->initChildrenListMutex();
     this->initRenderable();
+    this->initTransformDirty();
 }
 
 Node::Node(const std::string &name) {
-    this->initChildrenListMutex();
     this->initRenderable();
+    this->initTransformDirty();
     this->name = name;
 }
 
@@ -47,19 +54,18 @@ Node::Node(const std::string &name) {
  * Destructor of the class.
  */
 Node::~Node() {
-    // closes the children list mutex
-    MUTEX_CLOSE(this->childrenListMutexHandle);
-}
-
-inline void Node::initChildrenListMutex() {
-    // creates the children list mutex
-    MUTEX_CREATE(this->childrenListMutexHandle);
 }
 
 inline void Node::initRenderable() {
     this->renderable = false;
 }
 
+inline void Node::initTransformDirty() {
+    this->parent = NULL;
+    this->transformDirty = true;
+    this->childrenTransformDirty = false;
+}
+
 Node *Node::getParent() {
     return this->parent;
 }
@@ -78,23 +84,20 @@ void Node::reparentTo(Node *parent) {
  * @param child The child node to be added.
  */
 void Node::addChild(Node *child) {
-    // locks the children list mutex
-    MUTEX_LOCK(childrenListMutexHandle);
+    // locks the scene for writing
+    RWLOCK_WRITE_LOCK(Node::sceneLockHandle);
 
-    // adds the child node to the children list
-    this->childrenList.push_back(child);
+    // adds the child node (unsafe)
+    this->_addChild(child);
 
-    // sets the child node parent
-    child->setParent(this);
-
-    // unlocks the children list mutex
-    MUTEX_UNLOCK(childrenListMutexHandle);
+    // unlocks the scene
+    RWLOCK_WRITE_UNLOCK(Node::sceneLockHandle);
 }
 
 /**
  * Adds a child node to the current node.
- * This operation is unsafe as it does not use the access
- * mutex to write the list. Use this method carrefully.
+ * This operation is unsafe as it does not use the scene
+ * lock to write the list. Use this method carrefully.
  *
  * @param child The child node to be added.
  */
@@ -104,6 +107,12 @@ void Node::_addChild(Node *child) {
 
     // sets the child node parent
     child->setParent(this);
+
+    // sets the child node transform as dirty (new parent)
+    child->setTransformDirty();
+
+    // increments the scene version (structural change)
+    Node::incrementSceneVersion();
 }
 
 /**
@@ -112,8 +121,8 @@ void Node::_addChild(Node *child) {
  * @param _childrenList The list of children nodes to be added.
  */
 void Node::addChildren(std::vector<Node *> &_childrenList) {
-    // locks the children list mutex
-    MUTEX_LOCK(childrenListMutexHandle);
+    // locks the scene for writing
+    RWLOCK_WRITE_LOCK(Node::sceneLockHandle);
 
     // retrieves the children list iterator
     std::vector<Node *>::iterator childrenListIterator = _childrenList.begin();
@@ -129,37 +138,40 @@ void Node::addChildren(std::vector<Node *> &_childrenList) {
         // sets the child node parent
         child->setParent(this);
 
+        // sets the child node transform as dirty (new parent)
+        child->setTransformDirty();
+
         // increments the children list iterator
         childrenListIterator++;
     }
 
-    // unlocks the children list mutex
-    MUTEX_UNLOCK(childrenListMutexHandle);
+    // increments the scene version (structural change)
+    Node::incrementSceneVersion();
+
+    // unlocks the scene
+    RWLOCK_WRITE_UNLOCK(Node::sceneLockHandle);
 }
 
 /**
  * Removes a child node from the current node.
- * This operation is unsafe as it does not use the access
- * mutex to write the list. Use this method carrefully.
  *
  * @param child The child node to be removed.
  */
 void Node::removeChild(Node *child) {
-    // locks the children list mutex
-    MUTEX_LOCK(childrenListMutexHandle);
-
-    // removes the child node from the children list
-    this->childrenList.remove(child);
+    // locks the scene for writing
+    RWLOCK_WRITE_LOCK(Node::sceneLockHandle);
 
-    // resets the child node parent
-    child->setParent(NULL);
+    // removes the child node (unsafe)
+    this->_removeChild(child);
 
-    // unlocks the children list mutex
-    MUTEX_UNLOCK(childrenListMutexHandle);
+    // unlocks the scene
+    RWLOCK_WRITE_UNLOCK(Node::sceneLockHandle);
 }
 
 /**
  * Removes a child node from the current node.
+ * This operation is unsafe as it does not use the scene
+ * lock to write the list. Use this method carrefully.
  *
  * @param child The child node to be removed.
  */
@@ -169,6 +181,9 @@ void Node::_removeChild(Node *child) {
 
     // resets the child node parent
     child->setParent(NULL);
+
+    // increments the scene version (structural change)
+    Node::incrementSceneVersion();
 }
 
 /**
@@ -177,8 +192,8 @@ void Node::_removeChild(Node *child) {
  * @param _childrenList The list of children nodes to be removed.
  */
 void Node::removeChildren(std::vector<Node *> &_childrenList) {
-    // locks the children list mutex
-    MUTEX_LOCK(childrenListMutexHandle);
+    // locks the scene for writing
+    RWLOCK_WRITE_LOCK(Node::sceneLockHandle);
 
     // retrieves the children list iterator
     std::vector<Node *>::iterator childrenListIterator = _childrenList.begin();
@@ -198,19 +213,22 @@ void Node::removeChildren(std::vector<Node *> &_childrenList) {
         childrenListIterator++;
     }
 
-    // unlocks the children list mutex
-    MUTEX_UNLOCK(childrenListMutexHandle);
+    // increments the scene version (structural change)
+    Node::incrementSceneVersion();
+
+    // unlocks the scene
+    RWLOCK_WRITE_UNLOCK(Node::sceneLockHandle);
 }
 
 bool Node::isRenderable() {
     return this->renderable;
 }
 
-std::list<Node *> &Node::getChildrenList() {
+NodeList &Node::getChildrenList() {
     return this->childrenList;
 }
 
-void Node::setChildrenList(std::list<Node *> &childrenList) {
+void Node::setChildrenList(NodeList &childrenList) {
     this->childrenList = childrenList;
 }
 
@@ -219,7 +237,130 @@ bool Node::getRenderable() {
 }
 
 void Node::setRenderable(bool renderable) {
+    // in case the renderable flag is not changed
+    if(this->renderable == renderable) {
+        // returns immediately
+        return;
+    }
+
+    // sets the renderable flag
     this->renderable = renderable;
+
+    // increments the scene version (renderable set changed)
+    Node::incrementSceneVersion();
+}
+
+bool Node::isTransformDirty() {
+    return this->transformDirty;
+}
+
+/**
+ * Sets the transform of the node as dirty, the ancestor nodes
+ * are marked so that the next transforms update visits the node.
+ */
+void Node::setTransformDirty() {
+    // sets the transform dirty flag
+    this->transformDirty = true;
+
+    // retrieves the parent node
+    Node *parent = this->parent;
+
+    // iterates while the parent is not yet marked
+    while(parent && !parent->childrenTransformDirty) {
+        // sets the children transform dirty flag
+        parent->childrenTransformDirty = true;
+
+        // retrieves the next parent node
+        parent = parent->parent;
+    }
+}
+
+/**
+ * Updates the (world) transforms of the node and its descendants,
+ * only the changed subtrees are visited (in a single pass).
+ * Must be called in the root node of the scene.
+ */
+void Node::updateTransforms() {
+    // locks the scene for reading (once for the whole traversal)
+    Node::lockScene();
+
+    // updates the transforms starting with the identity transform
+    this->updateTransforms(MatrixUtil::IDENTITY_MATRIX, false);
+
+    // unlocks the scene
+    Node::unlockScene();
+}
+
+/**
+ * Updates the transforms of the node and of the dirty descendant
+ * nodes, in case the parent transform changed all the descendant
+ * transforms are recomputed.
+ *
+ * @param parentTransform The (world) transform of the parent node.
+ * @param parentChanged If the parent transform was changed.
+ */
+void Node::updateTransforms(const Matrix4d_t &parentTransform, bool parentChanged) {
+    // the transform changed in case it's dirty or the
+    // parent transform changed
+    bool changed = parentChanged || this->transformDirty;
+
+    // in case the transform did not change and there are
+    // no dirty descendants
+    if(!changed && !this->childrenTransformDirty) {
+        // returns immediately (clean subtree)
+        return;
+    }
+
+    // updates the transform (in case it changed), the returned
+    // transform is the one to be used by the children
+    const Matrix4d_t &transform = this->updateTransform(parentTransform, changed);
+
+    // unsets the dirty flags
+    this->transformDirty = false;
+    this->childrenTransformDirty = false;
+
+    // in case the node has no children (leaf node)
+    if(this->childrenList.empty()) {
+        // returns immediately
+        return;
+    }
+
+    // iterates over all the child nodes
+    for(unsigned int index = 0; index < this->childrenList.size(); index++) {
+        // updates the child node transforms
+        this->childrenList[index]->updateTransforms(transform, changed);
+    }
+}
+
+/**
+ * Updates the (world) transform of the node for the given
+ * parent transform, the base node has no transform.
+ *
+ * @param parentTransform The (world) transform of the parent node.
+ * @param changed If the transform must be recomputed.
+ * @return The (world) transform to be used by the children.
+ */
+const Matrix4d_t &Node::updateTransform(const Matrix4d_t &parentTransform, bool changed) {
+    return parentTransform;
+}
+
+/**
+ * Retrieves the current version of the structure of the scenes,
+ * the version changes with every structural change (children or
+ * renderable flags) and may be used to invalidate caches.
+ *
+ * @return The current version of the structure of the scenes.
+ */
+unsigned long Node::getSceneVersion() {
+    return Node::sceneVersion;
+}
+
+/**
+ * Increments the version of the structure of the scenes, must
+ * be called after every structural change.
+ */
+void Node::incrementSceneVersion() {
+    ATOMIC_INCREMENT(Node::sceneVersion);
 }
 
 Node *Node::duplicate() {
@@ -26,6 +26,15 @@
 #pragma once
 
 #include "../system/thread.h"
+#include "../structures/matrix.h"
+#include "../structures/small_vector.h"
+#include "../debugging/profiler.h"
+
+/**
+ * The number of children stored inline in
+ * the node (without heap allocation).
+ */
+#define NODE_CHILDREN_INLINE_CAPACITY 4
 
 namespace mariachi {
     namespace nodes {
@@ -43,6 +52,14 @@ namespace mariachi {
             COLLISION_NODE_TYPE
         } BasicNodesType;
 
+        class Node;
+
+        /**
+         * The list of (children) nodes, the first nodes
+         * are stored inline.
+         */
+        typedef structures::SmallVector<Node *, NODE_CHILDREN_INLINE_CAPACITY> NodeList;
+
         class Node {
             private:
                 /**
@@ -54,16 +71,39 @@ namespace mariachi {
                  * The list containing the children elements
                  * of the node.
                  */
-                std::list<Node *> childrenList;
+                NodeList childrenList;
+
+                /**
+                 * The read write lock used in the access to the
+                 * structure of the scenes (children lists), the
+                 * traversals lock it once for reading.
+                 */
+                static RWLOCK_HANDLE sceneLockHandle;
+
+                /**
+                 * The version of the structure of the scenes,
+                 * changed in every structural change.
+                 */
+                static ATOMIC_VALUE sceneVersion;
 
                 /**
-                 * The handle to the  mutex used in the
-                 * access to the children list.
+                 * Flag that controls if the transform of the
+                 * node must be recomputed.
                  */
-                MUTEX_HANDLE childrenListMutexHandle;
+                bool transformDirty;
+
+                /**
+                 * Flag that controls if the transform of any of
+                 * the descendant nodes must be recomputed.
+                 */
+                bool childrenTransformDirty;
 
-                inline void initChildrenListMutex();
                 inline void initRenderable();
+                inline void initTransformDirty();
+                void updateTransforms(const structures::Matrix4d_t &parentTransform, bool parentChanged);
+
+            protected:
+                virtual const structures::Matrix4d_t &updateTransform(const structures::Matrix4d_t &parentTransform, bool changed);
 
             public:
                 /**
@@ -90,27 +130,35 @@ namespace mariachi {
                 void _removeChild(Node *child);
                 void removeChildren(std::vector<Node *> &_childrenList);
                 bool isRenderable();
-                std::list<Node *> &getChildrenList();
-                void setChildrenList(std::list<Node *> &childrenList);
+                NodeList &getChildrenList();
+                void setChildrenList(NodeList &childrenList);
                 bool getRenderable();
                 void setRenderable(bool renderable);
+                bool isTransformDirty();
+                void setTransformDirty();
+                void updateTransforms();
                 virtual Node *duplicate();
                 virtual inline unsigned int getNodeType() { return NODE_TYPE; };
 
+                static unsigned long getSceneVersion();
+                static void incrementSceneVersion();
+
                 /**
-                 * Locks the node access to the children list.
+                 * Locks the structure of the scenes for reading, the
+                 * children lists may be traversed (by multiple threads)
+                 * until the scene is unlocked.
                  */
-                inline void lock() {
-                    // locks the children list mutex
-                    MUTEX_LOCK(childrenListMutexHandle);
+                static inline void lockScene() {
+                    // locks the scene for reading (profiling the wait)
+                    debugging::Profiler::lockRead(Node::sceneLockHandle, debugging::NODE_LOCK_TIMER_ID);
                 }
 
                 /**
-                 * Unlocks the node access to the children list.
+                 * Unlocks the structure of the scenes.
                  */
-                inline void unlock() {
-                    // unlock the children list mutex
-                    MUTEX_UNLOCK(childrenListMutexHandle);
+                static inline void unlockScene() {
+                    // unlocks the scene
+                    RWLOCK_READ_UNLOCK(Node::sceneLockHandle);
                 }
         };
     }
@@ -45,6 +45,7 @@ SquareNode::~SquareNode() {
 
 inline void SquareNode::initPositionReference() {
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
     this->positionReference = TOP_LEFT_REFERENCE_POSITION;
 }
 
@@ -76,6 +77,54 @@ Coordinate2d_t &SquareNode::getTopLeftPosition() {
     return this->topLeftPosition;
 }
 
+/**
+ * Retrieves the real (window) box of the node for the given
+ * window ratios, the box is cached and only recomputed when
+ * the node or the ratios change.
+ *
+ * @param widthRatio The ratio between the window width and the
+ * reference width.
+ * @param heightRatio The ratio between the window height and the
+ * reference height.
+ * @return The real (window) box of the node.
+ */
+Box2d_t &SquareNode::getRealBox(float widthRatio, float heightRatio) {
+    // in case the real box is not dirty and the ratios are the same
+    if(!this->realBoxDirty && this->realBoxWidthRatio == widthRatio && this->realBoxHeightRatio == heightRatio) {
+        // returns the real box
+        return this->realBox;
+    }
+
+    // switches over the position reference
+    switch(this->positionReference) {
+        case TOP_LEFT_REFERENCE_POSITION:
+            this->realBox.x1 = this->position.x * widthRatio;
+            this->realBox.y1 = this->position.y * heightRatio;
+
+            break;
+
+        case CENTER_REFERENCE_POSITION:
+            this->realBox.x1 = this->position.x * widthRatio - this->size.width / 2.0f;
+            this->realBox.y1 = this->position.y * heightRatio - this->size.height / 2.0f;
+
+            break;
+    }
+
+    // sets the real box end (scaling the size)
+    this->realBox.x2 = this->realBox.x1 + this->size.width * widthRatio;
+    this->realBox.y2 = this->realBox.y1 + this->size.height * heightRatio;
+
+    // sets the ratios of the real box
+    this->realBoxWidthRatio = widthRatio;
+    this->realBoxHeightRatio = heightRatio;
+
+    // unsets the real box dirty flag
+    this->realBoxDirty = false;
+
+    // returns the real box
+    return this->realBox;
+}
+
 Coordinate2d_t &SquareNode::getPosition() {
     return this->position;
 }
@@ -83,6 +132,7 @@ Coordinate2d_t &SquareNode::getPosition() {
 void SquareNode::setPosition(Coordinate2d_t &position) {
     this->position = position;
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
 }
 
 void SquareNode::setPosition(float x, float y) {
@@ -90,6 +140,7 @@ void SquareNode::setPosition(float x, float y) {
 
     this->position = position;
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
 }
 
 FloatSize2d_t &SquareNode::getSize() {
@@ -99,6 +150,7 @@ FloatSize2d_t &SquareNode::getSize() {
 void SquareNode::setSize(FloatSize2d_t &size) {
     this->size = size;
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
 }
 
 void SquareNode::setSize(float width, float height) {
@@ -106,6 +158,7 @@ void SquareNode::setSize(float width, float height) {
 
     this->size = size;
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
 }
 
 PositionReferenceType_t SquareNode::getPositionReference() {
@@ -115,4 +168,5 @@ PositionReferenceType_t SquareNode::getPositionReference() {
 void SquareNode::setPositionReference(PositionReferenceType_t positionReference) {
     this->positionReference = positionReference;
     this->topLeftPositionDirty = true;
+    this->realBoxDirty = true;
 }
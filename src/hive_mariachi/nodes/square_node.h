@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "../structures/box.h"
 #include "../structures/size.h"
 #include "../structures/position.h"
 
@@ -44,6 +45,10 @@ namespace mariachi {
                 structures::FloatSize2d_t size;
                 structures::Coordinate2d_t topLeftPosition;
                 bool topLeftPositionDirty;
+                structures::Box2d_t realBox;
+                float realBoxWidthRatio;
+                float realBoxHeightRatio;
+                bool realBoxDirty;
                 PositionReferenceType_t positionReference;
 
                 inline void initPositionReference();
@@ -53,6 +58,7 @@ namespace mariachi {
                 SquareNode(const std::string &name);
                 ~SquareNode();
                 structures::Coordinate2d_t &getTopLeftPosition();
+                structures::Box2d_t &getRealBox(float widthRatio, float heightRatio);
                 structures::Coordinate2d_t &getPosition();
                 void setPosition(structures::Coordinate2d_t &position);
                 void setPosition(float x, float y);
@@ -286,8 +286,9 @@ btRigidBody *BulletPhysicsEngine::getRigidBody(PhysicalNode *physicalNode, Colli
 
     // in case a collision node is defined
     if(collisionNode) {
-        // retrieves the bullet physics collision solid
-        BulletPhysicsEngineCollisionSolid *bulletPhysicsEngineCollisionSolid = (BulletPhysicsEngineCollisionSolid *) collisionNode->getCollisionSolid();
+        // retrieves the bullet physics collision solid (the collision
+        // solid may be a sibling base of the bullet collision solid)
+        BulletPhysicsEngineCollisionSolid *bulletPhysicsEngineCollisionSolid = dynamic_cast<BulletPhysicsEngineCollisionSolid *>(collisionNode->getCollisionSolid());
 
         // retrieves the bullet collision shape
         collisionShape = (btCollisionShape *) bulletPhysicsEngineCollisionSolid->getCollisionShape();
@@ -297,7 +298,7 @@ btRigidBody *BulletPhysicsEngine::getRigidBody(PhysicalNode *physicalNode, Colli
     }
 
     // retrieves the physical node position
-    Coordinate3d_t &physicalNodePosition = physicalNode->getPosition();
+    Coordinate3d_t physicalNodePosition = physicalNode->getPosition();
 
     // converts the physical node position
     btVector3 physicalNodePositionVector(physicalNodePosition.x, physicalNodePosition.y, physicalNodePosition.z);
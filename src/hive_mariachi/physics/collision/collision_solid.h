@@ -32,7 +32,7 @@ namespace mariachi {
 
             public:
                 CollisionSolid();
-                ~CollisionSolid();
+                virtual ~CollisionSolid();
         };
     }
 }
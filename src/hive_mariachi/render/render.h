@@ -25,4 +25,6 @@
 
 #pragma once
 
+#include "render_queue.h"
+#include "render_snapshot.h"
 #include "render_information.h"
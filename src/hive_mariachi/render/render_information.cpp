@@ -34,8 +34,19 @@ using namespace mariachi::render;
  * Constructor of the class.
  */
 RenderInformation::RenderInformation() {
+    // unsets the render references
+    this->render = NULL;
+    this->render2d = NULL;
+    this->activeCamera = NULL;
+
+    // sets the default aspect ratio
+    this->aspectRatio = DEFAULT_ASPECT_RATIO;
+
     // creates the mutex
     MUTEX_CREATE(this->mutex);
+
+    // creates the snapshots
+    this->initSnapshots();
 }
 
 /**
@@ -44,6 +55,21 @@ RenderInformation::RenderInformation() {
 RenderInformation::~RenderInformation() {
     // closes the mutex handle
     MUTEX_CLOSE(this->mutex);
+
+    // deletes the snapshots
+    delete this->backSnapshot;
+    delete this->readySnapshot;
+    delete this->frontSnapshot;
+}
+
+inline void RenderInformation::initSnapshots() {
+    // creates the back, ready and front snapshots
+    this->backSnapshot = new RenderSnapshot();
+    this->readySnapshot = new RenderSnapshot();
+    this->frontSnapshot = new RenderSnapshot();
+
+    // unsets the ready flag
+    this->readyFlag = false;
 }
 
 SceneNode *RenderInformation::getRender() {
@@ -78,3 +104,73 @@ MUTEX_HANDLE RenderInformation::getMutex() {
 void RenderInformation::setMutex(MUTEX_HANDLE mutex) {
     this->mutex = mutex;
 }
+
+/**
+ * Retrieves the back snapshot, to be built by the render
+ * stage (owned by the producer, no mutex required).
+ *
+ * @return The back snapshot.
+ */
+RenderSnapshot *RenderInformation::getBackSnapshot() {
+    return this->backSnapshot;
+}
+
+/**
+ * Publishes the back snapshot, making it ready to be
+ * acquired by the render adapter.
+ * Must be called with the mutex locked.
+ */
+void RenderInformation::publishSnapshot() {
+    // swaps the back snapshot with the ready snapshot
+    RenderSnapshot *snapshot = this->readySnapshot;
+    this->readySnapshot = this->backSnapshot;
+    this->backSnapshot = snapshot;
+
+    // sets the ready flag
+    this->readyFlag = true;
+}
+
+/**
+ * Acquires the most recent published snapshot, in case no
+ * new snapshot was published the current front snapshot
+ * is returned (drawn again).
+ * Must be called with the mutex locked.
+ *
+ * @return The front snapshot (owned by the consumer).
+ */
+RenderSnapshot *RenderInformation::acquireSnapshot() {
+    // in case a new snapshot is ready
+    if(this->readyFlag) {
+        // swaps the ready snapshot with the front snapshot
+        RenderSnapshot *snapshot = this->frontSnapshot;
+        this->frontSnapshot = this->readySnapshot;
+        this->readySnapshot = snapshot;
+
+        // unsets the ready flag
+        this->readyFlag = false;
+    }
+
+    // returns the front snapshot
+    return this->frontSnapshot;
+}
+
+/**
+ * Retrieves the aspect ratio of the view port, set
+ * by the render adapter.
+ * Must be called with the mutex locked.
+ *
+ * @return The aspect ratio of the view port.
+ */
+float RenderInformation::getAspectRatio() {
+    return this->aspectRatio;
+}
+
+/**
+ * Sets the aspect ratio of the view port.
+ * Must be called with the mutex locked.
+ *
+ * @param aspectRatio The aspect ratio of the view port.
+ */
+void RenderInformation::setAspectRatio(float aspectRatio) {
+    this->aspectRatio = aspectRatio;
+}
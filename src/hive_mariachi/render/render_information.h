@@ -28,15 +28,37 @@
 #include "../structures/structures.h"
 #include "../system/thread.h"
 #include "../nodes/nodes.h"
+#include "render_snapshot.h"
+
+/**
+ * The default aspect ratio of the view port
+ * (before it's set by the render adapter).
+ */
+#define DEFAULT_ASPECT_RATIO 1.333333f
 
 namespace mariachi {
     namespace render {
+        /**
+         * The information shared between the render stage and
+         * the render adapter (protected by the mutex).
+         * The render snapshots are buffered, the render stage builds
+         * the back snapshot while the render adapter draws the front
+         * one, only the (ready) snapshot pointers are swapped under
+         * the mutex.
+         */
         class RenderInformation {
             private:
                 MUTEX_HANDLE mutex;
                 nodes::SceneNode *render;
                 nodes::Scene2dNode *render2d;
                 nodes::CameraNode *activeCamera;
+                RenderSnapshot *backSnapshot;
+                RenderSnapshot *readySnapshot;
+                RenderSnapshot *frontSnapshot;
+                bool readyFlag;
+                float aspectRatio;
+
+                inline void initSnapshots();
 
             public:
                 RenderInformation();
@@ -49,6 +71,11 @@ namespace mariachi {
                 void setActiveCamera(nodes::CameraNode *activeCamera);
                 MUTEX_HANDLE getMutex();
                 void setMutex(MUTEX_HANDLE mutex);
+                RenderSnapshot *getBackSnapshot();
+                void publishSnapshot();
+                RenderSnapshot *acquireSnapshot();
+                float getAspectRatio();
+                void setAspectRatio(float aspectRatio);
         };
     }
 }
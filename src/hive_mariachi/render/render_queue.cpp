@@ -0,0 +1,169 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "render_queue.h"
+
+using namespace mariachi::render;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+RenderQueue::RenderQueue() {
+}
+
+/**
+ * Destructor of the class.
+ */
+RenderQueue::~RenderQueue() {
+}
+
+/**
+ * Clears the render queue, removing all the entries
+ * (the memory is kept for reuse).
+ */
+void RenderQueue::clear() {
+    this->entriesList.clear();
+}
+
+/**
+ * Adds an entry to the render queue.
+ *
+ * @param sortKey The sort key of the entry.
+ * @param index The index of the render item of the entry.
+ */
+void RenderQueue::addEntry(unsigned long long sortKey, unsigned int index) {
+    // creates the render queue entry
+    RenderQueueEntry_t entry;
+    entry.sortKey = sortKey;
+    entry.index = index;
+
+    // adds the entry to the entries list
+    this->entriesList.push_back(entry);
+}
+
+/**
+ * Sorts the render queue entries by sort key, using a stable
+ * radix sort (the passes in which all the entries share the same
+ * digit are skipped).
+ */
+void RenderQueue::sort() {
+    // retrieves the number of entries
+    size_t numberEntries = this->entriesList.size();
+
+    // in case there is nothing to be sorted
+    if(numberEntries < 2) {
+        // returns immediately
+        return;
+    }
+
+    // resizes the auxiliary entries list
+    this->auxiliaryEntriesList.resize(numberEntries);
+
+    // retrieves the source and target entries buffers
+    RenderQueueEntry_t *sourceEntries = &this->entriesList[0];
+    RenderQueueEntry_t *targetEntries = &this->auxiliaryEntriesList[0];
+
+    // allocates the buckets offsets
+    size_t offsets[RENDER_QUEUE_RADIX_SIZE];
+
+    // iterates over all the digits of the sort key
+    for(unsigned int shift = 0; shift < 64; shift += RENDER_QUEUE_RADIX_BITS) {
+        // resets the buckets offsets
+        memset(offsets, 0, sizeof(offsets));
+
+        // counts the entries in each bucket
+        for(size_t index = 0; index < numberEntries; index++) {
+            offsets[(sourceEntries[index].sortKey >> shift) & (RENDER_QUEUE_RADIX_SIZE - 1)]++;
+        }
+
+        // in case all the entries are in the same bucket
+        if(offsets[(sourceEntries[0].sortKey >> shift) & (RENDER_QUEUE_RADIX_SIZE - 1)] == numberEntries) {
+            // skips the pass
+            continue;
+        }
+
+        // converts the counts into the buckets offsets
+        size_t offset = 0;
+        for(unsigned int bucket = 0; bucket < RENDER_QUEUE_RADIX_SIZE; bucket++) {
+            size_t count = offsets[bucket];
+            offsets[bucket] = offset;
+            offset += count;
+        }
+
+        // scatters the entries into the target entries
+        for(size_t index = 0; index < numberEntries; index++) {
+            targetEntries[offsets[(sourceEntries[index].sortKey >> shift) & (RENDER_QUEUE_RADIX_SIZE - 1)]++] = sourceEntries[index];
+        }
+
+        // swaps the source and target entries
+        RenderQueueEntry_t *entries = sourceEntries;
+        sourceEntries = targetEntries;
+        targetEntries = entries;
+    }
+
+    // in case the sorted entries are in the auxiliary entries list
+    if(sourceEntries != &this->entriesList[0]) {
+        // swaps the entries list with the auxiliary entries list
+        this->entriesList.swap(this->auxiliaryEntriesList);
+    }
+}
+
+/**
+ * Retrieves the entries list.
+ *
+ * @return The entries list.
+ */
+std::vector<RenderQueueEntry_t> &RenderQueue::getEntriesList() {
+    return this->entriesList;
+}
+
+/**
+ * Creates the sort key for the given state, the texture is the
+ * most significant part followed by the mesh list and the depth
+ * (drawing front to back inside each batch).
+ *
+ * @param textureKey The key of the texture (unique per texture).
+ * @param meshKey The key of the mesh list (unique per mesh list).
+ * @param depth The (non negative) depth of the item.
+ * @return The sort key for the given state.
+ */
+unsigned long long RenderQueue::createSortKey(unsigned int textureKey, unsigned int meshKey, float depth) {
+    // the bit representation of a non negative float
+    // has the same ordering as the float
+    unsigned int depthKey;
+    memcpy(&depthKey, &depth, sizeof(unsigned int));
+
+    // creates the sort key from the texture key, mesh key and depth key
+    unsigned long long sortKey = (unsigned long long) (textureKey & ((1 << RENDER_QUEUE_TEXTURE_BITS) - 1)) << (RENDER_QUEUE_MESH_BITS + RENDER_QUEUE_DEPTH_BITS);
+    sortKey |= (unsigned long long) (meshKey & ((1 << RENDER_QUEUE_MESH_BITS) - 1)) << RENDER_QUEUE_DEPTH_BITS;
+    sortKey |= (unsigned long long) depthKey;
+
+    // returns the sort key
+    return sortKey;
+}
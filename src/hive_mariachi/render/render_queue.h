@@ -0,0 +1,95 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../structures/structures.h"
+
+/**
+ * The number of bits of the texture part of
+ * the sort key.
+ */
+#define RENDER_QUEUE_TEXTURE_BITS 16
+
+/**
+ * The number of bits of the mesh (list) part of
+ * the sort key.
+ */
+#define RENDER_QUEUE_MESH_BITS 16
+
+/**
+ * The number of bits of the depth part of
+ * the sort key.
+ */
+#define RENDER_QUEUE_DEPTH_BITS 32
+
+/**
+ * The number of bits sorted in each pass
+ * of the radix sort.
+ */
+#define RENDER_QUEUE_RADIX_BITS 8
+
+/**
+ * The number of buckets used in each pass
+ * of the radix sort.
+ */
+#define RENDER_QUEUE_RADIX_SIZE 256
+
+namespace mariachi {
+    namespace render {
+        /**
+         * The render queue entry, associating the sort
+         * key with the index of the render item.
+         */
+        typedef struct RenderQueueEntry_t {
+            unsigned long long sortKey;
+            unsigned int index;
+        } RenderQueueEntry;
+
+        /**
+         * Flat queue of draw entries ordered by a 64 bit sort key
+         * (texture, mesh list and depth), so that the draw items
+         * sharing state are submitted together (in batches) and the
+         * draw items sharing the mesh list are adjacent (instanced).
+         * The entries are sorted using a (least significant digit)
+         * radix sort, the entries lists are reused between frames.
+         */
+        class RenderQueue {
+            private:
+                std::vector<RenderQueueEntry_t> entriesList;
+                std::vector<RenderQueueEntry_t> auxiliaryEntriesList;
+
+            public:
+                RenderQueue();
+                ~RenderQueue();
+                void clear();
+                void addEntry(unsigned long long sortKey, unsigned int index);
+                void sort();
+                std::vector<RenderQueueEntry_t> &getEntriesList();
+                static unsigned long long createSortKey(unsigned int textureKey, unsigned int meshKey, float depth);
+        };
+    }
+}
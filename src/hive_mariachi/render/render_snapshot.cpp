@@ -0,0 +1,353 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "../nodes/lens_node.h"
+
+#include "render_snapshot.h"
+
+using namespace mariachi::render;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+RenderSnapshot::RenderSnapshot() {
+    this->initCamera();
+    this->initLens();
+    this->initFrameNumber();
+    this->initInterpolation();
+    this->initDynamicMeshes();
+}
+
+/**
+ * Destructor of the class.
+ */
+RenderSnapshot::~RenderSnapshot() {
+}
+
+inline void RenderSnapshot::initCamera() {
+    this->cameraFlag = false;
+}
+
+inline void RenderSnapshot::initLens() {
+    this->fieldOfView = DEFAULT_LENS_FIELD_OF_VIEW;
+    this->nearDistance = DEFAULT_LENS_NEAR_DISTANCE;
+    this->farDistance = DEFAULT_LENS_FAR_DISTANCE;
+}
+
+inline void RenderSnapshot::initFrameNumber() {
+    this->frameNumber = 0;
+}
+
+inline void RenderSnapshot::initInterpolation() {
+    this->interpolationAlpha = 1.0f;
+}
+
+inline void RenderSnapshot::initDynamicMeshes() {
+    this->dynamicMeshListsCount = 0;
+}
+
+/**
+ * Clears the snapshot, removing all the render items
+ * and the camera (the memory is kept for reuse).
+ */
+void RenderSnapshot::clear() {
+    // clears the render items list
+    this->renderItemsList.clear();
+
+    // clears the render queue
+    this->renderQueue.clear();
+
+    // clears the dynamic meshes and vertices (the dynamic
+    // mesh lists are kept for reuse)
+    this->dynamicMeshesList.clear();
+    this->dynamicVertexOffsetsList.clear();
+    this->dynamicVerticesList.clear();
+    this->initDynamicMeshes();
+
+    // unsets the camera flag
+    this->cameraFlag = false;
+
+    // resets the lens
+    this->initLens();
+
+    // resets the interpolation (the transforms
+    // are set to the current ones)
+    this->initInterpolation();
+}
+
+/**
+ * Adds a render item to the snapshot, the render item
+ * is copied into the snapshot.
+ * In case the mesh list of the render item contains dynamic
+ * meshes the meshes are also copied (the mesh list of the
+ * item is set in the dynamic meshes resolution).
+ *
+ * @param renderItem The render item to be added.
+ */
+void RenderSnapshot::addRenderItem(RenderItem_t &renderItem) {
+    // adds the render item to the render items list
+    this->renderItemsList.push_back(renderItem);
+
+    // in case the mesh list contains dynamic meshes
+    if(renderItem.meshList && this->isDynamic(renderItem.meshList)) {
+        // copies the mesh list into the snapshot
+        this->addDynamicMeshList(renderItem.meshList);
+    }
+}
+
+/**
+ * Resolves the dynamic meshes copied into the snapshot, setting
+ * the (copied) mesh lists in the render items.
+ * Must be called after all the render items are added (the
+ * copies are only addressable after that).
+ */
+void RenderSnapshot::resolveDynamicMeshes() {
+    // iterates over all the dynamic mesh lists
+    for(unsigned int index = 0; index < this->dynamicMeshListsCount; index++) {
+        // retrieves the dynamic mesh list
+        RenderDynamicMeshList_t &dynamicMeshList = this->dynamicMeshListsList[index];
+
+        // clears the mesh list (keeping the capacity)
+        dynamicMeshList.meshList.clear();
+
+        // iterates over all the (copied) meshes
+        for(unsigned int meshIndex = dynamicMeshList.meshesStart; meshIndex < dynamicMeshList.meshesStart + dynamicMeshList.meshesCount; meshIndex++) {
+            // retrieves the mesh
+            Mesh_t &mesh = this->dynamicMeshesList[meshIndex];
+
+            // sets the (copied) vertex list in the mesh
+            mesh.vertexList = mesh.numberVertices ? &this->dynamicVerticesList[this->dynamicVertexOffsetsList[meshIndex]] : NULL;
+
+            // adds the mesh to the mesh list
+            dynamicMeshList.meshList.push_back(&mesh);
+        }
+
+        // sets the (copied) mesh list in the render item
+        this->renderItemsList[dynamicMeshList.itemIndex].meshList = &dynamicMeshList.meshList;
+    }
+}
+
+inline bool RenderSnapshot::isDynamic(std::vector<Mesh_t *> *meshList) {
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshList->size(); index++) {
+        // in case the mesh is dynamic
+        if((*meshList)[index]->dynamic) {
+            // returns true
+            return true;
+        }
+    }
+
+    // returns false
+    return false;
+}
+
+inline void RenderSnapshot::addDynamicMeshList(std::vector<Mesh_t *> *meshList) {
+    // in case there is no dynamic mesh list to be reused
+    if(this->dynamicMeshListsCount == this->dynamicMeshListsList.size()) {
+        // adds a new dynamic mesh list
+        this->dynamicMeshListsList.push_back(RenderDynamicMeshList_t());
+    }
+
+    // retrieves the dynamic mesh list (to be reused)
+    RenderDynamicMeshList_t &dynamicMeshList = this->dynamicMeshListsList[this->dynamicMeshListsCount++];
+
+    // sets the render item and the meshes range of the list
+    dynamicMeshList.itemIndex = this->renderItemsList.size() - 1;
+    dynamicMeshList.meshesStart = this->dynamicMeshesList.size();
+    dynamicMeshList.meshesCount = meshList->size();
+
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshList->size(); index++) {
+        // retrieves the mesh
+        Mesh_t *mesh = (*meshList)[index];
+
+        // copies the mesh (drawn as dynamic, the copy
+        // is not cached in the render adapter)
+        this->dynamicMeshesList.push_back(*mesh);
+        this->dynamicMeshesList.back().dynamic = true;
+
+        // sets the offset of the (copied) vertices
+        this->dynamicVertexOffsetsList.push_back(this->dynamicVerticesList.size());
+
+        // copies the vertices
+        this->dynamicVerticesList.insert(this->dynamicVerticesList.end(), mesh->vertexList, mesh->vertexList + mesh->numberVertices * 3);
+    }
+}
+
+/**
+ * Interpolates the (drawn) transforms of the render items between
+ * the previous and the current transforms, using the given alpha.
+ * The interpolation is linear over the matrix values, which is
+ * adequate for the small change in a single timestep.
+ *
+ * @param interpolationAlpha The interpolation alpha (fraction of
+ * the timestep elapsed since the current transforms).
+ */
+void RenderSnapshot::interpolate(float interpolationAlpha) {
+    // in case the transforms are already interpolated
+    // with the same alpha
+    if(interpolationAlpha == this->interpolationAlpha) {
+        // returns immediately
+        return;
+    }
+
+    // iterates over all the render items
+    for(unsigned int index = 0; index < this->renderItemsList.size(); index++) {
+        // retrieves the current render item
+        RenderItem_t &renderItem = this->renderItemsList[index];
+
+        // iterates over all the transform values
+        for(unsigned int valueIndex = 0; valueIndex < 16; valueIndex++) {
+            // retrieves the previous and current values
+            float previousValue = renderItem.previousTransform.values[valueIndex];
+            float currentValue = renderItem.currentTransform.values[valueIndex];
+
+            // blends the previous and the current values
+            renderItem.transform.values[valueIndex] = previousValue + (currentValue - previousValue) * interpolationAlpha;
+        }
+    }
+
+    // sets the interpolation alpha
+    this->interpolationAlpha = interpolationAlpha;
+}
+
+/**
+ * Retrieves the render items list.
+ *
+ * @return The render items list.
+ */
+std::vector<RenderItem_t> &RenderSnapshot::getRenderItemsList() {
+    return this->renderItemsList;
+}
+
+/**
+ * Retrieves the render queue.
+ *
+ * @return The render queue.
+ */
+RenderQueue &RenderSnapshot::getRenderQueue() {
+    return this->renderQueue;
+}
+
+/**
+ * Retrieves if the snapshot contains a camera.
+ *
+ * @return If the snapshot contains a camera.
+ */
+bool RenderSnapshot::hasCamera() {
+    return this->cameraFlag;
+}
+
+/**
+ * Sets the camera transforms in the snapshot.
+ *
+ * @param cameraPosition The position of the camera.
+ * @param cameraRotation The rotation of the camera.
+ */
+void RenderSnapshot::setCamera(const Coordinate3d_t &cameraPosition, const Rotation3d_t &cameraRotation) {
+    this->cameraPosition = cameraPosition;
+    this->cameraRotation = cameraRotation;
+    this->cameraFlag = true;
+}
+
+/**
+ * Retrieves the camera position.
+ *
+ * @return The camera position.
+ */
+Coordinate3d_t &RenderSnapshot::getCameraPosition() {
+    return this->cameraPosition;
+}
+
+/**
+ * Retrieves the camera rotation.
+ *
+ * @return The camera rotation.
+ */
+Rotation3d_t &RenderSnapshot::getCameraRotation() {
+    return this->cameraRotation;
+}
+
+/**
+ * Sets the lens (perspective) values in the snapshot.
+ *
+ * @param fieldOfView The (vertical) field of view (in degrees).
+ * @param nearDistance The distance to the near plane.
+ * @param farDistance The distance to the far plane.
+ */
+void RenderSnapshot::setLens(float fieldOfView, float nearDistance, float farDistance) {
+    this->fieldOfView = fieldOfView;
+    this->nearDistance = nearDistance;
+    this->farDistance = farDistance;
+}
+
+/**
+ * Retrieves the (vertical) field of view.
+ *
+ * @return The field of view (in degrees).
+ */
+float RenderSnapshot::getFieldOfView() {
+    return this->fieldOfView;
+}
+
+/**
+ * Retrieves the distance to the near plane.
+ *
+ * @return The distance to the near plane.
+ */
+float RenderSnapshot::getNearDistance() {
+    return this->nearDistance;
+}
+
+/**
+ * Retrieves the distance to the far plane.
+ *
+ * @return The distance to the far plane.
+ */
+float RenderSnapshot::getFarDistance() {
+    return this->farDistance;
+}
+
+/**
+ * Retrieves the number of the frame of the snapshot.
+ *
+ * @return The number of the frame of the snapshot.
+ */
+unsigned int RenderSnapshot::getFrameNumber() {
+    return this->frameNumber;
+}
+
+/**
+ * Sets the number of the frame of the snapshot.
+ *
+ * @param frameNumber The number of the frame of the snapshot.
+ */
+void RenderSnapshot::setFrameNumber(unsigned int frameNumber) {
+    this->frameNumber = frameNumber;
+}
@@ -0,0 +1,122 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../structures/structures.h"
+#include "render_queue.h"
+
+namespace mariachi {
+    namespace render {
+        /**
+         * The render item, an immutable copy of the
+         * state of a renderable (model) node.
+         * The transform is the one to be drawn, blended between
+         * the previous and the current (simulation) transforms.
+         */
+        typedef struct RenderItem_t {
+            structures::Matrix4d_t transform;
+            structures::Matrix4d_t previousTransform;
+            structures::Matrix4d_t currentTransform;
+            std::vector<structures::Mesh_t *> *meshList;
+            structures::Texture *texture;
+        } RenderItem;
+
+        /**
+         * A mesh list with dynamic meshes copied into the
+         * snapshot (the meshes of the node change in each frame).
+         *
+         * @param itemIndex The index of the render item of the list.
+         * @param meshesStart The index of the first (copied) mesh.
+         * @param meshesCount The number of (copied) meshes.
+         * @param meshList The list of the (copied) meshes.
+         */
+        typedef struct RenderDynamicMeshList_t {
+            unsigned int itemIndex;
+            unsigned int meshesStart;
+            unsigned int meshesCount;
+            std::vector<structures::Mesh_t *> meshList;
+        } RenderDynamicMeshList;
+
+        /**
+         * Immutable per frame copy of the render state, built
+         * by the render stage and consumed by the render adapter
+         * without accessing the (live) scene graph.
+         * The render items list is reused between frames to
+         * avoid the allocation of memory, the render queue defines
+         * the (sorted) order in which the items are drawn.
+         * The dynamic meshes (and their vertices) are copied into
+         * the snapshot, so the snapshot does not reference memory
+         * that the node changes or releases while it's drawn.
+         */
+        class RenderSnapshot {
+            private:
+                std::vector<RenderItem_t> renderItemsList;
+                std::vector<structures::Mesh_t> dynamicMeshesList;
+                std::vector<unsigned int> dynamicVertexOffsetsList;
+                std::vector<float> dynamicVerticesList;
+                std::vector<RenderDynamicMeshList_t> dynamicMeshListsList;
+                unsigned int dynamicMeshListsCount;
+                RenderQueue renderQueue;
+                bool cameraFlag;
+                structures::Coordinate3d_t cameraPosition;
+                structures::Rotation3d_t cameraRotation;
+                float fieldOfView;
+                float nearDistance;
+                float farDistance;
+                unsigned int frameNumber;
+                float interpolationAlpha;
+
+                inline void initCamera();
+                inline void initLens();
+                inline void initFrameNumber();
+                inline void initInterpolation();
+                inline void initDynamicMeshes();
+                inline bool isDynamic(std::vector<structures::Mesh_t *> *meshList);
+                inline void addDynamicMeshList(std::vector<structures::Mesh_t *> *meshList);
+
+            public:
+                RenderSnapshot();
+                ~RenderSnapshot();
+                void clear();
+                void addRenderItem(RenderItem_t &renderItem);
+                void resolveDynamicMeshes();
+                void interpolate(float interpolationAlpha);
+                std::vector<RenderItem_t> &getRenderItemsList();
+                RenderQueue &getRenderQueue();
+                bool hasCamera();
+                void setCamera(const structures::Coordinate3d_t &cameraPosition, const structures::Rotation3d_t &cameraRotation);
+                structures::Coordinate3d_t &getCameraPosition();
+                structures::Rotation3d_t &getCameraRotation();
+                void setLens(float fieldOfView, float nearDistance, float farDistance);
+                float getFieldOfView();
+                float getNearDistance();
+                float getFarDistance();
+                unsigned int getFrameNumber();
+                void setFrameNumber(unsigned int frameNumber);
+        };
+    }
+}
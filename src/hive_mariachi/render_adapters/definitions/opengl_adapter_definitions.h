@@ -32,3 +32,26 @@
 #elif MARIACHI_PLATFORM_MACOSX
 #define DEFAULT_RENDER_OPENGL_WINDOW_CLASS OpenglCocoaWindow
 #endif
+
+/**
+ * The vertex shader of the instancing program, the
+ * instance transform is applied before the (fixed
+ * function) model view and projection matrices.
+ */
+#define OPENGL_INSTANCING_VERTEX_SHADER "#version 120\n"\
+    "attribute mat4 instanceTransform;\n"\
+    "void main() {\n"\
+    "    gl_Position = gl_ModelViewProjectionMatrix * instanceTransform * gl_Vertex;\n"\
+    "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"\
+    "    gl_FrontColor = gl_Color;\n"\
+    "}\n"
+
+/**
+ * The fragment shader of the instancing program, modulates
+ * the texture with the color (as the fixed function).
+ */
+#define OPENGL_INSTANCING_FRAGMENT_SHADER "#version 120\n"\
+    "uniform sampler2D textureSampler;\n"\
+    "void main() {\n"\
+    "    gl_FragColor = texture2D(textureSampler, gl_TexCoord[0].st) * gl_Color;\n"\
+    "}\n"
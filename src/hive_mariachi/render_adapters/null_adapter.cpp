@@ -0,0 +1,221 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#include "stdafx.h"
+
+#include "../main/engine.h"
+#include "../debugging/profiler.h"
+#include "../render/render.h"
+
+#include "null_adapter.h"
+
+using namespace mariachi;
+using namespace mariachi::render;
+using namespace mariachi::debugging;
+using namespace mariachi::render_adapters;
+
+/**
+ * Constructor of the class.
+ */
+NullAdapter::NullAdapter() : RenderAdapter() {
+    this->initRunningFlag();
+}
+
+/**
+ * Destructor of the class.
+ */
+NullAdapter::~NullAdapter() {
+}
+
+inline void NullAdapter::initRunningFlag() {
+    this->runningFlag = false;
+    this->renderedNodesCount = 0;
+    this->frameCount = 0;
+}
+
+/**
+ * Starts the null adapter, running the presentation loop
+ * in the current thread until the adapter is stopped.
+ *
+ * @param arguments The render arguments (argc, argv, render
+ * information, render adapter and engine).
+ */
+void NullAdapter::start(void *arguments) {
+    RenderInformation *renderInformation = ((RenderInformation **) arguments)[2];
+    Engine *engine = ((Engine **) arguments)[4];
+
+    // sets the render information
+    this->renderInformation = renderInformation;
+
+    // sets the engine
+    this->setEngine(engine);
+
+    // sets the running flag
+    this->runningFlag = true;
+
+    // iterates while the adapter is running
+    while(this->runningFlag) {
+#if defined(MARIACHI_ASSYNC_PARALLEL_PROCESSING)
+        // displays the scene
+        this->display();
+
+        // yields the processor
+        THREAD_YIELD();
+#elif defined(MARIACHI_SYNC_PARALLEL_PROCESSING)
+        // enters the critical section
+        CRITICAL_SECTION_ENTER(engine->fifo->queueCriticalSection);
+
+        // iterates while the queue is empty, the stop flag is not set
+        // and the running flag is active
+        while(engine->fifo->queue.empty() && !engine->fifo->stopFlag && this->runningFlag) {
+            CONDITION_WAIT(engine->fifo->notEmptyCondition, engine->fifo->queueCriticalSection);
+        }
+
+        // in case the queue is empty (stopped)
+        if(engine->fifo->queue.empty()) {
+            // leaves the critical section
+            CRITICAL_SECTION_LEAVE(engine->fifo->queueCriticalSection);
+
+            // breaks the loop
+            break;
+        }
+
+        // displays the scene
+        this->display();
+
+        // removes a value from the fifo
+        engine->fifo->queue.pop_front();
+
+        // leaves the critical section
+        CRITICAL_SECTION_LEAVE(engine->fifo->queueCriticalSection);
+
+        // sends the condition signal
+        CONDITION_SIGNAL(engine->fifo->notFullCondition);
+#endif
+    }
+}
+
+/**
+ * Stops the null adapter, releasing the presentation loop.
+ *
+ * @param arguments The stop arguments.
+ */
+void NullAdapter::stop(void *arguments) {
+    // retrieves the engine
+    Engine *engine = this->getEngine();
+
+    // in case the adapter was not started
+    if(!engine) {
+        // unsets the running flag
+        this->runningFlag = false;
+
+        // returns immediately
+        return;
+    }
+
+#if defined(MARIACHI_ASSYNC_PARALLEL_PROCESSING)
+    // unsets the running flag
+    this->runningFlag = false;
+#elif defined(MARIACHI_SYNC_PARALLEL_PROCESSING)
+    // enters the critical section
+    CRITICAL_SECTION_ENTER(engine->fifo->queueCriticalSection);
+
+    // unsets the running flag
+    this->runningFlag = false;
+
+    // wakes the presentation loop and the engine
+    CONDITION_BROADCAST(engine->fifo->notEmptyCondition);
+    CONDITION_BROADCAST(engine->fifo->notFullCondition);
+
+    // leaves the critical section
+    CRITICAL_SECTION_LEAVE(engine->fifo->queueCriticalSection);
+#endif
+}
+
+/**
+ * Displays the current scene, consuming the most recent
+ * render snapshot without drawing it.
+ */
+void NullAdapter::display() {
+    // retrieves the active profiler
+    Profiler *profiler = Profiler::getActiveProfiler();
+
+    // in case there is an active profiler
+    if(profiler) {
+        // marks the render frame
+        profiler->markFrame(RENDER_FRAME_TIMER_ID);
+    }
+
+    // resets the rendered nodes count
+    this->renderedNodesCount = 0;
+
+    // waits for the render information mutex
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
+
+    // acquires the most recent render snapshot
+    RenderSnapshot *renderSnapshot = this->renderInformation->acquireSnapshot();
+
+    // releases the render information mutex
+    MUTEX_UNLOCK(this->renderInformation->getMutex());
+
+    // retrieves the engine
+    Engine *engine = this->getEngine();
+
+    // interpolates the snapshot transforms with the current
+    // interpolation alpha (between the last two simulation states)
+    renderSnapshot->interpolate(engine ? engine->getInterpolationAlpha() : 1.0f);
+
+    // retrieves the render items list
+    std::vector<RenderItem_t> &renderItemsList = renderSnapshot->getRenderItemsList();
+
+    // retrieves the (sorted) render queue entries list
+    std::vector<RenderQueueEntry_t> &entriesList = renderSnapshot->getRenderQueue().getEntriesList();
+
+    // iterates over all the render queue entries (in sort order)
+    for(unsigned int index = 0; index < entriesList.size(); index++) {
+        // renders the render item for the entry
+        this->renderItem(renderItemsList[entriesList[index].index]);
+    }
+
+    // increments the frame count
+    this->frameCount++;
+}
+
+/**
+ * Retrieves the number of nodes rendered in the last frame.
+ *
+ * @return The number of nodes rendered in the last frame.
+ */
+unsigned int NullAdapter::getRenderedNodesCount() {
+    return this->renderedNodesCount;
+}
+
+inline void NullAdapter::renderItem(RenderItem_t &renderItem) {
+    // in case the render item contains meshes
+    if(renderItem.meshList && !renderItem.meshList->empty()) {
+        // increments the rendered nodes count
+        this->renderedNodesCount++;
+    }
+}
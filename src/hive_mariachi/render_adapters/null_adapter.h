@@ -0,0 +1,54 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+#include "render_adapter.h"
+
+namespace mariachi {
+    namespace render_adapters {
+        /**
+         * Render adapter that presents nothing, the render snapshot
+         * is consumed as in the other adapters so that the engine
+         * may run headless (benchmarks).
+         */
+        class NullAdapter : public RenderAdapter {
+            private:
+                bool runningFlag;
+                unsigned int renderedNodesCount;
+
+                inline void initRunningFlag();
+                inline void renderItem(render::RenderItem_t &renderItem);
+
+            public:
+                NullAdapter();
+                ~NullAdapter();
+                void start(void *arguments);
+                void stop(void *arguments);
+                void display();
+                unsigned int getRenderedNodesCount();
+        };
+    }
+}
@@ -28,7 +28,10 @@
 #ifdef MARIACHI_PLATFORM_OPENGL
 
 #include "../main/engine.h"
+#include "../configuration/configuration.h"
+#include "../util/util.h"
 #include "../system/system.h"
+#include "../debugging/profiler.h"
 #include "../render/render.h"
 #include "../exceptions/exceptions.h"
 #include "../render_utils/opengl_glut_window.h"
@@ -36,11 +39,14 @@
 #include "../render_utils/opengl_cocoa_window.h"
 #include "definitions/opengl_adapter_definitions.h"
 
+#include "opengl_texture_manager.h"
 #include "opengl_adapter.h"
 
 using namespace mariachi::ui;
+using namespace mariachi::util;
 using namespace mariachi::nodes;
 using namespace mariachi::render;
+using namespace mariachi::debugging;
 using namespace mariachi::structures;
 using namespace mariachi::render_utils;
 using namespace mariachi::render_adapters;
@@ -49,6 +55,9 @@ using namespace mariachi::render_adapters;
  * Constructor of the class.
  */
 OpenglAdapter::OpenglAdapter() : RenderAdapter() {
+    this->initVertexBuffers();
+    this->initInstancing();
+    this->initTextureManager();
 }
 
 /**
@@ -57,6 +66,52 @@ OpenglAdapter::OpenglAdapter() : RenderAdapter() {
 OpenglAdapter::~OpenglAdapter() {
 }
 
+inline void OpenglAdapter::initVertexBuffers() {
+    // unsets the vertex buffer supported flag
+    this->vertexBufferSupported = false;
+
+    // unsets the vertex buffer functions
+    this->genBuffers = NULL;
+    this->deleteBuffers = NULL;
+    this->bindBuffer = NULL;
+    this->bufferData = NULL;
+    this->bufferSubData = NULL;
+}
+
+inline void OpenglAdapter::initInstancing() {
+    // unsets the instancing supported flag
+    this->instancingSupported = false;
+
+    // unsets the instancing program and buffer
+    this->instancingProgram = 0;
+    this->instanceBufferId = 0;
+
+    // unsets the shader functions
+    this->createShader = NULL;
+    this->shaderSource = NULL;
+    this->compileShader = NULL;
+    this->getShaderiv = NULL;
+    this->deleteShader = NULL;
+    this->createProgram = NULL;
+    this->attachShader = NULL;
+    this->bindAttribLocation = NULL;
+    this->linkProgram = NULL;
+    this->getProgramiv = NULL;
+    this->useProgram = NULL;
+    this->enableVertexAttribArray = NULL;
+    this->disableVertexAttribArray = NULL;
+    this->vertexAttribPointer = NULL;
+
+    // unsets the instancing functions
+    this->drawArraysInstanced = NULL;
+    this->drawElementsInstanced = NULL;
+    this->vertexAttribDivisor = NULL;
+}
+
+inline void OpenglAdapter::initTextureManager() {
+    this->textureManager = NULL;
+}
+
 void OpenglAdapter::start(void *arguments) {
     int argc = ((int *) arguments)[0];
     char **argv = ((char ***) arguments)[1];
@@ -84,6 +139,22 @@ void OpenglAdapter::start(void *arguments) {
     // sets the render information
     this->renderInformation = renderInformation;
 
+    // sets the engine
+    this->setEngine(engine);
+
+    // creates the texture manager (the textures are prepared
+    // in the engine tasks)
+    this->textureManager = new OpenglTextureManager(engine);
+
+    // retrieves the texture upload budget value
+    ConfigurationValue_t *textureUploadBudgetProperty = engine->getConfigurationManager()->getProperty("render/texture_upload_budget");
+
+    // in case a texture upload budget is defined in the configuration
+    if(textureUploadBudgetProperty) {
+        // sets the configured texture upload budget
+        this->textureManager->setUploadBudget(textureUploadBudgetProperty->structure.intValue);
+    }
+
     // creates the opengl window
     this->window = new DEFAULT_RENDER_OPENGL_WINDOW_CLASS();
 
@@ -139,30 +210,73 @@ void OpenglAdapter::init() {
 
     // enters into model view matrix mode
     glMatrixMode(GL_MODELVIEW);
+
+    // loads the vertex buffer functions (requires the context)
+    this->loadVertexBuffers();
+
+    // loads the instancing functions and program (requires the context)
+    this->loadInstancing();
+
+    // loads the texture manager (requires the context)
+    this->loadTextureManager();
 }
 
 void OpenglAdapter::clean() {
+    // in case the texture manager is defined
+    if(this->textureManager) {
+        // deletes the texture manager
+        delete this->textureManager;
+
+        // unsets the texture manager
+        this->textureManager = NULL;
+    }
 }
 
 void OpenglAdapter::display() {
     // updates the frame rate
     this->updateFrameRate();
 
+    // retrieves the active profiler
+    Profiler *profiler = Profiler::getActiveProfiler();
+
+    // in case there is an active profiler
+    if(profiler) {
+        // marks the render frame
+        profiler->markFrame(RENDER_FRAME_TIMER_ID);
+    }
+
+    // uploads the prepared textures (within the frame budget)
+    this->textureManager->update();
+
     // clears all pixels
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // waits for the render information mutex
-    MUTEX_LOCK(this->renderInformation->getMutex());
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
 
-    // displays the 3d scene
-    this->display3d();
+    // acquires the most recent render snapshot
+    RenderSnapshot *renderSnapshot = this->renderInformation->acquireSnapshot();
 
-    // displays the 2d scene
-    this->display2d();
+    // retrieves the render 2d (node)
+    Scene2dNode *render2d = this->renderInformation->getRender2d();
 
-    // releases the render information mutex
+    // releases the render information mutex (the snapshot
+    // is owned by the render adapter until the next acquire)
     MUTEX_UNLOCK(this->renderInformation->getMutex());
 
+    // retrieves the engine
+    Engine *engine = this->getEngine();
+
+    // interpolates the snapshot transforms with the current
+    // interpolation alpha (between the last two simulation states)
+    renderSnapshot->interpolate(engine ? engine->getInterpolationAlpha() : 1.0f);
+
+    // displays the 3d scene
+    this->display3d(renderSnapshot);
+
+    // displays the 2d scene
+    this->display2d(render2d);
+
     // flushes the open gl buffers
     glFlush();
 }
@@ -184,6 +298,15 @@ void OpenglAdapter::resizeScene(int windowWidth, int windowHeight) {
     // sets the window aspect ratio
     this->windowAspectRatio = (float) this->windowSize.width / (float) this->windowSize.height;
 
+    // waits for the render information mutex
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
+
+    // sets the aspect ratio in the render information (used in the culling)
+    this->renderInformation->setAspectRatio(this->windowAspectRatio);
+
+    // releases the render information mutex
+    MUTEX_UNLOCK(this->renderInformation->getMutex());
+
     // calculates the width and height ration
     this->widthRatio = windowWidth / REFERENCE_WIDTH_2D;
     this->heightRatio = windowHeight / REFERENCE_HEIGHT_2D;
@@ -206,43 +329,9 @@ void OpenglAdapter::keyPressed(unsigned char key, int x, int y) {
 }
 
 inline void OpenglAdapter::setTexture(Texture *texture) {
-    // allocates the texture id integer
-    GLuint textureId;
-
-    // in case the texture is already rendered in open gl
-    if(!(textureId = this->textureTextureIdMap[texture])) {
-        // retrieves the texture sizes
-        IntSize2d_t textureSize = texture->getSize();
-
-        // retrieves the image buffer
-        ImageColor_t *imageBuffer = texture->getImageBuffer();
-
-        // allocation space for the texture
-        glGenTextures(1, &textureId);
-
-        // binds the current context to the current texture
-        glBindTexture(GL_TEXTURE_2D, textureId);
-
-        // sets the pixel store policy
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-
-        // loads the texture
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureSize.width, textureSize.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (unsigned char *) imageBuffer);
-
-        // sets some texture parameters
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // sets the texture id for the current texture in the texture
-        // texture id map
-        this->textureTextureIdMap[texture] = textureId;
-    }
-    else {
-        // binds the current context to the current texture
-        glBindTexture(GL_TEXTURE_2D, textureId);
-    }
+    // binds the current context to the texture handle, the
+    // placeholder handle is used while the texture is uploading
+    glBindTexture(GL_TEXTURE_2D, this->textureManager->getHandle(texture));
 }
 
 inline time_t OpenglAdapter::clockSeconds() {
@@ -283,62 +372,98 @@ inline void OpenglAdapter::updateFrameRate() {
     }
 }
 
-inline void OpenglAdapter::display2d() {
+inline void OpenglAdapter::display2d(Scene2dNode *render2d) {
     // setup the display 2d
     this->setupDisplay2d();
 
-    // retrieves the render 2d (node)
-    Scene2dNode *render2d = this->renderInformation->getRender2d();
+    // locks the scene for reading (once for the whole traversal)
+    Node::lockScene();
 
     this->renderNode2d(render2d);
+
+    // unlocks the scene
+    Node::unlockScene();
 }
 
-inline void OpenglAdapter::display3d() {
+inline void OpenglAdapter::display3d(RenderSnapshot *renderSnapshot) {
     // setup the display 3d
-    this->setupDisplay3d();
+    this->setupDisplay3d(renderSnapshot);
 
-    // retrieves the current active camera
-    CameraNode *activeCamera = this->renderInformation->getActiveCamera();
-
-    // in case there is a camera node selected
-    if(activeCamera) {
-        // renders the current camera node
-        this->renderCameraNode(activeCamera);
+    // in case there is a camera in the snapshot
+    if(renderSnapshot->hasCamera()) {
+        // renders the snapshot camera
+        this->renderCamera(renderSnapshot);
     }
 
-    // retrieves the render (node)
-    SceneNode *render = this->renderInformation->getRender();
+    // retrieves the render items list
+    std::vector<RenderItem_t> &renderItemsList = renderSnapshot->getRenderItemsList();
 
-    // locks the render node
-    render->lock();
+    // retrieves the (sorted) render queue entries list
+    std::vector<RenderQueueEntry_t> &entriesList = renderSnapshot->getRenderQueue().getEntriesList();
 
-    // retrieves the render children list
-    std::list<Node *> &renderChildrenList = render->getChildrenList();
+    // retrieves the entries list size
+    size_t entriesListSize = entriesList.size();
 
-    // retrieves the render children list iterator
-    std::list<Node *>::iterator renderChildrenListIterator = renderChildrenList.begin();
+    // the texture of the current batch
+    Texture *batchTexture = NULL;
 
-    // iterates iver all the render children nodes
-    while(renderChildrenListIterator != renderChildrenList.end()) {
-        // retrieves the current node
-        Node *node = *renderChildrenListIterator;
+    // enables the client states (for all the batches)
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
 
-        // in case the node is renderable
-        if(node->renderable) {
-            // @todo change this harcode and make it a switch statement
-            // casts the node as model node
-            ModelNode *modelNode = (ModelNode *) node;
+    // iterates over all the render queue entries (in sort order)
+    for(unsigned int index = 0; index < entriesListSize;) {
+        // retrieves the render item for the entry
+        RenderItem_t &renderItem = renderItemsList[entriesList[index].index];
+
+        // in case the render item starts a new batch
+        if(index == 0 || renderItem.texture != batchTexture) {
+            // sets the texture
+            this->setTexture(renderItem.texture);
+
+            // sets the batch texture
+            batchTexture = renderItem.texture;
+        }
 
-            // renders the model node
-            this->renderModelNode(modelNode);
+        // counts the adjacent render items sharing the mesh list
+        // and the texture (the sort key keeps them together)
+        unsigned int count = 1;
+        while(index + count < entriesListSize) {
+            // retrieves the next render item
+            RenderItem_t &nextRenderItem = renderItemsList[entriesList[index + count].index];
+
+            // in case the next render item does not share the state
+            if(nextRenderItem.meshList != renderItem.meshList || nextRenderItem.texture != renderItem.texture) {
+                // breaks the loop
+                break;
+            }
+
+            // increments the count
+            count++;
         }
 
-        // increments the render children list iterator
-        renderChildrenListIterator++;
+        // in case there are enough render items to be instanced
+        if(count >= OPENGL_INSTANCING_MINIMUM_INSTANCES) {
+            // renders the render items as instances
+            this->renderInstances(renderItemsList, entriesList, index, count);
+        } else {
+            // renders the model of the render item
+            this->renderModel(renderItem);
+        }
+
+        // increments the index by the number of rendered items
+        index += count;
+    }
+
+    // in case the vertex buffers are supported
+    if(this->vertexBufferSupported) {
+        // unbinds the vertex buffer
+        this->bindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    // unlocks the render node
-    render->unlock();
+    // disables the client states
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
 inline void OpenglAdapter::setupDisplay2d() {
@@ -361,7 +486,7 @@ inline void OpenglAdapter::setupDisplay2d() {
     glScalef(this->lowestRatio, this->lowestRatio, 0.0);
 }
 
-inline void OpenglAdapter::setupDisplay3d() {
+inline void OpenglAdapter::setupDisplay3d(RenderSnapshot *renderSnapshot) {
     // sets the matrix mode to projection
     glMatrixMode(GL_PROJECTION);
 
@@ -369,7 +494,7 @@ inline void OpenglAdapter::setupDisplay3d() {
     glLoadIdentity();
 
     // recalculates the glu perspective
-    gluPerspective(45.0, this->windowAspectRatio, 0.3f, 1000.0f);
+    gluPerspective(renderSnapshot->getFieldOfView(), this->windowAspectRatio, renderSnapshot->getNearDistance(), renderSnapshot->getFarDistance());
 
     // sets the matrix mode to model view
     glMatrixMode(GL_MODELVIEW);
@@ -378,12 +503,12 @@ inline void OpenglAdapter::setupDisplay3d() {
     glLoadIdentity();
 }
 
-inline void OpenglAdapter::renderCameraNode(CameraNode *cameraNode) {
+inline void OpenglAdapter::renderCamera(RenderSnapshot *renderSnapshot) {
     // retrieves the position
-    Coordinate3d_t &position = cameraNode->getPosition();
+    Coordinate3d_t &position = renderSnapshot->getCameraPosition();
 
     // retrieves the rotation
-    Rotation3d_t &rotation = cameraNode->getRotation();
+    Rotation3d_t &rotation = renderSnapshot->getCameraRotation();
 
     // performs the rotation to match the elements orientation
     glRotatef(rotation.angle, rotation.x, rotation.y, rotation.z);
@@ -393,14 +518,11 @@ inline void OpenglAdapter::renderCameraNode(CameraNode *cameraNode) {
 }
 
 inline void OpenglAdapter::renderNode2d(Node *node) {
-    // locks the node
-    node->lock();
-
     // retrieves the node children list
-    std::list<Node *> &nodeChildrenList = node->getChildrenList();
+    NodeList &nodeChildrenList = node->getChildrenList();
 
     // retrieves the node children list iterator
-    std::list<Node *>::iterator nodeChildrenListIterator = nodeChildrenList.begin();
+    NodeList::iterator nodeChildrenListIterator = nodeChildrenList.begin();
 
     // iterates over all the node children
     while(nodeChildrenListIterator != nodeChildrenList.end()) {
@@ -480,9 +602,6 @@ inline void OpenglAdapter::renderNode2d(Node *node) {
         // increments the node children list iterator
         nodeChildrenListIterator++;
     }
-
-    // unlocks the node
-    node->unlock();
 }
 
 /**
@@ -506,99 +625,649 @@ inline void OpenglAdapter::renderSquare(float x1, float y1, float x2, float y2)
     glEnd();
 }
 
-inline void OpenglAdapter::renderModelNode(ModelNode *modelNode) {
+inline void OpenglAdapter::renderModel(RenderItem_t &renderItem) {
     // retrieves the mesh list
-    std::vector<Mesh_t *> *meshList = modelNode->getMeshList();
+    std::vector<Mesh_t *> *meshList = renderItem.meshList;
 
-    // retrieves the texture
-    Texture *texture = modelNode->getTexture();
+    // retrieves the mesh list size
+    size_t meshListSize = meshList->size();
 
-    // retrieves the position
-    Coordinate3d_t &position = modelNode->getPosition();
+    // pushes the transformation matrix
+    glPushMatrix();
 
-    // retrieves the rotation
-    Rotation3d_t &rotation = modelNode->getRotation();
+    // multiplies by the (cached) world transform of the element
+    glMultMatrixf(renderItem.transform.values);
 
-    // retrieves the scale
-    Coordinate3d_t &scale = modelNode->getScale();
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshListSize; index++) {
+        // retrieves the current mesh
+        Mesh_t *mesh = (*meshList)[index];
 
-    // retrieves the mesh list size
-    size_t meshListSize = meshList->size();
+        // retrieves the number of vertices
+        unsigned int numberVertices = mesh->numberVertices;
 
-    // sets the texture
-    this->setTexture(texture);
+        // in case the number of vertices is not valid
+        if(!numberVertices) {
+            // continues the loop
+            continue;
+        }
 
-    // pushes the transformation matrix
-    glPushMatrix();
+        // sets the mesh (vertex and texture coordinate arrays)
+        this->setMesh(mesh);
 
-    // puts the element in the screen
-    glTranslatef(position.x, position.y, position.z);
+        // draws the mesh
+        this->drawMesh(mesh);
+    }
+
+    // pops the matrix
+    glPopMatrix();
+}
 
-    // scales the element
-    glScalef(scale.x, scale.y, scale.z);
+/**
+ * Renders the given (adjacent) render queue entries as instances
+ * of the same mesh list and texture, using hardware instancing in
+ * case it's supported and the pre transform of the vertices (in
+ * the cpu) otherwise.
+ *
+ * @param renderItemsList The list of render items.
+ * @param entriesList The (sorted) render queue entries list.
+ * @param start The index of the first entry to be rendered.
+ * @param count The number of entries to be rendered.
+ */
+inline void OpenglAdapter::renderInstances(std::vector<RenderItem_t> &renderItemsList, std::vector<RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count) {
+    // in case the instancing is supported
+    if(this->instancingSupported) {
+        // renders the instances in a single draw per mesh
+        this->renderInstancesHardware(renderItemsList, entriesList, start, count);
+    } else {
+        // renders the instances pre transformed (in the cpu)
+        this->renderInstancesPreTransform(renderItemsList, entriesList, start, count);
+    }
+}
 
-    // rotates the element
-    glRotatef(rotation.angle, rotation.x, rotation.y, rotation.z);
+inline void OpenglAdapter::renderInstancesHardware(std::vector<RenderItem_t> &renderItemsList, std::vector<RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count) {
+    // retrieves the mesh list (shared by all the instances)
+    std::vector<Mesh_t *> *meshList = renderItemsList[entriesList[start].index].meshList;
+
+    // resizes the instance transforms list
+    this->instanceTransformsList.resize(count * 16);
+
+    // iterates over all the instances
+    for(unsigned int index = 0; index < count; index++) {
+        // copies the instance transform into the instance transforms list
+        memcpy(&this->instanceTransformsList[index * 16], renderItemsList[entriesList[start + index].index].transform.values, 16 * sizeof(float));
+    }
+
+    // binds the instance buffer and uploads the instance transforms
+    this->bindBuffer(GL_ARRAY_BUFFER, this->instanceBufferId);
+    this->bufferData(GL_ARRAY_BUFFER, count * 16 * sizeof(float), &this->instanceTransformsList[0], GL_STREAM_DRAW);
+
+    // iterates over all the instance transform columns
+    for(unsigned int index = 0; index < 4; index++) {
+        // sets the column attribute (advanced once per instance)
+        this->enableVertexAttribArray(OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE + index);
+        this->vertexAttribPointer(OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE + index, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float), (GLvoid *) (index * 4 * sizeof(float)));
+        this->vertexAttribDivisor(OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE + index, 1);
+    }
+
+    // uses the instancing program
+    this->useProgram(this->instancingProgram);
 
     // iterates over all the meshes
-    for(unsigned int index = 0; index < meshListSize; index++) {
+    for(unsigned int index = 0; index < meshList->size(); index++) {
         // retrieves the current mesh
         Mesh_t *mesh = (*meshList)[index];
 
-        // retrieves the position
-        Coordinate3d_t position = mesh->position;
+        // in case the number of vertices is not valid
+        if(!mesh->numberVertices) {
+            // continues the loop
+            continue;
+        }
+
+        // sets the mesh (vertex and texture coordinate arrays)
+        this->setMesh(mesh);
+
+        // in case the mesh is indexed
+        if(mesh->indexList) {
+            // draws all the instances of the mesh (using the indexes)
+            this->drawElementsInstanced(this->getMeshMode(mesh), mesh->numberIndexes, this->getMeshIndexType(mesh), this->getMeshIndexes(mesh), count);
+        } else {
+            // draws all the instances of the mesh
+            this->drawArraysInstanced(this->getMeshMode(mesh), 0, mesh->numberVertices, count);
+        }
+    }
+
+    // uses the fixed function pipeline
+    this->useProgram(0);
+
+    // iterates over all the instance transform columns
+    for(unsigned int index = 0; index < 4; index++) {
+        // resets the column attribute
+        this->vertexAttribDivisor(OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE + index, 0);
+        this->disableVertexAttribArray(OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE + index);
+    }
+}
 
-        // retrieves the vertex list
-        float *vertexList = mesh->vertexList;
+inline void OpenglAdapter::renderInstancesPreTransform(std::vector<RenderItem_t> &renderItemsList, std::vector<RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count) {
+    // retrieves the mesh list (shared by all the instances)
+    std::vector<Mesh_t *> *meshList = renderItemsList[entriesList[start].index].meshList;
 
-        // retrieves the texture vertex list
-        float *textureVertexList = mesh->textureVertexList;
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshList->size(); index++) {
+        // retrieves the current mesh
+        Mesh_t *mesh = (*meshList)[index];
 
         // retrieves the number of vertices
         unsigned int numberVertices = mesh->numberVertices;
 
-        // switches over the mesh type
-        switch(mesh->type) {
-            case TRIANGLE:
-                break;
-            case TRIANGLE_STRIP:
-                glBegin(GL_TRIANGLE_STRIP);
-                break;
-            case TRIANGLE_FAN:
-                glBegin(GL_TRIANGLE_FAN);
-                break;
+        // in case the number of vertices is not valid
+        if(!numberVertices) {
+            // continues the loop
+            continue;
+        }
+
+        // retrieves the number of indexes (zero for non indexed meshes)
+        unsigned int numberIndexes = mesh->indexList ? mesh->numberIndexes : 0;
+
+        // in case the mesh can not be merged (strips and fans)
+        if(mesh->type != TRIANGLE) {
+            // sets the mesh (vertex and texture coordinate arrays)
+            this->setMesh(mesh);
+
+            // iterates over all the instances
+            for(unsigned int instanceIndex = 0; instanceIndex < count; instanceIndex++) {
+                // draws the mesh with the instance transform
+                glPushMatrix();
+                glMultMatrixf(renderItemsList[entriesList[start + instanceIndex].index].transform.values);
+                this->drawMesh(mesh);
+                glPopMatrix();
+            }
+
+            // continues the loop
+            continue;
         }
 
-        // iterates over all the vertices
-        for(unsigned int index = 0; index < numberVertices; index++) {
-            // retrieves the texture vertex
-            float *textureVertex = &textureVertexList[index * 2];
+        // resizes the pre transform lists (for all the instances)
+        this->preTransformVertexList.resize(count * numberVertices * 3);
+        this->preTransformTextureVertexList.resize(count * numberVertices * 2);
+
+        // iterates over all the instances
+        for(unsigned int instanceIndex = 0; instanceIndex < count; instanceIndex++) {
+            // retrieves the instance transform values
+            float *values = renderItemsList[entriesList[start + instanceIndex].index].transform.values;
 
-            // retrieves the texture vertex coordinates
-            float textureVertexX = textureVertex[0];
-            float textureVertexY = textureVertex[1];
+            // retrieves the instance vertex and texture vertex lists
+            float *vertexList = &this->preTransformVertexList[instanceIndex * numberVertices * 3];
+            float *textureVertexList = &this->preTransformTextureVertexList[instanceIndex * numberVertices * 2];
 
-            // retrieves the vertex
-            float *vertex = &vertexList[index * 3];
+            // iterates over all the vertices
+            for(unsigned int vertexIndex = 0; vertexIndex < numberVertices; vertexIndex++) {
+                // retrieves the vertex
+                float *vertex = &mesh->vertexList[vertexIndex * 3];
 
-            // retrieves the vertex coordinates
-            float vertexX = vertex[0];
-            float vertexY = vertex[1];
-            float vertexZ = vertex[2];
+                // transforms the vertex (column major transform)
+                vertexList[vertexIndex * 3] = values[0] * vertex[0] + values[4] * vertex[1] + values[8] * vertex[2] + values[12];
+                vertexList[vertexIndex * 3 + 1] = values[1] * vertex[0] + values[5] * vertex[1] + values[9] * vertex[2] + values[13];
+                vertexList[vertexIndex * 3 + 2] = values[2] * vertex[0] + values[6] * vertex[1] + values[10] * vertex[2] + values[14];
+            }
 
-            // sets the texture coordinates of mapping
-            glTexCoord2f(textureVertexX, textureVertexY);
+            // copies the texture vertices
+            memcpy(textureVertexList, mesh->textureVertexList, numberVertices * 2 * sizeof(float));
+        }
 
-            // sets the vertex coordinates
-            glVertex3f(vertexX, vertexY, vertexZ);
+        // in case the mesh is indexed
+        if(numberIndexes) {
+            // resizes the pre transform index list (for all the instances)
+            this->preTransformIndexList.resize(count * numberIndexes);
+
+            // iterates over all the instances
+            for(unsigned int instanceIndex = 0; instanceIndex < count; instanceIndex++) {
+                // retrieves the instance index list and the offset of the
+                // instance vertices (in the merged vertices)
+                unsigned int *indexList = &this->preTransformIndexList[instanceIndex * numberIndexes];
+                unsigned int vertexOffset = instanceIndex * numberVertices;
+
+                // in case the indexes are short
+                if(mesh->indexType == SHORT_INDEX) {
+                    // retrieves the short mesh indexes
+                    unsigned short *meshIndexList = (unsigned short *) mesh->indexList;
+
+                    // copies the indexes (offset to the instance vertices)
+                    for(unsigned int indexIndex = 0; indexIndex < numberIndexes; indexIndex++) {
+                        indexList[indexIndex] = vertexOffset + meshIndexList[indexIndex];
+                    }
+                } else {
+                    // retrieves the int mesh indexes
+                    unsigned int *meshIndexList = (unsigned int *) mesh->indexList;
+
+                    // copies the indexes (offset to the instance vertices)
+                    for(unsigned int indexIndex = 0; indexIndex < numberIndexes; indexIndex++) {
+                        indexList[indexIndex] = vertexOffset + meshIndexList[indexIndex];
+                    }
+                }
+            }
         }
 
-        // ends the gl drawing
-        glEnd();
+        // in case the vertex buffers are supported
+        if(this->vertexBufferSupported) {
+            // unbinds the vertex and index buffers (client side arrays)
+            this->bindBuffer(GL_ARRAY_BUFFER, 0);
+            this->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+
+        // sets the client side vertex and texture coordinate arrays
+        glVertexPointer(3, GL_FLOAT, 0, &this->preTransformVertexList[0]);
+        glTexCoordPointer(2, GL_FLOAT, 0, &this->preTransformTextureVertexList[0]);
+
+        // in case the mesh is indexed
+        if(numberIndexes) {
+            // draws all the instances of the mesh (using the merged indexes)
+            glDrawElements(GL_TRIANGLES, count * numberIndexes, GL_UNSIGNED_INT, &this->preTransformIndexList[0]);
+        } else {
+            // draws all the instances of the mesh
+            glDrawArrays(GL_TRIANGLES, 0, count * numberVertices);
+        }
     }
+}
 
-    // pops the matrix
-    glPopMatrix();
+/**
+ * Sets the vertex and texture coordinate arrays of the given mesh,
+ * in case the vertex buffers are supported the mesh is uploaded
+ * into a vertex buffer the first time it's set (the vertices are
+ * followed by the texture coordinates), otherwise the client side
+ * arrays of the mesh are used.
+ * The indexes of the indexed meshes are uploaded into an index
+ * buffer (bound with the vertex buffer).
+ * The dynamic meshes (changed in every frame) always use the
+ * client side arrays.
+ *
+ * @param mesh The mesh to be set.
+ */
+inline void OpenglAdapter::setMesh(Mesh_t *mesh) {
+    // in case the vertex buffers are not supported or
+    // the mesh is dynamic
+    if(!this->vertexBufferSupported || mesh->dynamic) {
+        // in case the vertex buffers are supported
+        if(this->vertexBufferSupported) {
+            // unbinds the vertex and index buffers (client side arrays)
+            this->bindBuffer(GL_ARRAY_BUFFER, 0);
+            this->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+
+        // sets the client side vertex and texture coordinate arrays
+        glVertexPointer(3, GL_FLOAT, 0, mesh->vertexList);
+        glTexCoordPointer(2, GL_FLOAT, 0, mesh->textureVertexList);
+
+        // returns immediately
+        return;
+    }
+
+    // calculates the vertex and texture vertex list sizes
+    size_t vertexListSize = mesh->numberVertices * 3 * sizeof(float);
+    size_t textureVertexListSize = mesh->numberVertices * 2 * sizeof(float);
+
+    // retrieves the buffers of the mesh (cached by address)
+    MeshBuffers_t &meshBuffers = this->meshBuffersMap[mesh];
+
+    // in case the buffers were created for a (released) mesh
+    // that had the same address
+    if(meshBuffers.generation != mesh->generation) {
+        // deletes the stale buffers
+        this->deleteMeshBuffers(meshBuffers);
+
+        // sets the generation of the mesh in the buffers
+        meshBuffers.generation = mesh->generation;
+    }
+
+    // in case the mesh is not yet uploaded to a vertex buffer
+    if(!meshBuffers.bufferId) {
+        // allocates the buffer id integer
+        GLuint bufferId;
+
+        // allocates the vertex buffer
+        this->genBuffers(1, &bufferId);
+
+        // binds the vertex buffer
+        this->bindBuffer(GL_ARRAY_BUFFER, bufferId);
+
+        // allocates the vertex buffer storage and uploads the vertex
+        // and texture vertex lists
+        this->bufferData(GL_ARRAY_BUFFER, vertexListSize + textureVertexListSize, NULL, GL_STATIC_DRAW);
+        this->bufferSubData(GL_ARRAY_BUFFER, 0, vertexListSize, mesh->vertexList);
+        this->bufferSubData(GL_ARRAY_BUFFER, vertexListSize, textureVertexListSize, mesh->textureVertexList);
+
+        // sets the buffer id in the mesh buffers
+        meshBuffers.bufferId = bufferId;
+    } else {
+        // binds the vertex buffer
+        this->bindBuffer(GL_ARRAY_BUFFER, meshBuffers.bufferId);
+    }
+
+    // in case the mesh is indexed
+    if(mesh->indexList) {
+        // in case the indexes are not yet uploaded to an index buffer
+        if(!meshBuffers.indexBufferId) {
+            // allocates the index buffer id integer
+            GLuint indexBufferId;
+
+            // allocates and binds the index buffer
+            this->genBuffers(1, &indexBufferId);
+            this->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+
+            // uploads the indexes
+            this->bufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->numberIndexes * MeshUtil::getIndexSize(mesh->indexType), mesh->indexList, GL_STATIC_DRAW);
+
+            // sets the index buffer id in the mesh buffers
+            meshBuffers.indexBufferId = indexBufferId;
+        } else {
+            // binds the index buffer
+            this->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshBuffers.indexBufferId);
+        }
+    }
+
+    // sets the vertex and texture coordinate arrays (as offsets
+    // in the vertex buffer)
+    glVertexPointer(3, GL_FLOAT, 0, (GLvoid *) 0);
+    glTexCoordPointer(2, GL_FLOAT, 0, (GLvoid *) vertexListSize);
+}
+
+/**
+ * Loads the vertex buffer functions, the vertex buffers are
+ * used in case the opengl version is at least 1.5 or the vertex
+ * buffer object extension is available.
+ */
+inline void OpenglAdapter::loadVertexBuffers() {
+    // retrieves the version string
+    const char *versionString = (const char *) glGetString(GL_VERSION);
+
+    // retrieves the major and minor versions
+    int majorVersion = 0;
+    int minorVersion = 0;
+    if(versionString) {
+        sscanf(versionString, "%d.%d", &majorVersion, &minorVersion);
+    }
+
+    // in case the version is at least 1.5
+    if(majorVersion > 1 || (majorVersion == 1 && minorVersion >= 5)) {
+        // loads the core vertex buffer functions
+        this->genBuffers = (GenBuffersFunction_t) this->getProcedureAddress("glGenBuffers");
+        this->deleteBuffers = (DeleteBuffersFunction_t) this->getProcedureAddress("glDeleteBuffers");
+        this->bindBuffer = (BindBufferFunction_t) this->getProcedureAddress("glBindBuffer");
+        this->bufferData = (BufferDataFunction_t) this->getProcedureAddress("glBufferData");
+        this->bufferSubData = (BufferSubDataFunction_t) this->getProcedureAddress("glBufferSubData");
+    }
+    // in case the vertex buffer object extension is supported
+    else if(this->isExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        // loads the extension vertex buffer functions
+        this->genBuffers = (GenBuffersFunction_t) this->getProcedureAddress("glGenBuffersARB");
+        this->deleteBuffers = (DeleteBuffersFunction_t) this->getProcedureAddress("glDeleteBuffersARB");
+        this->bindBuffer = (BindBufferFunction_t) this->getProcedureAddress("glBindBufferARB");
+        this->bufferData = (BufferDataFunction_t) this->getProcedureAddress("glBufferDataARB");
+        this->bufferSubData = (BufferSubDataFunction_t) this->getProcedureAddress("glBufferSubDataARB");
+    }
+
+    // the vertex buffers are supported in case all the functions are loaded
+    this->vertexBufferSupported = this->genBuffers && this->deleteBuffers && this->bindBuffer && this->bufferData && this->bufferSubData;
+}
+
+/**
+ * Deletes the vertex and index buffers in the given mesh
+ * buffers, unsetting the buffer ids.
+ *
+ * @param meshBuffers The mesh buffers to be deleted.
+ */
+inline void OpenglAdapter::deleteMeshBuffers(MeshBuffers_t &meshBuffers) {
+    // in case the vertex buffer is set
+    if(meshBuffers.bufferId) {
+        // deletes the vertex buffer
+        this->deleteBuffers(1, &meshBuffers.bufferId);
+        meshBuffers.bufferId = 0;
+    }
+
+    // in case the index buffer is set
+    if(meshBuffers.indexBufferId) {
+        // deletes the index buffer
+        this->deleteBuffers(1, &meshBuffers.indexBufferId);
+        meshBuffers.indexBufferId = 0;
+    }
+}
+
+/**
+ * Draws the given (previously set) mesh, in case the mesh is
+ * indexed the vertices are drawn using the index list.
+ *
+ * @param mesh The mesh to be drawn.
+ */
+inline void OpenglAdapter::drawMesh(Mesh_t *mesh) {
+    // in case the mesh is indexed
+    if(mesh->indexList) {
+        // draws the mesh using the indexes
+        glDrawElements(this->getMeshMode(mesh), mesh->numberIndexes, this->getMeshIndexType(mesh), this->getMeshIndexes(mesh));
+    } else {
+        // draws the mesh vertices in order
+        glDrawArrays(this->getMeshMode(mesh), 0, mesh->numberVertices);
+    }
+}
+
+/**
+ * Retrieves the opengl primitive mode for the given mesh.
+ *
+ * @param mesh The mesh to retrieve the mode.
+ * @return The opengl primitive mode for the mesh.
+ */
+inline GLenum OpenglAdapter::getMeshMode(Mesh_t *mesh) {
+    // switches over the mesh type
+    switch(mesh->type) {
+        case TRIANGLE_STRIP:
+            return GL_TRIANGLE_STRIP;
+        case TRIANGLE_FAN:
+            return GL_TRIANGLE_FAN;
+        default:
+            return GL_TRIANGLES;
+    }
+}
+
+/**
+ * Retrieves the opengl index type for the given (indexed) mesh.
+ *
+ * @param mesh The mesh to retrieve the index type.
+ * @return The opengl index type for the mesh.
+ */
+inline GLenum OpenglAdapter::getMeshIndexType(Mesh_t *mesh) {
+    return mesh->indexType == SHORT_INDEX ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+/**
+ * Retrieves the indexes to be drawn for the given (previously set)
+ * mesh, the offset in the index buffer in case the mesh indexes
+ * are uploaded, otherwise the client side index list.
+ *
+ * @param mesh The mesh to retrieve the indexes.
+ * @return The indexes to be drawn for the mesh.
+ */
+inline const GLvoid *OpenglAdapter::getMeshIndexes(Mesh_t *mesh) {
+    return this->vertexBufferSupported && !mesh->dynamic ? (const GLvoid *) 0 : mesh->indexList;
+}
+
+/**
+ * Loads the instancing functions and program, the instancing is
+ * used in case the vertex buffers and shaders are supported and
+ * the opengl version is at least 3.3 or the draw instanced and
+ * instanced arrays extensions are available.
+ */
+inline void OpenglAdapter::loadInstancing() {
+    // in case the vertex buffers are not supported
+    if(!this->vertexBufferSupported) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the version string
+    const char *versionString = (const char *) glGetString(GL_VERSION);
+
+    // retrieves the major and minor versions
+    int majorVersion = 0;
+    int minorVersion = 0;
+    if(versionString) {
+        sscanf(versionString, "%d.%d", &majorVersion, &minorVersion);
+    }
+
+    // in case the version is less than 2.0 (no shaders)
+    if(majorVersion < 2) {
+        // returns immediately
+        return;
+    }
+
+    // loads the shader functions
+    this->createShader = (CreateShaderFunction_t) this->getProcedureAddress("glCreateShader");
+    this->shaderSource = (ShaderSourceFunction_t) this->getProcedureAddress("glShaderSource");
+    this->compileShader = (CompileShaderFunction_t) this->getProcedureAddress("glCompileShader");
+    this->getShaderiv = (GetShaderivFunction_t) this->getProcedureAddress("glGetShaderiv");
+    this->deleteShader = (DeleteShaderFunction_t) this->getProcedureAddress("glDeleteShader");
+    this->createProgram = (CreateProgramFunction_t) this->getProcedureAddress("glCreateProgram");
+    this->attachShader = (AttachShaderFunction_t) this->getProcedureAddress("glAttachShader");
+    this->bindAttribLocation = (BindAttribLocationFunction_t) this->getProcedureAddress("glBindAttribLocation");
+    this->linkProgram = (LinkProgramFunction_t) this->getProcedureAddress("glLinkProgram");
+    this->getProgramiv = (GetProgramivFunction_t) this->getProcedureAddress("glGetProgramiv");
+    this->useProgram = (UseProgramFunction_t) this->getProcedureAddress("glUseProgram");
+    this->enableVertexAttribArray = (EnableVertexAttribArrayFunction_t) this->getProcedureAddress("glEnableVertexAttribArray");
+    this->disableVertexAttribArray = (DisableVertexAttribArrayFunction_t) this->getProcedureAddress("glDisableVertexAttribArray");
+    this->vertexAttribPointer = (VertexAttribPointerFunction_t) this->getProcedureAddress("glVertexAttribPointer");
+
+    // in case the version is at least 3.3
+    if(majorVersion > 3 || (majorVersion == 3 && minorVersion >= 3)) {
+        // loads the core instancing functions
+        this->drawArraysInstanced = (DrawArraysInstancedFunction_t) this->getProcedureAddress("glDrawArraysInstanced");
+        this->drawElementsInstanced = (DrawElementsInstancedFunction_t) this->getProcedureAddress("glDrawElementsInstanced");
+        this->vertexAttribDivisor = (VertexAttribDivisorFunction_t) this->getProcedureAddress("glVertexAttribDivisor");
+    }
+    // in case the draw instanced and instanced arrays extensions are supported
+    else if(this->isExtensionSupported("GL_ARB_draw_instanced") && this->isExtensionSupported("GL_ARB_instanced_arrays")) {
+        // loads the extension instancing functions
+        this->drawArraysInstanced = (DrawArraysInstancedFunction_t) this->getProcedureAddress("glDrawArraysInstancedARB");
+        this->drawElementsInstanced = (DrawElementsInstancedFunction_t) this->getProcedureAddress("glDrawElementsInstancedARB");
+        this->vertexAttribDivisor = (VertexAttribDivisorFunction_t) this->getProcedureAddress("glVertexAttribDivisorARB");
+    }
+
+    // in case any of the functions is not loaded
+    if(!this->createShader || !this->shaderSource || !this->compileShader || !this->getShaderiv || !this->deleteShader
+        || !this->createProgram || !this->attachShader || !this->bindAttribLocation || !this->linkProgram || !this->getProgramiv
+        || !this->useProgram || !this->enableVertexAttribArray || !this->disableVertexAttribArray || !this->vertexAttribPointer
+        || !this->drawArraysInstanced || !this->drawElementsInstanced || !this->vertexAttribDivisor) {
+        // returns immediately
+        return;
+    }
+
+    // loads the instancing vertex and fragment shaders
+    GLuint vertexShader = this->loadShader(GL_VERTEX_SHADER, OPENGL_INSTANCING_VERTEX_SHADER);
+    GLuint fragmentShader = this->loadShader(GL_FRAGMENT_SHADER, OPENGL_INSTANCING_FRAGMENT_SHADER);
+
+    // in case both shaders were loaded
+    if(vertexShader && fragmentShader) {
+        // creates the instancing program and attaches the shaders
+        this->instancingProgram = this->createProgram();
+        this->attachShader(this->instancingProgram, vertexShader);
+        this->attachShader(this->instancingProgram, fragmentShader);
+
+        // binds the instance transform attribute and links the program
+        this->bindAttribLocation(this->instancingProgram, OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE, "instanceTransform");
+        this->linkProgram(this->instancingProgram);
+
+        // retrieves the link status
+        GLint linkStatus = GL_FALSE;
+        this->getProgramiv(this->instancingProgram, GL_LINK_STATUS, &linkStatus);
+
+        // in case the program was linked
+        if(linkStatus == GL_TRUE) {
+            // allocates the instance buffer
+            this->genBuffers(1, &this->instanceBufferId);
+
+            // sets the instancing supported flag
+            this->instancingSupported = true;
+        }
+    }
+
+    // deletes the shaders (owned by the program)
+    if(vertexShader) {
+        this->deleteShader(vertexShader);
+    }
+    if(fragmentShader) {
+        this->deleteShader(fragmentShader);
+    }
+}
+
+/**
+ * Loads (creates and compiles) a shader of the given type
+ * from the given source.
+ *
+ * @param type The type of the shader to be loaded.
+ * @param source The source of the shader.
+ * @return The loaded shader or zero in case the compilation failed.
+ */
+inline GLuint OpenglAdapter::loadShader(GLenum type, const char *source) {
+    // creates the shader and compiles the source
+    GLuint shader = this->createShader(type);
+    this->shaderSource(shader, 1, &source, NULL);
+    this->compileShader(shader);
+
+    // retrieves the compile status
+    GLint compileStatus = GL_FALSE;
+    this->getShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+
+    // in case the shader was not compiled
+    if(compileStatus != GL_TRUE) {
+        // deletes the shader
+        this->deleteShader(shader);
+
+        // returns invalid
+        return 0;
+    }
+
+    // returns the shader
+    return shader;
+}
+
+inline void OpenglAdapter::loadTextureManager() {
+    // retrieves the version string
+    const char *versionString = (const char *) glGetString(GL_VERSION);
+
+    // retrieves the major and minor versions
+    int majorVersion = 0;
+    int minorVersion = 0;
+    if(versionString) {
+        sscanf(versionString, "%d.%d", &majorVersion, &minorVersion);
+    }
+
+    // in case the buffers are supported and the version is at least 2.1
+    // or the pixel buffer object extension is supported
+    if(this->vertexBufferSupported && (majorVersion > 2 || (majorVersion == 2 && minorVersion >= 1) || this->isExtensionSupported("GL_ARB_pixel_buffer_object"))) {
+        // sets the buffer functions in the texture manager (used
+        // for the pixel buffers)
+        this->textureManager->setPixelBufferFunctions(this->genBuffers, this->bindBuffer, this->bufferData);
+    }
+
+    // loads the texture manager
+    this->textureManager->load();
+}
+
+/**
+ * Retrieves the address of the opengl procedure with the
+ * given name (for the current context).
+ *
+ * @param procedureName The name of the procedure to be retrieved.
+ * @return The address of the procedure or null in case the
+ * procedure is not available.
+ */
+inline void *OpenglAdapter::getProcedureAddress(const char *procedureName) {
+#ifdef MARIACHI_PLATFORM_WIN32
+    return (void *) wglGetProcAddress(procedureName);
+#elif MARIACHI_PLATFORM_LINUX
+    return (void *) glXGetProcAddressARB((const GLubyte *) procedureName);
+#elif MARIACHI_PLATFORM_MACOSX
+    return dlsym(RTLD_DEFAULT, procedureName);
+#else
+    return NULL;
+#endif
 }
 
 inline void OpenglAdapter::renderViewPortNode(ViewPortNode *viewPortNode, SquareNode *targetNode) {
@@ -663,60 +1332,22 @@ inline void OpenglAdapter::renderButtonNode(ButtonNode *buttonNode, SquareNode *
 }
 
 inline Coordinate2d_t OpenglAdapter::getRealPosition2d(SquareNode *squareNode, SquareNode *targetNode) {
-    // retrieves the square node size
-    FloatSize2d_t size = squareNode->getSize();
-
-    // retrieves the target node position
-    Coordinate2d_t targetPosition = targetNode->getPosition();
-
-    // retrieves the target node size
-    FloatSize2d_t targetSize = targetNode->getSize();
-
-    // retrieves the square node position
-    Coordinate2d_t basePosition = squareNode->getPosition();
-
-    // retrieves the button position reference
-    PositionReferenceType_t positionReference = squareNode->getPositionReference();
-
-    // the position value
-    Coordinate2d_t position;
+    // retrieves the (cached) real box of the square node
+    Box2d_t &realBox = squareNode->getRealBox(this->lowestWidthRevertRatio, this->lowestHeightRevertRatio);
 
-    float targetPositionX = targetPosition.x <= 100.0 && targetPosition.x >= 0.0 ? targetPosition.x : 0.0;
-    float targetPositionY = targetPosition.y <= 100.0 && targetPosition.y >= 0.0 ? targetPosition.y : 0.0;
-
-    float ratio1Width = targetSize.width <= 100.0 && targetSize.width >= 0.0 ? 100.0 / targetSize.width : 100.0;
-    float ratio1Height = targetSize.height <= 100.0 && targetSize.width >= 0.0 ? 100.0 / targetSize.height : 100.0;
-
-    float basePosition_x = basePosition.x / ratio1Width + targetPositionX;
-    float basePosition_y = basePosition.y / ratio1Height + targetPositionY;
-
-    // switches over the position reference
-    switch(positionReference) {
-        case TOP_LEFT_REFERENCE_POSITION:
-            position.x = basePosition.x * this->lowestWidthRevertRatio;
-            position.y = basePosition.y * this->lowestHeightRevertRatio;
-
-            break;
-
-        case CENTER_REFERENCE_POSITION:
-            position.x = basePosition.x * this->lowestWidthRevertRatio - size.width / 2.0;
-            position.y = basePosition.y * this->lowestHeightRevertRatio - size.height / 2.0;
-
-            break;
-    }
+    // creates the position from the real box
+    Coordinate2d_t position = { realBox.x1, realBox.y1 };
 
     // returns the position
     return position;
 }
 
 inline FloatSize2d_t OpenglAdapter::getRealSize2d(SquareNode *squareNode) {
-    // retrieves the square node size
-    FloatSize2d_t baseSize = squareNode->getSize();
-
-    FloatSize2d_t size;
+    // retrieves the (cached) real box of the square node
+    Box2d_t &realBox = squareNode->getRealBox(this->lowestWidthRevertRatio, this->lowestHeightRevertRatio);
 
-    size.width = baseSize.width * this->lowestWidthRevertRatio;
-    size.height = baseSize.height * this->lowestHeightRevertRatio;
+    // creates the size from the real box
+    FloatSize2d_t size = { realBox.x2 - realBox.x1, realBox.y2 - realBox.y1 };
 
     // returns the size
     return size;
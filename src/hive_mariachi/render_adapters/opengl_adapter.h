@@ -35,6 +35,14 @@
 #include <GL/glu.h>
 #endif
 
+#ifdef MARIACHI_PLATFORM_LINUX
+#include <GL/glx.h>
+#endif
+
+#ifdef MARIACHI_PLATFORM_MACOSX
+#include <dlfcn.h>
+#endif
+
 #include "../nodes/nodes.h"
 #include "../user_interface/user_interface.h"
 #include "../structures/texture.h"
@@ -47,8 +55,106 @@
  */
 #define DEFAULT_ZOOM_LEVEL 100.0
 
+/**
+ * The minimum number of adjacent draw items sharing
+ * the mesh list and texture to be drawn as instances.
+ */
+#define OPENGL_INSTANCING_MINIMUM_INSTANCES 2
+
+/**
+ * The (first) attribute location of the instance
+ * transform (one location per column).
+ */
+#define OPENGL_INSTANCE_TRANSFORM_ATTRIBUTE 4
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
 namespace mariachi {
     namespace render_adapters {
+        class OpenglTextureManager;
+
+        /**
+         * The vertex buffer object functions (opengl 1.5), loaded
+         * at runtime (not exported in every platform).
+         */
+        typedef void (APIENTRY *GenBuffersFunction_t)(GLsizei size, GLuint *buffers);
+        typedef void (APIENTRY *DeleteBuffersFunction_t)(GLsizei size, const GLuint *buffers);
+        typedef void (APIENTRY *BindBufferFunction_t)(GLenum target, GLuint buffer);
+        typedef void (APIENTRY *BufferDataFunction_t)(GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage);
+        typedef void (APIENTRY *BufferSubDataFunction_t)(GLenum target, ptrdiff_t offset, ptrdiff_t size, const GLvoid *data);
+
+        /**
+         * The shader functions (opengl 2.0), used by the
+         * instancing program.
+         */
+        typedef GLuint (APIENTRY *CreateShaderFunction_t)(GLenum type);
+        typedef void (APIENTRY *ShaderSourceFunction_t)(GLuint shader, GLsizei count, const char **strings, const GLint *lengths);
+        typedef void (APIENTRY *CompileShaderFunction_t)(GLuint shader);
+        typedef void (APIENTRY *GetShaderivFunction_t)(GLuint shader, GLenum name, GLint *parameters);
+        typedef void (APIENTRY *DeleteShaderFunction_t)(GLuint shader);
+        typedef GLuint (APIENTRY *CreateProgramFunction_t)();
+        typedef void (APIENTRY *AttachShaderFunction_t)(GLuint program, GLuint shader);
+        typedef void (APIENTRY *BindAttribLocationFunction_t)(GLuint program, GLuint index, const char *name);
+        typedef void (APIENTRY *LinkProgramFunction_t)(GLuint program);
+        typedef void (APIENTRY *GetProgramivFunction_t)(GLuint program, GLenum name, GLint *parameters);
+        typedef void (APIENTRY *UseProgramFunction_t)(GLuint program);
+        typedef void (APIENTRY *EnableVertexAttribArrayFunction_t)(GLuint index);
+        typedef void (APIENTRY *DisableVertexAttribArrayFunction_t)(GLuint index);
+        typedef void (APIENTRY *VertexAttribPointerFunction_t)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer);
+
+        /**
+         * The instancing functions (opengl 3.3 or the draw
+         * instanced and instanced arrays extensions).
+         */
+        typedef void (APIENTRY *DrawArraysInstancedFunction_t)(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+        typedef void (APIENTRY *DrawElementsInstancedFunction_t)(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei instanceCount);
+        typedef void (APIENTRY *VertexAttribDivisorFunction_t)(GLuint index, GLuint divisor);
+
+        /**
+         * The vertex and index buffers of a mesh, the generation
+         * identifies the mesh for which the buffers were created
+         * (the address of a released mesh may be reused).
+         */
+        typedef struct MeshBuffers_t {
+            unsigned long generation;
+            GLuint bufferId;
+            GLuint indexBufferId;
+        } MeshBuffers;
+
         class OpenglAdapter : public RenderAdapter {
             private:
                 render_utils::OpenglWindow *window;
@@ -61,18 +167,66 @@ namespace mariachi {
                 float bestRatio;
                 float lowestWidthRevertRatio;
                 float lowestHeightRevertRatio;
-                std::map<structures::Texture *, int> textureTextureIdMap;
+                OpenglTextureManager *textureManager;
+                std::map<structures::Mesh_t *, MeshBuffers_t> meshBuffersMap;
+                bool vertexBufferSupported;
+                GenBuffersFunction_t genBuffers;
+                DeleteBuffersFunction_t deleteBuffers;
+                BindBufferFunction_t bindBuffer;
+                BufferDataFunction_t bufferData;
+                BufferSubDataFunction_t bufferSubData;
+                bool instancingSupported;
+                GLuint instancingProgram;
+                GLuint instanceBufferId;
+                std::vector<float> instanceTransformsList;
+                std::vector<float> preTransformVertexList;
+                std::vector<float> preTransformTextureVertexList;
+                std::vector<unsigned int> preTransformIndexList;
+                CreateShaderFunction_t createShader;
+                ShaderSourceFunction_t shaderSource;
+                CompileShaderFunction_t compileShader;
+                GetShaderivFunction_t getShaderiv;
+                DeleteShaderFunction_t deleteShader;
+                CreateProgramFunction_t createProgram;
+                AttachShaderFunction_t attachShader;
+                BindAttribLocationFunction_t bindAttribLocation;
+                LinkProgramFunction_t linkProgram;
+                GetProgramivFunction_t getProgramiv;
+                UseProgramFunction_t useProgram;
+                EnableVertexAttribArrayFunction_t enableVertexAttribArray;
+                DisableVertexAttribArrayFunction_t disableVertexAttribArray;
+                VertexAttribPointerFunction_t vertexAttribPointer;
+                DrawArraysInstancedFunction_t drawArraysInstanced;
+                DrawElementsInstancedFunction_t drawElementsInstanced;
+                VertexAttribDivisorFunction_t vertexAttribDivisor;
 
                 inline time_t clockSeconds();
                 inline void updateFrameRate();
-                inline void display2d();
-                inline void display3d();
+                inline void display2d(nodes::Scene2dNode *render2d);
+                inline void display3d(render::RenderSnapshot *renderSnapshot);
                 inline void setupDisplay2d();
-                inline void setupDisplay3d();
-                inline void renderCameraNode(nodes::CameraNode *cameraNode);
+                inline void setupDisplay3d(render::RenderSnapshot *renderSnapshot);
+                inline void renderCamera(render::RenderSnapshot *renderSnapshot);
                 inline void renderNode2d(nodes::Node *node);
                 inline void renderSquare(float x1, float y1, float x2, float y2);
-                inline void renderModelNode(nodes::ModelNode *modelNode);
+                inline void renderModel(render::RenderItem_t &renderItem);
+                inline void renderInstances(std::vector<render::RenderItem_t> &renderItemsList, std::vector<render::RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count);
+                inline void renderInstancesHardware(std::vector<render::RenderItem_t> &renderItemsList, std::vector<render::RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count);
+                inline void renderInstancesPreTransform(std::vector<render::RenderItem_t> &renderItemsList, std::vector<render::RenderQueueEntry_t> &entriesList, unsigned int start, unsigned int count);
+                inline void setMesh(structures::Mesh_t *mesh);
+                inline void drawMesh(structures::Mesh_t *mesh);
+                inline void deleteMeshBuffers(MeshBuffers_t &meshBuffers);
+                inline GLenum getMeshMode(structures::Mesh_t *mesh);
+                inline GLenum getMeshIndexType(structures::Mesh_t *mesh);
+                inline const GLvoid *getMeshIndexes(structures::Mesh_t *mesh);
+                inline void initVertexBuffers();
+                inline void loadVertexBuffers();
+                inline void initInstancing();
+                inline void loadInstancing();
+                inline GLuint loadShader(GLenum type, const char *source);
+                inline void *getProcedureAddress(const char *procedureName);
+                inline void initTextureManager();
+                inline void loadTextureManager();
                 inline void renderViewPortNode(ui::ViewPortNode *viewPortNode, nodes::SquareNode *targetNode);
                 inline void renderPanelNode(ui::PanelNode *panelNode, nodes::SquareNode *targetNode);
                 inline void renderButtonNode(ui::ButtonNode *buttonNode, nodes::SquareNode *targetNode);
@@ -0,0 +1,473 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#ifdef MARIACHI_PLATFORM_OPENGL
+
+#include "opengl_texture_manager.h"
+
+using namespace mariachi;
+using namespace mariachi::tasks;
+using namespace mariachi::structures;
+using namespace mariachi::render_adapters;
+
+/**
+ * Constructor of the class.
+ */
+OpenglTextureManager::OpenglTextureManager() {
+    this->engine = NULL;
+    this->initPlaceholder();
+    this->initPixelBuffer();
+    this->initUploads();
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The engine used to run the upload tasks.
+ */
+OpenglTextureManager::OpenglTextureManager(Engine *engine) {
+    this->engine = engine;
+    this->initPlaceholder();
+    this->initPixelBuffer();
+    this->initUploads();
+}
+
+/**
+ * Destructor of the class.
+ */
+OpenglTextureManager::~OpenglTextureManager() {
+    // stops the ready uploads fifo (releasing the workers
+    // waiting to add an upload)
+    this->readyUploadsFifo->stop();
+
+    // retrieves the uploads list iterator
+    std::list<TextureUpload_t *>::iterator uploadsListIterator = this->uploadsList.begin();
+
+    // iterates over all the (incomplete) uploads
+    while(uploadsListIterator != this->uploadsList.end()) {
+        // retrieves the texture upload
+        TextureUpload_t *textureUpload = *uploadsListIterator;
+
+        // cancels the upload task (retrieving if it was
+        // canceled while pending)
+        bool pending = textureUpload->task->cancel();
+
+        // in case the task was canceled while pending (still
+        // referenced by the task pool)
+        if(pending) {
+            // unsets the task (must not be deleted)
+            textureUpload->task = NULL;
+        } else {
+            // waits for the task (in case it's running)
+            textureUpload->task->wait();
+        }
+
+        // deletes the texture upload
+        this->deleteUpload(textureUpload);
+
+        // increments the uploads list iterator
+        uploadsListIterator++;
+    }
+
+    // deletes the ready uploads fifo
+    delete this->readyUploadsFifo;
+}
+
+inline void OpenglTextureManager::initPlaceholder() {
+    this->placeholderHandle = 0;
+}
+
+inline void OpenglTextureManager::initPixelBuffer() {
+    this->pixelBufferSupported = false;
+    this->pixelBuffer = 0;
+    this->genBuffers = NULL;
+    this->bindBuffer = NULL;
+    this->bufferData = NULL;
+}
+
+inline void OpenglTextureManager::initUploads() {
+    this->uploadBudget = DEFAULT_TEXTURE_UPLOAD_BUDGET;
+    this->readyUploadsFifo = new RingFifo<TextureUpload_t *>(TEXTURE_UPLOAD_FIFO_SIZE);
+}
+
+/**
+ * Loads the texture manager, creating the placeholder texture
+ * and the pixel buffer (requires the opengl context).
+ */
+void OpenglTextureManager::load() {
+    // creates the placeholder color (opaque gray)
+    ImageColor_t placeholderColor;
+    placeholderColor.rgba.red = 128;
+    placeholderColor.rgba.green = 128;
+    placeholderColor.rgba.blue = 128;
+    placeholderColor.rgba.alpha = 255;
+
+    // allocates space for the placeholder texture
+    glGenTextures(1, &this->placeholderHandle);
+
+    // binds the current context to the placeholder texture
+    glBindTexture(GL_TEXTURE_2D, this->placeholderHandle);
+
+    // sets the pixel store policy
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // loads the placeholder texture (single pixel)
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, (unsigned char *) &placeholderColor);
+
+    // sets the placeholder texture parameters
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // in case the pixel buffers are supported
+    if(this->pixelBufferSupported) {
+        // allocates the pixel buffer
+        this->genBuffers(1, &this->pixelBuffer);
+    }
+}
+
+/**
+ * Updates the texture manager, uploading the prepared textures
+ * until the upload budget of the frame is reached (at least one
+ * texture is uploaded per frame).
+ * Must be called in the render thread.
+ */
+void OpenglTextureManager::update() {
+    // allocates the list of uploads for the frame
+    std::vector<TextureUpload_t *> frameUploadsList;
+
+    // starts the frame size
+    size_t frameSize = 0;
+
+    // allocates the texture upload
+    TextureUpload_t *textureUpload;
+
+    // moves the uploads added by the workers (without blocking)
+    // to the ready uploads list
+    while(this->readyUploadsFifo->tryWait(textureUpload)) {
+        this->readyUploadsList.push_back(textureUpload);
+    }
+
+    // iterates while there are ready uploads within the budget
+    while(!this->readyUploadsList.empty() && (frameUploadsList.empty() || frameSize + this->readyUploadsList.front()->size <= this->uploadBudget)) {
+        // retrieves the ready upload
+        textureUpload = this->readyUploadsList.front();
+
+        // removes the upload from the ready uploads list
+        this->readyUploadsList.pop_front();
+
+        // adds the upload to the frame uploads list
+        frameUploadsList.push_back(textureUpload);
+
+        // increments the frame size
+        frameSize += textureUpload->size;
+    }
+
+    // iterates over all the frame uploads
+    for(unsigned int index = 0; index < frameUploadsList.size(); index++) {
+        // uploads the texture
+        this->upload(frameUploadsList[index]);
+    }
+}
+
+/**
+ * Retrieves the opengl handle for the given texture, in case
+ * the texture is not loaded its upload is requested and the
+ * placeholder handle is returned.
+ *
+ * @param texture The texture to retrieve the handle.
+ * @return The opengl handle to be bound for the texture.
+ */
+GLuint OpenglTextureManager::getHandle(Texture *texture) {
+    // switches over the texture status
+    switch(texture->getStatus()) {
+        case LOADED_TEXTURE_STATUS:
+            // returns the texture handle
+            return texture->getHandle();
+
+        case UNLOADED_TEXTURE_STATUS:
+            // requests the texture upload
+            this->requestUpload(texture);
+            break;
+
+        default:
+            break;
+    }
+
+    // returns the placeholder handle
+    return this->placeholderHandle;
+}
+
+/**
+ * Prepares the given texture upload, creating the mipmap chain
+ * of the texture (box filtered).
+ * May be called in any thread.
+ *
+ * @param textureUpload The texture upload to be prepared.
+ */
+void OpenglTextureManager::prepareUpload(TextureUpload_t *textureUpload) {
+    // retrieves the texture
+    Texture *texture = textureUpload->texture;
+
+    // creates the base level (using the texture buffer)
+    TextureLevel_t level = { texture->getSize(), texture->getImageBuffer() };
+
+    // adds the base level to the levels list
+    textureUpload->levelsList.push_back(level);
+
+    // sets the upload size
+    textureUpload->size = level.size.width * level.size.height * sizeof(ImageColor_t);
+
+    // iterates while the level is larger than a pixel
+    while(level.size.width > 1 || level.size.height > 1) {
+        // retrieves the previous level
+        TextureLevel_t previousLevel = level;
+
+        // calculates the level size (halving the previous one)
+        level.size.width = previousLevel.size.width > 1 ? previousLevel.size.width / 2 : 1;
+        level.size.height = previousLevel.size.height > 1 ? previousLevel.size.height / 2 : 1;
+
+        // allocates the level buffer
+        level.buffer = new ImageColor_t[level.size.width * level.size.height];
+
+        // iterates over all the level pixels
+        for(unsigned int y = 0; y < level.size.height; y++) {
+            for(unsigned int x = 0; x < level.size.width; x++) {
+                // calculates the source pixel coordinates (clamped)
+                unsigned int x1 = x * 2 < previousLevel.size.width ? x * 2 : previousLevel.size.width - 1;
+                unsigned int y1 = y * 2 < previousLevel.size.height ? y * 2 : previousLevel.size.height - 1;
+                unsigned int x2 = x1 + 1 < previousLevel.size.width ? x1 + 1 : x1;
+                unsigned int y2 = y1 + 1 < previousLevel.size.height ? y1 + 1 : y1;
+
+                // retrieves the source pixels
+                unsigned char *pixel1 = (unsigned char *) &previousLevel.buffer[y1 * previousLevel.size.width + x1];
+                unsigned char *pixel2 = (unsigned char *) &previousLevel.buffer[y1 * previousLevel.size.width + x2];
+                unsigned char *pixel3 = (unsigned char *) &previousLevel.buffer[y2 * previousLevel.size.width + x1];
+                unsigned char *pixel4 = (unsigned char *) &previousLevel.buffer[y2 * previousLevel.size.width + x2];
+
+                // retrieves the target pixel
+                unsigned char *pixel = (unsigned char *) &level.buffer[y * level.size.width + x];
+
+                // averages the source pixels components
+                for(unsigned int component = 0; component < sizeof(ImageColor_t); component++) {
+                    pixel[component] = (unsigned char) ((pixel1[component] + pixel2[component] + pixel3[component] + pixel4[component] + 2) / 4);
+                }
+            }
+        }
+
+        // adds the level to the levels list
+        textureUpload->levelsList.push_back(level);
+
+        // increments the upload size
+        textureUpload->size += level.size.width * level.size.height * sizeof(ImageColor_t);
+    }
+}
+
+/**
+ * Adds the given (prepared) texture upload to the ready
+ * uploads, to be uploaded in the render thread.
+ * May be called in any thread.
+ *
+ * @param textureUpload The texture upload to be added.
+ */
+void OpenglTextureManager::addReadyUpload(TextureUpload_t *textureUpload) {
+    // adds the texture upload to the ready uploads fifo
+    // (lock free, the render thread drains it in the update)
+    this->readyUploadsFifo->signal(textureUpload);
+}
+
+/**
+ * Sets the buffer functions used in the pixel buffers, in
+ * case the functions are not valid the textures are uploaded
+ * from the client memory.
+ *
+ * @param genBuffers The function used to generate buffers.
+ * @param bindBuffer The function used to bind buffers.
+ * @param bufferData The function used to set the buffer data.
+ */
+void OpenglTextureManager::setPixelBufferFunctions(GenBuffersFunction_t genBuffers, BindBufferFunction_t bindBuffer, BufferDataFunction_t bufferData) {
+    this->genBuffers = genBuffers;
+    this->bindBuffer = bindBuffer;
+    this->bufferData = bufferData;
+    this->pixelBufferSupported = genBuffers && bindBuffer && bufferData;
+}
+
+/**
+ * Retrieves the number of bytes uploaded in each frame.
+ *
+ * @return The number of bytes uploaded in each frame.
+ */
+size_t OpenglTextureManager::getUploadBudget() {
+    return this->uploadBudget;
+}
+
+/**
+ * Sets the number of bytes uploaded in each frame.
+ *
+ * @param uploadBudget The number of bytes uploaded in each frame.
+ */
+void OpenglTextureManager::setUploadBudget(size_t uploadBudget) {
+    this->uploadBudget = uploadBudget;
+}
+
+inline void OpenglTextureManager::requestUpload(Texture *texture) {
+    // sets the texture as loading
+    texture->setStatus(LOADING_TEXTURE_STATUS);
+
+    // creates the texture upload
+    TextureUpload_t *textureUpload = new TextureUpload_t();
+    textureUpload->texture = texture;
+    textureUpload->size = 0;
+
+    // creates the texture upload task
+    textureUpload->task = new TextureUploadTask(this, textureUpload);
+
+    // adds the texture upload to the uploads list
+    this->uploadsList.push_back(textureUpload);
+
+    // in case the engine is available
+    if(this->engine) {
+        // adds the task to the engine (worker thread)
+        this->engine->addTask(textureUpload->task);
+    } else {
+        // runs the task (in the current thread)
+        textureUpload->task->run();
+    }
+}
+
+inline void OpenglTextureManager::upload(TextureUpload_t *textureUpload) {
+    // waits for the task to be complete (it may still
+    // be finishing after adding the upload)
+    textureUpload->task->wait();
+
+    // retrieves the texture and the levels list
+    Texture *texture = textureUpload->texture;
+    std::vector<TextureLevel_t> &levelsList = textureUpload->levelsList;
+
+    // allocates the texture handle
+    GLuint handle;
+
+    // allocation space for the texture
+    glGenTextures(1, &handle);
+
+    // binds the current context to the texture
+    glBindTexture(GL_TEXTURE_2D, handle);
+
+    // sets the pixel store policy
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // sets the texture parameters (using the mipmap chain)
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelsList.size() - 1);
+
+    // iterates over all the levels
+    for(unsigned int index = 0; index < levelsList.size(); index++) {
+        // retrieves the level
+        TextureLevel_t &level = levelsList[index];
+
+        // in case the pixel buffers are supported
+        if(this->pixelBufferSupported) {
+            // binds the pixel buffer and sets the level data
+            // (orphaning the previous data)
+            this->bindBuffer(GL_PIXEL_UNPACK_BUFFER, this->pixelBuffer);
+            this->bufferData(GL_PIXEL_UNPACK_BUFFER, level.size.width * level.size.height * sizeof(ImageColor_t), level.buffer, GL_STREAM_DRAW);
+
+            // loads the level (from the pixel buffer)
+            glTexImage2D(GL_TEXTURE_2D, index, GL_RGBA, level.size.width, level.size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *) 0);
+        } else {
+            // loads the level (from the client memory)
+            glTexImage2D(GL_TEXTURE_2D, index, GL_RGBA, level.size.width, level.size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (unsigned char *) level.buffer);
+        }
+    }
+
+    // in case the pixel buffers are supported
+    if(this->pixelBufferSupported) {
+        // unbinds the pixel buffer
+        this->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // sets the texture handle and the loaded status
+    texture->setHandle(handle);
+    texture->setStatus(LOADED_TEXTURE_STATUS);
+
+    // removes the texture upload from the uploads list
+    this->uploadsList.remove(textureUpload);
+
+    // deletes the texture upload
+    this->deleteUpload(textureUpload);
+}
+
+inline void OpenglTextureManager::deleteUpload(TextureUpload_t *textureUpload) {
+    // iterates over all the levels (except the base level
+    // that uses the texture buffer)
+    for(unsigned int index = 1; index < textureUpload->levelsList.size(); index++) {
+        // deletes the level buffer
+        delete[] textureUpload->levelsList[index].buffer;
+    }
+
+    // deletes the task and the texture upload
+    delete textureUpload->task;
+    delete textureUpload;
+}
+
+/**
+ * Constructor of the class.
+ */
+TextureUploadTask::TextureUploadTask() : Task() {
+    this->textureManager = NULL;
+    this->textureUpload = NULL;
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param textureManager The texture manager of the upload.
+ * @param textureUpload The texture upload to be prepared.
+ */
+TextureUploadTask::TextureUploadTask(OpenglTextureManager *textureManager, TextureUpload_t *textureUpload) : Task("texture_upload") {
+    this->textureManager = textureManager;
+    this->textureUpload = textureUpload;
+}
+
+/**
+ * Destructor of the class.
+ */
+TextureUploadTask::~TextureUploadTask() {
+}
+
+void TextureUploadTask::start(void *parameters) {
+    // prepares the texture upload (mipmap chain)
+    this->textureManager->prepareUpload(this->textureUpload);
+
+    // adds the texture upload to the ready uploads
+    this->textureManager->addReadyUpload(this->textureUpload);
+}
+
+#endif
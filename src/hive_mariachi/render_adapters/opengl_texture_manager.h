@@ -0,0 +1,150 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#ifdef MARIACHI_PLATFORM_OPENGL
+
+#include "../main/engine.h"
+#include "../tasks/task.h"
+#include "../structures/texture.h"
+#include "../structures/ring_fifo.h"
+#include "opengl_adapter.h"
+
+/**
+ * The default number of bytes uploaded to the
+ * textures in each frame.
+ */
+#define DEFAULT_TEXTURE_UPLOAD_BUDGET 4194304
+
+/**
+ * The capacity of the fifo of prepared uploads
+ * (handed from the workers to the render thread).
+ */
+#define TEXTURE_UPLOAD_FIFO_SIZE 256
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
+namespace mariachi {
+    namespace render_adapters {
+        class TextureUploadTask;
+
+        /**
+         * A level of the (mipmap) chain of a texture.
+         */
+        typedef struct TextureLevel_t {
+            structures::IntSize2d_t size;
+            structures::ImageColor_t *buffer;
+        } TextureLevel;
+
+        /**
+         * The upload of a texture, prepared in a worker
+         * thread and uploaded in the render thread.
+         */
+        typedef struct TextureUpload_t {
+            structures::Texture *texture;
+            std::vector<TextureLevel_t> levelsList;
+            size_t size;
+            TextureUploadTask *task;
+        } TextureUpload;
+
+        /**
+         * Manages the residency of the textures in the opengl
+         * context, the textures are prepared (mipmap chain) in the
+         * engine worker threads and uploaded in the render thread
+         * under a per frame byte budget (using pixel buffers when
+         * available). The texture handle is stored in the texture
+         * itself, a placeholder texture is used until the upload
+         * is complete.
+         */
+        class OpenglTextureManager {
+            private:
+                Engine *engine;
+                GLuint placeholderHandle;
+                size_t uploadBudget;
+                bool pixelBufferSupported;
+                GLuint pixelBuffer;
+                GenBuffersFunction_t genBuffers;
+                BindBufferFunction_t bindBuffer;
+                BufferDataFunction_t bufferData;
+                std::list<TextureUpload_t *> uploadsList;
+                std::list<TextureUpload_t *> readyUploadsList;
+                structures::RingFifo<TextureUpload_t *> *readyUploadsFifo;
+
+                inline void initPlaceholder();
+                inline void initPixelBuffer();
+                inline void initUploads();
+                inline void requestUpload(structures::Texture *texture);
+                inline void upload(TextureUpload_t *textureUpload);
+                inline void deleteUpload(TextureUpload_t *textureUpload);
+
+            public:
+                OpenglTextureManager();
+                OpenglTextureManager(Engine *engine);
+                ~OpenglTextureManager();
+                void load();
+                void update();
+                GLuint getHandle(structures::Texture *texture);
+                void prepareUpload(TextureUpload_t *textureUpload);
+                void addReadyUpload(TextureUpload_t *textureUpload);
+                void setPixelBufferFunctions(GenBuffersFunction_t genBuffers, BindBufferFunction_t bindBuffer, BufferDataFunction_t bufferData);
+                size_t getUploadBudget();
+                void setUploadBudget(size_t uploadBudget);
+        };
+
+        /**
+         * Task that prepares the upload of a texture (in a
+         * worker thread), creating the mipmap chain.
+         */
+        class TextureUploadTask : public tasks::Task {
+            private:
+                OpenglTextureManager *textureManager;
+                TextureUpload_t *textureUpload;
+
+            public:
+                TextureUploadTask();
+                TextureUploadTask(OpenglTextureManager *textureManager, TextureUpload_t *textureUpload);
+                ~TextureUploadTask();
+                void start(void *parameters);
+        };
+    }
+}
+
+#endif
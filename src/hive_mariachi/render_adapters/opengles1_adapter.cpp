@@ -29,6 +29,7 @@
 
 #include "../main/engine.h"
 #include "../system/system.h"
+#include "../debugging/profiler.h"
 #include "../render/render.h"
 #include "../render_utils/opengles_uikit_window.h"
 #include "definitions/opengles1_adapter_definitions.h"
@@ -37,6 +38,7 @@
 using namespace mariachi::ui;
 using namespace mariachi::nodes;
 using namespace mariachi::render;
+using namespace mariachi::debugging;
 using namespace mariachi::structures;
 using namespace mariachi::render_utils;
 using namespace mariachi::render_adapters;
@@ -141,149 +143,171 @@ void Opengles1Adapter::display() {
     // updates the frame rate
     this->updateFrameRate();
 
+    // retrieves the active profiler
+    Profiler *profiler = Profiler::getActiveProfiler();
+
+    // in case there is an active profiler
+    if(profiler) {
+        // marks the render frame
+        profiler->markFrame(RENDER_FRAME_TIMER_ID);
+    }
+
     // clears all pixels
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // waits for the render information mutex
-    MUTEX_LOCK(this->renderInformation->getMutex());
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
 
-    // displays the 3d scene
-    this->display3d();
+    // acquires the most recent render snapshot
+    RenderSnapshot *renderSnapshot = this->renderInformation->acquireSnapshot();
 
-    // displays the 2d scene
-    this->display2d();
+    // retrieves the render 2d (node)
+    Scene2dNode *render2d = this->renderInformation->getRender2d();
 
-    // releases the render information mutex
+    // releases the render information mutex (the snapshot
+    // is owned by the render adapter until the next acquire)
     MUTEX_UNLOCK(this->renderInformation->getMutex());
 
+    // retrieves the engine
+    Engine *engine = this->getEngine();
+
+    // interpolates the snapshot transforms with the current
+    // interpolation alpha (between the last two simulation states)
+    renderSnapshot->interpolate(engine ? engine->getInterpolationAlpha() : 1.0f);
+
+    // displays the 3d scene
+    this->display3d(renderSnapshot);
+
+    // displays the 2d scene
+    this->display2d(render2d);
+
     // flushes the open gl buffers
     glFlush();
 }
 
-inline void Opengles1Adapter::display2d() {
+inline void Opengles1Adapter::display2d(Scene2dNode *render2d) {
     // setup the display 2d
     this->setupDisplay2d();
 
-    // retrieves the render 2d (node)
-    Scene2dNode *render2d = this->renderInformation->getRender2d();
+    // locks the scene for reading (once for the whole traversal)
+    Node::lockScene();
 
     this->renderNode2d(render2d);
+
+    // unlocks the scene
+    Node::unlockScene();
 }
 
-inline void Opengles1Adapter::display3d() {
+inline void Opengles1Adapter::display3d(RenderSnapshot *renderSnapshot) {
     // setups the display
-    this->setupDisplay3d();
-
-    // retrieves the current active camera
-    CameraNode *activeCamera = this->renderInformation->getActiveCamera();
+    this->setupDisplay3d(renderSnapshot);
 
-    if(activeCamera) {
-        this->renderCameraNode(activeCamera);
+    // in case there is a camera in the snapshot
+    if(renderSnapshot->hasCamera()) {
+        this->renderCamera(renderSnapshot);
     }
 
-    // retrieves the render (node)
-    SceneNode *render = this->renderInformation->getRender();
+    // retrieves the render items list
+    std::vector<RenderItem_t> &renderItemsList = renderSnapshot->getRenderItemsList();
 
-    std::list<Node *> &renderChildrenList = render->getChildrenList();
-
-    std::list<Node *>::iterator renderChildrenListIterator = renderChildrenList.begin();
-
-    while(renderChildrenListIterator != renderChildrenList.end()) {
-        // retrieves the current node
-        Node *node = *renderChildrenListIterator;
-
-        // in case the node is renderable
-        if(node->renderable) {
-            // casts the node as model node
-            ModelNode *modelNode = (ModelNode *) node;
+    // retrieves the (sorted) render queue entries list
+    std::vector<RenderQueueEntry_t> &entriesList = renderSnapshot->getRenderQueue().getEntriesList();
 
-            // retrieves the mesh list
-            std::vector<Mesh_t *> *meshList = modelNode->getMeshList();
+    // retrieves the entries list size
+    size_t entriesListSize = entriesList.size();
 
-            // retrieves the texture
-            Texture *texture = modelNode->getTexture();
+    // the texture of the current batch
+    Texture *batchTexture = NULL;
 
-            // retrieves the position
-            Coordinate3d_t &position = modelNode->getPosition();
-
-            // retrieves the rotation
-            Rotation3d_t &rotation = modelNode->getRotation();
-
-            // retrieves the scale
-            Coordinate3d_t &scale = modelNode->getScale();
+    // enables the client states (for all the batches)
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
 
-            // retrieves the mesh list size
-            size_t meshListSize = meshList->size();
+    // iterates over all the render queue entries (in sort order)
+    for(unsigned int entryIndex = 0; entryIndex < entriesListSize; entryIndex++) {
+        // retrieves the render item for the entry
+        RenderItem_t &renderItem = renderItemsList[entriesList[entryIndex].index];
 
+        // in case the render item starts a new batch
+        if(entryIndex == 0 || renderItem.texture != batchTexture) {
             // sets the texture
-            this->setTexture(texture);
+            this->setTexture(renderItem.texture);
 
-            // pushes the transformation matrix
-            glPushMatrix();
+            // sets the batch texture
+            batchTexture = renderItem.texture;
+        }
 
-            // puts the element in the screen
-            glTranslatef(position.x, position.y, position.z);
+        // retrieves the mesh list
+        std::vector<Mesh_t *> *meshList = renderItem.meshList;
 
-            // scales the element
-            glScalef(scale.x, scale.y, scale.z);
+        // retrieves the mesh list size
+        size_t meshListSize = meshList->size();
 
-            // rotates the element
-            glRotatef(rotation.angle, rotation.x, rotation.y, rotation.z);
+        // pushes the transformation matrix
+        glPushMatrix();
 
-            // enables the client states
-            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glEnableClientState(GL_VERTEX_ARRAY);
+        // multiplies by the (cached) world transform of the element
+        glMultMatrixf(renderItem.transform.values);
 
-            // iterates over all the meshes
-            for(unsigned int index = 0; index < meshListSize; index++) {
-                // retrieves the current mesh
-                Mesh_t *mesh = (*meshList)[index];
+        // iterates over all the meshes
+        for(unsigned int index = 0; index < meshListSize; index++) {
+            // retrieves the current mesh
+            Mesh_t *mesh = (*meshList)[index];
 
-                // retrieves the position
-                Coordinate3d_t position = mesh->position;
+            // retrieves the position
+            Coordinate3d_t position = mesh->position;
 
-                // retrieves the vertex list
-                float *vertexList = mesh->vertexList;
+            // retrieves the vertex list
+            float *vertexList = mesh->vertexList;
 
-                // retrieves the texture vertex list
-                float *textureVertexList = mesh->textureVertexList;
+            // retrieves the texture vertex list
+            float *textureVertexList = mesh->textureVertexList;
 
-                // retrieves the number of vertices
-                unsigned int numberVertices = mesh->numberVertices;
+            // retrieves the number of vertices
+            unsigned int numberVertices = mesh->numberVertices;
 
-                // in case the number of vertices is valid
-                if(numberVertices) {
-                    // creates the vertex pointer
-                    glVertexPointer(3, GL_FLOAT, 0, vertexList);
+            // in case the number of vertices is valid
+            if(numberVertices) {
+                // creates the vertex pointer
+                glVertexPointer(3, GL_FLOAT, 0, vertexList);
 
-                    // creates the texture coordinate pointer
-                    glTexCoordPointer(2, GL_FLOAT, 0, textureVertexList);
+                // creates the texture coordinate pointer
+                glTexCoordPointer(2, GL_FLOAT, 0, textureVertexList);
 
-                    // switches over the mesh type
-                    switch(mesh->type) {
-                        case TRIANGLE:
-                            break;
-                        case TRIANGLE_STRIP:
-                            glDrawArrays(GL_TRIANGLE_STRIP, 0, numberVertices);
-                            break;
-                        case TRIANGLE_FAN:
-                            glDrawArrays(GL_TRIANGLE_FAN, 0, numberVertices);
-                            break;
+                // in case the mesh is indexed (only the 16 bit
+                // indexes are supported)
+                if(mesh->indexList) {
+                    // draws the mesh using the indexes
+                    if(mesh->type == TRIANGLE && mesh->indexType == SHORT_INDEX) {
+                        glDrawElements(GL_TRIANGLES, mesh->numberIndexes, GL_UNSIGNED_SHORT, mesh->indexList);
                     }
-                }
-            }
 
-            // disables the client states
-            glDisableClientState(GL_VERTEX_ARRAY);
-            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+                    // continues the loop
+                    continue;
+                }
 
-            // pops the matrix
-            glPopMatrix();
+                // switches over the mesh type
+                switch(mesh->type) {
+                    case TRIANGLE:
+                        glDrawArrays(GL_TRIANGLES, 0, numberVertices);
+                        break;
+                    case TRIANGLE_STRIP:
+                        glDrawArrays(GL_TRIANGLE_STRIP, 0, numberVertices);
+                        break;
+                    case TRIANGLE_FAN:
+                        glDrawArrays(GL_TRIANGLE_FAN, 0, numberVertices);
+                        break;
+                }
+            }
         }
 
-        // increments the render children list iterator
-        renderChildrenListIterator++;
+        // pops the matrix
+        glPopMatrix();
     }
+
+    // disables the client states
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
 void gluPerspective(float fovy, float aspect, float zNear, float zFar) {
@@ -324,6 +348,15 @@ void Opengles1Adapter::resizeScene(int windowWidth, int windowHeight) {
     // sets the window aspect ratio
     this->windowAspectRatio = (float) this->windowSize.width / (float) this->windowSize.height;
 
+    // waits for the render information mutex
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
+
+    // sets the aspect ratio in the render information (used in the culling)
+    this->renderInformation->setAspectRatio(this->windowAspectRatio);
+
+    // releases the render information mutex
+    MUTEX_UNLOCK(this->renderInformation->getMutex());
+
     // calculates the width and height ration
     this->widthRatio = windowWidth / REFERENCE_WIDTH_2D;
     this->heightRatio = windowHeight / REFERENCE_HEIGHT_2D;
@@ -468,7 +501,7 @@ inline void Opengles1Adapter::setupDisplay2d() {
     glScalef(this->lowestRatio, this->lowestRatio, 0.0);
 }
 
-inline void Opengles1Adapter::setupDisplay3d() {
+inline void Opengles1Adapter::setupDisplay3d(RenderSnapshot *renderSnapshot) {
     // sets the matrix mode to projection
     glMatrixMode(GL_PROJECTION);
 
@@ -482,7 +515,7 @@ inline void Opengles1Adapter::setupDisplay3d() {
     }
 
     // recalculates the glu perspective
-    gluPerspective(45.0, this->windowAspectRatio, 0.3, 1000.0);
+    gluPerspective(renderSnapshot->getFieldOfView(), this->windowAspectRatio, renderSnapshot->getNearDistance(), renderSnapshot->getFarDistance());
 
     // sets the matrix mode to model view
     glMatrixMode(GL_MODELVIEW);
@@ -491,12 +524,12 @@ inline void Opengles1Adapter::setupDisplay3d() {
     glLoadIdentity();
 }
 
-inline void Opengles1Adapter::renderCameraNode(CameraNode *cameraNode) {
+inline void Opengles1Adapter::renderCamera(RenderSnapshot *renderSnapshot) {
     // retrieves the position
-    Coordinate3d_t &position = cameraNode->getPosition();
+    Coordinate3d_t &position = renderSnapshot->getCameraPosition();
 
     // retrieves the rotation
-    Rotation3d_t &rotation = cameraNode->getRotation();
+    Rotation3d_t &rotation = renderSnapshot->getCameraRotation();
 
     // performs the rotation to match the elements orientation
     glRotatef(rotation.angle, rotation.x, rotation.y, rotation.z);
@@ -507,10 +540,10 @@ inline void Opengles1Adapter::renderCameraNode(CameraNode *cameraNode) {
 
 inline void Opengles1Adapter::renderNode2d(Node *node) {
     // retrieves the node children list
-    std::list<Node *> &nodeChildrenList = node->getChildrenList();
+    NodeList &nodeChildrenList = node->getChildrenList();
 
     // retrieves the node children list iterator
-    std::list<Node *>::iterator nodeChildrenListIterator = nodeChildrenList.begin();
+    NodeList::iterator nodeChildrenListIterator = nodeChildrenList.begin();
 
     // iterates over all the node children
     while(nodeChildrenListIterator != nodeChildrenList.end()) {
@@ -60,11 +60,11 @@ namespace mariachi {
 
                 inline time_t clockSeconds();
                 inline void updateFrameRate();
-                inline void display2d();
-                inline void display3d();
+                inline void display2d(nodes::Scene2dNode *render2d);
+                inline void display3d(render::RenderSnapshot *renderSnapshot);
                 inline void setupDisplay2d();
-                inline void setupDisplay3d();
-                inline void renderCameraNode(nodes::CameraNode *cameraNode);
+                inline void setupDisplay3d(render::RenderSnapshot *renderSnapshot);
+                inline void renderCamera(render::RenderSnapshot *renderSnapshot);
                 inline void renderNode2d(nodes::Node *node);
                 inline void renderSquare(float x1, float y1, float x2, float y2);
                 inline void renderViewPortNode(ui::ViewPortNode *viewPortNode, nodes::SquareNode *targetNode);
@@ -27,12 +27,16 @@
 
 #include "render_adapter.h"
 
+using namespace mariachi;
 using namespace mariachi::render_adapters;
 
 /**
  * Constructor of the class.
  */
 RenderAdapter::RenderAdapter() {
+    // initializes the engine
+    this->engine = NULL;
+
     // initializes the layout
     this->initLayout();
 }
@@ -48,6 +52,14 @@ inline void RenderAdapter::initLayout() {
     this->layout = ROTATED_LAYOUT;
 }
 
+Engine *RenderAdapter::getEngine() {
+    return this->engine;
+}
+
+void RenderAdapter::setEngine(Engine *engine) {
+    this->engine = engine;
+}
+
 unsigned int RenderAdapter::getLayout() {
     return this->layout;
 }
@@ -27,6 +27,7 @@
 
 #include "direct3d9_adapter.h"
 #include "direct3d_adapter.h"
+#include "null_adapter.h"
 #include "opengl_adapter.h"
 #include "opengles1_adapter.h"
 #include "opengles_adapter.h"
@@ -58,6 +58,9 @@ void OpenglCocoaWindow::start(void *arguments) {
     startOpenglCocoaWindowFunctionCallerTask->setCallerFunction(&startOpenglCocoaWindow);
     startOpenglCocoaWindowFunctionCallerTask->setCallerArguments(arguments);
 
+    // sets the function caller task to be run in the main thread
+    startOpenglCocoaWindowFunctionCallerTask->setMainThread(true);
+
     // adds the function caller task to the engine task list
     this->engine->addTask(startOpenglCocoaWindowFunctionCallerTask);
 }
@@ -73,6 +76,9 @@ void OpenglCocoaWindow::loop(void *arguments) {
     loopOpenglCocoaWindowFunctionCallerTask->setCallerFunction(&loopOpenglCocoaWindow);
     loopOpenglCocoaWindowFunctionCallerTask->setCallerArguments(arguments);
 
+    // sets the function caller task to be run in the main thread
+    loopOpenglCocoaWindowFunctionCallerTask->setMainThread(true);
+
     // adds the function caller task to the engine task list
     this->engine->addTask(loopOpenglCocoaWindowFunctionCallerTask);
 
@@ -64,6 +64,9 @@ void OpenglesUikitWindow::start(void *arguments) {
     startOpenglesUikitWindowFunctionCallerTask->setCallerFunction(&startOpenglesUikitWindow);
     startOpenglesUikitWindowFunctionCallerTask->setCallerArguments(arguments);
 
+    // sets the function caller task to be run in the main thread
+    startOpenglesUikitWindowFunctionCallerTask->setMainThread(true);
+
     // adds the function caller task to the engine task list
     this->engine->addTask(startOpenglesUikitWindowFunctionCallerTask);
 }
@@ -79,6 +82,9 @@ void OpenglesUikitWindow::loop(void *arguments) {
     loopOpenglesUikitWindowFunctionCallerTask->setCallerFunction(&loopOpenglesUikitWindow);
     loopOpenglesUikitWindowFunctionCallerTask->setCallerArguments(arguments);
 
+    // sets the function caller task to be run in the main thread
+    loopOpenglesUikitWindowFunctionCallerTask->setMainThread(true);
+
     // adds the function caller task to the engine task list
     this->engine->addTask(loopOpenglesUikitWindowFunctionCallerTask);
 
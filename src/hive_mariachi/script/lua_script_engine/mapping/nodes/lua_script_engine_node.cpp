@@ -66,11 +66,23 @@ int LuaNode::getChildrenList(lua_State *luaState) {
     // retrieves self
     Node *self = (Node *) lua_getself(luaState);
 
-    // retrieves the children list
-    std::list<Node *> &childrenList = self->getChildrenList();
+    // creates the (snapshot) children list
+    std::list<Node *> *childrenList = new std::list<Node *>();
+
+    // locks the scene for reading
+    Node::lockScene();
+
+    // retrieves the node children list
+    NodeList &nodeChildrenList = self->getChildrenList();
+
+    // copies the node children into the children list
+    childrenList->insert(childrenList->end(), nodeChildrenList.begin(), nodeChildrenList.end());
+
+    // unlocks the scene
+    Node::unlockScene();
 
     // creates a new lua list object
-    LuaListStructure<Node *> *luaList = new LuaListStructure<Node *>(&childrenList, (LuaConstructor_t) LuaNode::allocate);
+    LuaListStructure<Node *> *luaList = new LuaListStructure<Node *>(childrenList, (LuaConstructor_t) LuaNode::allocate);
 
     // creates and loads a list
     LuaList::allocate<Node *>(luaState, luaList);
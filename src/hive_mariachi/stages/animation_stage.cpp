@@ -0,0 +1,208 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "animation_stage.h"
+
+using namespace mariachi;
+using namespace mariachi::nodes;
+using namespace mariachi::tasks;
+using namespace mariachi::stages;
+
+/**
+ * Constructor of the class.
+ */
+AnimationStage::AnimationStage() : Stage() {
+    this->initThread();
+    this->initResources();
+    this->initActorNodes();
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The currently used engine.
+ */
+AnimationStage::AnimationStage(Engine *engine) : Stage(engine) {
+    this->initThread();
+    this->initResources();
+    this->initActorNodes();
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The currently used engine.
+ * @param name The name of the stage.
+ */
+AnimationStage::AnimationStage(Engine *engine, const std::string &name) : Stage(engine, name) {
+    this->initThread();
+    this->initResources();
+    this->initActorNodes();
+}
+
+/**
+ * Destructor of the class.
+ */
+AnimationStage::~AnimationStage() {
+}
+
+inline void AnimationStage::initThread() {
+    this->thread = true;
+}
+
+inline void AnimationStage::initResources() {
+    this->addWrite(SCENE_GRAPH_RESOURCE);
+}
+
+inline void AnimationStage::initActorNodes() {
+    this->actorNodesRender = NULL;
+    this->actorNodesVersion = 0;
+    this->delta = 0.0f;
+}
+
+void AnimationStage::start(void *arguments) {
+    Stage::start(arguments);
+}
+
+void AnimationStage::stop(void *arguments) {
+    Stage::stop(arguments);
+}
+
+void AnimationStage::update(void *arguments) {
+    Stage::update(arguments);
+
+    // retrieves the render (node)
+    SceneNode *render = this->engine->getRender();
+
+    // in case the render is not available
+    if(!render) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the (cached) actor nodes list
+    std::vector<ActorNode *> &actorNodesList = this->getActorNodesList(render);
+
+    // in case there are no actor nodes
+    if(actorNodesList.empty()) {
+        // returns immediately
+        return;
+    }
+
+    // sets the delta as the simulation timestep
+    this->delta = (float) this->engine->getTimestep();
+
+    // retrieves the job scheduler
+    JobScheduler *jobScheduler = this->engine->getJobScheduler();
+
+    // in case there is a job scheduler
+    if(jobScheduler) {
+        // advances the actor nodes in chunks (jobs)
+        jobScheduler->runRange(actorNodesList.size(), ANIMATION_STAGE_CHUNK_SIZE, AnimationStage::updateActorNodesRange, this, this->jobRangesList);
+    } else {
+        // advances all the actor nodes
+        AnimationStage::updateActorNodesRange(this, 0, actorNodesList.size());
+    }
+
+    // iterates over all the actor nodes
+    for(unsigned int index = 0; index < actorNodesList.size(); index++) {
+        // updates the attached nodes (serially, the attached
+        // nodes mark the shared ancestor nodes as dirty)
+        actorNodesList[index]->updateAttachments();
+    }
+}
+
+/**
+ * Retrieves the list of actor nodes of the given render (node),
+ * the list is cached and only rebuilt when the structure of the
+ * scene changes (scene version).
+ *
+ * @param render The render (node) to retrieve the actor nodes.
+ * @return The list of actor nodes of the render (node).
+ */
+std::vector<ActorNode *> &AnimationStage::getActorNodesList(SceneNode *render) {
+    // locks the scene for reading
+    Node::lockScene();
+
+    // retrieves the current scene version
+    unsigned long sceneVersion = Node::getSceneVersion();
+
+    // in case the render or the scene changed
+    if(render != this->actorNodesRender || sceneVersion != this->actorNodesVersion) {
+        // clears the actor nodes list
+        this->actorNodesList.clear();
+
+        // adds the actor render children nodes
+        this->addActorNodes(render->getChildrenList());
+
+        // sets the render and the scene version of the list
+        this->actorNodesRender = render;
+        this->actorNodesVersion = sceneVersion;
+    }
+
+    // unlocks the scene
+    Node::unlockScene();
+
+    // returns the actor nodes list
+    return this->actorNodesList;
+}
+
+inline void AnimationStage::addActorNodes(NodeList &childrenList) {
+    // iterates over all the children nodes
+    for(unsigned int index = 0; index < childrenList.size(); index++) {
+        // retrieves the current node
+        Node *node = childrenList[index];
+
+        // in case the node is not renderable
+        if(!node->renderable) {
+            // continues the loop
+            continue;
+        }
+
+        // in case the node is an actor node
+        if(node->getNodeType() == ACTOR_NODE_TYPE) {
+            // adds the node (as actor node) to the actor nodes list
+            this->actorNodesList.push_back((ActorNode *) node);
+        }
+
+        // adds the actor children nodes (the same nodes
+        // visited by the render stage)
+        this->addActorNodes(node->getChildrenList());
+    }
+}
+
+void AnimationStage::updateActorNodesRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the animation stage
+    AnimationStage *animationStage = (AnimationStage *) arguments;
+
+    // iterates over all the actor nodes in the range
+    for(unsigned int index = start; index < end; index++) {
+        // advances the actor node animation
+        animationStage->actorNodesList[index]->advanceAnimation(animationStage->delta);
+    }
+}
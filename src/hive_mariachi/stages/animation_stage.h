@@ -0,0 +1,77 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#ifndef MARIACHI_STAGE_ANIMATION
+#define MARIACHI_STAGE_ANIMATION true
+#endif
+
+#include "../nodes/actor_node.h"
+#include "../nodes/scene_node.h"
+#include "stage.h"
+
+/**
+ * The number of actor nodes updated in each job
+ * of the animation stage.
+ */
+#define ANIMATION_STAGE_CHUNK_SIZE 16
+
+namespace mariachi {
+    namespace stages {
+        /**
+         * Stage that advances the animations of all the actor
+         * nodes of the render, in a single pass (split in jobs)
+         * with the simulation timestep.
+         * The attached nodes are updated after the jobs, in
+         * a serial pass (they mark the shared ancestor nodes).
+         */
+        class AnimationStage : public Stage {
+            private:
+                std::vector<nodes::ActorNode *> actorNodesList;
+                nodes::SceneNode *actorNodesRender;
+                unsigned long actorNodesVersion;
+                std::vector<tasks::JobRange_t> jobRangesList;
+                float delta;
+
+                inline void initThread();
+                inline void initResources();
+                inline void initActorNodes();
+                inline void addActorNodes(nodes::NodeList &childrenList);
+                static void updateActorNodesRange(void *arguments, unsigned int start, unsigned int end);
+
+            public:
+                AnimationStage();
+                AnimationStage(Engine *engine);
+                AnimationStage(Engine *engine, const std::string &name);
+                ~AnimationStage();
+                void start(void *arguments);
+                void stop(void *arguments);
+                void update(void *arguments);
+                std::vector<nodes::ActorNode *> &getActorNodesList(nodes::SceneNode *render);
+        };
+    }
+}
@@ -36,6 +36,7 @@ using namespace mariachi::stages;
  * Constructor of the class.
  */
 CameraStage::CameraStage() : Stage() {
+    this->initResources();
 }
 
 /**
@@ -44,6 +45,7 @@ CameraStage::CameraStage() : Stage() {
  * @param engine The currently used engine.
  */
 CameraStage::CameraStage(Engine *engine) : Stage(engine) {
+    this->initResources();
 }
 
 /**
@@ -53,6 +55,7 @@ CameraStage::CameraStage(Engine *engine) : Stage(engine) {
  * @param name The name of the stage.
  */
 CameraStage::CameraStage(Engine *engine, const std::string &name) : Stage(engine, name) {
+    this->initResources();
 }
 
 /**
@@ -61,6 +64,10 @@ CameraStage::CameraStage(Engine *engine, const std::string &name) : Stage(engine
 CameraStage::~CameraStage() {
 }
 
+inline void CameraStage::initResources() {
+    this->addWrite(CAMERA_STATE_RESOURCE);
+}
+
 void CameraStage::start(void *arguments) {
     Stage::start(arguments);
 
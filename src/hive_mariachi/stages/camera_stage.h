@@ -40,6 +40,8 @@ namespace mariachi {
                  */
                 camera::CameraManager *cameraManager;
 
+                inline void initResources();
+
             public:
                 CameraStage();
                 CameraStage(Engine *engine);
@@ -25,6 +25,7 @@
 
 #include "stdafx.h"
 
+#include "stage_runner.h"
 #include "console_stage.h"
 
 using namespace mariachi;
@@ -64,6 +65,7 @@ ConsoleStage::~ConsoleStage() {
 
 inline void ConsoleStage::initThread() {
     this->thread = true;
+    this->dedicatedThread = true;
 }
 
 void ConsoleStage::start(void *arguments) {
@@ -92,6 +94,16 @@ void ConsoleStage::update(void *arguments) {
     // retrieves the current line from standard input
     getline(std::cin, stringBuffer);
 
+    // in case the standard input is closed (no
+    // more lines to be processed)
+    if(std::cin.fail()) {
+        // stops the stage runner (no more updates)
+        this->engine->getStageRunner(this)->stop(NULL);
+
+        // returns immediately
+        return;
+    }
+
     // processes the command line value
     this->consoleManager->processCommandLine(stringBuffer.c_str());
 }
@@ -25,6 +25,12 @@
 
 #pragma once
 
+/**
+ * The name of the null render adapter, used to
+ * run the engine without presentation (headless).
+ */
+#define NULL_RENDER_ADAPTER_NAME "null"
+
 #ifdef MARIACHI_PLATFORM_OPENGL
 #define DEFAULT_RENDER_ADAPTER_CLASS OpenglAdapter
 #elif MARIACHI_PLATFORM_OPENGLES
@@ -0,0 +1,329 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#include "stdafx.h"
+
+#include "../exceptions/exceptions.h"
+
+#include "frame_graph.h"
+
+using namespace mariachi::tasks;
+using namespace mariachi::stages;
+using namespace mariachi::exceptions;
+
+/**
+ * Constructor of the class.
+ */
+FrameGraph::FrameGraph() {
+    this->initJobScheduler(NULL);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param jobScheduler The job scheduler to be used to run the stages.
+ */
+FrameGraph::FrameGraph(JobScheduler *jobScheduler) {
+    this->initJobScheduler(jobScheduler);
+}
+
+/**
+ * Destructor of the class.
+ */
+FrameGraph::~FrameGraph() {
+}
+
+inline void FrameGraph::initJobScheduler(JobScheduler *jobScheduler) {
+    this->jobScheduler = jobScheduler;
+}
+
+/**
+ * Adds a stage runner to the frame graph, the stage runners
+ * are ordered by the order of addition.
+ *
+ * @param stageRunner The stage runner to be added.
+ */
+void FrameGraph::addStageRunner(StageRunner *stageRunner) {
+    this->stageRunnersList.push_back(stageRunner);
+}
+
+/**
+ * Adds a resource read by the presentation (render window), the
+ * stages that write it are synchronized with the presentation.
+ *
+ * @param resource The name of the resource read by the presentation.
+ */
+void FrameGraph::addPresentationRead(const std::string &resource) {
+    this->presentationReadsList.push_back(resource);
+}
+
+/**
+ * Compiles the frame graph, computing the dependencies between
+ * the stages from their resource accesses and splitting them in
+ * pipelined and synchronized stages.
+ */
+void FrameGraph::compile() {
+    // allocates the map associating the stage runner with the index
+    std::map<StageRunner *, unsigned int> stageRunnerIndexMap;
+
+    // allocates the map associating the stage runner with the synchronized flag
+    std::map<StageRunner *, bool> stageRunnerSynchronizedMap;
+
+    // clears the pipelined and synchronized lists
+    this->pipelinedStageRunnersList.clear();
+    this->synchronizedStageRunnersList.clear();
+
+    // iterates over all the stage runners
+    for(unsigned int index = 0; index < this->stageRunnersList.size(); index++) {
+        // retrieves the stage runner and the stage
+        StageRunner *stageRunner = this->stageRunnersList[index];
+        Stage *stage = stageRunner->getStage();
+
+        // retrieves the dependencies list
+        std::vector<StageRunner *> &dependenciesList = stageRunner->getDependenciesList();
+
+        // iterates over all the previous stage runners
+        for(unsigned int previousIndex = 0; previousIndex < index; previousIndex++) {
+            // retrieves the previous stage runner
+            StageRunner *previousStageRunner = this->stageRunnersList[previousIndex];
+
+            // in case the stages conflict and the dependency is not yet set
+            if(this->conflicts(previousStageRunner->getStage(), stage) && std::find(dependenciesList.begin(), dependenciesList.end(), previousStageRunner) == dependenciesList.end()) {
+                // adds the previous stage runner as dependency
+                stageRunner->addDependency(previousStageRunner);
+            }
+        }
+
+        // the stage is synchronized in case it writes a resource read
+        // by the presentation
+        bool synchronized = this->intersects(stage, stage->getWritesList(), this->presentationReadsList);
+
+        // iterates over all the dependencies
+        for(unsigned int dependencyIndex = 0; dependencyIndex < dependenciesList.size(); dependencyIndex++) {
+            // retrieves the dependency stage runner
+            StageRunner *dependencyStageRunner = dependenciesList[dependencyIndex];
+
+            // in case the dependency is not a previous stage
+            if(stageRunnerIndexMap.find(dependencyStageRunner) == stageRunnerIndexMap.end()) {
+                // throws a runtime exception
+                throw RuntimeException("Stage dependency not registered before the stage: " + dependencyStageRunner->getStage()->getName());
+            }
+
+            // in case the dependency is synchronized the stage
+            // must be synchronized too (it can only run after it)
+            if(stageRunnerSynchronizedMap[dependencyStageRunner]) {
+                // sets the synchronized flag
+                synchronized = true;
+            }
+        }
+
+        // sets the stage runner index and synchronized flag
+        stageRunnerIndexMap[stageRunner] = index;
+        stageRunnerSynchronizedMap[stageRunner] = synchronized;
+
+        // in case the stage is synchronized
+        if(synchronized) {
+            // adds the stage runner to the synchronized stage runners list
+            this->synchronizedStageRunnersList.push_back(stageRunner);
+        } else {
+            // adds the stage runner to the pipelined stage runners list
+            this->pipelinedStageRunnersList.push_back(stageRunner);
+        }
+    }
+}
+
+/**
+ * Starts a new frame, preparing the stage jobs and updating
+ * the pipelined stages (not waiting for them).
+ */
+void FrameGraph::startFrame() {
+    // iterates over all the stage runners
+    for(unsigned int index = 0; index < this->stageRunnersList.size(); index++) {
+        // retrieves the stage runner
+        StageRunner *stageRunner = this->stageRunnersList[index];
+
+        // initializes the stage runner job, main thread stages
+        // use an empty job (only used to release the dependents)
+        this->jobScheduler->initJob(stageRunner->getJob(), stageRunner->getStage()->requiresThread() ? stageRunnerJob : NULL, stageRunner);
+    }
+
+    // iterates over all the stage runners
+    for(unsigned int index = 0; index < this->stageRunnersList.size(); index++) {
+        // retrieves the stage runner
+        StageRunner *stageRunner = this->stageRunnersList[index];
+
+        // retrieves the dependencies list
+        std::vector<StageRunner *> &dependenciesList = stageRunner->getDependenciesList();
+
+        // iterates over all the dependencies
+        for(unsigned int dependencyIndex = 0; dependencyIndex < dependenciesList.size(); dependencyIndex++) {
+            // adds the dependency job to the stage runner job
+            this->jobScheduler->addDependency(stageRunner->getJob(), dependenciesList[dependencyIndex]->getJob());
+        }
+    }
+
+    // updates the pipelined stage runners
+    this->updateStageRunners(this->pipelinedStageRunnersList);
+}
+
+/**
+ * Updates the synchronized stages, waiting for them to finish.
+ * Must be called with the presentation synchronized.
+ */
+void FrameGraph::update() {
+    // updates the synchronized stage runners
+    this->updateStageRunners(this->synchronizedStageRunnersList);
+
+    // joins the synchronized stage runners
+    this->joinStageRunners(this->synchronizedStageRunnersList);
+}
+
+/**
+ * Ends the frame, waiting for the pipelined stages to finish.
+ */
+void FrameGraph::endFrame() {
+    // joins the pipelined stage runners
+    this->joinStageRunners(this->pipelinedStageRunnersList);
+}
+
+/**
+ * Retrieves the stage runners list.
+ *
+ * @return The stage runners list.
+ */
+std::vector<StageRunner *> &FrameGraph::getStageRunnersList() {
+    return this->stageRunnersList;
+}
+
+/**
+ * Retrieves the pipelined stage runners list.
+ *
+ * @return The pipelined stage runners list.
+ */
+std::vector<StageRunner *> &FrameGraph::getPipelinedStageRunnersList() {
+    return this->pipelinedStageRunnersList;
+}
+
+/**
+ * Retrieves the synchronized stage runners list.
+ *
+ * @return The synchronized stage runners list.
+ */
+std::vector<StageRunner *> &FrameGraph::getSynchronizedStageRunnersList() {
+    return this->synchronizedStageRunnersList;
+}
+
+/**
+ * Retrieves the job scheduler.
+ *
+ * @return The job scheduler.
+ */
+JobScheduler *FrameGraph::getJobScheduler() {
+    return this->jobScheduler;
+}
+
+/**
+ * Sets the job scheduler.
+ *
+ * @param jobScheduler The job scheduler.
+ */
+void FrameGraph::setJobScheduler(JobScheduler *jobScheduler) {
+    this->jobScheduler = jobScheduler;
+}
+
+inline bool FrameGraph::intersects(Stage *stage, std::list<std::string> &resourcesList, std::list<std::string> &otherResourcesList) {
+    // in case the stage does not declare resources
+    // it accesses all of them
+    if(!stage->declaresResources()) {
+        // returns in case there are other resources
+        return !otherResourcesList.empty();
+    }
+
+    // retrieves the resources list iterator
+    std::list<std::string>::iterator resourcesListIterator = resourcesList.begin();
+
+    // iterates over all the resources
+    while(resourcesListIterator != resourcesList.end()) {
+        // in case the resource exists in the other resources
+        if(std::find(otherResourcesList.begin(), otherResourcesList.end(), *resourcesListIterator) != otherResourcesList.end()) {
+            // returns true
+            return true;
+        }
+
+        // increments the resources list iterator
+        resourcesListIterator++;
+    }
+
+    // returns false
+    return false;
+}
+
+inline bool FrameGraph::conflicts(Stage *stage, Stage *otherStage) {
+    // in case any of the stages does not declare resources
+    if(!stage->declaresResources() || !otherStage->declaresResources()) {
+        // returns true (conservative)
+        return true;
+    }
+
+    // the stages conflict in case one writes a resource
+    // the other reads or writes
+    return this->intersects(stage, stage->getWritesList(), otherStage->getReadsList())
+        || this->intersects(stage, stage->getWritesList(), otherStage->getWritesList())
+        || this->intersects(otherStage, otherStage->getWritesList(), stage->getReadsList());
+}
+
+inline void FrameGraph::updateStageRunners(std::vector<StageRunner *> &stageRunnersList) {
+    // iterates over all the stage runners
+    for(unsigned int index = 0; index < stageRunnersList.size(); index++) {
+        // retrieves the stage runner
+        StageRunner *stageRunner = stageRunnersList[index];
+
+        // in case the stage is to be run in the main thread
+        if(!stageRunner->getStage()->requiresThread()) {
+            // retrieves the dependencies list
+            std::vector<StageRunner *> &dependenciesList = stageRunner->getDependenciesList();
+
+            // iterates over all the dependencies
+            for(unsigned int dependencyIndex = 0; dependencyIndex < dependenciesList.size(); dependencyIndex++) {
+                // waits for the dependency job
+                this->jobScheduler->wait(dependenciesList[dependencyIndex]->getJob());
+            }
+
+            // updates the stage runner (in the main thread)
+            stageRunner->update(NULL);
+        }
+
+        // submits the stage runner job
+        this->jobScheduler->submit(stageRunner->getJob());
+    }
+}
+
+inline void FrameGraph::joinStageRunners(std::vector<StageRunner *> &stageRunnersList) {
+    // iterates over all the stage runners
+    for(unsigned int index = 0; index < stageRunnersList.size(); index++) {
+        // waits for the stage runner job
+        this->jobScheduler->wait(stageRunnersList[index]->getJob());
+    }
+}
@@ -0,0 +1,71 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+#include "../tasks/job_scheduler.h"
+#include "stage_runner.h"
+
+namespace mariachi {
+    namespace stages {
+        /**
+         * The graph of stages updated in each frame, the stage
+         * ordering is computed from the resources read and written
+         * by each stage (in registration order).
+         * The stages that do not write resources read by the presentation
+         * are pipelined, running while the previous frame is presented.
+         */
+        class FrameGraph {
+            private:
+                tasks::JobScheduler *jobScheduler;
+                std::vector<StageRunner *> stageRunnersList;
+                std::list<std::string> presentationReadsList;
+                std::vector<StageRunner *> pipelinedStageRunnersList;
+                std::vector<StageRunner *> synchronizedStageRunnersList;
+
+                inline void initJobScheduler(tasks::JobScheduler *jobScheduler);
+                inline bool intersects(Stage *stage, std::list<std::string> &resourcesList, std::list<std::string> &otherResourcesList);
+                inline bool conflicts(Stage *stage, Stage *otherStage);
+                inline void updateStageRunners(std::vector<StageRunner *> &stageRunnersList);
+                inline void joinStageRunners(std::vector<StageRunner *> &stageRunnersList);
+
+            public:
+                FrameGraph();
+                FrameGraph(tasks::JobScheduler *jobScheduler);
+                ~FrameGraph();
+                void addStageRunner(StageRunner *stageRunner);
+                void addPresentationRead(const std::string &resource);
+                void compile();
+                void startFrame();
+                void update();
+                void endFrame();
+                std::vector<StageRunner *> &getStageRunnersList();
+                std::vector<StageRunner *> &getPipelinedStageRunnersList();
+                std::vector<StageRunner *> &getSynchronizedStageRunnersList();
+                tasks::JobScheduler *getJobScheduler();
+                void setJobScheduler(tasks::JobScheduler *jobScheduler);
+        };
+    }
+}
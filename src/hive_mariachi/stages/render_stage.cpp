@@ -25,15 +25,24 @@
 
 #include "stdafx.h"
 
+#include "../debugging/profiler.h"
+#include "../configuration/configuration.h"
+#include "../util/box_util.h"
+#include "../util/frustum_util.h"
+#include "../util/matrix_util.h"
 #include "../render_adapters/render_adapters.h"
 #include "definitions/render_stage_definitions.h"
 
 #include "render_stage.h"
 
 using namespace mariachi;
+using namespace mariachi::nodes;
+using namespace mariachi::util;
 using namespace mariachi::render;
+using namespace mariachi::debugging;
 using namespace mariachi::stages;
 using namespace mariachi::render_adapters;
+using namespace mariachi::structures;
 
 THREAD_RETURN mariachi::stages::renderRunnerThread(THREAD_ARGUMENTS parameters) {
     // retrieves the render adapter
@@ -51,7 +60,10 @@ THREAD_RETURN mariachi::stages::renderRunnerThread(THREAD_ARGUMENTS parameters)
  */
 RenderStage::RenderStage() : Stage() {
     this->initThread();
+    this->initResources();
     this->initRenderInformation();
+    this->initFrameNumber();
+    this->initRenderableNodes();
 }
 
 /**
@@ -61,7 +73,10 @@ RenderStage::RenderStage() : Stage() {
  */
 RenderStage::RenderStage(Engine *engine) : Stage(engine) {
     this->initThread();
+    this->initResources();
     this->initRenderInformation();
+    this->initFrameNumber();
+    this->initRenderableNodes();
 }
 
 /**
@@ -72,7 +87,10 @@ RenderStage::RenderStage(Engine *engine) : Stage(engine) {
  */
 RenderStage::RenderStage(Engine *engine, const std::string &name) : Stage(engine, name) {
     this->initThread();
+    this->initResources();
     this->initRenderInformation();
+    this->initFrameNumber();
+    this->initRenderableNodes();
 }
 
 /**
@@ -84,7 +102,10 @@ RenderStage::RenderStage(Engine *engine, const std::string &name) : Stage(engine
  */
 RenderStage::RenderStage(Engine *engine, const std::string &name, RenderSystem renderSystem) : Stage(engine, name) {
     this->initThread();
+    this->initResources();
     this->initRenderInformation();
+    this->initFrameNumber();
+    this->initRenderableNodes();
     this->renderSystem = renderSystem;
 }
 
@@ -99,18 +120,43 @@ inline void RenderStage::initThread() {
     this->thread = true;
 }
 
+inline void RenderStage::initResources() {
+    this->addRead(SCENE_GRAPH_RESOURCE);
+    this->addRead(CAMERA_STATE_RESOURCE);
+    this->addWrite(RENDER_INFORMATION_RESOURCE);
+}
+
 inline void RenderStage::initRenderInformation() {
     this->renderInformation = new RenderInformation();
 }
 
+inline void RenderStage::initFrameNumber() {
+    this->frameNumber = 0;
+    this->aspectRatio = DEFAULT_ASPECT_RATIO;
+}
+
+inline void RenderStage::initRenderableNodes() {
+    this->renderableNodesRender = NULL;
+    this->renderableNodesVersion = 0;
+}
+
 void RenderStage::start(void *arguments) {
     Stage::start(arguments);
 
     // TENHO DE ADICIONAR TODOS OS ADAPTERS DISPONIVEIS
     // E DEPOIS FAZER SET SO DO MEU PRINCIAPL (por defined)
 
-    // creates the render adapter
-    this->renderAdapter = new DEFAULT_RENDER_ADAPTER_CLASS();
+    // retrieves the render adapter value from the configuration
+    ConfigurationValue_t *renderAdapterProperty = this->engine->getConfigurationManager()->getProperty("render/adapter");
+
+    // in case the null render adapter is defined in the configuration
+    if(renderAdapterProperty && *renderAdapterProperty->structure.stringValue == NULL_RENDER_ADAPTER_NAME) {
+        // creates the null render adapter (headless)
+        this->renderAdapter = new NullAdapter();
+    } else {
+        // creates the render adapter
+        this->renderAdapter = new DEFAULT_RENDER_ADAPTER_CLASS();
+    }
 
     // allocates space for the render arguments
     char *renderArguments = (char *) malloc(sizeof(int) + sizeof(char **) + sizeof(RenderInformation *) + sizeof(RenderAdapter *) + sizeof(Engine *));
@@ -150,12 +196,24 @@ void RenderStage::stop(void *arguments) {
 void RenderStage::update(void *arguments) {
     Stage::update(arguments);
 
+    // retrieves the back snapshot (not used by the render adapter)
+    RenderSnapshot *renderSnapshot = this->renderInformation->getBackSnapshot();
+
+    // updates the back snapshot (outside the render information mutex)
+    this->updateRenderSnapshot(renderSnapshot);
+
     // waits for the render information mutex
-    MUTEX_LOCK(this->renderInformation->getMutex());
+    Profiler::lockMutex(this->renderInformation->getMutex(), RENDER_INFORMATION_LOCK_TIMER_ID);
 
     // updates the render information
     this->updateRenderInformation(this->renderInformation);
 
+    // retrieves the aspect ratio (used in the culling of the next frame)
+    this->aspectRatio = this->renderInformation->getAspectRatio();
+
+    // publishes the back snapshot to the render adapter
+    this->renderInformation->publishSnapshot();
+
     // releases the render information mutex
     MUTEX_UNLOCK(this->renderInformation->getMutex());
 }
@@ -165,3 +223,353 @@ void RenderStage::updateRenderInformation(RenderInformation *renderInformation)
     renderInformation->setRender2d(this->engine->getRender2d());
     renderInformation->setActiveCamera(this->engine->getActiveCamera());
 }
+
+/**
+ * Updates the given render snapshot with the current state
+ * of the scene graph, copying the transforms, meshes and textures
+ * of the renderable nodes and the active camera.
+ *
+ * @param renderSnapshot The render snapshot to be updated.
+ */
+void RenderStage::updateRenderSnapshot(RenderSnapshot *renderSnapshot) {
+    // clears the render snapshot
+    renderSnapshot->clear();
+
+    // sets the render snapshot frame number
+    renderSnapshot->setFrameNumber(this->frameNumber++);
+
+    // retrieves the current active camera
+    CameraNode *activeCamera = this->engine->getActiveCamera();
+
+    // in case there is a camera node selected
+    if(activeCamera) {
+        // sets the camera and the lens in the render snapshot
+        renderSnapshot->setCamera(activeCamera->getPosition(), activeCamera->getRotation());
+        renderSnapshot->setLens(activeCamera->getFieldOfView(), activeCamera->getNearDistance(), activeCamera->getFarDistance());
+    }
+
+    // retrieves the render (node)
+    SceneNode *render = this->engine->getRender();
+
+    // in case the render is not available
+    if(!render) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the transform store
+    TransformStore *transformStore = this->engine->getTransformStore();
+
+    // in case there is a transform store
+    if(transformStore) {
+        // updates the (local) transforms of the changed handles
+        // in a single streaming pass
+        transformStore->updateTransforms();
+    }
+
+    // updates the (world) transforms of the changed nodes
+    render->updateTransforms();
+
+    // allocates the render item
+    RenderItem_t renderItem;
+
+    // retrieves the (cached) renderable nodes list
+    std::vector<ModelNode *> &renderableNodesList = this->getRenderableNodesList(render);
+
+    // iterates over all the renderable nodes
+    for(unsigned int index = 0; index < renderableNodesList.size(); index++) {
+        // retrieves the current model node
+        ModelNode *modelNode = renderableNodesList[index];
+
+        // retrieves the (world) transform of the model node
+        Matrix4d_t &transform = modelNode->getTransform();
+
+        // copies the model node state into the render item, the
+        // previous transform is the one of the last snapshot
+        renderItem.transform = transform;
+        renderItem.previousTransform = this->previousTransformsList[index];
+        renderItem.currentTransform = transform;
+        renderItem.meshList = modelNode->getMeshList();
+        renderItem.texture = modelNode->getTexture();
+
+        // sets the transform as the previous one (for the next snapshot)
+        this->previousTransformsList[index] = transform;
+
+        // in case the render item contains meshes
+        if(renderItem.meshList && !renderItem.meshList->empty()) {
+            // adds the render item to the render snapshot
+            renderSnapshot->addRenderItem(renderItem);
+        }
+    }
+
+    // resolves the dynamic meshes copied into the render snapshot
+    renderSnapshot->resolveDynamicMeshes();
+
+    // culls the render snapshot (filling the render queue)
+    this->cullRenderSnapshot(renderSnapshot);
+}
+
+/**
+ * Retrieves the list of renderable nodes of the given render (node),
+ * the list is cached and only rebuilt when the structure of the
+ * scene changes (scene version).
+ *
+ * @param render The render (node) to retrieve the renderable nodes.
+ * @return The list of renderable nodes of the render (node).
+ */
+std::vector<ModelNode *> &RenderStage::getRenderableNodesList(SceneNode *render) {
+    // locks the scene for reading
+    Node::lockScene();
+
+    // retrieves the current scene version
+    unsigned long sceneVersion = Node::getSceneVersion();
+
+    // in case the render or the scene changed
+    if(render != this->renderableNodesRender || sceneVersion != this->renderableNodesVersion) {
+        // clears the renderable nodes list
+        this->renderableNodesList.clear();
+
+        // clears the mesh list box map (the mesh lists of the
+        // removed nodes may be released and their addresses reused)
+        this->meshListBoxMap.clear();
+
+        // clears the texture and mesh key maps, the keys only
+        // group the items of a frame so the keys of the removed
+        // textures and mesh lists are released for reuse
+        this->textureKeyMap.clear();
+        this->meshKeyMap.clear();
+
+        // adds the renderable render children nodes
+        this->addRenderableNodes(render->getChildrenList());
+
+        // clears the previous transforms list
+        this->previousTransformsList.clear();
+
+        // iterates over all the renderable nodes
+        for(unsigned int index = 0; index < this->renderableNodesList.size(); index++) {
+            // sets the current transform as the previous one (no
+            // interpolation in the first snapshot of the node)
+            this->previousTransformsList.push_back(this->renderableNodesList[index]->getTransform());
+        }
+
+        // sets the render and the scene version of the list
+        this->renderableNodesRender = render;
+        this->renderableNodesVersion = sceneVersion;
+    }
+
+    // unlocks the scene
+    Node::unlockScene();
+
+    // returns the renderable nodes list
+    return this->renderableNodesList;
+}
+
+inline void RenderStage::addRenderableNodes(NodeList &childrenList) {
+    // iterates over all the children nodes
+    for(unsigned int index = 0; index < childrenList.size(); index++) {
+        // retrieves the current node
+        Node *node = childrenList[index];
+
+        // in case the node is not renderable
+        if(!node->renderable) {
+            // continues the loop
+            continue;
+        }
+
+        // adds the node (as model node) to the renderable nodes list
+        this->renderableNodesList.push_back((ModelNode *) node);
+
+        // adds the renderable children nodes (sub models
+        // attached to the model)
+        this->addRenderableNodes(node->getChildrenList());
+    }
+}
+
+/**
+ * Culls the render items of the given render snapshot against the
+ * frustum of the snapshot camera, the visible render items are added
+ * to the (sorted) render queue.
+ *
+ * @param renderSnapshot The render snapshot to be culled.
+ */
+void RenderStage::cullRenderSnapshot(RenderSnapshot *renderSnapshot) {
+    // retrieves the render items list and the render queue
+    std::vector<RenderItem_t> &renderItemsList = renderSnapshot->getRenderItemsList();
+    RenderQueue &renderQueue = renderSnapshot->getRenderQueue();
+
+    // retrieves the number of render items
+    unsigned int numberRenderItems = renderItemsList.size();
+
+    // resizes the visible list (all visible by default)
+    this->visibleList.assign(numberRenderItems, 1);
+
+    // in case there is a camera in the snapshot
+    if(renderSnapshot->hasCamera() && numberRenderItems) {
+        // resizes the bounds lists
+        this->minimumXList.resize(numberRenderItems);
+        this->minimumYList.resize(numberRenderItems);
+        this->minimumZList.resize(numberRenderItems);
+        this->maximumXList.resize(numberRenderItems);
+        this->maximumYList.resize(numberRenderItems);
+        this->maximumZList.resize(numberRenderItems);
+
+        // iterates over all the render items
+        for(unsigned int index = 0; index < numberRenderItems; index++) {
+            // retrieves the render item
+            RenderItem_t &renderItem = renderItemsList[index];
+
+            // calculates the (world) bounding box of the render item
+            Box3d_t box = MatrixUtil::transformBox(this->getMeshListBox(renderItem.meshList), renderItem.transform);
+
+            // sets the bounding box in the bounds lists
+            this->minimumXList[index] = box.x1;
+            this->minimumYList[index] = box.y1;
+            this->minimumZList[index] = box.z1;
+            this->maximumXList[index] = box.x2;
+            this->maximumYList[index] = box.y2;
+            this->maximumZList[index] = box.z2;
+        }
+
+        // creates the frustum for the snapshot camera and lens
+        Frustum3d_t frustum = FrustumUtil::createFrustum(renderSnapshot->getFieldOfView(), this->aspectRatio, renderSnapshot->getNearDistance(), renderSnapshot->getFarDistance(), renderSnapshot->getCameraPosition(), renderSnapshot->getCameraRotation());
+
+        // culls the bounding boxes against the frustum
+        FrustumUtil::cullBoxes(frustum, &this->minimumXList[0], &this->minimumYList[0], &this->minimumZList[0], &this->maximumXList[0], &this->maximumYList[0], &this->maximumZList[0], numberRenderItems, &this->visibleList[0]);
+    }
+
+    // in case the key maps reached the number of keys of the
+    // sort key (the new keys would wrap and merge the groups)
+    if(this->textureKeyMap.size() >= (1 << RENDER_QUEUE_TEXTURE_BITS) || this->meshKeyMap.size() >= (1 << RENDER_QUEUE_MESH_BITS)) {
+        // clears the texture and mesh key maps (the keys are
+        // reused from the start)
+        this->textureKeyMap.clear();
+        this->meshKeyMap.clear();
+    }
+
+    // iterates over all the render items
+    for(unsigned int index = 0; index < numberRenderItems; index++) {
+        // in case the render item is visible
+        if(this->visibleList[index]) {
+            // adds the render item to the render queue (with the sort key)
+            renderQueue.addEntry(this->getSortKey(renderItemsList[index], renderSnapshot), index);
+        }
+    }
+
+    // sorts the render queue (batching the render items state)
+    renderQueue.sort();
+}
+
+/**
+ * Retrieves the (local) bounding box of the given mesh list, the
+ * bounding box is computed from the mesh vertices the first time
+ * the mesh list is used (and cached until the scene changes).
+ * The box of a mesh list with dynamic meshes is computed in every
+ * call (the vertices change in each frame).
+ *
+ * @param meshList The mesh list to retrieve the bounding box.
+ * @return The (local) bounding box of the mesh list.
+ */
+Box3d_t &RenderStage::getMeshListBox(std::vector<Mesh_t *> *meshList) {
+    // retrieves the mesh list box (from the mesh list box map)
+    std::map<std::vector<Mesh_t *> *, Box3d_t>::iterator meshListBoxIterator = this->meshListBoxMap.find(meshList);
+
+    // in case the mesh list box is already computed
+    if(meshListBoxIterator != this->meshListBoxMap.end()) {
+        // returns the mesh list box
+        return meshListBoxIterator->second;
+    }
+
+    // starts the box with the inverted maximum extents
+    Box3d_t box = { FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    // unsets the dynamic flag
+    bool dynamic = false;
+
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshList->size(); index++) {
+        // retrieves the current mesh
+        Mesh_t *mesh = (*meshList)[index];
+
+        // updates the dynamic flag (vertices changing in each frame)
+        dynamic |= mesh->dynamic;
+
+        // iterates over all the vertices
+        for(unsigned int vertexIndex = 0; vertexIndex < mesh->numberVertices; vertexIndex++) {
+            // retrieves the vertex
+            float *vertex = &mesh->vertexList[vertexIndex * 3];
+
+            // extends the box with the vertex
+            box.x1 = vertex[0] < box.x1 ? vertex[0] : box.x1;
+            box.y1 = vertex[1] < box.y1 ? vertex[1] : box.y1;
+            box.z1 = vertex[2] < box.z1 ? vertex[2] : box.z1;
+            box.x2 = vertex[0] > box.x2 ? vertex[0] : box.x2;
+            box.y2 = vertex[1] > box.y2 ? vertex[1] : box.y2;
+            box.z2 = vertex[2] > box.z2 ? vertex[2] : box.z2;
+        }
+    }
+
+    // in case no vertex was found
+    if(box.x1 > box.x2) {
+        // sets the empty box (in the origin)
+        box = BoxUtil::createBox(0.0f, 0.0f, 0.0f);
+    }
+
+    // in case the mesh list is dynamic (the box changes
+    // in each frame and is not cached)
+    if(dynamic) {
+        // sets the dynamic mesh list box and returns it
+        return this->dynamicMeshListBox = box;
+    }
+
+    // sets the box in the mesh list box map and returns it
+    return this->meshListBoxMap[meshList] = box;
+}
+
+/**
+ * Retrieves the sort key for the given render item, the key
+ * groups the items by texture and mesh list and orders them
+ * by the (squared) distance to the camera.
+ *
+ * @param renderItem The render item to retrieve the sort key.
+ * @param renderSnapshot The render snapshot containing the camera.
+ * @return The sort key for the given render item.
+ */
+unsigned long long RenderStage::getSortKey(RenderItem_t &renderItem, RenderSnapshot *renderSnapshot) {
+    // retrieves the texture key (from the texture key map)
+    std::map<Texture *, unsigned int>::iterator textureKeyIterator = this->textureKeyMap.find(renderItem.texture);
+
+    // in case the texture does not have a key
+    if(textureKeyIterator == this->textureKeyMap.end()) {
+        // creates a new key for the texture
+        textureKeyIterator = this->textureKeyMap.insert(std::make_pair(renderItem.texture, (unsigned int) this->textureKeyMap.size())).first;
+    }
+
+    // retrieves the mesh key (from the mesh key map)
+    std::map<std::vector<Mesh_t *> *, unsigned int>::iterator meshKeyIterator = this->meshKeyMap.find(renderItem.meshList);
+
+    // in case the mesh list does not have a key
+    if(meshKeyIterator == this->meshKeyMap.end()) {
+        // creates a new key for the mesh list
+        meshKeyIterator = this->meshKeyMap.insert(std::make_pair(renderItem.meshList, (unsigned int) this->meshKeyMap.size())).first;
+    }
+
+    // starts the depth
+    float depth = 0.0;
+
+    // in case there is a camera in the snapshot
+    if(renderSnapshot->hasCamera()) {
+        // retrieves the camera position
+        Coordinate3d_t &cameraPosition = renderSnapshot->getCameraPosition();
+
+        // calculates the distance components
+        float distanceX = renderItem.transform.values[12] - cameraPosition.x;
+        float distanceY = renderItem.transform.values[13] - cameraPosition.y;
+        float distanceZ = renderItem.transform.values[14] - cameraPosition.z;
+
+        // calculates the squared distance
+        depth = distanceX * distanceX + distanceY * distanceY + distanceZ * distanceZ;
+    }
+
+    // creates the sort key
+    return RenderQueue::createSortKey(textureKeyIterator->second, meshKeyIterator->second, depth);
+}
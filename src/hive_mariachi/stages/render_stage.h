@@ -45,9 +45,30 @@ namespace mariachi {
                 render::RenderInformation *renderInformation;
                 THREAD_HANDLE renderAdapterThreadHandle;
                 THREAD_IDENTIFIER renderAdapterThreadIdentifier;
+                unsigned int frameNumber;
+                std::map<structures::Texture *, unsigned int> textureKeyMap;
+                std::map<std::vector<structures::Mesh_t *> *, unsigned int> meshKeyMap;
+                std::map<std::vector<structures::Mesh_t *> *, structures::Box3d_t> meshListBoxMap;
+                structures::Box3d_t dynamicMeshListBox;
+                std::vector<float> minimumXList;
+                std::vector<float> minimumYList;
+                std::vector<float> minimumZList;
+                std::vector<float> maximumXList;
+                std::vector<float> maximumYList;
+                std::vector<float> maximumZList;
+                std::vector<unsigned char> visibleList;
+                std::vector<nodes::ModelNode *> renderableNodesList;
+                std::vector<structures::Matrix4d_t> previousTransformsList;
+                nodes::SceneNode *renderableNodesRender;
+                unsigned long renderableNodesVersion;
+                float aspectRatio;
 
                 inline void initThread();
+                inline void initResources();
                 inline void initRenderInformation();
+                inline void initFrameNumber();
+                inline void initRenderableNodes();
+                inline void addRenderableNodes(nodes::NodeList &childrenList);
 
             public:
                 RenderStage();
@@ -59,6 +80,11 @@ namespace mariachi {
                 void stop(void *arguments);
                 void update(void *arguments);
                 void updateRenderInformation(render::RenderInformation *renderInformation);
+                void updateRenderSnapshot(render::RenderSnapshot *renderSnapshot);
+                void cullRenderSnapshot(render::RenderSnapshot *renderSnapshot);
+                std::vector<nodes::ModelNode *> &getRenderableNodesList(nodes::SceneNode *render);
+                structures::Box3d_t &getMeshListBox(std::vector<structures::Mesh_t *> *meshList);
+                unsigned long long getSortKey(render::RenderItem_t &renderItem, render::RenderSnapshot *renderSnapshot);
         };
 
         THREAD_RETURN renderRunnerThread(THREAD_ARGUMENTS parameters);
@@ -67,6 +67,7 @@ Stage::~Stage() {
 
 inline void Stage::initThread() {
     this->thread = false;
+    this->dedicatedThread = false;
 }
 
 inline void Stage::initEngine(Engine *engine) {
@@ -139,6 +140,64 @@ bool Stage::requiresThread() {
     return this->thread;
 }
 
+/**
+ * Retrieves if the stage requires a dedicated thread, this is the
+ * case for stages whose update blocks (and so can not be scheduled as a job).
+ *
+ * @return If the stage requires a dedicated thread.
+ */
+bool Stage::requiresDedicatedThread() {
+    return this->dedicatedThread;
+}
+
+/**
+ * Declares a read access of the stage to the given resource,
+ * used to compute the stage ordering in the frame graph.
+ *
+ * @param resource The name of the resource read by the stage.
+ */
+void Stage::addRead(const std::string &resource) {
+    this->readsList.push_back(resource);
+}
+
+/**
+ * Declares a write access of the stage to the given resource,
+ * used to compute the stage ordering in the frame graph.
+ *
+ * @param resource The name of the resource written by the stage.
+ */
+void Stage::addWrite(const std::string &resource) {
+    this->writesList.push_back(resource);
+}
+
+/**
+ * Retrieves if the stage declares its resource accesses, the
+ * stages that do not are considered to access all the resources.
+ *
+ * @return If the stage declares its resource accesses.
+ */
+bool Stage::declaresResources() {
+    return !this->readsList.empty() || !this->writesList.empty();
+}
+
+/**
+ * Retrieves the reads list.
+ *
+ * @return The reads list.
+ */
+std::list<std::string> &Stage::getReadsList() {
+    return this->readsList;
+}
+
+/**
+ * Retrieves the writes list.
+ *
+ * @return The writes list.
+ */
+std::list<std::string> &Stage::getWritesList() {
+    return this->writesList;
+}
+
 /**
  * Retrieves the name.
  *
@@ -27,14 +27,40 @@
 
 #include "../main/engine.h"
 #include "../main/module.h"
-#include "../structures/fifo.h"
+
+/**
+ * The scene graph resource (3d and 2d nodes hierarchy).
+ */
+#define SCENE_GRAPH_RESOURCE "scene_graph"
+
+/**
+ * The camera state resource (active camera and transitions).
+ */
+#define CAMERA_STATE_RESOURCE "camera_state"
+
+/**
+ * The physics state resource (physics engine world).
+ */
+#define PHYSICS_STATE_RESOURCE "physics_state"
+
+/**
+ * The input state resource (input devices event queues).
+ */
+#define INPUT_STATE_RESOURCE "input_state"
+
+/**
+ * The render information resource (state handed to the
+ * render adapter).
+ */
+#define RENDER_INFORMATION_RESOURCE "render_information"
 
 namespace mariachi {
     namespace stages {
         class Stage : public Module {
             private:
                 std::string name;
-                structures::Fifo<bool> fifo;
+                std::list<std::string> readsList;
+                std::list<std::string> writesList;
 
                 inline void initThread();
                 inline void initEngine(Engine *engine);
@@ -43,6 +69,7 @@ namespace mariachi {
             protected:
                 Engine *engine;
                 bool thread;
+                bool dedicatedThread;
 
             public:
                 Stage();
@@ -59,36 +86,16 @@ namespace mariachi {
                 virtual void critical(const std::string &value) { };
                 virtual std::string formatLoggerValue(const std::string &value);
                 bool requiresThread();
+                bool requiresDedicatedThread();
+                void addRead(const std::string &resource);
+                void addWrite(const std::string &resource);
+                bool declaresResources();
+                std::list<std::string> &getReadsList();
+                std::list<std::string> &getWritesList();
                 std::string &getName();
                 void setName(std::string &name);
                 Engine *getEngine();
                 void setEngine(Engine *engine);
-
-                inline void startDependencySync() {
-#ifdef MARIACHI_SYNC_PARALLEL_PROCESSING
-                    // enters the critical section
-                    CRITICAL_SECTION_ENTER(this->fifo.queueCriticalSection);
-
-                    // iterates while the queue is full, the stop flag is not set
-                    // and the running flag is active
-                    while(this->fifo.queue.size() == this->fifo.size && !this->fifo.stopFlag) {
-                        CONDITION_WAIT(this->fifo.notFullCondition, this->fifo.queueCriticalSection);
-                    }
-#endif
-                }
-
-                inline void endDependencySync() {
-#ifdef MARIACHI_SYNC_PARALLEL_PROCESSING
-                    // adds the true value to the fifo
-                    this->fifo.queue.push_back(true);
-
-                    // leaves the critical section
-                    CRITICAL_SECTION_LEAVE(this->fifo.queueCriticalSection);
-
-                    // sends the condition signal
-                    CONDITION_SIGNAL(this->fifo.notEmptyCondition);
-#endif
-                }
         };
     }
 }
@@ -26,11 +26,28 @@
 #include "stdafx.h"
 
 #include "../system/system_util.h"
+#include "../debugging/profiler.h"
 
 #include "stage_runner.h"
 
+using namespace mariachi::tasks;
+using namespace mariachi::debugging;
 using namespace mariachi::stages;
 
+/**
+ * Job that runs a single update of the stage associated
+ * with the stage runner sent as argument.
+ *
+ * @param arguments The stage runner to be updated.
+ */
+void mariachi::stages::stageRunnerJob(void *arguments) {
+    // retrieves the stage runner from the arguments
+    StageRunner *stageRunner = (StageRunner *) arguments;
+
+    // updates the stage runner
+    stageRunner->update(NULL);
+}
+
 /**
  * Constructor of the class.
  */
@@ -39,6 +56,10 @@ StageRunner::StageRunner() {
 
 StageRunner::StageRunner(Stage *stage) {
     this->stage = stage;
+
+    // registers the stage timer (once, the updates
+    // are profiled with the timer id)
+    this->timerId = Profiler::registerTimer(stage->getName());
 }
 
 /**
@@ -55,13 +76,11 @@ void StageRunner::start(void *arguments) {
     this->stage->start(arguments);
 
     // iterates while the running flag
-    // is set
+    // is set, the stage update is expected to
+    // block (dedicated thread stage)
     while(this->runningFlag) {
         // updates the stage
         this->stage->update(arguments);
-
-        // @todo: temporary hack until sheduller
-        SLEEP(100);
     }
 
     // stops the stage
@@ -72,3 +91,54 @@ void StageRunner::stop(void *arguments) {
     // unsets the running flag
     this->runningFlag = false;
 }
+
+/**
+ * Runs a single update of the stage, used when the
+ * stage is run as a job in the job scheduler.
+ *
+ * @param arguments The arguments for the stage update.
+ */
+void StageRunner::update(void *arguments) {
+    // profiles the stage update (in the current scope)
+    ProfilerScope profilerScope(Profiler::getActiveProfiler(), this->timerId);
+
+    // updates the stage
+    this->stage->update(arguments);
+}
+
+/**
+ * Adds a stage runner dependency, the stage is only updated
+ * after the dependency stage is updated (in the same tick).
+ *
+ * @param stageRunner The stage runner to depend on.
+ */
+void StageRunner::addDependency(StageRunner *stageRunner) {
+    this->dependenciesList.push_back(stageRunner);
+}
+
+/**
+ * Retrieves the dependencies list.
+ *
+ * @return The dependencies list.
+ */
+std::vector<StageRunner *> &StageRunner::getDependenciesList() {
+    return this->dependenciesList;
+}
+
+/**
+ * Retrieves the stage.
+ *
+ * @return The stage.
+ */
+Stage *StageRunner::getStage() {
+    return this->stage;
+}
+
+/**
+ * Retrieves the job used to schedule the stage update.
+ *
+ * @return The job used to schedule the stage update.
+ */
+Job_t *StageRunner::getJob() {
+    return &this->job;
+}
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "../tasks/job_scheduler.h"
 #include "stage.h"
 
 namespace mariachi {
@@ -32,7 +33,10 @@ namespace mariachi {
         class StageRunner {
             private:
                 Stage *stage;
+                unsigned int timerId;
                 bool runningFlag;
+                tasks::Job_t job;
+                std::vector<StageRunner *> dependenciesList;
 
             public:
                 StageRunner();
@@ -40,6 +44,13 @@ namespace mariachi {
                 ~StageRunner();
                 void start(void *arguments);
                 void stop(void *arguments);
+                void update(void *arguments);
+                void addDependency(StageRunner *stageRunner);
+                std::vector<StageRunner *> &getDependenciesList();
+                Stage *getStage();
+                tasks::Job_t *getJob();
         };
+
+        void stageRunnerJob(void *arguments);
     }
 }
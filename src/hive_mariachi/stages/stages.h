@@ -25,9 +25,11 @@
 
 #pragma once
 
+#include "animation_stage.h"
 #include "camera_stage.h"
 #include "console_stage.h"
 #include "dummy_stage.h"
+#include "frame_graph.h"
 #include "render_stage.h"
 #include "stage.h"
 #include "stage_runner.h"
@@ -25,6 +25,10 @@
 
 #define ADD_TO_STAGES_LIST(stage) stagesList->push_back(stage);
 
+#ifdef MARIACHI_STAGE_ANIMATION
+ADD_TO_STAGES_LIST(new AnimationStage(this, std::string("animation")));
+#endif
+
 #ifdef MARIACHI_STAGE_RENDER
 ADD_TO_STAGES_LIST(new RenderStage(this, std::string("render")));
 #endif
@@ -28,6 +28,7 @@
 #ifdef __MACH__
 #define unix true
 #include <TargetConditionals.h>
+#include <mach/mach_time.h>
 #endif
 
 #ifdef _WIN32
@@ -50,6 +51,10 @@
 #ifdef MARIACHI_PLATFORM_UNIX
 #include <unistd.h>
 #include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #ifdef MARIACHI_PLATFORM_IPHONE
@@ -61,6 +66,7 @@ const char *getBundleDirectory();
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <float.h>
 
 #include <string>
 #include <map>
@@ -71,4 +77,5 @@ const char *getBundleDirectory();
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <typeinfo>
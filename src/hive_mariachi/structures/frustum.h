@@ -0,0 +1,63 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+/**
+ * The number of planes of the frustum.
+ */
+#define FRUSTUM_PLANES 6
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * Represents a plane in a 3d space, with
+         * the equation a * x + b * y + c * z + d = 0.
+         *
+         * @param a The x coefficient of the plane.
+         * @param b The y coefficient of the plane.
+         * @param c The z coefficient of the plane.
+         * @param d The constant of the plane.
+         */
+        typedef struct Plane3d_t {
+            float a;
+            float b;
+            float c;
+            float d;
+        } Plane3d;
+
+        /**
+         * Represents a view frustum, the points inside
+         * the frustum are in the positive side of all
+         * the planes (left, right, bottom, top, near and far).
+         *
+         * @param planes The planes of the frustum.
+         */
+        typedef struct Frustum3d_t {
+            Plane3d_t planes[FRUSTUM_PLANES];
+        } Frustum3d;
+    }
+}
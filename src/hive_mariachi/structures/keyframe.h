@@ -0,0 +1,141 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "mesh.h"
+
+/**
+ * The number of bytes used to store each of the
+ * quantized vertices (x, y, z and normal index).
+ */
+#define QUANTIZED_VERTEX_SIZE 4
+
+/**
+ * The number of bytes used to store each of the
+ * short quantized vertices (x, y, z and normal).
+ */
+#define QUANTIZED_SHORT_VERTEX_SIZE 8
+
+/**
+ * The default keyframe animation rate (in frames
+ * per second).
+ */
+#define DEFAULT_KEYFRAME_RATE 10.0f
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * The format of the quantized vertices of
+         * the keyframes.
+         */
+        typedef enum KeyframeFormat_t {
+            QUANTIZED_BYTE = 1,
+            QUANTIZED_SHORT
+        } KeyframeFormat;
+
+        /**
+         * Keyframe with the vertices quantized to a byte (or
+         * a signed short) per coordinate, the coordinates are
+         * decoded using the scale and translation of the keyframe.
+         *
+         * @param scale The scale of each of the coordinates.
+         * @param translate The translation of each of the coordinates.
+         * @param vertices The quantized vertices (x, y, z and normal).
+         */
+        typedef struct QuantizedKeyframe_t {
+            float scale[3];
+            float translate[3];
+            unsigned char *vertices;
+        } QuantizedKeyframe;
+
+        /**
+         * Named range of keyframes of an animation (an animation
+         * sequence, like running or jumping).
+         *
+         * @param name The name of the clip.
+         * @param start The index of the first keyframe of the clip.
+         * @param count The number of keyframes of the clip.
+         */
+        typedef struct AnimationClip_t {
+            std::string name;
+            unsigned int start;
+            unsigned int count;
+        } AnimationClip;
+
+        /**
+         * Attachment point of a keyframe (the transform of
+         * a sub model attached to the model).
+         *
+         * @param origin The origin of the tag.
+         * @param axis The rotated x, y and z axis of the tag (the
+         * columns of the rotation matrix).
+         */
+        typedef struct KeyframeTag_t {
+            Coordinate3d_t origin;
+            Coordinate3d_t axis[3];
+        } KeyframeTag;
+
+        /**
+         * Animation with the keyframes kept in quantized form,
+         * the meshes are decoded (and interpolated) from the
+         * keyframes in each update.
+         *
+         * @param format The format of the quantized vertices.
+         * @param numberVertices The number of vertices in each keyframe.
+         * @param numberKeyframes The number of keyframes.
+         * @param keyframes The quantized keyframes.
+         * @param frameRate The rate of the keyframes (in frames per second).
+         * @param numberMeshes The number of meshes.
+         * @param meshes The template meshes (type, number of vertices and
+         * texture vertex list).
+         * @param numberMeshVertices The number of vertices of all the meshes.
+         * @param meshVertexIndexes The keyframe vertex index of each of
+         * the mesh vertices (in mesh order).
+         * @param numberClips The number of clips.
+         * @param clips The clips of the animation.
+         * @param numberTags The number of tags in each keyframe.
+         * @param tagNames The names of the tags.
+         * @param tags The tags of the keyframes (in keyframe order).
+         */
+        typedef struct KeyframeAnimation_t {
+            KeyframeFormat_t format;
+            unsigned int numberVertices;
+            unsigned int numberKeyframes;
+            QuantizedKeyframe_t *keyframes;
+            float frameRate;
+            unsigned int numberMeshes;
+            Mesh_t *meshes;
+            unsigned int numberMeshVertices;
+            unsigned int *meshVertexIndexes;
+            unsigned int numberClips;
+            AnimationClip_t *clips;
+            unsigned int numberTags;
+            std::string *tagNames;
+            KeyframeTag_t *tags;
+        } KeyframeAnimation;
+    }
+}
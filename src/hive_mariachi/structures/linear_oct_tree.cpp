@@ -0,0 +1,869 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "../util/util.h"
+#include "oct_tree_shape.h"
+#include "linear_oct_tree.h"
+
+using namespace mariachi::util;
+using namespace mariachi::tasks;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+LinearOctTree::LinearOctTree() {
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param elements The elements to be built into the tree.
+ * @param elementBoxes The bounding boxes of the elements.
+ * @param elementsCount The number of elements.
+ */
+LinearOctTree::LinearOctTree(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount) {
+    this->build(elements, elementBoxes, elementsCount, NULL);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param elements The elements to be built into the tree.
+ * @param elementBoxes The bounding boxes of the elements.
+ * @param elementsCount The number of elements.
+ * @param jobScheduler The job scheduler used to build the tree in parallel.
+ */
+LinearOctTree::LinearOctTree(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount, JobScheduler *jobScheduler) {
+    this->build(elements, elementBoxes, elementsCount, jobScheduler);
+}
+
+/**
+ * Destructor of the class.
+ */
+LinearOctTree::~LinearOctTree() {
+}
+
+/**
+ * Builds the tree (in bulk) from the given elements, replacing
+ * the current contents of the tree.
+ *
+ * @param elements The elements to be built into the tree.
+ * @param elementBoxes The bounding boxes of the elements.
+ * @param elementsCount The number of elements.
+ */
+void LinearOctTree::build(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount) {
+    this->build(elements, elementBoxes, elementsCount, NULL);
+}
+
+/**
+ * Builds the tree (in bulk) from the given elements, replacing
+ * the current contents of the tree.
+ * Each element is assigned to the deepest node containing it and the
+ * elements are sorted by the (morton) code of that node, so that the
+ * elements of each node (and subtree) are contiguous.
+ * The elements are partitioned by the nodes at the split depth, so
+ * that the sorting and the subtrees of these nodes are built in parallel.
+ *
+ * @param elements The elements to be built into the tree.
+ * @param elementBoxes The bounding boxes of the elements.
+ * @param elementsCount The number of elements.
+ * @param jobScheduler The job scheduler used to build the tree in
+ * parallel (null to build the tree in the calling thread).
+ */
+void LinearOctTree::build(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount, JobScheduler *jobScheduler) {
+    // clears the current contents
+    this->clear();
+
+    // in case there are no elements
+    if(elementsCount == 0) {
+        // returns immediately
+        return;
+    }
+
+    // creates the build state
+    LinearOctTreeBuild_t build;
+    build.linearOctTree = this;
+    build.elements = elements;
+    build.elementBoxes = elementBoxes;
+
+    // computes the root box (bounding all the elements)
+    build.rootBox = elementBoxes[0];
+    for(unsigned int index = 1; index < elementsCount; index++) {
+        BoxUtil::mergeBox(build.rootBox, elementBoxes[index]);
+    }
+
+    // computes the entries of the elements
+    build.entries.resize(elementsCount);
+    this->runRange(jobScheduler, elementsCount, LINEAR_OCT_TREE_BUILD_CHUNK_SIZE, computeEntriesRange, &build, this->jobRanges);
+
+    // partitions the entries by the split nodes and
+    // sorts the entries of each split node
+    this->partitionEntries(build);
+    this->runRange(jobScheduler, build.bucketStarts.size() - 1, 1, sortBucketsRange, &build, this->jobRanges);
+
+    // fills the elements pool (in morton order)
+    this->elements.resize(elementsCount);
+    this->elementBoxes.resize(elementsCount);
+    this->runRange(jobScheduler, elementsCount, LINEAR_OCT_TREE_BUILD_CHUNK_SIZE, fillElementsRange, &build, this->jobRanges);
+
+    // creates the root node (with all the elements)
+    LinearOctTreeNode_t rootNode = { { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }, 0, 0, 0, 0 };
+    this->nodes.push_back(rootNode);
+    build.nodesEnd.push_back(elementsCount);
+    build.nodesDepth.push_back(0);
+
+    // builds the top nodes (until the split depth)
+    build.subtreesStart = this->buildNodes(build.sortedEntries, this->nodes, build.nodesEnd, build.nodesDepth, LINEAR_OCT_TREE_SPLIT_DEPTH);
+
+    // builds the subtrees of the split nodes
+    build.subtreesNodes.resize(this->nodes.size() - build.subtreesStart);
+    this->runRange(jobScheduler, build.subtreesNodes.size(), 1, buildSubtreesRange, &build, this->jobRanges);
+
+    // merges the subtrees and computes the bounding
+    // boxes of the top nodes
+    this->mergeSubtrees(build);
+    this->computeBoundingBoxes(this->nodes, build.subtreesStart);
+}
+
+/**
+ * Clears the tree, removing all the nodes and elements.
+ */
+void LinearOctTree::clear() {
+    this->nodes.clear();
+    this->elements.clear();
+    this->elementBoxes.clear();
+}
+
+/**
+ * Retrieves the elements intersecting the provided query box.
+ *
+ * @param queryBox The box for which intersecting elements are retrieved.
+ * @return The elements intersecting the provided box.
+ */
+std::vector<void *> LinearOctTree::getBoxElements(Box3d_t *queryBox) {
+    std::vector<void *> elements;
+    this->getBoxElements(queryBox, elements);
+    return elements;
+}
+
+/**
+ * Retrieves the elements intersecting the provided query box,
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param queryBox The box for which intersecting elements are retrieved.
+ * @param elements The buffer to be filled with the elements.
+ */
+void LinearOctTree::getBoxElements(Box3d_t *queryBox, std::vector<void *> &elements) {
+    this->visitBoxElements(queryBox, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided query box.
+ *
+ * @param queryBox The box for which intersecting elements are visited.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void LinearOctTree::visitBoxElements(Box3d_t *queryBox, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the box shape
+    OctTreeBoxShape_t boxShape;
+    boxShape.box = *queryBox;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(boxShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements intersecting the provided sphere,
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @param elements The buffer to be filled with the elements.
+ */
+void LinearOctTree::getSphereElements(const Coordinate3d_t &center, float radius, std::vector<void *> &elements) {
+    this->visitSphereElements(center, radius, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided sphere.
+ *
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void LinearOctTree::visitSphereElements(const Coordinate3d_t &center, float radius, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the sphere shape
+    OctTreeSphereShape_t sphereShape;
+    sphereShape.center = center;
+    sphereShape.squaredRadius = radius * radius;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(sphereShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements intersecting the provided frustum (culling),
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param frustum The frustum to be used in the query.
+ * @param elements The buffer to be filled with the elements.
+ */
+void LinearOctTree::getFrustumElements(const Frustum3d_t &frustum, std::vector<void *> &elements) {
+    this->visitFrustumElements(frustum, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided frustum.
+ *
+ * @param frustum The frustum to be used in the query.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void LinearOctTree::visitFrustumElements(const Frustum3d_t &frustum, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the frustum shape
+    OctTreeFrustumShape_t frustumShape;
+    frustumShape.frustum = frustum;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(frustumShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements hit by the provided ray (picking), the hits
+ * are added to the given (reused) buffer sorted by distance.
+ *
+ * @param origin The origin of the ray.
+ * @param direction The (normalized) direction of the ray.
+ * @param maximumDistance The maximum distance along the ray.
+ * @param hits The buffer to be filled with the hits.
+ */
+void LinearOctTree::getRayElements(const Coordinate3d_t &origin, const Coordinate3d_t &direction, float maximumDistance, std::vector<OctTreeHit_t> &hits) {
+    // in case the tree is empty
+    if(this->nodes.empty()) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the start of the hits (the buffer may not be empty)
+    size_t hitsStart = hits.size();
+
+    // computes the inverse of the direction
+    Coordinate3d_t inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+    // allocates the distance
+    float distance;
+
+    // creates the nodes stack with the root node
+    unsigned int nodesStack[LINEAR_OCT_TREE_STACK_SIZE];
+    unsigned int nodesStackSize = 1;
+    nodesStack[0] = 0;
+
+    // until the stack is empty
+    while(nodesStackSize > 0) {
+        // retrieves and removes the current node
+        LinearOctTreeNode_t &currentNode = this->nodes[nodesStack[--nodesStackSize]];
+
+        // in case the ray does not hit the node
+        if(!BoxUtil::intersectsRay(currentNode.boundingBox, origin, inverseDirection, maximumDistance, distance)) {
+            // continues the loop
+            continue;
+        }
+
+        // computes the end of the node elements
+        unsigned int elementsEnd = currentNode.elementsStart + currentNode.elementsCount;
+
+        // for all the node elements
+        for(unsigned int index = currentNode.elementsStart; index < elementsEnd; index++) {
+            // in case the ray hits the element
+            if(BoxUtil::intersectsRay(this->elementBoxes[index], origin, inverseDirection, maximumDistance, distance)) {
+                // adds the hit
+                OctTreeHit_t hit = { this->elements[index], distance };
+                hits.push_back(hit);
+            }
+        }
+
+        // pushes the child nodes
+        unsigned int childCount = this->getChildCount(currentNode.childMask);
+        for(unsigned int index = 0; index < childCount; index++) {
+            nodesStack[nodesStackSize++] = currentNode.firstChild + index;
+        }
+    }
+
+    // sorts the (new) hits by distance
+    std::sort(hits.begin() + hitsStart, hits.end(), compareHitDistance);
+}
+
+/**
+ * Runs a batch of box queries, the queries are split in chunks
+ * (across the job scheduler workers), each chunk with its own
+ * output buffer in the batch.
+ *
+ * @param queryBoxes The boxes of the queries.
+ * @param queriesCount The number of queries.
+ * @param batch The batch to be filled with the results.
+ * @param jobScheduler The job scheduler used to run the queries in
+ * parallel (null to run the queries in the calling thread).
+ */
+void LinearOctTree::getBoxElementsBatch(Box3d_t *queryBoxes, unsigned int queriesCount, LinearOctTreeBatch_t &batch, JobScheduler *jobScheduler) {
+    // prepares the batch
+    this->prepareBatch(batch, queriesCount);
+
+    // runs the queries
+    LinearOctTreeBatchQuery_t batchQuery = { this, queryBoxes, NULL, &batch };
+    this->runRange(jobScheduler, queriesCount, LINEAR_OCT_TREE_BATCH_CHUNK_SIZE, runBoxQueriesRange, &batchQuery, batch.jobRanges);
+}
+
+/**
+ * Runs a batch of frustum queries (culling), the queries are split
+ * in chunks (across the job scheduler workers), each chunk with its
+ * own output buffer in the batch.
+ *
+ * @param frustums The frustums of the queries.
+ * @param queriesCount The number of queries.
+ * @param batch The batch to be filled with the results.
+ * @param jobScheduler The job scheduler used to run the queries in
+ * parallel (null to run the queries in the calling thread).
+ */
+void LinearOctTree::getFrustumElementsBatch(Frustum3d_t *frustums, unsigned int queriesCount, LinearOctTreeBatch_t &batch, JobScheduler *jobScheduler) {
+    // prepares the batch
+    this->prepareBatch(batch, queriesCount);
+
+    // runs the queries
+    LinearOctTreeBatchQuery_t batchQuery = { this, NULL, frustums, &batch };
+    this->runRange(jobScheduler, queriesCount, LINEAR_OCT_TREE_BATCH_CHUNK_SIZE, runFrustumQueriesRange, &batchQuery, batch.jobRanges);
+}
+
+/**
+ * Retrieves the nodes of the tree, the first
+ * node is the root node.
+ *
+ * @return The nodes of the tree.
+ */
+std::vector<LinearOctTreeNode_t> &LinearOctTree::getNodes() {
+    return this->nodes;
+}
+
+/**
+ * Retrieves the number of elements in the tree.
+ *
+ * @return The number of elements in the tree.
+ */
+unsigned int LinearOctTree::getElementsCount() {
+    return this->elements.size();
+}
+
+inline void LinearOctTree::computeEntries(const Box3d_t &rootBox, Box3d_t *elementBoxes, unsigned int start, unsigned int end, std::vector<LinearOctTreeEntry_t> &entries) {
+    // computes the number of cells (per axis) of the deepest level
+    unsigned int cellsCount = 1 << LINEAR_OCT_TREE_MAXIMUM_DEPTH;
+
+    // computes the scales from the root box to the cells
+    float scaleX = rootBox.x2 > rootBox.x1 ? (float) cellsCount / (rootBox.x2 - rootBox.x1) : 0.0f;
+    float scaleY = rootBox.y2 > rootBox.y1 ? (float) cellsCount / (rootBox.y2 - rootBox.y1) : 0.0f;
+    float scaleZ = rootBox.z2 > rootBox.z1 ? (float) cellsCount / (rootBox.z2 - rootBox.z1) : 0.0f;
+
+    // for all the elements in the range
+    for(unsigned int index = start; index < end; index++) {
+        // retrieves the element box
+        Box3d_t &elementBox = elementBoxes[index];
+
+        // computes the cells of the element box corners
+        unsigned int x1 = (unsigned int) ((elementBox.x1 - rootBox.x1) * scaleX);
+        unsigned int y1 = (unsigned int) ((elementBox.y1 - rootBox.y1) * scaleY);
+        unsigned int z1 = (unsigned int) ((elementBox.z1 - rootBox.z1) * scaleZ);
+        unsigned int x2 = (unsigned int) ((elementBox.x2 - rootBox.x1) * scaleX);
+        unsigned int y2 = (unsigned int) ((elementBox.y2 - rootBox.y1) * scaleY);
+        unsigned int z2 = (unsigned int) ((elementBox.z2 - rootBox.z1) * scaleZ);
+
+        // clamps the cells to the root box
+        x1 = x1 < cellsCount ? x1 : cellsCount - 1;
+        y1 = y1 < cellsCount ? y1 : cellsCount - 1;
+        z1 = z1 < cellsCount ? z1 : cellsCount - 1;
+        x2 = x2 < cellsCount ? x2 : cellsCount - 1;
+        y2 = y2 < cellsCount ? y2 : cellsCount - 1;
+        z2 = z2 < cellsCount ? z2 : cellsCount - 1;
+
+        // computes the number of levels (from the bottom) in which the
+        // corners differ, the element is contained in the node above them
+        unsigned int difference = (x1 ^ x2) | (y1 ^ y2) | (z1 ^ z2);
+        unsigned int differenceLevels = 0;
+        while(difference) {
+            difference >>= 1;
+            differenceLevels++;
+        }
+
+        // computes the morton code of the containing node (clearing
+        // the levels below it)
+        unsigned long long code = this->expandBits(x1) | (this->expandBits(y1) << 1) | (this->expandBits(z1) << 2);
+        code &= ~((1ULL << (3 * differenceLevels)) - 1);
+
+        // sets the entry, with the depth of the node
+        // after the code (parents first)
+        entries[index].key = (code << 4) | (LINEAR_OCT_TREE_MAXIMUM_DEPTH - differenceLevels);
+        entries[index].index = index;
+    }
+}
+
+inline void LinearOctTree::partitionEntries(LinearOctTreeBuild_t &build) {
+    // computes the number of split nodes (buckets) and the
+    // shift of the split node in the keys
+    unsigned int bucketsCount = 1 << (3 * LINEAR_OCT_TREE_SPLIT_DEPTH);
+    unsigned int bucketShift = 4 + 3 * (LINEAR_OCT_TREE_MAXIMUM_DEPTH - LINEAR_OCT_TREE_SPLIT_DEPTH);
+
+    // resets the bucket starts
+    build.bucketStarts.assign(bucketsCount + 1, 0);
+
+    // counts the entries of each bucket, the elements above
+    // the split depth are counted in the first bucket of the
+    // node containing them (sorted first in it)
+    for(unsigned int index = 0; index < build.entries.size(); index++) {
+        build.bucketStarts[(unsigned int) (build.entries[index].key >> bucketShift) + 1]++;
+    }
+
+    // accumulates the counts into the bucket starts
+    for(unsigned int index = 1; index <= bucketsCount; index++) {
+        build.bucketStarts[index] += build.bucketStarts[index - 1];
+    }
+
+    // scatters the entries into the buckets (the bucket order
+    // matches the key order)
+    std::vector<unsigned int> bucketPositions(build.bucketStarts.begin(), build.bucketStarts.end() - 1);
+    build.sortedEntries.resize(build.entries.size());
+    for(unsigned int index = 0; index < build.entries.size(); index++) {
+        unsigned int bucket = (unsigned int) (build.entries[index].key >> bucketShift);
+        build.sortedEntries[bucketPositions[bucket]++] = build.entries[index];
+    }
+}
+
+inline unsigned int LinearOctTree::buildNodes(std::vector<LinearOctTreeEntry_t> &entries, std::vector<LinearOctTreeNode_t> &nodes, std::vector<unsigned int> &nodesEnd, std::vector<unsigned int> &nodesDepth, unsigned int splitDepth) {
+    // iterates over all the nodes (breadth first), the child
+    // nodes are created contiguously after the current nodes
+    for(unsigned int index = 0; index < nodes.size(); index++) {
+        // retrieves the elements range and the depth of the node
+        unsigned int elementsStart = nodes[index].elementsStart;
+        unsigned int elementsEnd = nodesEnd[index];
+        unsigned int depth = nodesDepth[index];
+
+        // in case the node is at the split depth (all the
+        // remaining nodes are at the split depth)
+        if(depth == splitDepth) {
+            // returns the index of the first split node
+            return index;
+        }
+
+        // in case the node is not to be subdivided
+        if(elementsEnd - elementsStart <= LINEAR_OCT_TREE_LEAF_ELEMENTS || depth == LINEAR_OCT_TREE_MAXIMUM_DEPTH) {
+            // sets all the range elements in the node
+            nodes[index].elementsCount = elementsEnd - elementsStart;
+
+            // continues the loop
+            continue;
+        }
+
+        // skips the elements contained in the node (not in
+        // any of the children), sorted first
+        unsigned int childStart = elementsStart;
+        while(childStart < elementsEnd && (entries[childStart].key & 0xf) == depth) {
+            childStart++;
+        }
+
+        // sets the node elements and the first child
+        nodes[index].elementsCount = childStart - elementsStart;
+        nodes[index].firstChild = nodes.size();
+
+        // computes the shift of the child octant in the keys
+        unsigned int octantShift = 4 + 3 * (LINEAR_OCT_TREE_MAXIMUM_DEPTH - depth - 1);
+
+        // until all the child elements are processed
+        while(childStart < elementsEnd) {
+            // retrieves the octant of the child
+            unsigned int octant = (unsigned int) (entries[childStart].key >> octantShift) & 0x7;
+
+            // finds the end of the child elements (same octant)
+            unsigned int childEnd = childStart + 1;
+            while(childEnd < elementsEnd && ((unsigned int) (entries[childEnd].key >> octantShift) & 0x7) == octant) {
+                childEnd++;
+            }
+
+            // sets the octant in the child mask
+            nodes[index].childMask |= 1 << octant;
+
+            // creates the child node
+            LinearOctTreeNode_t childNode = { { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }, 0, childStart, 0, 0 };
+            nodes.push_back(childNode);
+            nodesEnd.push_back(childEnd);
+            nodesDepth.push_back(depth + 1);
+
+            // moves to the next child
+            childStart = childEnd;
+        }
+    }
+
+    // returns the number of nodes (no split nodes)
+    return nodes.size();
+}
+
+inline void LinearOctTree::mergeSubtrees(LinearOctTreeBuild_t &build) {
+    // computes the total number of nodes
+    size_t nodesCount = this->nodes.size();
+    for(unsigned int index = 0; index < build.subtreesNodes.size(); index++) {
+        nodesCount += build.subtreesNodes[index].size() - 1;
+    }
+
+    // reserves the nodes
+    this->nodes.reserve(nodesCount);
+
+    // iterates over all the subtrees
+    for(unsigned int index = 0; index < build.subtreesNodes.size(); index++) {
+        // retrieves the subtree nodes
+        std::vector<LinearOctTreeNode_t> &subtreeNodes = build.subtreesNodes[index];
+
+        // computes the offset of the subtree nodes, the subtree root
+        // replaces the split node and the other nodes are appended
+        unsigned int offset = this->nodes.size() - 1;
+
+        // offsets the first child of the subtree nodes
+        for(unsigned int nodeIndex = 0; nodeIndex < subtreeNodes.size(); nodeIndex++) {
+            if(subtreeNodes[nodeIndex].childMask) {
+                subtreeNodes[nodeIndex].firstChild += offset;
+            }
+        }
+
+        // sets the split node and appends the other nodes
+        this->nodes[build.subtreesStart + index] = subtreeNodes[0];
+        this->nodes.insert(this->nodes.end(), subtreeNodes.begin() + 1, subtreeNodes.end());
+    }
+}
+
+inline void LinearOctTree::computeBoundingBoxes(std::vector<LinearOctTreeNode_t> &nodes, unsigned int nodesCount) {
+    // iterates over all the nodes in reverse (children first)
+    for(int index = nodesCount - 1; index >= 0; index--) {
+        // retrieves the node
+        LinearOctTreeNode_t &node = nodes[index];
+
+        // retrieves the number of children
+        unsigned int childCount = this->getChildCount(node.childMask);
+
+        // starts the bounding box with the first element or child
+        // (every node contains at least one element in the subtree)
+        node.boundingBox = node.elementsCount > 0 ? this->elementBoxes[node.elementsStart] : nodes[node.firstChild].boundingBox;
+
+        // merges the node elements boxes
+        for(unsigned int elementIndex = 0; elementIndex < node.elementsCount; elementIndex++) {
+            BoxUtil::mergeBox(node.boundingBox, this->elementBoxes[node.elementsStart + elementIndex]);
+        }
+
+        // merges the child nodes boxes
+        for(unsigned int childIndex = 0; childIndex < childCount; childIndex++) {
+            BoxUtil::mergeBox(node.boundingBox, nodes[node.firstChild + childIndex].boundingBox);
+        }
+    }
+}
+
+inline void LinearOctTree::prepareBatch(LinearOctTreeBatch_t &batch, unsigned int queriesCount) {
+    // resizes the buffers (one per chunk, keeping the
+    // capacity of the existing buffers) and the results
+    batch.buffers.resize((queriesCount + LINEAR_OCT_TREE_BATCH_CHUNK_SIZE - 1) / LINEAR_OCT_TREE_BATCH_CHUNK_SIZE);
+    batch.results.resize(queriesCount);
+}
+
+inline void LinearOctTree::runRange(JobScheduler *jobScheduler, unsigned int count, unsigned int chunkSize, JobRangeFunction_t rangeFunction, void *arguments, std::vector<JobRange_t> &jobRanges) {
+    // in case there is a job scheduler
+    if(jobScheduler) {
+        // runs the range in the job scheduler (reusing the job ranges)
+        jobScheduler->runRange(count, chunkSize, rangeFunction, arguments, jobRanges);
+
+        // returns immediately
+        return;
+    }
+
+    // iterates over all the chunks
+    for(unsigned int start = 0; start < count; start += chunkSize) {
+        // runs the chunk in the calling thread
+        rangeFunction(arguments, start, start + chunkSize < count ? start + chunkSize : count);
+    }
+}
+
+inline unsigned long long LinearOctTree::expandBits(unsigned int value) {
+    // spreads the (ten) bits of the value, leaving
+    // two zero bits between each of them
+    unsigned long long expandedValue = value & 0x3ff;
+    expandedValue = (expandedValue | (expandedValue << 16)) & 0x30000ff;
+    expandedValue = (expandedValue | (expandedValue << 8)) & 0x300f00f;
+    expandedValue = (expandedValue | (expandedValue << 4)) & 0x30c30c3;
+    expandedValue = (expandedValue | (expandedValue << 2)) & 0x9249249;
+
+    // returns the expanded value
+    return expandedValue;
+}
+
+inline unsigned int LinearOctTree::getChildCount(unsigned char childMask) {
+    // counts the bits set in the child mask
+    unsigned int count = childMask - ((childMask >> 1) & 0x55);
+    count = (count & 0x33) + ((count >> 2) & 0x33);
+    count = (count + (count >> 4)) & 0x0f;
+
+    // returns the count
+    return count;
+}
+
+/**
+ * Visits the elements intersecting the provided shape, only the
+ * nodes (subtrees) intersecting the shape are traversed.
+ *
+ * @param shape The shape (with the box intersection test).
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+template<typename T> inline void LinearOctTree::visitShapeElements(const T &shape, OctTreeVisitor_t visitor, void *parameters) {
+    // in case the tree is empty
+    if(this->nodes.empty()) {
+        // returns immediately
+        return;
+    }
+
+    // creates the nodes stack with the root node
+    unsigned int nodesStack[LINEAR_OCT_TREE_STACK_SIZE];
+    unsigned int nodesStackSize = 1;
+    nodesStack[0] = 0;
+
+    // until the stack is empty
+    while(nodesStackSize > 0) {
+        // retrieves and removes the current node
+        LinearOctTreeNode_t &currentNode = this->nodes[nodesStack[--nodesStackSize]];
+
+        // in case the shape does not intersect the node
+        if(!shape.intersectsBox(currentNode.boundingBox)) {
+            // continues the loop
+            continue;
+        }
+
+        // computes the end of the node elements
+        unsigned int elementsEnd = currentNode.elementsStart + currentNode.elementsCount;
+
+        // for all the node elements
+        for(unsigned int index = currentNode.elementsStart; index < elementsEnd; index++) {
+            // in case the shape intersects the element
+            if(shape.intersectsBox(this->elementBoxes[index])) {
+                // visits the element
+                visitor(this->elements[index], parameters);
+            }
+        }
+
+        // pushes the child nodes
+        unsigned int childCount = this->getChildCount(currentNode.childMask);
+        for(unsigned int index = 0; index < childCount; index++) {
+            nodesStack[nodesStackSize++] = currentNode.firstChild + index;
+        }
+    }
+}
+
+/**
+ * Computes the entries of a range of the elements
+ * being built (run as a job).
+ *
+ * @param arguments The build state.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::computeEntriesRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the build state
+    LinearOctTreeBuild_t *build = (LinearOctTreeBuild_t *) arguments;
+
+    // computes the entries of the range
+    build->linearOctTree->computeEntries(build->rootBox, build->elementBoxes, start, end, build->entries);
+}
+
+/**
+ * Sorts the entries of a range of the buckets (split
+ * nodes) being built (run as a job).
+ *
+ * @param arguments The build state.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::sortBucketsRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the build state
+    LinearOctTreeBuild_t *build = (LinearOctTreeBuild_t *) arguments;
+
+    // iterates over all the buckets in the range
+    for(unsigned int index = start; index < end; index++) {
+        // sorts the entries of the bucket
+        std::sort(build->sortedEntries.begin() + build->bucketStarts[index], build->sortedEntries.begin() + build->bucketStarts[index + 1], compareEntryKey);
+    }
+}
+
+/**
+ * Fills a range of the elements pool with the (sorted)
+ * elements being built (run as a job).
+ *
+ * @param arguments The build state.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::fillElementsRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the build state
+    LinearOctTreeBuild_t *build = (LinearOctTreeBuild_t *) arguments;
+    LinearOctTree *linearOctTree = build->linearOctTree;
+
+    // iterates over all the elements in the range
+    for(unsigned int index = start; index < end; index++) {
+        // sets the element and the element box
+        unsigned int elementIndex = build->sortedEntries[index].index;
+        linearOctTree->elements[index] = build->elements[elementIndex];
+        linearOctTree->elementBoxes[index] = build->elementBoxes[elementIndex];
+    }
+}
+
+/**
+ * Builds a range of the subtrees of the split nodes, each
+ * subtree is built in its own nodes list (run as a job).
+ *
+ * @param arguments The build state.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::buildSubtreesRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the build state
+    LinearOctTreeBuild_t *build = (LinearOctTreeBuild_t *) arguments;
+    LinearOctTree *linearOctTree = build->linearOctTree;
+
+    // iterates over all the subtrees in the range
+    for(unsigned int index = start; index < end; index++) {
+        // retrieves the split node index and the subtree nodes
+        unsigned int nodeIndex = build->subtreesStart + index;
+        std::vector<LinearOctTreeNode_t> &subtreeNodes = build->subtreesNodes[index];
+
+        // creates the subtree root (from the split node)
+        std::vector<unsigned int> nodesEnd(1, build->nodesEnd[nodeIndex]);
+        std::vector<unsigned int> nodesDepth(1, build->nodesDepth[nodeIndex]);
+        subtreeNodes.push_back(linearOctTree->nodes[nodeIndex]);
+
+        // builds the subtree nodes and computes their bounding boxes
+        linearOctTree->buildNodes(build->sortedEntries, subtreeNodes, nodesEnd, nodesDepth, LINEAR_OCT_TREE_MAXIMUM_DEPTH + 1);
+        linearOctTree->computeBoundingBoxes(subtreeNodes, subtreeNodes.size());
+    }
+}
+
+/**
+ * Runs a range of the box queries of a batch, in the
+ * output buffer of the chunk (run as a job).
+ *
+ * @param arguments The batch query.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::runBoxQueriesRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the batch query
+    LinearOctTreeBatchQuery_t *batchQuery = (LinearOctTreeBatchQuery_t *) arguments;
+
+    // retrieves and clears the output buffer of the chunk
+    std::vector<void *> &buffer = batchQuery->batch->buffers[start / LINEAR_OCT_TREE_BATCH_CHUNK_SIZE];
+    buffer.clear();
+
+    // allocates the offsets of the queries in the buffer
+    unsigned int offsets[LINEAR_OCT_TREE_BATCH_CHUNK_SIZE + 1];
+
+    // iterates over all the queries in the range
+    for(unsigned int index = start; index < end; index++) {
+        // sets the query offset and runs the query
+        offsets[index - start] = buffer.size();
+        batchQuery->linearOctTree->getBoxElements(&batchQuery->queryBoxes[index], buffer);
+    }
+
+    // sets the end offset and the results
+    offsets[end - start] = buffer.size();
+    setBatchResults(*batchQuery->batch, buffer, offsets, start, end);
+}
+
+/**
+ * Runs a range of the frustum queries of a batch, in the
+ * output buffer of the chunk (run as a job).
+ *
+ * @param arguments The batch query.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::runFrustumQueriesRange(void *arguments, unsigned int start, unsigned int end) {
+    // retrieves the batch query
+    LinearOctTreeBatchQuery_t *batchQuery = (LinearOctTreeBatchQuery_t *) arguments;
+
+    // retrieves and clears the output buffer of the chunk
+    std::vector<void *> &buffer = batchQuery->batch->buffers[start / LINEAR_OCT_TREE_BATCH_CHUNK_SIZE];
+    buffer.clear();
+
+    // allocates the offsets of the queries in the buffer
+    unsigned int offsets[LINEAR_OCT_TREE_BATCH_CHUNK_SIZE + 1];
+
+    // iterates over all the queries in the range
+    for(unsigned int index = start; index < end; index++) {
+        // sets the query offset and runs the query
+        offsets[index - start] = buffer.size();
+        batchQuery->linearOctTree->getFrustumElements(batchQuery->frustums[index], buffer);
+    }
+
+    // sets the end offset and the results
+    offsets[end - start] = buffer.size();
+    setBatchResults(*batchQuery->batch, buffer, offsets, start, end);
+}
+
+/**
+ * Sets the results of a range of the queries of a batch,
+ * pointing to the output buffer of the chunk.
+ *
+ * @param batch The batch to be set.
+ * @param buffer The output buffer of the chunk.
+ * @param offsets The offsets of the queries in the buffer.
+ * @param start The start of the range.
+ * @param end The end (exclusive) of the range.
+ */
+void LinearOctTree::setBatchResults(LinearOctTreeBatch_t &batch, std::vector<void *> &buffer, unsigned int *offsets, unsigned int start, unsigned int end) {
+    // iterates over all the queries in the range
+    for(unsigned int index = start; index < end; index++) {
+        // retrieves the query result
+        LinearOctTreeResult_t &result = batch.results[index];
+
+        // sets the result elements (in the buffer)
+        result.elementsCount = offsets[index - start + 1] - offsets[index - start];
+        result.elements = result.elementsCount > 0 ? &buffer[offsets[index - start]] : NULL;
+    }
+}
+
+/**
+ * Compares two linear oct tree entries by key (morton
+ * order, with the parents first).
+ *
+ * @param firstEntry The first entry to be compared.
+ * @param secondEntry The second entry to be compared.
+ * @return If the first entry key is smaller than the second entry key.
+ */
+bool mariachi::structures::compareEntryKey(const LinearOctTreeEntry_t &firstEntry, const LinearOctTreeEntry_t &secondEntry) {
+    return firstEntry.key < secondEntry.key;
+}
@@ -0,0 +1,255 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../tasks/job_scheduler.h"
+
+#include "oct_tree_query.h"
+#include "frustum.h"
+#include "box.h"
+
+/**
+ * The maximum depth of the linear oct tree, the
+ * (morton) codes use three bits per level.
+ */
+#define LINEAR_OCT_TREE_MAXIMUM_DEPTH 10
+
+/**
+ * The number of elements up to which a linear
+ * oct tree node is not subdivided.
+ */
+#define LINEAR_OCT_TREE_LEAF_ELEMENTS 8
+
+/**
+ * The size of the traversal stack, enough for the
+ * children of every level of the tree.
+ */
+#define LINEAR_OCT_TREE_STACK_SIZE (8 * (LINEAR_OCT_TREE_MAXIMUM_DEPTH + 1))
+
+/**
+ * The depth of the subtrees built in parallel, the
+ * elements are partitioned by the nodes at this depth.
+ */
+#define LINEAR_OCT_TREE_SPLIT_DEPTH 2
+
+/**
+ * The number of elements processed by each job
+ * of the (parallel) build.
+ */
+#define LINEAR_OCT_TREE_BUILD_CHUNK_SIZE 4096
+
+/**
+ * The number of queries run by each job of a
+ * batch, each with its own output buffer.
+ */
+#define LINEAR_OCT_TREE_BATCH_CHUNK_SIZE 64
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * Structure describing a node of the linear oct tree.
+         * The children of a node are contiguous (in morton order)
+         * and the elements of a node are a range of the elements pool.
+         *
+         * @param boundingBox The box bounding all the elements of the node subtree.
+         * @param firstChild The index of the first child node.
+         * @param elementsStart The index of the first element of the node.
+         * @param elementsCount The number of elements of the node.
+         * @param childMask The mask of the existing child octants.
+         */
+        typedef struct LinearOctTreeNode_t {
+            Box3d_t boundingBox;
+            unsigned int firstChild;
+            unsigned int elementsStart;
+            unsigned int elementsCount;
+            unsigned char childMask;
+        } LinearOctTreeNode;
+
+        /**
+         * Structure describing an element being built into
+         * the linear oct tree.
+         *
+         * @param key The morton code of the deepest node containing
+         * the element, followed by the depth of the node.
+         * @param index The index of the element.
+         */
+        typedef struct LinearOctTreeEntry_t {
+            unsigned long long key;
+            unsigned int index;
+        } LinearOctTreeEntry;
+
+        /**
+         * Structure describing the result of a query in a batch,
+         * the elements are stored in the batch buffers.
+         *
+         * @param elements The elements of the query.
+         * @param elementsCount The number of elements of the query.
+         */
+        typedef struct LinearOctTreeResult_t {
+            void **elements;
+            unsigned int elementsCount;
+        } LinearOctTreeResult;
+
+        /**
+         * Structure describing a batch of queries, with an output
+         * buffer for each chunk of queries (run by a single job).
+         * The batch may be reused, keeping the buffers capacity.
+         *
+         * @param buffers The output buffers of the chunks.
+         * @param results The results of the queries.
+         * @param jobRanges The job ranges used to run the chunks.
+         */
+        typedef struct LinearOctTreeBatch_t {
+            std::vector<std::vector<void *> > buffers;
+            std::vector<LinearOctTreeResult_t> results;
+            std::vector<tasks::JobRange_t> jobRanges;
+        } LinearOctTreeBatch;
+
+        class LinearOctTree;
+
+        /**
+         * Structure describing the state of a (parallel) build.
+         *
+         * @param linearOctTree The tree being built.
+         * @param elements The elements to be built into the tree.
+         * @param elementBoxes The bounding boxes of the elements.
+         * @param rootBox The box bounding all the elements.
+         * @param entries The entries of the elements.
+         * @param sortedEntries The entries sorted in morton order.
+         * @param bucketStarts The start of the entries of each split node.
+         * @param nodesEnd The end of the elements range of each (top) node.
+         * @param nodesDepth The depth of each (top) node.
+         * @param subtreesStart The index of the first split node.
+         * @param subtreesNodes The nodes of each subtree (built in parallel).
+         */
+        typedef struct LinearOctTreeBuild_t {
+            LinearOctTree *linearOctTree;
+            void **elements;
+            Box3d_t *elementBoxes;
+            Box3d_t rootBox;
+            std::vector<LinearOctTreeEntry_t> entries;
+            std::vector<LinearOctTreeEntry_t> sortedEntries;
+            std::vector<unsigned int> bucketStarts;
+            std::vector<unsigned int> nodesEnd;
+            std::vector<unsigned int> nodesDepth;
+            unsigned int subtreesStart;
+            std::vector<std::vector<LinearOctTreeNode_t> > subtreesNodes;
+        } LinearOctTreeBuild;
+
+        /**
+         * Structure describing a batch of queries being run.
+         *
+         * @param linearOctTree The tree being queried.
+         * @param queryBoxes The boxes of the (box) queries.
+         * @param frustums The frustums of the (frustum) queries.
+         * @param batch The batch to be filled.
+         */
+        typedef struct LinearOctTreeBatchQuery_t {
+            LinearOctTree *linearOctTree;
+            Box3d_t *queryBoxes;
+            Frustum3d_t *frustums;
+            LinearOctTreeBatch_t *batch;
+        } LinearOctTreeBatchQuery;
+
+        /**
+         * Represents a packed (linear) oct tree in 3d space, built
+         * in bulk for static elements (world geometry).
+         * The nodes are stored in a contiguous array (each level
+         * in morton order) and the elements are stored once, in the
+         * deepest node containing them, in a shared pool.
+         * The build and the batches of queries may be split across
+         * the workers of a job scheduler.
+         * The queries do not change the tree, so they may run concurrently.
+         */
+        class LinearOctTree {
+            private:
+                /**
+                 * The (contiguous) nodes of the tree, the
+                 * first node is the root node.
+                 */
+                std::vector<LinearOctTreeNode_t> nodes;
+
+                /**
+                 * The elements pool, sorted in morton order.
+                 */
+                std::vector<void *> elements;
+
+                /**
+                 * The bounding boxes of the elements, in
+                 * the same order as the elements.
+                 */
+                std::vector<Box3d_t> elementBoxes;
+
+                /**
+                 * The job ranges used to run the build
+                 * chunks (reused between builds).
+                 */
+                std::vector<tasks::JobRange_t> jobRanges;
+
+                inline void computeEntries(const Box3d_t &rootBox, Box3d_t *elementBoxes, unsigned int start, unsigned int end, std::vector<LinearOctTreeEntry_t> &entries);
+                inline void partitionEntries(LinearOctTreeBuild_t &build);
+                inline unsigned int buildNodes(std::vector<LinearOctTreeEntry_t> &entries, std::vector<LinearOctTreeNode_t> &nodes, std::vector<unsigned int> &nodesEnd, std::vector<unsigned int> &nodesDepth, unsigned int splitDepth);
+                inline void mergeSubtrees(LinearOctTreeBuild_t &build);
+                inline void computeBoundingBoxes(std::vector<LinearOctTreeNode_t> &nodes, unsigned int nodesCount);
+                inline void prepareBatch(LinearOctTreeBatch_t &batch, unsigned int queriesCount);
+                inline void runRange(tasks::JobScheduler *jobScheduler, unsigned int count, unsigned int chunkSize, tasks::JobRangeFunction_t rangeFunction, void *arguments, std::vector<tasks::JobRange_t> &jobRanges);
+                inline unsigned long long expandBits(unsigned int value);
+                inline unsigned int getChildCount(unsigned char childMask);
+                template<typename T> inline void visitShapeElements(const T &shape, OctTreeVisitor_t visitor, void *parameters);
+                static void computeEntriesRange(void *arguments, unsigned int start, unsigned int end);
+                static void sortBucketsRange(void *arguments, unsigned int start, unsigned int end);
+                static void fillElementsRange(void *arguments, unsigned int start, unsigned int end);
+                static void buildSubtreesRange(void *arguments, unsigned int start, unsigned int end);
+                static void runBoxQueriesRange(void *arguments, unsigned int start, unsigned int end);
+                static void runFrustumQueriesRange(void *arguments, unsigned int start, unsigned int end);
+                static void setBatchResults(LinearOctTreeBatch_t &batch, std::vector<void *> &buffer, unsigned int *offsets, unsigned int start, unsigned int end);
+
+            public:
+                LinearOctTree();
+                LinearOctTree(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount);
+                LinearOctTree(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount, tasks::JobScheduler *jobScheduler);
+                ~LinearOctTree();
+                void build(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount);
+                void build(void **elements, Box3d_t *elementBoxes, unsigned int elementsCount, tasks::JobScheduler *jobScheduler);
+                void clear();
+                std::vector<void *> getBoxElements(Box3d_t *queryBox);
+                void getBoxElements(Box3d_t *queryBox, std::vector<void *> &elements);
+                void visitBoxElements(Box3d_t *queryBox, OctTreeVisitor_t visitor, void *parameters);
+                void getSphereElements(const Coordinate3d_t &center, float radius, std::vector<void *> &elements);
+                void visitSphereElements(const Coordinate3d_t &center, float radius, OctTreeVisitor_t visitor, void *parameters);
+                void getFrustumElements(const Frustum3d_t &frustum, std::vector<void *> &elements);
+                void visitFrustumElements(const Frustum3d_t &frustum, OctTreeVisitor_t visitor, void *parameters);
+                void getRayElements(const Coordinate3d_t &origin, const Coordinate3d_t &direction, float maximumDistance, std::vector<OctTreeHit_t> &hits);
+                void getBoxElementsBatch(Box3d_t *queryBoxes, unsigned int queriesCount, LinearOctTreeBatch_t &batch, tasks::JobScheduler *jobScheduler);
+                void getFrustumElementsBatch(Frustum3d_t *frustums, unsigned int queriesCount, LinearOctTreeBatch_t &batch, tasks::JobScheduler *jobScheduler);
+                std::vector<LinearOctTreeNode_t> &getNodes();
+                unsigned int getElementsCount();
+        };
+
+        bool compareEntryKey(const LinearOctTreeEntry_t &firstEntry, const LinearOctTreeEntry_t &secondEntry);
+    }
+}
@@ -0,0 +1,47 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+/**
+ * The number of values of a 4x4 matrix.
+ */
+#define MATRIX_4D_VALUES 16
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * Represents a 4x4 matrix used for the transforms
+         * in a 3d space, the values are stored in column
+         * major order (as in opengl).
+         *
+         * @param values The values of the matrix.
+         */
+        typedef struct Matrix4d_t {
+            float values[MATRIX_4D_VALUES];
+        } Matrix4d;
+    }
+}
@@ -36,12 +36,42 @@ namespace mariachi {
             TRIANGLE_FAN
         } MeshType;
 
+        typedef enum MeshIndexType_t {
+            SHORT_INDEX = 1,
+            INT_INDEX
+        } MeshIndexType;
+
+        /**
+         * Represents a mesh, the vertices are drawn in order
+         * or, in case the index list is set, using the index
+         * list (indexed mesh).
+         *
+         * @param type The type of primitive of the mesh.
+         * @param position The position of the mesh.
+         * @param numberVertices The number of vertices.
+         * @param vertexList The coordinates of the vertices (three per vertex).
+         * @param textureVertexList The texture coordinates of the vertices
+         * (two per vertex).
+         * @param dynamic If the vertices change (not cached in the gpu).
+         * @param numberIndexes The number of indexes (zero in case the
+         * mesh is not indexed).
+         * @param indexType The type of the indexes (16 or 32 bit).
+         * @param indexList The indexes of the vertices to be drawn.
+         * @param generation The (unique) generation of the mesh, identifies
+         * the mesh in the render adapter caches (the address of a released
+         * mesh may be reused).
+         */
         typedef struct Mesh_t {
             MeshType_t type;
             Coordinate3d_t position;
             unsigned int numberVertices;
             float *vertexList;
             float *textureVertexList;
+            bool dynamic;
+            unsigned int numberIndexes;
+            MeshIndexType_t indexType;
+            void *indexList;
+            unsigned long generation;
         } Mesh;
     }
 }
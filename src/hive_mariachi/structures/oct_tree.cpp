@@ -25,7 +25,10 @@
 
 #include "stdafx.h"
 
+#include <cassert>
+
 #include "../util/util.h"
+#include "oct_tree_shape.h"
 #include "oct_tree.h"
 
 using namespace mariachi::util;
@@ -35,6 +38,8 @@ using namespace mariachi::structures;
  * Constructor of the class.
  */
 OctTree::OctTree() {
+    this->initRootNode();
+    this->initQuery();
 }
 
 /**
@@ -43,6 +48,8 @@ OctTree::OctTree() {
 OctTree::OctTree(Box3d_t boundingBox) {
     // creates the root node using the provided bounding box
     this->rootNode = new OctTreeNode(boundingBox);
+
+    this->initQuery();
 }
 
 /**
@@ -51,6 +58,17 @@ OctTree::OctTree(Box3d_t boundingBox) {
 OctTree::OctTree(float boxWidth, float boxHeight, float boxDepth) {
     // creates the root node using the provided dimensions
     this->rootNode = new OctTreeNode(boxWidth, boxHeight, boxDepth);
+
+    this->initQuery();
+}
+
+inline void OctTree::initRootNode() {
+    this->rootNode = NULL;
+}
+
+inline void OctTree::initQuery() {
+    this->queryStamp = 0;
+    this->queryFlag = false;
 }
 
 /**
@@ -69,17 +87,556 @@ OctTree::~OctTree() {
  * @param elementBoundingBox The box bounding the inserted element.
  */
 void OctTree::insertElementBox(void *element, Box3d_t *elementBoundingBox) {
-    this->rootNode->insertElementBox(element, elementBoundingBox);
+    // in case the element is already in the oct tree
+    if(this->elementsMap.find(element) != this->elementsMap.end()) {
+        // moves the element to the new bounding box
+        this->updateElementBox(element, elementBoundingBox);
+
+        // returns immediately
+        return;
+    }
+
+    // retrieves the (new) oct tree element
+    OctTreeElement_t &octTreeElement = this->elementsMap[element];
+
+    // sets the element, bounding box and query stamp
+    octTreeElement.element = element;
+    octTreeElement.boundingBox = *elementBoundingBox;
+    octTreeElement.queryStamp = 0;
+
+    // inserts the element structure, retrieving the nodes containing it
+    this->rootNode->insertElementBox((void *) &octTreeElement, elementBoundingBox, &octTreeElement.nodes);
+}
+
+/**
+ * Removes an element from the oct tree, the nodes left
+ * empty are only collapsed in the next rebalance.
+ *
+ * @param element The element to be removed from the oct tree.
+ * @return If the element was in the oct tree.
+ */
+bool OctTree::removeElement(void *element) {
+    // retrieves the element iterator
+    std::map<void *, OctTreeElement_t>::iterator elementIterator = this->elementsMap.find(element);
+
+    // in case the element is not in the oct tree
+    if(elementIterator == this->elementsMap.end()) {
+        // returns false
+        return false;
+    }
+
+    // removes the element from its nodes
+    this->removeElementNodes(elementIterator->second);
+
+    // removes the element from the elements map
+    this->elementsMap.erase(elementIterator);
+
+    // returns true
+    return true;
+}
+
+/**
+ * Updates the bounding box of an element in the oct tree (moving it),
+ * in case the element is contained in a single node and stays
+ * inside the node's bounding box it's kept in the node.
+ *
+ * @param element The element to be moved.
+ * @param elementBoundingBox The new box bounding the element.
+ */
+void OctTree::updateElementBox(void *element, Box3d_t *elementBoundingBox) {
+    // retrieves the element iterator
+    std::map<void *, OctTreeElement_t>::iterator elementIterator = this->elementsMap.find(element);
+
+    // in case the element is not in the oct tree
+    if(elementIterator == this->elementsMap.end()) {
+        // inserts the element
+        this->insertElementBox(element, elementBoundingBox);
+
+        // returns immediately
+        return;
+    }
+
+    // retrieves the oct tree element
+    OctTreeElement_t &octTreeElement = elementIterator->second;
+
+    // sets the element bounding box
+    octTreeElement.boundingBox = *elementBoundingBox;
+
+    // in case the element stays inside its (single) node
+    if(octTreeElement.nodes.size() == 1 && BoxUtil::containsBox(octTreeElement.nodes[0]->getBoundingBox(), *elementBoundingBox)) {
+        // returns immediately (fast path)
+        return;
+    }
+
+    // removes the element from its nodes
+    this->removeElementNodes(octTreeElement);
+
+    // inserts the element structure, retrieving the nodes containing it
+    this->rootNode->insertElementBox((void *) &octTreeElement, elementBoundingBox, &octTreeElement.nodes);
 }
 
 /**
- * Retrieves the elements bounded by the provided query box.
- * Delegates the retrieval process to the root node.
+ * Rebalances the oct tree, collapsing the (empty) children of the
+ * nodes changed by the removed (or moved) elements, the collapse
+ * is propagated to the ancestors left empty.
+ * Only the nodes changed since the last rebalance are visited.
  *
- * @param queryBox The box for which contained elements are retrieved.
- * @return The elements bounded by the provided box.
+ * @return The number of collapsed nodes.
+ */
+unsigned int OctTree::rebalance() {
+    // starts the number of collapsed nodes
+    unsigned int collapsedCount = 0;
+
+    // orders the collapse nodes by depth (as a heap with the deepest
+    // node first), so that the nodes are collapsed before their
+    // ancestors (which delete them)
+    std::make_heap(this->collapseNodes.begin(), this->collapseNodes.end(), compareNodeDepth);
+
+    // iterates while there are collapse nodes
+    while(!this->collapseNodes.empty()) {
+        // retrieves and removes the deepest collapse node
+        std::pop_heap(this->collapseNodes.begin(), this->collapseNodes.end(), compareNodeDepth);
+        OctTreeNode *collapseNode = this->collapseNodes.back();
+        this->collapseNodes.pop_back();
+
+        // collapses the node (in case all the children are empty)
+        if(!collapseNode->collapse()) {
+            // continues the loop
+            continue;
+        }
+
+        // increments the number of collapsed nodes
+        collapsedCount++;
+
+        // retrieves the parent node
+        OctTreeNode *parentNode = collapseNode->getParentNode();
+
+        // in case the node is left empty and the parent is not yet pending
+        if(collapseNode->isEmpty() && parentNode && !parentNode->getCollapsePending()) {
+            // adds the parent node to the collapse nodes
+            parentNode->setCollapsePending(true);
+            this->collapseNodes.push_back(parentNode);
+            std::push_heap(this->collapseNodes.begin(), this->collapseNodes.end(), compareNodeDepth);
+        }
+    }
+
+    // returns the number of collapsed nodes
+    return collapsedCount;
+}
+
+/**
+ * Retrieves the elements intersecting the provided query box.
+ *
+ * @param queryBox The box for which intersecting elements are retrieved.
+ * @return The elements intersecting the provided box.
  */
 std::vector<void *> OctTree::getBoxElements(Box3d_t *queryBox) {
-    std::vector<void *> elements = this->rootNode->getBoxElements(queryBox);
+    std::vector<void *> elements;
+    this->getBoxElements(queryBox, elements);
     return elements;
 }
+
+/**
+ * Retrieves the elements intersecting the provided query box,
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param queryBox The box for which intersecting elements are retrieved.
+ * @param elements The buffer to be filled with the elements.
+ */
+void OctTree::getBoxElements(Box3d_t *queryBox, std::vector<void *> &elements) {
+    this->visitBoxElements(queryBox, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided query box.
+ *
+ * @param queryBox The box for which intersecting elements are visited.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void OctTree::visitBoxElements(Box3d_t *queryBox, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the box shape
+    OctTreeBoxShape_t boxShape;
+    boxShape.box = *queryBox;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(boxShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements intersecting the provided sphere,
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @param elements The buffer to be filled with the elements.
+ */
+void OctTree::getSphereElements(const Coordinate3d_t &center, float radius, std::vector<void *> &elements) {
+    this->visitSphereElements(center, radius, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided sphere.
+ *
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void OctTree::visitSphereElements(const Coordinate3d_t &center, float radius, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the sphere shape
+    OctTreeSphereShape_t sphereShape;
+    sphereShape.center = center;
+    sphereShape.squaredRadius = radius * radius;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(sphereShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements intersecting the provided frustum (culling),
+ * the elements are added to the given (reused) buffer.
+ *
+ * @param frustum The frustum to be used in the query.
+ * @param elements The buffer to be filled with the elements.
+ */
+void OctTree::getFrustumElements(const Frustum3d_t &frustum, std::vector<void *> &elements) {
+    this->visitFrustumElements(frustum, pushOctTreeElement, (void *) &elements);
+}
+
+/**
+ * Visits the elements intersecting the provided frustum.
+ *
+ * @param frustum The frustum to be used in the query.
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+void OctTree::visitFrustumElements(const Frustum3d_t &frustum, OctTreeVisitor_t visitor, void *parameters) {
+    // creates the frustum shape
+    OctTreeFrustumShape_t frustumShape;
+    frustumShape.frustum = frustum;
+
+    // visits the elements intersecting the shape
+    this->visitShapeElements(frustumShape, visitor, parameters);
+}
+
+/**
+ * Retrieves the elements hit by the provided ray (picking), the hits
+ * are added to the given (reused) buffer sorted by distance.
+ *
+ * @param origin The origin of the ray.
+ * @param direction The (normalized) direction of the ray.
+ * @param maximumDistance The maximum distance along the ray.
+ * @param hits The buffer to be filled with the hits.
+ */
+void OctTree::getRayElements(const Coordinate3d_t &origin, const Coordinate3d_t &direction, float maximumDistance, std::vector<OctTreeHit_t> &hits) {
+    // retrieves the start of the hits (the buffer may not be empty)
+    size_t hitsStart = hits.size();
+
+    // creates a new query stamp
+    unsigned int queryStamp = this->createQueryStamp();
+
+    // computes the inverse of the direction
+    Coordinate3d_t inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+    // allocates the distance
+    float distance;
+
+    // clears the nodes stack and pushes the root node
+    this->nodesStack.clear();
+    this->nodesStack.push_back(this->rootNode);
+
+    // until the stack is empty
+    while(!this->nodesStack.empty()) {
+        // retrieves and removes the current node
+        OctTreeNode *currentNode = this->nodesStack.back();
+        this->nodesStack.pop_back();
+
+        // in case the ray does not hit the node
+        if(!BoxUtil::intersectsRay(currentNode->getBoundingBox(), origin, inverseDirection, maximumDistance, distance)) {
+            // continues the loop
+            continue;
+        }
+
+        // retrieves the current node elements
+        std::vector<void *> &elements = currentNode->getElements();
+
+        // for all the elements
+        for(unsigned int i = 0; i < elements.size(); i++) {
+            // retrieves the oct tree element
+            OctTreeElement_t *octTreeElement = (OctTreeElement_t *) elements[i];
+
+            // in case the element was already visited
+            if(octTreeElement->queryStamp == queryStamp) {
+                // continues the loop
+                continue;
+            }
+
+            // marks the element as visited
+            octTreeElement->queryStamp = queryStamp;
+
+            // in case the ray hits the element
+            if(BoxUtil::intersectsRay(octTreeElement->boundingBox, origin, inverseDirection, maximumDistance, distance)) {
+                // adds the hit
+                OctTreeHit_t hit = { octTreeElement->element, distance };
+                hits.push_back(hit);
+            }
+        }
+
+        // pushes the child nodes
+        std::vector<OctTreeNode *> &childNodes = currentNode->getChildNodes();
+        this->nodesStack.insert(this->nodesStack.end(), childNodes.begin(), childNodes.end());
+    }
+
+    // sorts the (new) hits by distance
+    std::sort(hits.begin() + hitsStart, hits.end(), compareHitDistance);
+}
+
+/**
+ * Retrieves the nearest elements to the provided point (k nearest
+ * neighbours), using a best first traversal of the tree. The hits are
+ * added to the given (reused) buffer sorted by distance.
+ *
+ * @param point The point for which the nearest elements are retrieved.
+ * @param count The (maximum) number of elements to be retrieved.
+ * @param maximumDistance The maximum distance to the point.
+ * @param hits The buffer to be filled with the hits.
+ */
+void OctTree::getNearestElements(const Coordinate3d_t &point, unsigned int count, float maximumDistance, std::vector<OctTreeHit_t> &hits) {
+    // creates a new query stamp
+    unsigned int queryStamp = this->createQueryStamp();
+
+    // computes the maximum squared distance
+    float maximumSquaredDistance = maximumDistance * maximumDistance;
+
+    // starts the number of retrieved elements
+    unsigned int retrievedCount = 0;
+
+    // clears the query queue and pushes the root node
+    OctTreeQueueEntry_t rootEntry = { BoxUtil::getSquaredDistance(this->rootNode->getBoundingBox(), point), this->rootNode, NULL };
+    this->queryQueue.clear();
+    this->queryQueue.push_back(rootEntry);
+
+    // until the queue is empty or all the elements are retrieved
+    while(!this->queryQueue.empty() && retrievedCount < count) {
+        // retrieves and removes the nearest entry
+        std::pop_heap(this->queryQueue.begin(), this->queryQueue.end(), compareQueueEntryDistance);
+        OctTreeQueueEntry_t entry = this->queryQueue.back();
+        this->queryQueue.pop_back();
+
+        // in case the entry is beyond the maximum distance
+        if(entry.distance > maximumSquaredDistance) {
+            // breaks the loop (all the remaining entries are further)
+            break;
+        }
+
+        // in case the entry is an element
+        if(entry.element) {
+            // in case the element was already retrieved
+            if(entry.element->queryStamp == queryStamp) {
+                // continues the loop
+                continue;
+            }
+
+            // marks the element as retrieved
+            entry.element->queryStamp = queryStamp;
+
+            // adds the hit (no closer element remains in the queue)
+            OctTreeHit_t hit = { entry.element->element, sqrt(entry.distance) };
+            hits.push_back(hit);
+
+            // increments the number of retrieved elements
+            retrievedCount++;
+
+            // continues the loop
+            continue;
+        }
+
+        // retrieves the entry node elements
+        std::vector<void *> &elements = entry.node->getElements();
+
+        // for all the elements
+        for(unsigned int i = 0; i < elements.size(); i++) {
+            // retrieves the oct tree element
+            OctTreeElement_t *octTreeElement = (OctTreeElement_t *) elements[i];
+
+            // in case the element was already retrieved
+            if(octTreeElement->queryStamp == queryStamp) {
+                // continues the loop
+                continue;
+            }
+
+            // pushes the element entry
+            OctTreeQueueEntry_t elementEntry = { BoxUtil::getSquaredDistance(octTreeElement->boundingBox, point), NULL, octTreeElement };
+            this->queryQueue.push_back(elementEntry);
+            std::push_heap(this->queryQueue.begin(), this->queryQueue.end(), compareQueueEntryDistance);
+        }
+
+        // retrieves the entry node child nodes
+        std::vector<OctTreeNode *> &childNodes = entry.node->getChildNodes();
+
+        // for all the child nodes
+        for(unsigned int i = 0; i < childNodes.size(); i++) {
+            // pushes the child node entry
+            OctTreeQueueEntry_t childEntry = { BoxUtil::getSquaredDistance(childNodes[i]->getBoundingBox(), point), childNodes[i], NULL };
+            this->queryQueue.push_back(childEntry);
+            std::push_heap(this->queryQueue.begin(), this->queryQueue.end(), compareQueueEntryDistance);
+        }
+    }
+}
+
+/**
+ * Retrieves the number of elements in the oct tree.
+ *
+ * @return The number of elements in the oct tree.
+ */
+unsigned int OctTree::getElementsCount() {
+    return this->elementsMap.size();
+}
+
+inline void OctTree::removeElementNodes(OctTreeElement_t &octTreeElement) {
+    // caches the element nodes vector size
+    unsigned int nodesSize = octTreeElement.nodes.size();
+
+    // for all the element nodes
+    for(unsigned int i = 0; i < nodesSize; i++) {
+        // removes the element structure from the node
+        octTreeElement.nodes[i]->removeElement((void *) &octTreeElement, this->collapseNodes);
+    }
+
+    // clears the element nodes
+    octTreeElement.nodes.clear();
+}
+
+/**
+ * Creates a new query stamp, in case the stamps wrap around
+ * the stamps of all the elements are reset.
+ *
+ * @return The new query stamp.
+ */
+inline unsigned int OctTree::createQueryStamp() {
+    // asserts that no query is running (the nested queries
+    // would reset the traversal buffers and stamps in use)
+    assert(!this->queryFlag);
+
+    // in case the query stamp wraps around
+    if(++this->queryStamp == 0) {
+        // retrieves the elements map iterator
+        std::map<void *, OctTreeElement_t>::iterator elementsIterator = this->elementsMap.begin();
+
+        // iterates over all the elements
+        while(elementsIterator != this->elementsMap.end()) {
+            // resets the element query stamp
+            elementsIterator->second.queryStamp = 0;
+
+            // increments the elements iterator
+            elementsIterator++;
+        }
+
+        // sets the first query stamp
+        this->queryStamp = 1;
+    }
+
+    // returns the query stamp
+    return this->queryStamp;
+}
+
+/**
+ * Visits the elements intersecting the provided shape, only the
+ * nodes intersecting the shape are traversed and each element is
+ * visited once (even if split in several nodes).
+ *
+ * @param shape The shape (with the box intersection test).
+ * @param visitor The function called for each element.
+ * @param parameters The parameters passed to the visitor.
+ */
+template<typename T> inline void OctTree::visitShapeElements(const T &shape, OctTreeVisitor_t visitor, void *parameters) {
+    // creates a new query stamp
+    unsigned int queryStamp = this->createQueryStamp();
+
+    // sets the query flag (the visitor must not query the tree)
+    this->queryFlag = true;
+
+    // clears the nodes stack and pushes the root node
+    this->nodesStack.clear();
+    this->nodesStack.push_back(this->rootNode);
+
+    // until the stack is empty
+    while(!this->nodesStack.empty()) {
+        // retrieves and removes the current node
+        OctTreeNode *currentNode = this->nodesStack.back();
+        this->nodesStack.pop_back();
+
+        // in case the shape does not intersect the node
+        if(!shape.intersectsBox(currentNode->getBoundingBox())) {
+            // continues the loop
+            continue;
+        }
+
+        // retrieves the current node elements
+        std::vector<void *> &elements = currentNode->getElements();
+
+        // for all the elements
+        for(unsigned int i = 0; i < elements.size(); i++) {
+            // retrieves the oct tree element
+            OctTreeElement_t *octTreeElement = (OctTreeElement_t *) elements[i];
+
+            // in case the element was already visited
+            if(octTreeElement->queryStamp == queryStamp) {
+                // continues the loop
+                continue;
+            }
+
+            // marks the element as visited
+            octTreeElement->queryStamp = queryStamp;
+
+            // in case the shape intersects the element
+            if(shape.intersectsBox(octTreeElement->boundingBox)) {
+                // visits the element
+                visitor(octTreeElement->element, parameters);
+            }
+        }
+
+        // pushes the child nodes
+        std::vector<OctTreeNode *> &childNodes = currentNode->getChildNodes();
+        this->nodesStack.insert(this->nodesStack.end(), childNodes.begin(), childNodes.end());
+    }
+
+    // unsets the query flag
+    this->queryFlag = false;
+}
+
+/**
+ * Compares two oct tree nodes by depth, used to order the
+ * collapse nodes heap (with the deepest node on top).
+ *
+ * @param firstNode The first node to be compared.
+ * @param secondNode The second node to be compared.
+ * @return If the first node is shallower than the second node.
+ */
+bool mariachi::structures::compareNodeDepth(OctTreeNode *firstNode, OctTreeNode *secondNode) {
+    return firstNode->getDepth() < secondNode->getDepth();
+}
+
+/**
+ * Compares two oct tree hits by distance (nearest first).
+ *
+ * @param firstHit The first hit to be compared.
+ * @param secondHit The second hit to be compared.
+ * @return If the first hit is nearer than the second hit.
+ */
+bool mariachi::structures::compareHitDistance(const OctTreeHit_t &firstHit, const OctTreeHit_t &secondHit) {
+    return firstHit.distance < secondHit.distance;
+}
+
+/**
+ * Compares two queue entries by distance, used to order the
+ * best first traversal heap (with the nearest entry on top).
+ *
+ * @param firstEntry The first entry to be compared.
+ * @param secondEntry The second entry to be compared.
+ * @return If the first entry is further than the second entry.
+ */
+bool mariachi::structures::compareQueueEntryDistance(const OctTreeQueueEntry_t &firstEntry, const OctTreeQueueEntry_t &secondEntry) {
+    return firstEntry.distance > secondEntry.distance;
+}
@@ -26,18 +26,96 @@
 #pragma once
 
 #include "oct_tree_node.h"
+#include "oct_tree_query.h"
+#include "frustum.h"
 #include "box.h"
 
 namespace mariachi {
     namespace structures {
         class OctTreeNode;
 
+        /**
+         * Structure describing an element inserted in the oct tree,
+         * with back references to the nodes containing it.
+         * The nodes contain the pointers to these structures.
+         *
+         * @param element The element (as inserted).
+         * @param boundingBox The box bounding the element.
+         * @param nodes The nodes containing the element.
+         * @param queryStamp The stamp of the last query to visit the element.
+         */
+        typedef struct OctTreeElement_t {
+            void *element;
+            Box3d_t boundingBox;
+            std::vector<OctTreeNode *> nodes;
+            unsigned int queryStamp;
+        } OctTreeElement;
+
+        /**
+         * Structure describing an entry of the best first traversal
+         * queue, either a node or an element.
+         *
+         * @param distance The (squared) distance to the node or element.
+         * @param node The node of the entry (null for elements).
+         * @param element The element of the entry (null for nodes).
+         */
+        typedef struct OctTreeQueueEntry_t {
+            float distance;
+            OctTreeNode *node;
+            OctTreeElement_t *element;
+        } OctTreeQueueEntry;
+
         /**
          * Represents an oct tree in 3d space.
          * Used for partioning a 3d environment into octants for faster spatial queries.
+         * The elements may be removed or moved, the nodes left empty are
+         * collapsed lazily (in the rebalance).
+         * The queries fill the given buffers (or call the given visitor)
+         * and reuse the tree's traversal buffers, so the queries over the
+         * same tree must not run concurrently nor be nested (a visitor
+         * must not query the tree it's visiting).
          */
         class OctTree {
             private:
+                /**
+                 * The map associating the elements with their
+                 * bounding box and containing nodes.
+                 */
+                std::map<void *, OctTreeElement_t> elementsMap;
+
+                /**
+                 * The nodes pending to have their (empty)
+                 * children collapsed.
+                 */
+                std::vector<OctTreeNode *> collapseNodes;
+
+                /**
+                 * The stamp of the current query, used to visit
+                 * each element (split in several nodes) once.
+                 */
+                unsigned int queryStamp;
+
+                /**
+                 * If a query is running (used to detect nested
+                 * queries, not supported).
+                 */
+                bool queryFlag;
+
+                /**
+                 * The stack of nodes used in the traversals.
+                 */
+                std::vector<OctTreeNode *> nodesStack;
+
+                /**
+                 * The queue (heap) used in the best first traversals.
+                 */
+                std::vector<OctTreeQueueEntry_t> queryQueue;
+
+                inline void initRootNode();
+                inline void initQuery();
+                inline void removeElementNodes(OctTreeElement_t &octTreeElement);
+                inline unsigned int createQueryStamp();
+                template<typename T> inline void visitShapeElements(const T &shape, OctTreeVisitor_t visitor, void *parameters);
 
             public:
                 /**
@@ -50,7 +128,22 @@ namespace mariachi {
                 OctTree(float boxWidth, float boxHeight, float boxDepth);
                 ~OctTree();
                 void insertElementBox(void *element, Box3d_t *elementBoundingBox);
+                bool removeElement(void *element);
+                void updateElementBox(void *element, Box3d_t *elementBoundingBox);
+                unsigned int rebalance();
                 std::vector<void *> getBoxElements(Box3d_t *queryBox);
+                void getBoxElements(Box3d_t *queryBox, std::vector<void *> &elements);
+                void visitBoxElements(Box3d_t *queryBox, OctTreeVisitor_t visitor, void *parameters);
+                void getSphereElements(const Coordinate3d_t &center, float radius, std::vector<void *> &elements);
+                void visitSphereElements(const Coordinate3d_t &center, float radius, OctTreeVisitor_t visitor, void *parameters);
+                void getFrustumElements(const Frustum3d_t &frustum, std::vector<void *> &elements);
+                void visitFrustumElements(const Frustum3d_t &frustum, OctTreeVisitor_t visitor, void *parameters);
+                void getRayElements(const Coordinate3d_t &origin, const Coordinate3d_t &direction, float maximumDistance, std::vector<OctTreeHit_t> &hits);
+                void getNearestElements(const Coordinate3d_t &point, unsigned int count, float maximumDistance, std::vector<OctTreeHit_t> &hits);
+                unsigned int getElementsCount();
         };
+
+        bool compareNodeDepth(OctTreeNode *firstNode, OctTreeNode *secondNode);
+        bool compareQueueEntryDistance(const OctTreeQueueEntry_t &firstEntry, const OctTreeQueueEntry_t &secondEntry);
     }
 }
@@ -35,12 +35,15 @@ using namespace mariachi::structures;
  * Constructor of the class.
  */
 OctTreeNode::OctTreeNode() {
+    this->initNode();
 }
 
 /**
  * Constructor of the class with bounding box.
  */
 OctTreeNode::OctTreeNode(Box3d_t boundingBox) {
+    this->initNode();
+
     // copies the provided bounding box
     this->boundingBox = boundingBox;
 }
@@ -49,6 +52,8 @@ OctTreeNode::OctTreeNode(Box3d_t boundingBox) {
  * Constructor of the class with bounding box extents.
  */
 OctTreeNode::OctTreeNode(float boxWidth, float boxHeight, float boxDepth) {
+    this->initNode();
+
     // updates the bounding box limits
     this->boundingBox.x1 = 0.0;
     this->boundingBox.y1 = 0.0;
@@ -72,6 +77,12 @@ OctTreeNode::~OctTreeNode() {
     }
 }
 
+inline void OctTreeNode::initNode() {
+    this->parentNode = NULL;
+    this->depth = 0;
+    this->collapsePending = false;
+}
+
 /**
  * Inserts an element into the oct tree.
  * Inserts into the element list in case of overlapping (black boxes),
@@ -82,6 +93,20 @@ OctTreeNode::~OctTreeNode() {
  * @param elementBoundingBox The box bounding the inserted element.
  */
 void OctTreeNode::insertElementBox(void *element, Box3d_t *elementBoundingBox) {
+    this->insertElementBox(element, elementBoundingBox, NULL);
+}
+
+/**
+ * Inserts an element into the oct tree, retrieving the nodes
+ * in which the element was inserted (back references used to
+ * remove or move the element).
+ *
+ * @param element The element to insert in the oct tree node.
+ * @param elementBoundingBox The box bounding the inserted element.
+ * @param elementNodes The list to be filled with the nodes containing
+ * the element (may be null).
+ */
+void OctTreeNode::insertElementBox(void *element, Box3d_t *elementBoundingBox, std::vector<OctTreeNode *> *elementNodes) {
     // initializes the stack of nodes to process
     std::vector<OctTreeNodeBox3d_t> nodesStack;
 
@@ -123,7 +148,7 @@ void OctTreeNode::insertElementBox(void *element, Box3d_t *elementBoundingBox) {
         // tests for overlapping
         if (BoxUtil::overlaps(currentNode->boundingBox, currentBox)) {
             // adds the element
-            currentNode->elements.push_back(element);
+            currentNode->addElement(element, elementNodes);
 
             // continues the loop
             continue;
@@ -139,7 +164,7 @@ void OctTreeNode::insertElementBox(void *element, Box3d_t *elementBoundingBox) {
             // else stops descent and adds the element
             else {
                 // adds the element
-                currentNode->elements.push_back(element);
+                currentNode->addElement(element, elementNodes);
 
                 // continues the loop
                 continue;
@@ -517,6 +542,85 @@ void OctTreeNode::insertElementBox(void *element, Box3d_t *elementBoundingBox) {
     }
 }
 
+/**
+ * Removes an element from the oct tree node, in case the node is
+ * left empty its parent is added to the collapse nodes list (the
+ * children are collapsed lazily).
+ *
+ * @param element The element to be removed from the oct tree node.
+ * @param collapseNodes The list of nodes pending to be collapsed.
+ */
+void OctTreeNode::removeElement(void *element, std::vector<OctTreeNode *> &collapseNodes) {
+    // caches the elements vector size
+    unsigned int elementsSize = this->elements.size();
+
+    // for all the elements
+    for(unsigned int i = 0; i < elementsSize; i++) {
+        // in case the element is not the one to be removed
+        if(this->elements[i] != element) {
+            // continues the loop
+            continue;
+        }
+
+        // replaces the element with the last one (the
+        // order of the elements is not relevant)
+        this->elements[i] = this->elements[elementsSize - 1];
+        this->elements.pop_back();
+
+        // in case the node is left empty and the parent
+        // is not yet pending
+        if(this->isEmpty() && this->parentNode && !this->parentNode->collapsePending) {
+            // adds the parent node to the collapse nodes
+            this->parentNode->collapsePending = true;
+            collapseNodes.push_back(this->parentNode);
+        }
+
+        // returns immediately
+        return;
+    }
+}
+
+/**
+ * Collapses the node's children in case all of them are
+ * empty (no elements and no children).
+ *
+ * @return If the node's children were collapsed.
+ */
+bool OctTreeNode::collapse() {
+    // unsets the collapse pending flag
+    this->collapsePending = false;
+
+    // caches the child nodes vector size
+    unsigned int childNodesSize = this->childNodes.size();
+
+    // in case the node has no children
+    if(childNodesSize == 0) {
+        // returns false
+        return false;
+    }
+
+    // for all the child nodes
+    for(unsigned int i = 0; i < childNodesSize; i++) {
+        // in case the child node is not empty
+        if(!this->childNodes[i]->isEmpty()) {
+            // returns false
+            return false;
+        }
+    }
+
+    // for all the child nodes
+    for(unsigned int i = 0; i < childNodesSize; i++) {
+        // deletes the child node object
+        delete this->childNodes[i];
+    }
+
+    // clears the child nodes
+    this->childNodes.clear();
+
+    // returns true
+    return true;
+}
+
 /**
  * Retrieves the elements bounded by the provided query box.
  *
@@ -974,7 +1078,15 @@ std::vector<void *> OctTreeNode::getBoxElements(Box3d_t *queryBox) {
  * @param boundingBox The bounding box for the child node.
  */
 inline OctTreeNode *OctTreeNode::createChildNode(Box3d_t &boundingBox) {
-    return new OctTreeNode(boundingBox);
+    // creates the child node
+    OctTreeNode *childNode = new OctTreeNode(boundingBox);
+
+    // sets the child node parent and depth
+    childNode->parentNode = this;
+    childNode->depth = this->depth + 1;
+
+    // returns the child node
+    return childNode;
 }
 
 /**
@@ -1045,7 +1157,7 @@ inline int OctTreeNode::getPointOctant(const Coordinate3d_t &point) {
         OctTreeNode *childNode = this->childNodes[i];
 
         // in case the given point is inside the node
-        if (BoxUtil::containsPoint(this->boundingBox, point)) {
+        if (BoxUtil::containsPoint(childNode->boundingBox, point)) {
             // signals the index was found
             octantIndex = i;
             break;
@@ -1085,3 +1197,57 @@ inline bool OctTreeNode::isSubdividable() {
     // the node is subdividable if its volume is greater or equal to the minimum volume
     return volume >= MIN_SUBDIVIDABLE_VOLUME;
 }
+
+/**
+ * Adds an element to the node's elements.
+ *
+ * @param element The element to be added.
+ * @param elementNodes The list to be filled with the node (may be null).
+ */
+inline void OctTreeNode::addElement(void *element, std::vector<OctTreeNode *> *elementNodes) {
+    // adds the element
+    this->elements.push_back(element);
+
+    // in case the element nodes are requested
+    if(elementNodes) {
+        // adds the node to the element nodes
+        elementNodes->push_back(this);
+    }
+}
+
+Box3d_t &OctTreeNode::getBoundingBox() {
+    return this->boundingBox;
+}
+
+OctTreeNode *OctTreeNode::getParentNode() {
+    return this->parentNode;
+}
+
+unsigned int OctTreeNode::getDepth() {
+    return this->depth;
+}
+
+std::vector<OctTreeNode *> &OctTreeNode::getChildNodes() {
+    return this->childNodes;
+}
+
+std::vector<void *> &OctTreeNode::getElements() {
+    return this->elements;
+}
+
+bool OctTreeNode::getCollapsePending() {
+    return this->collapsePending;
+}
+
+void OctTreeNode::setCollapsePending(bool collapsePending) {
+    this->collapsePending = collapsePending;
+}
+
+/**
+ * Indicates if the node is empty (no elements and no children).
+ *
+ * @return If the node is empty.
+ */
+bool OctTreeNode::isEmpty() {
+    return this->elements.empty() && this->childNodes.empty();
+}
@@ -61,11 +61,29 @@ namespace mariachi {
                  */
                 Box3d_t boundingBox;
 
+                /**
+                 * The node's parent (null for the root node).
+                 */
+                OctTreeNode *parentNode;
+
+                /**
+                 * The node's depth in the tree (zero for the root node).
+                 */
+                unsigned int depth;
+
+                /**
+                 * If the node is pending to have its (empty)
+                 * children collapsed.
+                 */
+                bool collapsePending;
+
+                inline void initNode();
                 inline OctTreeNode *createChildNode(Box3d_t &boundingBox);
                 inline void generateChildNodes();
                 inline int getPointOctant(const Coordinate3d_t &point);
                 inline void pushNodeBoxes(int node_count, OctTreeNode **nodes, Box3d_t *boxes, OctTreeNodeBox3d_t *nodeBoxes, std::vector<OctTreeNodeBox3d_t> &nodesStack);
                 inline bool isSubdividable();
+                inline void addElement(void *element, std::vector<OctTreeNode *> *elementNodes);
 
             public:
                 OctTreeNode();
@@ -73,7 +91,18 @@ namespace mariachi {
                 OctTreeNode(float boxWidth, float boxHeight, float boxDepth);
                 ~OctTreeNode();
                 void insertElementBox(void *element, Box3d_t *elementBoundingBox);
+                void insertElementBox(void *element, Box3d_t *elementBoundingBox, std::vector<OctTreeNode *> *elementNodes);
+                void removeElement(void *element, std::vector<OctTreeNode *> &collapseNodes);
+                bool collapse();
+                bool isEmpty();
                 std::vector<void *> getBoxElements(Box3d_t *queryBox);
+                Box3d_t &getBoundingBox();
+                std::vector<OctTreeNode *> &getChildNodes();
+                std::vector<void *> &getElements();
+                OctTreeNode *getParentNode();
+                unsigned int getDepth();
+                bool getCollapsePending();
+                void setCollapsePending(bool collapsePending);
                 std::string toString(std::string padding);
         };
 
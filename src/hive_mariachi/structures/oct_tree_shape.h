@@ -0,0 +1,79 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../util/box_util.h"
+#include "../util/frustum_util.h"
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * The box shape used in the (oct tree) box queries.
+         */
+        typedef struct OctTreeBoxShape_t {
+            Box3d_t box;
+
+            inline bool intersectsBox(const Box3d_t &boundingBox) const {
+                return util::BoxUtil::intersects(this->box, boundingBox);
+            }
+        } OctTreeBoxShape;
+
+        /**
+         * The sphere shape used in the (oct tree) sphere queries.
+         */
+        typedef struct OctTreeSphereShape_t {
+            Coordinate3d_t center;
+            float squaredRadius;
+
+            inline bool intersectsBox(const Box3d_t &boundingBox) const {
+                return util::BoxUtil::getSquaredDistance(boundingBox, this->center) <= this->squaredRadius;
+            }
+        } OctTreeSphereShape;
+
+        /**
+         * The frustum shape used in the (oct tree) frustum queries.
+         */
+        typedef struct OctTreeFrustumShape_t {
+            Frustum3d_t frustum;
+
+            inline bool intersectsBox(const Box3d_t &boundingBox) const {
+                return util::FrustumUtil::containsBox(this->frustum, boundingBox);
+            }
+        } OctTreeFrustumShape;
+
+        /**
+         * Adds the element to the elements list given as parameters,
+         * used to fill the query buffers.
+         *
+         * @param element The element to be added.
+         * @param parameters The elements list.
+         */
+        inline void pushOctTreeElement(void *element, void *parameters) {
+            ((std::vector<void *> *) parameters)->push_back(element);
+        }
+    }
+}
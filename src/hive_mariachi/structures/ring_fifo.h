@@ -0,0 +1,389 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+#include "../system/thread.h"
+
+/**
+ * The default ring fifo size (rounded to
+ * a power of two).
+ */
+#define DEFAULT_RING_FIFO_SIZE 64
+
+/**
+ * The number of failed attempts made by a
+ * producer or consumer before parking.
+ */
+#define RING_FIFO_SPIN_COUNT 128
+
+/**
+ * The size of the cache line used to pad the
+ * ring fifo positions.
+ */
+#define RING_FIFO_CACHE_LINE_SIZE 64
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * Lock free bounded fifo (multiple producers and consumers)
+         * backed by a fixed size ring buffer, with the same
+         * api as the fifo. Each cell contains a sequence number
+         * used to order the producers and consumers.
+         * The producers and consumers spin before parking in the
+         * fifo conditions (only used when the fifo is full or empty).
+         */
+        template<typename T> class RingFifo {
+            private:
+                typedef struct RingFifoCell_t {
+                    ATOMIC_VALUE sequence;
+                    T value;
+                } RingFifoCell;
+
+                char startPadding[RING_FIFO_CACHE_LINE_SIZE];
+                RingFifoCell_t *cells;
+                unsigned long mask;
+                char cellsPadding[RING_FIFO_CACHE_LINE_SIZE];
+                ATOMIC_VALUE enqueuePosition;
+                char enqueuePadding[RING_FIFO_CACHE_LINE_SIZE];
+                ATOMIC_VALUE dequeuePosition;
+                char dequeuePadding[RING_FIFO_CACHE_LINE_SIZE];
+                ATOMIC_VALUE waitingProducers;
+                ATOMIC_VALUE waitingConsumers;
+                CRITICAL_SECTION_HANDLE parkCriticalSection;
+                CONDITION_HANDLE notEmptyCondition;
+                CONDITION_HANDLE notFullCondition;
+
+                inline void initCells(unsigned int size) {
+                    // rounds the size to the next power of two
+                    for(this->size = 2; this->size < size; this->size <<= 1);
+
+                    // creates the cells and sets the mask
+                    this->cells = new RingFifoCell_t[this->size];
+                    this->mask = this->size - 1;
+
+                    // sets the initial cell sequences
+                    for(unsigned int index = 0; index < this->size; index++) {
+                        this->cells[index].sequence = index;
+                    }
+
+                    // resets the positions and the waiting counters
+                    this->enqueuePosition = 0;
+                    this->dequeuePosition = 0;
+                    this->waitingProducers = 0;
+                    this->waitingConsumers = 0;
+
+                    // unsets the stop flag
+                    this->stopFlag = false;
+                }
+
+                inline void initPark() {
+                    CRITICAL_SECTION_CREATE(this->parkCriticalSection);
+                    CONDITION_CREATE(this->notEmptyCondition);
+                    CONDITION_CREATE(this->notFullCondition);
+                }
+
+                inline void wake(ATOMIC_VALUE &waitingCount, CONDITION_HANDLE &condition) {
+                    // orders the cell publication before the waiting count read
+                    MEMORY_BARRIER();
+
+                    // in case there is no one waiting
+                    if(waitingCount == 0) {
+                        // returns immediately
+                        return;
+                    }
+
+                    // enters the park critical section
+                    CRITICAL_SECTION_ENTER(this->parkCriticalSection);
+
+                    // wakes one of the waiting threads
+                    CONDITION_SIGNAL(condition);
+
+                    // leaves the park critical section
+                    CRITICAL_SECTION_LEAVE(this->parkCriticalSection);
+                }
+
+                inline bool enqueue(T value) {
+                    // retrieves the current enqueue position
+                    long position = this->enqueuePosition;
+
+                    // iterates while the cell is not acquired
+                    while(true) {
+                        // retrieves the cell for the position
+                        RingFifoCell_t *cell = &this->cells[position & this->mask];
+
+                        // computes the difference between the cell sequence and the position
+                        long difference = (long) ((unsigned long) cell->sequence - (unsigned long) position);
+
+                        // in case the cell is free for the position
+                        if(difference == 0) {
+                            // tries to acquire the position
+                            if(ATOMIC_COMPARE_AND_SWAP(this->enqueuePosition, position, position + 1)) {
+                                // sets the value in the cell
+                                cell->value = value;
+
+                                // publishes the cell to the consumers
+                                MEMORY_BARRIER();
+                                cell->sequence = position + 1;
+
+                                // returns true
+                                return true;
+                            }
+
+                            // retrieves the updated enqueue position
+                            position = this->enqueuePosition;
+                        }
+                        // in case the cell is still in use (full fifo)
+                        else if(difference < 0) {
+                            // returns false
+                            return false;
+                        } else {
+                            // retrieves the updated enqueue position
+                            position = this->enqueuePosition;
+                        }
+                    }
+                }
+
+                inline bool dequeue(T &value) {
+                    // retrieves the current dequeue position
+                    long position = this->dequeuePosition;
+
+                    // iterates while the cell is not acquired
+                    while(true) {
+                        // retrieves the cell for the position
+                        RingFifoCell_t *cell = &this->cells[position & this->mask];
+
+                        // computes the difference between the cell sequence and the position
+                        long difference = (long) ((unsigned long) cell->sequence - (unsigned long) (position + 1));
+
+                        // in case the cell is filled for the position
+                        if(difference == 0) {
+                            // tries to acquire the position
+                            if(ATOMIC_COMPARE_AND_SWAP(this->dequeuePosition, position, position + 1)) {
+                                // retrieves the value from the cell
+                                value = cell->value;
+
+                                // releases the cell to the producers
+                                MEMORY_BARRIER();
+                                cell->sequence = position + this->mask + 1;
+
+                                // returns true
+                                return true;
+                            }
+
+                            // retrieves the updated dequeue position
+                            position = this->dequeuePosition;
+                        }
+                        // in case the cell is not yet filled (empty fifo)
+                        else if(difference < 0) {
+                            // returns false
+                            return false;
+                        } else {
+                            // retrieves the updated dequeue position
+                            position = this->dequeuePosition;
+                        }
+                    }
+                }
+
+            public:
+                bool stopFlag;
+                unsigned int size;
+
+                /**
+                 * Constructor of the class.
+                 */
+                RingFifo() {
+                    this->initCells(DEFAULT_RING_FIFO_SIZE);
+                    this->initPark();
+                }
+
+                /**
+                 * Constructor of the class.
+                 *
+                 * @param size The capacity of the fifo (rounded to a
+                 * power of two).
+                 */
+                RingFifo(unsigned int size) {
+                    this->initCells(size);
+                    this->initPark();
+                }
+
+                /**
+                 * Destructor of the class.
+                 */
+                ~RingFifo() {
+                    CRITICAL_SECTION_CLOSE(this->parkCriticalSection);
+                    CONDITION_CLOSE(this->notEmptyCondition);
+                    CONDITION_CLOSE(this->notFullCondition);
+                    delete[] this->cells;
+                }
+
+                /**
+                 * Tries to add the value to the fifo, without blocking.
+                 *
+                 * @param value The value to be added.
+                 * @return If the value was added (the fifo was not full).
+                 */
+                inline bool trySignal(T value) {
+                    // in case the value is not added
+                    if(!this->enqueue(value)) {
+                        // returns false
+                        return false;
+                    }
+
+                    // wakes a waiting consumer
+                    this->wake(this->waitingConsumers, this->notEmptyCondition);
+
+                    // returns true
+                    return true;
+                }
+
+                /**
+                 * Tries to retrieve a value from the fifo, without blocking.
+                 *
+                 * @param value The retrieved value.
+                 * @return If a value was retrieved (the fifo was not empty).
+                 */
+                inline bool tryWait(T &value) {
+                    // in case no value is retrieved
+                    if(!this->dequeue(value)) {
+                        // returns false
+                        return false;
+                    }
+
+                    // wakes a waiting producer
+                    this->wake(this->waitingProducers, this->notFullCondition);
+
+                    // returns true
+                    return true;
+                }
+
+                inline void signal(T value) {
+                    // spins trying to add the value
+                    for(unsigned int index = 0; index < RING_FIFO_SPIN_COUNT; index++) {
+                        // in case the value is added or the stop flag is set
+                        if(this->trySignal(value) || this->stopFlag) {
+                            // returns immediately
+                            return;
+                        }
+
+                        // yields the processor
+                        THREAD_YIELD();
+                    }
+
+                    // enters the park critical section
+                    CRITICAL_SECTION_ENTER(this->parkCriticalSection);
+
+                    // increments the waiting producers
+                    ATOMIC_INCREMENT(this->waitingProducers);
+
+                    // starts the added flag
+                    bool added = false;
+
+                    // iterates while the fifo is full and the stop flag is not active
+                    while(!(added = this->enqueue(value)) && !this->stopFlag) {
+                        CONDITION_WAIT(this->notFullCondition, this->parkCriticalSection);
+                    }
+
+                    // decrements the waiting producers
+                    ATOMIC_DECREMENT(this->waitingProducers);
+
+                    // leaves the park critical section
+                    CRITICAL_SECTION_LEAVE(this->parkCriticalSection);
+
+                    // in case the value was added
+                    if(added) {
+                        // wakes a waiting consumer
+                        this->wake(this->waitingConsumers, this->notEmptyCondition);
+                    }
+                }
+
+                inline T wait() {
+                    // allocates the value
+                    T value = T();
+
+                    // spins trying to retrieve a value
+                    for(unsigned int index = 0; index < RING_FIFO_SPIN_COUNT; index++) {
+                        // in case a value is retrieved or the stop flag is set
+                        if(this->tryWait(value) || this->stopFlag) {
+                            // returns the value
+                            return value;
+                        }
+
+                        // yields the processor
+                        THREAD_YIELD();
+                    }
+
+                    // enters the park critical section
+                    CRITICAL_SECTION_ENTER(this->parkCriticalSection);
+
+                    // increments the waiting consumers
+                    ATOMIC_INCREMENT(this->waitingConsumers);
+
+                    // starts the retrieved flag
+                    bool retrieved = false;
+
+                    // iterates while the fifo is empty and the stop flag is not active
+                    while(!(retrieved = this->dequeue(value)) && !this->stopFlag) {
+                        CONDITION_WAIT(this->notEmptyCondition, this->parkCriticalSection);
+                    }
+
+                    // decrements the waiting consumers
+                    ATOMIC_DECREMENT(this->waitingConsumers);
+
+                    // leaves the park critical section
+                    CRITICAL_SECTION_LEAVE(this->parkCriticalSection);
+
+                    // in case a value was retrieved
+                    if(retrieved) {
+                        // wakes a waiting producer
+                        this->wake(this->waitingProducers, this->notFullCondition);
+                    }
+
+                    // returns the value
+                    return value;
+                }
+
+                inline void start() {
+                    this->stopFlag = false;
+                }
+
+                inline void stop() {
+                    // enters the park critical section
+                    CRITICAL_SECTION_ENTER(this->parkCriticalSection);
+
+                    // sets the stop flag
+                    this->stopFlag = true;
+
+                    // wakes all the waiting producers and consumers
+                    CONDITION_BROADCAST(this->notEmptyCondition);
+                    CONDITION_BROADCAST(this->notFullCondition);
+
+                    // leaves the park critical section
+                    CRITICAL_SECTION_LEAVE(this->parkCriticalSection);
+                }
+        };
+    }
+}
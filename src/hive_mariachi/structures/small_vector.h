@@ -0,0 +1,197 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+namespace mariachi {
+    namespace structures {
+        /**
+         * Vector with inline storage for the first values, the
+         * values are only allocated in the heap once the inline
+         * capacity is exceeded. Keeps the stl naming so that it
+         * may replace the stl containers in the iterations.
+         */
+        template<typename T, unsigned int N> class SmallVector {
+            private:
+                T inlineValues[N];
+                T *values;
+                unsigned int numberValues;
+                unsigned int capacity;
+
+                inline void initValues() {
+                    this->values = this->inlineValues;
+                    this->numberValues = 0;
+                    this->capacity = N;
+                }
+
+                inline void grow(unsigned int capacity) {
+                    // in case the capacity is enough
+                    if(capacity <= this->capacity) {
+                        // returns immediately
+                        return;
+                    }
+
+                    // calculates the new capacity (doubling the current one)
+                    unsigned int newCapacity = this->capacity * 2 > capacity ? this->capacity * 2 : capacity;
+
+                    // allocates the new values and copies the current ones
+                    T *newValues = new T[newCapacity];
+                    for(unsigned int index = 0; index < this->numberValues; index++) {
+                        newValues[index] = this->values[index];
+                    }
+
+                    // in case the current values are in the heap
+                    if(this->values != this->inlineValues) {
+                        // deletes the current values
+                        delete[] this->values;
+                    }
+
+                    // sets the new values and capacity
+                    this->values = newValues;
+                    this->capacity = newCapacity;
+                }
+
+            public:
+                typedef T *iterator;
+                typedef const T *const_iterator;
+
+                /**
+                 * Constructor of the class.
+                 */
+                SmallVector() {
+                    this->initValues();
+                }
+
+                /**
+                 * Constructor of the class.
+                 *
+                 * @param smallVector The small vector to be copied.
+                 */
+                SmallVector(const SmallVector<T, N> &smallVector) {
+                    this->initValues();
+                    *this = smallVector;
+                }
+
+                /**
+                 * Destructor of the class.
+                 */
+                ~SmallVector() {
+                    // in case the values are in the heap
+                    if(this->values != this->inlineValues) {
+                        // deletes the values
+                        delete[] this->values;
+                    }
+                }
+
+                SmallVector<T, N> &operator=(const SmallVector<T, N> &smallVector) {
+                    // in case it's the same small vector
+                    if(this == &smallVector) {
+                        // returns immediately
+                        return *this;
+                    }
+
+                    // grows the values and copies the small vector values
+                    this->grow(smallVector.numberValues);
+                    for(unsigned int index = 0; index < smallVector.numberValues; index++) {
+                        this->values[index] = smallVector.values[index];
+                    }
+
+                    // sets the number of values
+                    this->numberValues = smallVector.numberValues;
+
+                    // returns the small vector
+                    return *this;
+                }
+
+                inline T &operator[](unsigned int index) {
+                    return this->values[index];
+                }
+
+                inline const T &operator[](unsigned int index) const {
+                    return this->values[index];
+                }
+
+                inline iterator begin() {
+                    return this->values;
+                }
+
+                inline iterator end() {
+                    return this->values + this->numberValues;
+                }
+
+                inline const_iterator begin() const {
+                    return this->values;
+                }
+
+                inline const_iterator end() const {
+                    return this->values + this->numberValues;
+                }
+
+                inline unsigned int size() const {
+                    return this->numberValues;
+                }
+
+                inline bool empty() const {
+                    return this->numberValues == 0;
+                }
+
+                inline void push_back(const T &value) {
+                    // grows the values (in case it's required)
+                    this->grow(this->numberValues + 1);
+
+                    // adds the value
+                    this->values[this->numberValues++] = value;
+                }
+
+                /**
+                 * Removes all the values equal to the given value,
+                 * keeping the order of the remaining values.
+                 *
+                 * @param value The value to be removed.
+                 */
+                inline void remove(const T &value) {
+                    // starts the target index
+                    unsigned int targetIndex = 0;
+
+                    // iterates over all the values
+                    for(unsigned int index = 0; index < this->numberValues; index++) {
+                        // in case the value is not to be removed
+                        if(!(this->values[index] == value)) {
+                            // moves the value to the target index
+                            this->values[targetIndex++] = this->values[index];
+                        }
+                    }
+
+                    // sets the number of values
+                    this->numberValues = targetIndex;
+                }
+
+                inline void clear() {
+                    this->numberValues = 0;
+                }
+        };
+    }
+}
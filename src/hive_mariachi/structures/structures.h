@@ -32,12 +32,19 @@
 #include "data.h"
 #include "fifo.h"
 #include "frame.h"
+#include "frustum.h"
 #include "image.h"
+#include "keyframe.h"
+#include "linear_oct_tree.h"
+#include "matrix.h"
 #include "mesh.h"
 #include "oct_tree.h"
 #include "oct_tree_node.h"
 #include "path.h"
 #include "position.h"
+#include "ring_fifo.h"
 #include "rotation.h"
 #include "size.h"
+#include "small_vector.h"
 #include "texture.h"
+#include "transform_store.h"
@@ -33,6 +33,7 @@ using namespace mariachi::structures;
  * Constructor of the class.
  */
 Texture::Texture() {
+    this->initHandle();
 }
 
 /**
@@ -41,6 +42,12 @@ Texture::Texture() {
 Texture::~Texture() {
 }
 
+inline void Texture::initHandle() {
+    this->imageBuffer = NULL;
+    this->handle = 0;
+    this->status = UNLOADED_TEXTURE_STATUS;
+}
+
 IntSize2d_t Texture::getSize() {
     return this->size;
 }
@@ -55,3 +62,19 @@ ImageColor_t *Texture::getImageBuffer() {
 void Texture::setImageBuffer(ImageColor_t * imageBuffer) {
     this->imageBuffer = imageBuffer;
 }
+
+unsigned int Texture::getHandle() {
+    return this->handle;
+}
+
+void Texture::setHandle(unsigned int handle) {
+    this->handle = handle;
+}
+
+TextureStatus_t Texture::getStatus() {
+    return this->status;
+}
+
+void Texture::setStatus(TextureStatus_t status) {
+    this->status = status;
+}
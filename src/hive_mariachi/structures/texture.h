@@ -30,11 +30,30 @@
 
 namespace mariachi {
     namespace structures {
+        typedef enum TextureStatus_t {
+            UNLOADED_TEXTURE_STATUS = 1,
+            LOADING_TEXTURE_STATUS,
+            LOADED_TEXTURE_STATUS
+        } TextureStatus;
+
         class Texture {
             private:
                 structures::IntSize2d_t size;
                 structures::ImageColor_t *imageBuffer;
 
+                /**
+                 * The (render adapter) handle of the texture,
+                 * valid when the texture is loaded.
+                 */
+                unsigned int handle;
+
+                /**
+                 * The status of the texture in the render adapter.
+                 */
+                TextureStatus_t status;
+
+                inline void initHandle();
+
             public:
                 Texture();
                 ~Texture();
@@ -42,6 +61,10 @@ namespace mariachi {
                 void setSize(structures::IntSize2d_t size);
                 structures::ImageColor_t *getImageBuffer();
                 void setImageBuffer(structures::ImageColor_t * imageBuffer);
+                unsigned int getHandle();
+                void setHandle(unsigned int handle);
+                TextureStatus_t getStatus();
+                void setStatus(TextureStatus_t status);
         };
     }
 }
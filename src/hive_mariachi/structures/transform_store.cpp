@@ -0,0 +1,303 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "../util/matrix_util.h"
+#include "../nodes/node.h"
+#include "transform_store.h"
+
+using namespace mariachi::util;
+using namespace mariachi::nodes;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+TransformStore::TransformStore() {
+    this->initLists(DEFAULT_TRANSFORM_STORE_CAPACITY);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param capacity The maximum number of transforms in the store.
+ */
+TransformStore::TransformStore(unsigned int capacity) {
+    this->initLists(capacity);
+}
+
+/**
+ * Destructor of the class.
+ */
+TransformStore::~TransformStore() {
+    // deletes the component lists
+    delete[] this->positionXList;
+    delete[] this->positionYList;
+    delete[] this->positionZList;
+    delete[] this->rotationAngleList;
+    delete[] this->rotationXList;
+    delete[] this->rotationYList;
+    delete[] this->rotationZList;
+    delete[] this->scaleXList;
+    delete[] this->scaleYList;
+    delete[] this->scaleZList;
+    delete[] this->transformsList;
+    delete[] this->dirtyList;
+    delete[] this->nodesList;
+
+    // closes the handles critical section
+    CRITICAL_SECTION_CLOSE(this->handlesCriticalSection);
+}
+
+inline void TransformStore::initLists(unsigned int capacity) {
+    // sets the capacity and resets the size
+    this->capacity = capacity;
+    this->size = 0;
+
+    // creates the component lists
+    this->positionXList = new float[capacity];
+    this->positionYList = new float[capacity];
+    this->positionZList = new float[capacity];
+    this->rotationAngleList = new float[capacity];
+    this->rotationXList = new float[capacity];
+    this->rotationYList = new float[capacity];
+    this->rotationZList = new float[capacity];
+    this->scaleXList = new float[capacity];
+    this->scaleYList = new float[capacity];
+    this->scaleZList = new float[capacity];
+    this->transformsList = new Matrix4d_t[capacity];
+    this->dirtyList = new unsigned char[capacity];
+    this->nodesList = new Node *[capacity];
+
+    // creates the handles critical section
+    CRITICAL_SECTION_CREATE(this->handlesCriticalSection);
+}
+
+/**
+ * Creates a new handle in the store for the given node, the
+ * transform of the handle starts as the identity.
+ *
+ * @param node The node that owns the handle (marked as dirty
+ * when the transform of the handle changes).
+ * @return The created handle or the invalid handle in case
+ * the store is full.
+ */
+unsigned int TransformStore::createHandle(Node *node) {
+    // starts the handle as invalid
+    unsigned int handle = TRANSFORM_STORE_INVALID_HANDLE;
+
+    // enters the handles critical section
+    CRITICAL_SECTION_ENTER(this->handlesCriticalSection);
+
+    // in case there are free handles
+    if(!this->freeHandlesList.empty()) {
+        // reuses the last free handle
+        handle = this->freeHandlesList.back();
+        this->freeHandlesList.pop_back();
+    }
+    // in case the store is not full
+    else if(this->size < this->capacity) {
+        // uses the next handle
+        handle = this->size++;
+    }
+
+    // leaves the handles critical section
+    CRITICAL_SECTION_LEAVE(this->handlesCriticalSection);
+
+    // in case the handle is not valid
+    if(handle == TRANSFORM_STORE_INVALID_HANDLE) {
+        // returns the invalid handle
+        return handle;
+    }
+
+    // resets the transform of the handle (identity)
+    this->positionXList[handle] = 0.0f;
+    this->positionYList[handle] = 0.0f;
+    this->positionZList[handle] = 0.0f;
+    this->rotationAngleList[handle] = 0.0f;
+    this->rotationXList[handle] = 0.0f;
+    this->rotationYList[handle] = 0.0f;
+    this->rotationZList[handle] = 0.0f;
+    this->scaleXList[handle] = 1.0f;
+    this->scaleYList[handle] = 1.0f;
+    this->scaleZList[handle] = 1.0f;
+    this->transformsList[handle] = MatrixUtil::IDENTITY_MATRIX;
+    this->dirtyList[handle] = 0;
+    this->nodesList[handle] = node;
+
+    // returns the handle
+    return handle;
+}
+
+/**
+ * Releases the given handle, the handle may be
+ * reused by the next created handle.
+ *
+ * @param handle The handle to be released.
+ */
+void TransformStore::releaseHandle(unsigned int handle) {
+    // enters the handles critical section
+    CRITICAL_SECTION_ENTER(this->handlesCriticalSection);
+
+    // unsets the dirty flag (not to be updated)
+    // and the node of the handle
+    this->dirtyList[handle] = 0;
+    this->nodesList[handle] = NULL;
+
+    // adds the handle to the free handles list
+    this->freeHandlesList.push_back(handle);
+
+    // leaves the handles critical section
+    CRITICAL_SECTION_LEAVE(this->handlesCriticalSection);
+}
+
+/**
+ * Updates the (local) transforms of all the changed handles,
+ * streaming through the component lists, and marks the nodes
+ * of the changed handles as dirty (the hierarchy update then
+ * visits them).
+ * Must be called before the hierarchy update and not concurrently
+ * with it (the node dirty flags are written).
+ */
+void TransformStore::updateTransforms() {
+    // retrieves the size (handles created later are
+    // updated on demand)
+    unsigned int size = this->size;
+
+    // iterates over all the handles
+    for(unsigned int handle = 0; handle < size; handle++) {
+        // in case the handle is not dirty
+        if(!this->dirtyList[handle]) {
+            // continues the loop
+            continue;
+        }
+
+        // updates the transform of the handle
+        this->updateTransform(handle);
+
+        // in case the handle has a node
+        if(this->nodesList[handle]) {
+            // marks the node transform as dirty
+            this->nodesList[handle]->setTransformDirty();
+        }
+    }
+}
+
+Coordinate3d_t TransformStore::getPosition(unsigned int handle) {
+    // creates the position from the component lists
+    Coordinate3d_t position = { this->positionXList[handle], this->positionYList[handle], this->positionZList[handle] };
+
+    // returns the position
+    return position;
+}
+
+void TransformStore::setPosition(unsigned int handle, const Coordinate3d_t &position) {
+    this->positionXList[handle] = position.x;
+    this->positionYList[handle] = position.y;
+    this->positionZList[handle] = position.z;
+    this->dirtyList[handle] = 1;
+}
+
+Rotation3d_t TransformStore::getRotation(unsigned int handle) {
+    // creates the rotation from the component lists
+    Rotation3d_t rotation = { this->rotationAngleList[handle], this->rotationXList[handle], this->rotationYList[handle], this->rotationZList[handle] };
+
+    // returns the rotation
+    return rotation;
+}
+
+void TransformStore::setRotation(unsigned int handle, const Rotation3d_t &rotation) {
+    this->rotationAngleList[handle] = rotation.angle;
+    this->rotationXList[handle] = rotation.x;
+    this->rotationYList[handle] = rotation.y;
+    this->rotationZList[handle] = rotation.z;
+    this->dirtyList[handle] = 1;
+}
+
+Coordinate3d_t TransformStore::getScale(unsigned int handle) {
+    // creates the scale from the component lists
+    Coordinate3d_t scale = { this->scaleXList[handle], this->scaleYList[handle], this->scaleZList[handle] };
+
+    // returns the scale
+    return scale;
+}
+
+void TransformStore::setScale(unsigned int handle, const Coordinate3d_t &scale) {
+    this->scaleXList[handle] = scale.x;
+    this->scaleYList[handle] = scale.y;
+    this->scaleZList[handle] = scale.z;
+    this->dirtyList[handle] = 1;
+}
+
+/**
+ * Retrieves the (local) transform of the given handle, the
+ * transform is updated in case it's dirty.
+ *
+ * @param handle The handle to retrieve the transform.
+ * @return The (local) transform of the handle.
+ */
+Matrix4d_t &TransformStore::getTransform(unsigned int handle) {
+    // in case the handle is dirty
+    if(this->dirtyList[handle]) {
+        // updates the transform of the handle
+        this->updateTransform(handle);
+    }
+
+    // returns the transform
+    return this->transformsList[handle];
+}
+
+/**
+ * Retrieves the node that owns the given handle.
+ *
+ * @param handle The handle to retrieve the node.
+ * @return The node that owns the handle.
+ */
+Node *TransformStore::getNode(unsigned int handle) {
+    return this->nodesList[handle];
+}
+
+unsigned int TransformStore::getCapacity() {
+    return this->capacity;
+}
+
+unsigned int TransformStore::getSize() {
+    return this->size;
+}
+
+inline void TransformStore::updateTransform(unsigned int handle) {
+    // unsets the dirty flag
+    this->dirtyList[handle] = 0;
+
+    // retrieves the transform components
+    Coordinate3d_t position = { this->positionXList[handle], this->positionYList[handle], this->positionZList[handle] };
+    Rotation3d_t rotation = { this->rotationAngleList[handle], this->rotationXList[handle], this->rotationYList[handle], this->rotationZList[handle] };
+    Coordinate3d_t scale = { this->scaleXList[handle], this->scaleYList[handle], this->scaleZList[handle] };
+
+    // creates the transform
+    this->transformsList[handle] = MatrixUtil::createTransform(position, rotation, scale);
+}
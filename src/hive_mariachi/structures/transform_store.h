@@ -0,0 +1,105 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../system/thread.h"
+#include "matrix.h"
+#include "position.h"
+#include "rotation.h"
+
+/**
+ * The default number of transforms in the
+ * transform store.
+ */
+#define DEFAULT_TRANSFORM_STORE_CAPACITY 4096
+
+/**
+ * The handle value used when no transform
+ * is available in the store.
+ */
+#define TRANSFORM_STORE_INVALID_HANDLE 0xffffffff
+
+namespace mariachi {
+    namespace nodes {
+        class Node;
+    }
+
+    namespace structures {
+        /**
+         * Contiguous storage for the transforms (position, rotation
+         * and scale) of the nodes, each component is kept in its own
+         * array (structure of arrays) indexed by the node handle.
+         * The capacity is fixed at construction so that the arrays
+         * never move, the accessors are not locked (as the node
+         * fields they replace).
+         * The components may be written directly by handle (eg: the
+         * physics write back), the transforms update marks the node
+         * of each changed handle as dirty for the hierarchy update.
+         */
+        class TransformStore {
+            private:
+                unsigned int capacity;
+                unsigned int size;
+                float *positionXList;
+                float *positionYList;
+                float *positionZList;
+                float *rotationAngleList;
+                float *rotationXList;
+                float *rotationYList;
+                float *rotationZList;
+                float *scaleXList;
+                float *scaleYList;
+                float *scaleZList;
+                Matrix4d_t *transformsList;
+                unsigned char *dirtyList;
+                nodes::Node **nodesList;
+                std::vector<unsigned int> freeHandlesList;
+                CRITICAL_SECTION_HANDLE handlesCriticalSection;
+
+                inline void initLists(unsigned int capacity);
+                inline void updateTransform(unsigned int handle);
+
+            public:
+                TransformStore();
+                TransformStore(unsigned int capacity);
+                ~TransformStore();
+                unsigned int createHandle(nodes::Node *node);
+                void releaseHandle(unsigned int handle);
+                void updateTransforms();
+                Coordinate3d_t getPosition(unsigned int handle);
+                void setPosition(unsigned int handle, const Coordinate3d_t &position);
+                Rotation3d_t getRotation(unsigned int handle);
+                void setRotation(unsigned int handle, const Rotation3d_t &rotation);
+                Coordinate3d_t getScale(unsigned int handle);
+                void setScale(unsigned int handle, const Coordinate3d_t &scale);
+                Matrix4d_t &getTransform(unsigned int handle);
+                nodes::Node *getNode(unsigned int handle);
+                unsigned int getCapacity();
+                unsigned int getSize();
+        };
+    }
+}
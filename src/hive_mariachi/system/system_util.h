@@ -33,6 +33,8 @@
 #define SPRINTF(buffer, size, format, ...) sprintf_s(buffer, size, format, __VA_ARGS__)
 #define GET_ENV(buffer, bufferSize, variableName) _dupenv_s(&buffer, &bufferSize, variableName)
 #define FILE_EXISTS(filePath) GetFileAttributes(filePath) != 0xffffffff
+#define GET_CPU_COUNT(cpuCount) SYSTEM_INFO systemInformation; GetSystemInfo(&systemInformation); cpuCount = systemInformation.dwNumberOfProcessors
+#define MONOTONIC_CLOCK(clockValue) { LARGE_INTEGER performanceCounter; LARGE_INTEGER performanceFrequency; QueryPerformanceCounter(&performanceCounter); QueryPerformanceFrequency(&performanceFrequency); clockValue = (double) performanceCounter.QuadPart / (double) performanceFrequency.QuadPart; }
 #elif MARIACHI_PLATFORM_UNIX
 #define PID_TYPE pid_t
 #define LOCAL_TIME(localTimeValue, timeValue) localTimeValue = localtime(timeValue)
@@ -41,6 +43,12 @@
 #define SPRINTF(buffer, size, format, ...) sprintf(buffer, format, __VA_ARGS__)
 #define GET_ENV(buffer, bufferSize, variableName) buffer = getenv(variableName)
 #define FILE_EXISTS(filePath) access(filePath, F_OK) == 0
+#define GET_CPU_COUNT(cpuCount) cpuCount = sysconf(_SC_NPROCESSORS_ONLN)
+#ifdef __MACH__
+#define MONOTONIC_CLOCK(clockValue) { mach_timebase_info_data_t timebaseInformation; mach_timebase_info(&timebaseInformation); clockValue = (double) mach_absolute_time() * (double) timebaseInformation.numer / (double) timebaseInformation.denom / 1000000000.0; }
+#else
+#define MONOTONIC_CLOCK(clockValue) { timespec clockTime; clock_gettime(CLOCK_MONOTONIC, &clockTime); clockValue = (double) clockTime.tv_sec + (double) clockTime.tv_nsec / 1000000000.0; }
+#endif
 #endif
 
 #define CLOCK() clock()
@@ -58,7 +58,24 @@
 #define CONDITION_CREATE(conditionHandle) InitializeConditionVariable(&conditionHandle)
 #define CONDITION_WAIT(conditionHandle, criticalSectionHandle) SleepConditionVariableCS(&conditionHandle, &criticalSectionHandle, INFINITE)
 #define CONDITION_SIGNAL(conditionHandle) WakeConditionVariable(&conditionHandle)
+#define CONDITION_BROADCAST(conditionHandle) WakeAllConditionVariable(&conditionHandle)
 #define CONDITION_CLOSE(conditionHandle)
+#define RWLOCK_HANDLE SRWLOCK
+#define RWLOCK_INITIALIZER SRWLOCK_INIT
+#define RWLOCK_CREATE(rwlockHandle) InitializeSRWLock(&rwlockHandle)
+#define RWLOCK_READ_LOCK(rwlockHandle) AcquireSRWLockShared(&rwlockHandle)
+#define RWLOCK_READ_UNLOCK(rwlockHandle) ReleaseSRWLockShared(&rwlockHandle)
+#define RWLOCK_WRITE_LOCK(rwlockHandle) AcquireSRWLockExclusive(&rwlockHandle)
+#define RWLOCK_WRITE_UNLOCK(rwlockHandle) ReleaseSRWLockExclusive(&rwlockHandle)
+#define RWLOCK_CLOSE(rwlockHandle)
+#define THREAD_LOCAL __declspec(thread)
+#define THREAD_YIELD() SwitchToThread()
+#define ATOMIC_VALUE volatile LONG
+#define ATOMIC_INCREMENT(atomicValue) InterlockedIncrement(&atomicValue)
+#define ATOMIC_DECREMENT(atomicValue) InterlockedDecrement(&atomicValue)
+#define ATOMIC_ADD(atomicValue, value) (InterlockedExchangeAdd(&atomicValue, value) + value)
+#define ATOMIC_COMPARE_AND_SWAP(atomicValue, oldValue, newValue) (InterlockedCompareExchange(&atomicValue, newValue, oldValue) == oldValue)
+#define MEMORY_BARRIER() MemoryBarrier()
 #elif MARIACHI_PLATFORM_UNIX
 typedef struct EventHandle_t {
     pthread_cond_t event;
@@ -106,6 +123,23 @@ typedef struct EventHandle_t {
 pthread_cond_init(conditionHandle, NULL)
 #define CONDITION_WAIT(conditionHandle, criticalSectionHandle) pthread_cond_wait(conditionHandle, criticalSectionHandle)
 #define CONDITION_SIGNAL(conditionHandle) pthread_cond_signal(conditionHandle)
+#define CONDITION_BROADCAST(conditionHandle) pthread_cond_broadcast(conditionHandle)
 #define CONDITION_CLOSE(conditionHandle) pthread_cond_destroy(conditionHandle);\
 free(conditionHandle)
+#define RWLOCK_HANDLE pthread_rwlock_t
+#define RWLOCK_INITIALIZER PTHREAD_RWLOCK_INITIALIZER
+#define RWLOCK_CREATE(rwlockHandle) pthread_rwlock_init(&rwlockHandle, NULL)
+#define RWLOCK_READ_LOCK(rwlockHandle) pthread_rwlock_rdlock(&rwlockHandle)
+#define RWLOCK_READ_UNLOCK(rwlockHandle) pthread_rwlock_unlock(&rwlockHandle)
+#define RWLOCK_WRITE_LOCK(rwlockHandle) pthread_rwlock_wrlock(&rwlockHandle)
+#define RWLOCK_WRITE_UNLOCK(rwlockHandle) pthread_rwlock_unlock(&rwlockHandle)
+#define RWLOCK_CLOSE(rwlockHandle) pthread_rwlock_destroy(&rwlockHandle)
+#define THREAD_LOCAL __thread
+#define THREAD_YIELD() sched_yield()
+#define ATOMIC_VALUE volatile long
+#define ATOMIC_INCREMENT(atomicValue) __sync_add_and_fetch(&atomicValue, 1)
+#define ATOMIC_DECREMENT(atomicValue) __sync_sub_and_fetch(&atomicValue, 1)
+#define ATOMIC_ADD(atomicValue, value) __sync_add_and_fetch(&atomicValue, value)
+#define ATOMIC_COMPARE_AND_SWAP(atomicValue, oldValue, newValue) __sync_bool_compare_and_swap(&atomicValue, oldValue, newValue)
+#define MEMORY_BARRIER() __sync_synchronize()
 #endif
@@ -0,0 +1,638 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#include "stdafx.h"
+
+#include "../system/system_util.h"
+
+#include "job_scheduler.h"
+
+using namespace mariachi::tasks;
+
+/**
+ * The worker associated with the current thread, or null
+ * in case the current thread is not a scheduler worker.
+ */
+static THREAD_LOCAL JobWorker_t *currentWorker = NULL;
+
+/**
+ * Thread that runs a job scheduler worker, executing jobs from
+ * its own deque and stealing from the other workers.
+ *
+ * @param parameters The thread parameters.
+ * @return The thread result.
+ */
+THREAD_RETURN mariachi::tasks::jobWorkerThread(THREAD_ARGUMENTS parameters) {
+    // retrieves the worker from the parameters
+    JobWorker_t *worker = (JobWorker_t *) parameters;
+
+    // sets the worker as the current thread worker
+    currentWorker = worker;
+
+    // runs the worker loop
+    worker->jobScheduler->runWorker(worker);
+
+    // returns valid value
+    return THREAD_VALID_RETURN_VALUE;
+}
+
+/**
+ * Job function that runs a chunk of a range.
+ *
+ * @param arguments The job range structure.
+ */
+void mariachi::tasks::jobRangeFunction(void *arguments) {
+    // retrieves the job range from the arguments
+    JobRange_t *jobRange = (JobRange_t *) arguments;
+
+    // calls the range function for the chunk
+    jobRange->rangeFunction(jobRange->arguments, jobRange->start, jobRange->end);
+}
+
+/**
+ * Constructor of the class.
+ * Uses one worker less than the number of available
+ * processors, the waiting thread is also used for execution.
+ */
+JobScheduler::JobScheduler() {
+    // allocates space for the cpu count
+    long cpuCount;
+
+    // retrieves the cpu count
+    GET_CPU_COUNT(cpuCount);
+
+    this->initWorkerCount(cpuCount > 1 ? cpuCount - 1 : 1);
+    this->initRunningFlag();
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param workerCount The number of worker threads to be used.
+ */
+JobScheduler::JobScheduler(unsigned int workerCount) {
+    this->initWorkerCount(workerCount);
+    this->initRunningFlag();
+}
+
+/**
+ * Destructor of the class.
+ */
+JobScheduler::~JobScheduler() {
+}
+
+inline void JobScheduler::initWorkerCount(unsigned int workerCount) {
+    this->workerCount = workerCount;
+}
+
+inline void JobScheduler::initRunningFlag() {
+    this->runningFlag = false;
+}
+
+/**
+ * Starts the job scheduler, creating the workers and
+ * their threads.
+ *
+ * @param arguments The arguments for the job scheduler start.
+ */
+void JobScheduler::start(void *arguments) {
+    // sets the running flag
+    this->runningFlag = true;
+
+    // resets the job counters
+    this->queuedJobs = 0;
+    this->idleWorkers = 0;
+
+    // creates the idle critical section
+    CRITICAL_SECTION_CREATE(this->idleCriticalSection);
+
+    // creates the idle condition
+    CONDITION_CREATE(this->idleCondition);
+
+    // creates the workers, the extra (last) worker is
+    // used by the threads external to the scheduler
+    for(unsigned int index = 0; index < this->workerCount + 1; index++) {
+        // creates the worker
+        JobWorker_t *worker = new JobWorker_t();
+
+        // sets the worker attributes
+        worker->index = index;
+        worker->jobScheduler = this;
+        worker->jobsCount = 0;
+
+        // creates the jobs deque critical section
+        CRITICAL_SECTION_CREATE(worker->jobsDequeCriticalSection);
+
+        // adds the worker to the workers list
+        this->workersList.push_back(worker);
+    }
+
+    // iterates over all the (thread) workers
+    for(unsigned int index = 0; index < this->workerCount; index++) {
+        // retrieves the worker
+        JobWorker_t *worker = this->workersList[index];
+
+        // creates the worker thread
+        worker->threadHandle = THREAD_CREATE_BASE(worker->threadIdentifier, jobWorkerThread, worker);
+    }
+}
+
+/**
+ * Stops the job scheduler, waking and joining all the
+ * worker threads.
+ *
+ * @param arguments The arguments for the job scheduler stop.
+ */
+void JobScheduler::stop(void *arguments) {
+    // enters the idle critical section
+    CRITICAL_SECTION_ENTER(this->idleCriticalSection);
+
+    // unsets the running flag
+    this->runningFlag = false;
+
+    // wakes all the parked workers
+    CONDITION_BROADCAST(this->idleCondition);
+
+    // leaves the idle critical section
+    CRITICAL_SECTION_LEAVE(this->idleCriticalSection);
+
+    // iterates over all the (thread) workers
+    for(unsigned int index = 0; index < this->workerCount; index++) {
+        // retrieves the worker
+        JobWorker_t *worker = this->workersList[index];
+
+        // joins the worker thread
+        THREAD_JOIN_BASE(worker->threadHandle, worker->threadIdentifier);
+
+        // closes the worker thread handle
+        THREAD_CLOSE(worker->threadHandle);
+    }
+
+    // retrieves the workers list iterator
+    std::vector<JobWorker_t *>::iterator workersListIterator = this->workersList.begin();
+
+    // iterates over all the workers
+    while(workersListIterator != this->workersList.end()) {
+        // retrieves the worker
+        JobWorker_t *worker = *workersListIterator;
+
+        // closes the jobs deque critical section
+        CRITICAL_SECTION_CLOSE(worker->jobsDequeCriticalSection);
+
+        // deletes the worker
+        delete worker;
+
+        // increments the workers list iterator
+        workersListIterator++;
+    }
+
+    // clears the workers list
+    this->workersList.clear();
+
+    // closes the idle condition
+    CONDITION_CLOSE(this->idleCondition);
+
+    // closes the idle critical section
+    CRITICAL_SECTION_CLOSE(this->idleCriticalSection);
+}
+
+/**
+ * Initializes the given job, the job is only executed after
+ * being submitted and having all its dependencies finished.
+ * A job may only be re-initialized after being finished.
+ *
+ * @param job The job to be initialized.
+ * @param jobFunction The function to be called by the job.
+ * @param arguments The arguments to be sent to the job function.
+ */
+void JobScheduler::initJob(Job_t *job, void (*jobFunction)(void *), void *arguments) {
+    // sets the job function and arguments
+    job->jobFunction = jobFunction;
+    job->arguments = arguments;
+
+    // sets the pending dependencies to one, the
+    // reference held until the job is submitted
+    job->pendingDependencies = 1;
+
+    // unsets the finished flag
+    job->finished = 0;
+
+    // clears the dependents list (keeping the capacity)
+    job->dependentsList.clear();
+}
+
+/**
+ * Adds a dependency to the given job, the job is only
+ * executed after the dependency is finished.
+ * The dependency must be added before the dependency job
+ * is submitted.
+ *
+ * @param job The job that depends on the dependency.
+ * @param dependency The job to be finished first.
+ */
+void JobScheduler::addDependency(Job_t *job, Job_t *dependency) {
+    // increments the pending dependencies
+    ATOMIC_INCREMENT(job->pendingDependencies);
+
+    // adds the job to the dependents of the dependency
+    dependency->dependentsList.push_back(job);
+}
+
+/**
+ * Submits the given job for execution, the job is queued
+ * as soon as all its dependencies are finished.
+ *
+ * @param job The job to be submitted.
+ */
+void JobScheduler::submit(Job_t *job) {
+    // releases the submit reference, in case there
+    // are no more pending dependencies
+    if(ATOMIC_DECREMENT(job->pendingDependencies) == 0) {
+        // pushes the job into the current worker
+        this->pushJob(this->getCurrentWorker(), job);
+    }
+}
+
+/**
+ * Waits for the given job to be finished, executing other
+ * jobs in the meantime.
+ *
+ * @param job The job to wait for.
+ */
+void JobScheduler::wait(Job_t *job) {
+    // retrieves the current worker
+    JobWorker_t *worker = this->getCurrentWorker();
+
+    // iterates while the job is not finished
+    while(!this->isFinished(job)) {
+        // runs a job, in case no job is available
+        // yields the processor
+        if(!this->runJob(worker)) {
+            THREAD_YIELD();
+        }
+    }
+}
+
+/**
+ * Retrieves if the given job is finished.
+ *
+ * @param job The job to be tested.
+ * @return If the given job is finished.
+ */
+bool JobScheduler::isFinished(Job_t *job) {
+    // in case the job is not finished
+    if(!job->finished) {
+        // returns false
+        return false;
+    }
+
+    // synchronizes the memory with the finished job
+    MEMORY_BARRIER();
+
+    // returns true
+    return true;
+}
+
+/**
+ * Runs the given range function over the range from zero to count,
+ * split in chunks (of the given size) run as jobs.
+ * Waits for all the chunks to be finished, executing other jobs in
+ * the meantime (the calling thread also runs chunks).
+ *
+ * @param count The size of the range.
+ * @param chunkSize The size of each chunk (the last may be smaller).
+ * @param rangeFunction The function to be called for each chunk.
+ * @param arguments The arguments to be sent to the range function.
+ */
+void JobScheduler::runRange(unsigned int count, unsigned int chunkSize, JobRangeFunction_t rangeFunction, void *arguments) {
+    // allocates the (temporary) job ranges
+    std::vector<JobRange_t> jobRanges;
+
+    // runs the range with the job ranges
+    this->runRange(count, chunkSize, rangeFunction, arguments, jobRanges);
+}
+
+/**
+ * Runs the given range function over the range from zero to count,
+ * split in chunks (of the given size) run as jobs, using the given
+ * (reused) job ranges buffer.
+ * The buffer is only grown, so the runs with a buffer kept by the
+ * caller do not allocate memory (after the first run). The buffer
+ * must not be used by other runs at the same time.
+ *
+ * @param count The size of the range.
+ * @param chunkSize The size of each chunk (the last may be smaller).
+ * @param rangeFunction The function to be called for each chunk.
+ * @param arguments The arguments to be sent to the range function.
+ * @param jobRanges The buffer of job ranges to be used.
+ */
+void JobScheduler::runRange(unsigned int count, unsigned int chunkSize, JobRangeFunction_t rangeFunction, void *arguments, std::vector<JobRange_t> &jobRanges) {
+    // computes the number of chunks
+    unsigned int chunksCount = (count + chunkSize - 1) / chunkSize;
+
+    // in case there are no chunks
+    if(chunksCount == 0) {
+        // returns immediately
+        return;
+    }
+
+    // in case the job ranges buffer is too small
+    if(jobRanges.size() < chunksCount) {
+        // grows the job ranges buffer
+        jobRanges.resize(chunksCount);
+    }
+
+    // iterates over all the chunks
+    for(unsigned int index = 0; index < chunksCount; index++) {
+        // retrieves the job range
+        JobRange_t &jobRange = jobRanges[index];
+
+        // sets the job range attributes
+        jobRange.rangeFunction = rangeFunction;
+        jobRange.arguments = arguments;
+        jobRange.start = index * chunkSize;
+        jobRange.end = jobRange.start + chunkSize < count ? jobRange.start + chunkSize : count;
+
+        // initializes and submits the job
+        this->initJob(&jobRange.job, jobRangeFunction, &jobRange);
+        this->submit(&jobRange.job);
+    }
+
+    // iterates over all the chunks
+    for(unsigned int index = 0; index < chunksCount; index++) {
+        // waits for the chunk job
+        this->wait(&jobRanges[index].job);
+    }
+}
+
+/**
+ * Runs a job in the given worker, retrieving it from the
+ * worker deque or stealing it from the other workers.
+ *
+ * @param worker The worker to be used.
+ * @return If a job was run.
+ */
+bool JobScheduler::runJob(JobWorker_t *worker) {
+    // pops a job from the worker
+    Job_t *job = this->popJob(worker);
+
+    // in case no job was found in the worker
+    if(!job) {
+        // steals a job from the other workers
+        job = this->stealJob(worker);
+    }
+
+    // in case no job is available
+    if(!job) {
+        // returns false
+        return false;
+    }
+
+    // in case the job contains a function
+    if(job->jobFunction) {
+        // calls the job function
+        job->jobFunction(job->arguments);
+    }
+
+    // finishes the job
+    this->finishJob(worker, job);
+
+    // returns true
+    return true;
+}
+
+/**
+ * Runs the worker loop, executing jobs while the scheduler
+ * is running and parking the worker when no job is available.
+ *
+ * @param worker The worker to be run.
+ */
+void JobScheduler::runWorker(JobWorker_t *worker) {
+    // starts the spin count
+    unsigned int spinCount = 0;
+
+    // iterates while the running flag is set
+    while(this->runningFlag) {
+        // runs a job, in case it succeeds
+        if(this->runJob(worker)) {
+            // resets the spin count
+            spinCount = 0;
+        }
+        // in case the spin count is not exhausted
+        else if(spinCount < JOB_SCHEDULER_SPIN_COUNT) {
+            // increments the spin count
+            spinCount++;
+
+            // yields the processor
+            THREAD_YIELD();
+        } else {
+            // parks the worker
+            this->parkWorker();
+
+            // resets the spin count
+            spinCount = 0;
+        }
+    }
+}
+
+/**
+ * Retrieves the number of worker threads.
+ *
+ * @return The number of worker threads.
+ */
+unsigned int JobScheduler::getWorkerCount() {
+    return this->workerCount;
+}
+
+inline JobWorker_t *JobScheduler::getCurrentWorker() {
+    // in case the current thread is a worker of this scheduler
+    if(currentWorker && currentWorker->jobScheduler == this) {
+        // returns the current worker
+        return currentWorker;
+    }
+
+    // returns the external worker
+    return this->workersList[this->workerCount];
+}
+
+inline void JobScheduler::pushJob(JobWorker_t *worker, Job_t *job) {
+    // enters the jobs deque critical section
+    CRITICAL_SECTION_ENTER(worker->jobsDequeCriticalSection);
+
+    // adds the job to the back of the deque
+    worker->jobsDeque.push_back(job);
+
+    // increments the jobs count
+    ATOMIC_INCREMENT(worker->jobsCount);
+
+    // leaves the jobs deque critical section
+    CRITICAL_SECTION_LEAVE(worker->jobsDequeCriticalSection);
+
+    // increments the queued jobs
+    ATOMIC_INCREMENT(this->queuedJobs);
+
+    // in case there are parked workers
+    if(this->idleWorkers > 0) {
+        // enters the idle critical section
+        CRITICAL_SECTION_ENTER(this->idleCriticalSection);
+
+        // wakes one of the parked workers
+        CONDITION_SIGNAL(this->idleCondition);
+
+        // leaves the idle critical section
+        CRITICAL_SECTION_LEAVE(this->idleCriticalSection);
+    }
+}
+
+inline Job_t *JobScheduler::popJob(JobWorker_t *worker) {
+    // in case the worker has no jobs
+    if(worker->jobsCount == 0) {
+        // returns invalid
+        return NULL;
+    }
+
+    // starts the job
+    Job_t *job = NULL;
+
+    // enters the jobs deque critical section
+    CRITICAL_SECTION_ENTER(worker->jobsDequeCriticalSection);
+
+    // in case the deque is not empty
+    if(!worker->jobsDeque.empty()) {
+        // pops the (newest) job from the back of the deque
+        job = worker->jobsDeque.back();
+        worker->jobsDeque.pop_back();
+
+        // decrements the jobs count
+        ATOMIC_DECREMENT(worker->jobsCount);
+    }
+
+    // leaves the jobs deque critical section
+    CRITICAL_SECTION_LEAVE(worker->jobsDequeCriticalSection);
+
+    // in case a job was found
+    if(job) {
+        // decrements the queued jobs
+        ATOMIC_DECREMENT(this->queuedJobs);
+    }
+
+    // returns the job
+    return job;
+}
+
+inline Job_t *JobScheduler::stealJob(JobWorker_t *worker) {
+    // retrieves the number of workers
+    unsigned int workersCount = this->workersList.size();
+
+    // iterates over all the other workers
+    for(unsigned int offset = 1; offset < workersCount; offset++) {
+        // retrieves the victim worker
+        JobWorker_t *victim = this->workersList[(worker->index + offset) % workersCount];
+
+        // in case the victim has no jobs
+        if(victim->jobsCount == 0) {
+            // continues the loop
+            continue;
+        }
+
+        // starts the job
+        Job_t *job = NULL;
+
+        // enters the victim jobs deque critical section
+        CRITICAL_SECTION_ENTER(victim->jobsDequeCriticalSection);
+
+        // in case the victim deque is not empty
+        if(!victim->jobsDeque.empty()) {
+            // steals the (oldest) job from the front of the deque
+            job = victim->jobsDeque.front();
+            victim->jobsDeque.pop_front();
+
+            // decrements the jobs count
+            ATOMIC_DECREMENT(victim->jobsCount);
+        }
+
+        // leaves the victim jobs deque critical section
+        CRITICAL_SECTION_LEAVE(victim->jobsDequeCriticalSection);
+
+        // in case a job was stolen
+        if(job) {
+            // decrements the queued jobs
+            ATOMIC_DECREMENT(this->queuedJobs);
+
+            // returns the job
+            return job;
+        }
+    }
+
+    // returns invalid
+    return NULL;
+}
+
+inline void JobScheduler::finishJob(JobWorker_t *worker, Job_t *job) {
+    // retrieves the dependents list iterator
+    std::vector<Job_t *>::iterator dependentsListIterator = job->dependentsList.begin();
+
+    // iterates over all the dependents
+    while(dependentsListIterator != job->dependentsList.end()) {
+        // retrieves the dependent job
+        Job_t *dependent = *dependentsListIterator;
+
+        // releases the dependency, in case there are
+        // no more pending dependencies
+        if(ATOMIC_DECREMENT(dependent->pendingDependencies) == 0) {
+            // pushes the dependent into the worker
+            this->pushJob(worker, dependent);
+        }
+
+        // increments the dependents list iterator
+        dependentsListIterator++;
+    }
+
+    // synchronizes the memory before the finished flag
+    MEMORY_BARRIER();
+
+    // sets the finished flag (last access to the job)
+    job->finished = 1;
+}
+
+inline void JobScheduler::parkWorker() {
+    // enters the idle critical section
+    CRITICAL_SECTION_ENTER(this->idleCriticalSection);
+
+    // increments the idle workers
+    ATOMIC_INCREMENT(this->idleWorkers);
+
+    // iterates while there are no queued jobs
+    // and the running flag is set
+    while(this->queuedJobs == 0 && this->runningFlag) {
+        CONDITION_WAIT(this->idleCondition, this->idleCriticalSection);
+    }
+
+    // decrements the idle workers
+    ATOMIC_DECREMENT(this->idleWorkers);
+
+    // leaves the idle critical section
+    CRITICAL_SECTION_LEAVE(this->idleCriticalSection);
+}
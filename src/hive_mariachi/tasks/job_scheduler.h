@@ -0,0 +1,121 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+#include "../system/thread.h"
+
+/**
+ * The number of failed job retrievals an idle
+ * worker makes before parking.
+ */
+#define JOB_SCHEDULER_SPIN_COUNT 64
+
+namespace mariachi {
+    namespace tasks {
+        class JobScheduler;
+
+        typedef struct Job_t {
+            void (*jobFunction)(void *arguments);
+            void *arguments;
+            ATOMIC_VALUE pendingDependencies;
+            ATOMIC_VALUE finished;
+            std::vector<Job_t *> dependentsList;
+        } Job;
+
+        /**
+         * The function called for each chunk of a range, with
+         * the start and end (exclusive) of the chunk.
+         */
+        typedef void (*JobRangeFunction_t)(void *arguments, unsigned int start, unsigned int end);
+
+        /**
+         * Structure describing a chunk of a range run as a job.
+         *
+         * @param rangeFunction The function to be called for the chunk.
+         * @param arguments The arguments to be sent to the range function.
+         * @param start The start of the chunk.
+         * @param end The end (exclusive) of the chunk.
+         * @param job The job running the chunk.
+         */
+        typedef struct JobRange_t {
+            JobRangeFunction_t rangeFunction;
+            void *arguments;
+            unsigned int start;
+            unsigned int end;
+            Job_t job;
+        } JobRange;
+
+        typedef struct JobWorker_t {
+            unsigned int index;
+            JobScheduler *jobScheduler;
+            std::deque<Job_t *> jobsDeque;
+            ATOMIC_VALUE jobsCount;
+            CRITICAL_SECTION_HANDLE jobsDequeCriticalSection;
+            THREAD_HANDLE threadHandle;
+            THREAD_IDENTIFIER threadIdentifier;
+        } JobWorker;
+
+        class JobScheduler {
+            private:
+                unsigned int workerCount;
+                std::vector<JobWorker_t *> workersList;
+                bool runningFlag;
+                ATOMIC_VALUE queuedJobs;
+                ATOMIC_VALUE idleWorkers;
+                CRITICAL_SECTION_HANDLE idleCriticalSection;
+                CONDITION_HANDLE idleCondition;
+
+                inline void initWorkerCount(unsigned int workerCount);
+                inline void initRunningFlag();
+                inline JobWorker_t *getCurrentWorker();
+                inline void pushJob(JobWorker_t *worker, Job_t *job);
+                inline Job_t *popJob(JobWorker_t *worker);
+                inline Job_t *stealJob(JobWorker_t *worker);
+                inline void finishJob(JobWorker_t *worker, Job_t *job);
+                inline void parkWorker();
+
+            public:
+                JobScheduler();
+                JobScheduler(unsigned int workerCount);
+                ~JobScheduler();
+                void start(void *arguments);
+                void stop(void *arguments);
+                void initJob(Job_t *job, void (*jobFunction)(void *), void *arguments);
+                void addDependency(Job_t *job, Job_t *dependency);
+                void submit(Job_t *job);
+                void wait(Job_t *job);
+                bool isFinished(Job_t *job);
+                void runRange(unsigned int count, unsigned int chunkSize, JobRangeFunction_t rangeFunction, void *arguments);
+                void runRange(unsigned int count, unsigned int chunkSize, JobRangeFunction_t rangeFunction, void *arguments, std::vector<JobRange_t> &jobRanges);
+                bool runJob(JobWorker_t *worker);
+                void runWorker(JobWorker_t *worker);
+                unsigned int getWorkerCount();
+        };
+
+        THREAD_RETURN jobWorkerThread(THREAD_ARGUMENTS parameters);
+        void jobRangeFunction(void *arguments);
+    }
+}
@@ -33,9 +33,13 @@ using namespace mariachi::tasks;
  * Constructor of the class.
  */
 Task::Task() {
+    this->initPriority();
+    this->initStatus();
 }
 
 Task::Task(const std::string &name) {
+    this->initPriority();
+    this->initStatus();
     this->name = name;
 }
 
@@ -43,6 +47,164 @@ Task::Task(const std::string &name) {
  * Destructor of the class.
  */
 Task::~Task() {
+    CRITICAL_SECTION_CLOSE(this->statusCriticalSection);
+    CONDITION_CLOSE(this->statusCondition);
+}
+
+inline void Task::initPriority() {
+    this->priority = NORMAL_PRIORITY;
+    this->mainThread = false;
+}
+
+inline void Task::initStatus() {
+    // sets the initial status
+    this->status = PENDING_STATUS;
+    this->canceled = false;
+
+    // creates the status critical section and condition
+    CRITICAL_SECTION_CREATE(this->statusCriticalSection);
+    CONDITION_CREATE(this->statusCondition);
+}
+
+/**
+ * Runs the task, in case it was not canceled, updating
+ * the status and waking the threads waiting for it.
+ */
+void Task::run() {
+    // enters the status critical section
+    CRITICAL_SECTION_ENTER(this->statusCriticalSection);
+
+    // in case the task was canceled (before running)
+    if(this->canceled) {
+        // leaves the status critical section
+        CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+        // returns immediately
+        return;
+    }
+
+    // sets the running status
+    this->status = RUNNING_STATUS;
+
+    // leaves the status critical section
+    CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+    // starts the task
+    this->start(NULL);
+
+    // enters the status critical section
+    CRITICAL_SECTION_ENTER(this->statusCriticalSection);
+
+    // sets the final status
+    this->status = this->canceled ? CANCELED_STATUS : FINISHED_STATUS;
+
+    // wakes all the threads waiting for the task
+    CONDITION_BROADCAST(this->statusCondition);
+
+    // leaves the status critical section
+    CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+}
+
+/**
+ * Cancels the task, a pending task is not run and a running
+ * task is requested to stop.
+ * A task canceled while pending may still be referenced by
+ * the task pool (it's skipped when dequeued).
+ *
+ * @return If the task was canceled while pending (never run).
+ */
+bool Task::cancel() {
+    // enters the status critical section
+    CRITICAL_SECTION_ENTER(this->statusCriticalSection);
+
+    // in case the task is already complete
+    if(this->status == FINISHED_STATUS || this->status == CANCELED_STATUS) {
+        // leaves the status critical section
+        CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+        // returns invalid (not canceled while pending)
+        return false;
+    }
+
+    // sets the canceled flag
+    this->canceled = true;
+
+    // in case the task is still pending
+    if(this->status == PENDING_STATUS) {
+        // sets the canceled status
+        this->status = CANCELED_STATUS;
+
+        // wakes all the threads waiting for the task
+        CONDITION_BROADCAST(this->statusCondition);
+
+        // leaves the status critical section
+        CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+        // returns valid (canceled while pending)
+        return true;
+    }
+
+    // leaves the status critical section
+    CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+    // requests the (running) task to stop
+    this->stop(NULL);
+
+    // returns invalid (not canceled while pending)
+    return false;
+}
+
+/**
+ * Waits for the task to be complete (finished or canceled).
+ */
+void Task::wait() {
+    // enters the status critical section
+    CRITICAL_SECTION_ENTER(this->statusCriticalSection);
+
+    // iterates while the task is not complete
+    while(this->status != FINISHED_STATUS && this->status != CANCELED_STATUS) {
+        CONDITION_WAIT(this->statusCondition, this->statusCriticalSection);
+    }
+
+    // leaves the status critical section
+    CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+}
+
+/**
+ * Retrieves if the task is finished (run to completion).
+ *
+ * @return If the task is finished.
+ */
+bool Task::isFinished() {
+    return this->getStatus() == FINISHED_STATUS;
+}
+
+/**
+ * Retrieves if the task was canceled.
+ *
+ * @return If the task was canceled.
+ */
+bool Task::isCanceled() {
+    return this->canceled;
+}
+
+/**
+ * Retrieves the current task status.
+ *
+ * @return The current task status.
+ */
+TaskStatus_t Task::getStatus() {
+    // enters the status critical section
+    CRITICAL_SECTION_ENTER(this->statusCriticalSection);
+
+    // retrieves the status
+    TaskStatus_t status = this->status;
+
+    // leaves the status critical section
+    CRITICAL_SECTION_LEAVE(this->statusCriticalSection);
+
+    // returns the status
+    return status;
 }
 
 std::string &Task::getName() {
@@ -52,3 +214,19 @@ std::string &Task::getName() {
 void Task::setName(const std::string &name) {
     this->name = name;
 }
+
+TaskPriority_t Task::getPriority() {
+    return this->priority;
+}
+
+void Task::setPriority(TaskPriority_t priority) {
+    this->priority = priority;
+}
+
+bool Task::isMainThread() {
+    return this->mainThread;
+}
+
+void Task::setMainThread(bool mainThread) {
+    this->mainThread = mainThread;
+}
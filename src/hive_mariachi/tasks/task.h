@@ -25,10 +25,39 @@
 
 #pragma once
 
+#include "../system/thread.h"
+
 namespace mariachi {
     namespace tasks {
+        typedef enum TaskPriority_t {
+            LOW_PRIORITY = 1,
+            NORMAL_PRIORITY,
+            HIGH_PRIORITY
+        } TaskPriority;
+
+        typedef enum TaskStatus_t {
+            PENDING_STATUS = 1,
+            RUNNING_STATUS,
+            FINISHED_STATUS,
+            CANCELED_STATUS
+        } TaskStatus;
+
+        /**
+         * The base task, executed by the engine in the task pool
+         * (or in the main thread). The task is also the handle used
+         * to wait for its completion or to cancel it.
+         */
         class Task {
             private:
+                TaskPriority_t priority;
+                bool mainThread;
+                bool canceled;
+                TaskStatus_t status;
+                CRITICAL_SECTION_HANDLE statusCriticalSection;
+                CONDITION_HANDLE statusCondition;
+
+                inline void initPriority();
+                inline void initStatus();
 
             protected:
                 std::string name;
@@ -36,11 +65,21 @@ namespace mariachi {
             public:
                 Task();
                 Task(const std::string &name);
-                ~Task();
+                virtual ~Task();
                 virtual void start(void *parameters) { };
                 virtual void stop(void *parameters) { };
+                void run();
+                bool cancel();
+                void wait();
+                bool isFinished();
+                bool isCanceled();
+                TaskStatus_t getStatus();
                 std::string &getName();
                 void setName(const std::string &name);
+                TaskPriority_t getPriority();
+                void setPriority(TaskPriority_t priority);
+                bool isMainThread();
+                void setMainThread(bool mainThread);
         };
     }
 }
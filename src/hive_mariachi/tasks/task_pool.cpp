@@ -0,0 +1,226 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "task_pool.h"
+
+using namespace mariachi::tasks;
+
+/**
+ * Thread that runs a task pool worker, executing the pending
+ * tasks in order of priority.
+ *
+ * @param parameters The thread parameters.
+ * @return The thread result.
+ */
+THREAD_RETURN mariachi::tasks::taskPoolWorkerThread(THREAD_ARGUMENTS parameters) {
+    // retrieves the task pool from the parameters
+    TaskPool *taskPool = (TaskPool *) parameters;
+
+    // runs the worker loop
+    taskPool->runWorker();
+
+    // returns valid value
+    return THREAD_VALID_RETURN_VALUE;
+}
+
+/**
+ * Constructor of the class.
+ */
+TaskPool::TaskPool() {
+    this->initWorkerCount(DEFAULT_TASK_POOL_WORKER_COUNT);
+    this->initRunningFlag();
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param workerCount The number of worker threads to be used.
+ */
+TaskPool::TaskPool(unsigned int workerCount) {
+    this->initWorkerCount(workerCount);
+    this->initRunningFlag();
+}
+
+/**
+ * Destructor of the class.
+ */
+TaskPool::~TaskPool() {
+}
+
+inline void TaskPool::initWorkerCount(unsigned int workerCount) {
+    this->workerCount = workerCount;
+}
+
+inline void TaskPool::initRunningFlag() {
+    this->runningFlag = false;
+}
+
+/**
+ * Starts the task pool, creating the worker threads.
+ *
+ * @param arguments The arguments for the task pool start.
+ */
+void TaskPool::start(void *arguments) {
+    // sets the running flag
+    this->runningFlag = true;
+
+    // resets the sequence
+    this->sequence = 0;
+
+    // creates the tasks queue critical section and condition
+    CRITICAL_SECTION_CREATE(this->tasksQueueCriticalSection);
+    CONDITION_CREATE(this->tasksQueueCondition);
+
+    // iterates over all the workers
+    for(unsigned int index = 0; index < this->workerCount; index++) {
+        // allocates space for the thread id
+        THREAD_IDENTIFIER threadId;
+
+        // creates the worker thread
+        THREAD_HANDLE threadHandle = THREAD_CREATE_BASE(threadId, taskPoolWorkerThread, this);
+
+        // adds the thread handle and identifier to the lists
+        this->threadHandlesList.push_back(threadHandle);
+        this->threadIdentifiersList.push_back(threadId);
+    }
+}
+
+/**
+ * Stops the task pool, joining all the worker threads (the
+ * running tasks are waited) and canceling the pending tasks.
+ *
+ * @param arguments The arguments for the task pool stop.
+ */
+void TaskPool::stop(void *arguments) {
+    // enters the tasks queue critical section
+    CRITICAL_SECTION_ENTER(this->tasksQueueCriticalSection);
+
+    // unsets the running flag
+    this->runningFlag = false;
+
+    // wakes all the waiting workers
+    CONDITION_BROADCAST(this->tasksQueueCondition);
+
+    // leaves the tasks queue critical section
+    CRITICAL_SECTION_LEAVE(this->tasksQueueCriticalSection);
+
+    // iterates over all the workers
+    for(unsigned int index = 0; index < this->workerCount; index++) {
+        // joins the worker thread
+        THREAD_JOIN_BASE(this->threadHandlesList[index], this->threadIdentifiersList[index]);
+
+        // closes the worker thread handle
+        THREAD_CLOSE(this->threadHandlesList[index]);
+    }
+
+    // clears the thread handles and identifiers lists
+    this->threadHandlesList.clear();
+    this->threadIdentifiersList.clear();
+
+    // iterates while there are pending tasks
+    while(!this->tasksQueue.empty()) {
+        // cancels the pending task (waking the threads waiting for it)
+        this->tasksQueue.top().task->cancel();
+
+        // pops the tasks queue
+        this->tasksQueue.pop();
+    }
+
+    // closes the tasks queue critical section and condition
+    CRITICAL_SECTION_CLOSE(this->tasksQueueCriticalSection);
+    CONDITION_CLOSE(this->tasksQueueCondition);
+}
+
+/**
+ * Submits the given task to be run by the task pool.
+ *
+ * @param task The task to be submitted.
+ */
+void TaskPool::submit(Task *task) {
+    // enters the tasks queue critical section
+    CRITICAL_SECTION_ENTER(this->tasksQueueCriticalSection);
+
+    // creates the task pool entry (with a copy of the priority)
+    TaskPoolEntry_t entry = { task, task->getPriority(), this->sequence++ };
+
+    // adds the entry to the tasks queue
+    this->tasksQueue.push(entry);
+
+    // wakes a waiting worker
+    CONDITION_SIGNAL(this->tasksQueueCondition);
+
+    // leaves the tasks queue critical section
+    CRITICAL_SECTION_LEAVE(this->tasksQueueCriticalSection);
+}
+
+/**
+ * Runs the worker loop, retrieving and running the task with
+ * the highest priority while the task pool is running.
+ */
+void TaskPool::runWorker() {
+    // iterates continuously
+    while(true) {
+        // enters the tasks queue critical section
+        CRITICAL_SECTION_ENTER(this->tasksQueueCriticalSection);
+
+        // iterates while there are no tasks and the running flag is active
+        while(this->tasksQueue.empty() && this->runningFlag) {
+            CONDITION_WAIT(this->tasksQueueCondition, this->tasksQueueCriticalSection);
+        }
+
+        // in case the running flag is not active
+        if(!this->runningFlag) {
+            // leaves the tasks queue critical section
+            CRITICAL_SECTION_LEAVE(this->tasksQueueCriticalSection);
+
+            // breaks the loop
+            break;
+        }
+
+        // retrieves the task with the highest priority
+        Task *task = this->tasksQueue.top().task;
+
+        // pops the tasks queue
+        this->tasksQueue.pop();
+
+        // leaves the tasks queue critical section
+        CRITICAL_SECTION_LEAVE(this->tasksQueueCriticalSection);
+
+        // runs the task (skipped in case it was canceled)
+        task->run();
+    }
+}
+
+/**
+ * Retrieves the number of worker threads.
+ *
+ * @return The number of worker threads.
+ */
+unsigned int TaskPool::getWorkerCount() {
+    return this->workerCount;
+}
@@ -0,0 +1,100 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../system/thread.h"
+#include "task.h"
+
+/**
+ * The default number of worker threads
+ * in the task pool.
+ */
+#define DEFAULT_TASK_POOL_WORKER_COUNT 2
+
+namespace mariachi {
+    namespace tasks {
+        /**
+         * The task pool entry, the priority is a copy of
+         * the task priority at submission (the task priority
+         * may change while the task is queued).
+         */
+        typedef struct TaskPoolEntry_t {
+            Task *task;
+            TaskPriority_t priority;
+            unsigned long sequence;
+        } TaskPoolEntry;
+
+        /**
+         * Orders the task pool entries by priority, the entries
+         * with the same priority are ordered by submission.
+         */
+        typedef struct TaskPoolEntryCompare_t {
+            bool operator()(const TaskPoolEntry_t &entry, const TaskPoolEntry_t &otherEntry) const {
+                // in case the priorities are different
+                if(entry.priority != otherEntry.priority) {
+                    // returns if the entry has lower priority
+                    return entry.priority < otherEntry.priority;
+                }
+
+                // returns if the entry was submitted later
+                return entry.sequence > otherEntry.sequence;
+            }
+        } TaskPoolEntryCompare;
+
+        /**
+         * Pool of worker threads that run the (possibly long
+         * and blocking) engine tasks, the pending tasks are run
+         * in order of priority.
+         */
+        class TaskPool {
+            private:
+                unsigned int workerCount;
+                bool runningFlag;
+                unsigned long sequence;
+                std::priority_queue<TaskPoolEntry_t, std::vector<TaskPoolEntry_t>, TaskPoolEntryCompare_t> tasksQueue;
+                std::vector<THREAD_HANDLE> threadHandlesList;
+                std::vector<THREAD_IDENTIFIER> threadIdentifiersList;
+                CRITICAL_SECTION_HANDLE tasksQueueCriticalSection;
+                CONDITION_HANDLE tasksQueueCondition;
+
+                inline void initWorkerCount(unsigned int workerCount);
+                inline void initRunningFlag();
+
+            public:
+                TaskPool();
+                TaskPool(unsigned int workerCount);
+                ~TaskPool();
+                void start(void *arguments);
+                void stop(void *arguments);
+                void submit(Task *task);
+                void runWorker();
+                unsigned int getWorkerCount();
+        };
+
+        THREAD_RETURN taskPoolWorkerThread(THREAD_ARGUMENTS parameters);
+    }
+}
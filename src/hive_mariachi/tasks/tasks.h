@@ -26,4 +26,6 @@
 #pragma once
 
 #include "function_caller_task.h"
+#include "job_scheduler.h"
 #include "task.h"
+#include "task_pool.h"
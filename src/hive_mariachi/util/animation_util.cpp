@@ -0,0 +1,322 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "animation_util.h"
+
+#ifdef MARIACHI_ANIMATION_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace mariachi::util;
+using namespace mariachi::structures;
+
+/**
+ * Decodes the given vertices of the quantized keyframes and
+ * blends them (weighted sum) into the vertex list.
+ * The scale and translation of the keyframes are folded with
+ * the weights, so that each coordinate is computed with a
+ * multiplication and an addition per keyframe (using sse when
+ * available, four coordinates at a time).
+ *
+ * @param keyframes The keyframes to be blended.
+ * @param weights The weight of each of the keyframes (the sum
+ * of the weights should be one).
+ * @param numberKeyframes The number of keyframes to be blended (up
+ * to the maximum number of blend keyframes).
+ * @param vertexIndexes The indexes of the keyframe vertices to be
+ * decoded (in output order).
+ * @param numberVertices The number of vertices to be decoded.
+ * @param vertexList The list to be filled with the coordinates of the
+ * vertices (three per vertex).
+ */
+void AnimationUtil::blendKeyframes(const QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, const unsigned int *vertexIndexes, unsigned int numberVertices, float *vertexList) {
+    // allocates the folded scales and translation
+    float scales[ANIMATION_MAXIMUM_BLEND_KEYFRAMES][3];
+    float translate[3] = { 0.0f, 0.0f, 0.0f };
+
+    // iterates over all the keyframes
+    for(unsigned int index = 0; index < numberKeyframes; index++) {
+        // calculates the keyframe folded scale
+        scales[index][0] = keyframes[index]->scale[0] * weights[index];
+        scales[index][1] = keyframes[index]->scale[1] * weights[index];
+        scales[index][2] = keyframes[index]->scale[2] * weights[index];
+
+        // accumulates the keyframe translation
+        translate[0] += keyframes[index]->translate[0] * weights[index];
+        translate[1] += keyframes[index]->translate[1] * weights[index];
+        translate[2] += keyframes[index]->translate[2] * weights[index];
+    }
+
+    // starts the vertex index
+    unsigned int index = 0;
+
+#ifdef MARIACHI_ANIMATION_SSE
+    // creates the folded scales and translation vectors
+    __m128 scaleVectors[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+    __m128 translateVector = _mm_setr_ps(translate[0], translate[1], translate[2], 0.0f);
+
+    // iterates over all the keyframes
+    for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+        // creates the keyframe folded scale vector
+        scaleVectors[keyframeIndex] = _mm_setr_ps(scales[keyframeIndex][0], scales[keyframeIndex][1], scales[keyframeIndex][2], 0.0f);
+    }
+
+    // creates the zero vector
+    __m128i zero = _mm_setzero_si128();
+
+    // iterates over all the vertices but the last (the four
+    // coordinates store overlaps the next vertex)
+    for(; index + 1 < numberVertices; index++) {
+        // retrieves the offset of the quantized vertex
+        unsigned int offset = vertexIndexes[index] * QUANTIZED_VERTEX_SIZE;
+
+        // starts the coordinates with the translation
+        __m128 coordinates = translateVector;
+
+        // iterates over all the keyframes
+        for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+            // loads the quantized vertex (four bytes) and widens it to floats
+            __m128i vertex = _mm_cvtsi32_si128(*(int *) &keyframes[keyframeIndex]->vertices[offset]);
+            __m128 vertexFloat = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(vertex, zero), zero));
+
+            // accumulates the scaled vertex
+            coordinates = _mm_add_ps(coordinates, _mm_mul_ps(vertexFloat, scaleVectors[keyframeIndex]));
+        }
+
+        // stores the coordinates (the fourth value is overwritten
+        // by the next vertex)
+        _mm_storeu_ps(&vertexList[index * 3], coordinates);
+    }
+#endif
+
+    // iterates over all the remaining vertices
+    for(; index < numberVertices; index++) {
+        // retrieves the offset of the quantized vertex
+        unsigned int offset = vertexIndexes[index] * QUANTIZED_VERTEX_SIZE;
+
+        // starts the coordinates with the translation
+        float coordinates[3] = { translate[0], translate[1], translate[2] };
+
+        // iterates over all the keyframes
+        for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+            // retrieves the quantized vertex
+            const unsigned char *vertex = &keyframes[keyframeIndex]->vertices[offset];
+
+            // accumulates the scaled vertex
+            coordinates[0] += vertex[0] * scales[keyframeIndex][0];
+            coordinates[1] += vertex[1] * scales[keyframeIndex][1];
+            coordinates[2] += vertex[2] * scales[keyframeIndex][2];
+        }
+
+        // sets the coordinates in the vertex list
+        vertexList[index * 3] = coordinates[0];
+        vertexList[index * 3 + 1] = coordinates[1];
+        vertexList[index * 3 + 2] = coordinates[2];
+    }
+}
+
+/**
+ * Decodes the given vertices of the short quantized keyframes
+ * (signed short coordinates) and blends them (weighted sum) into
+ * the vertex list, as in the byte quantized keyframes.
+ *
+ * @param keyframes The keyframes to be blended.
+ * @param weights The weight of each of the keyframes (the sum
+ * of the weights should be one).
+ * @param numberKeyframes The number of keyframes to be blended (up
+ * to the maximum number of blend keyframes).
+ * @param vertexIndexes The indexes of the keyframe vertices to be
+ * decoded (in output order).
+ * @param numberVertices The number of vertices to be decoded.
+ * @param vertexList The list to be filled with the coordinates of the
+ * vertices (three per vertex).
+ */
+void AnimationUtil::blendShortKeyframes(const QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, const unsigned int *vertexIndexes, unsigned int numberVertices, float *vertexList) {
+    // allocates the folded scales and translation
+    float scales[ANIMATION_MAXIMUM_BLEND_KEYFRAMES][3];
+    float translate[3] = { 0.0f, 0.0f, 0.0f };
+
+    // iterates over all the keyframes
+    for(unsigned int index = 0; index < numberKeyframes; index++) {
+        // calculates the keyframe folded scale
+        scales[index][0] = keyframes[index]->scale[0] * weights[index];
+        scales[index][1] = keyframes[index]->scale[1] * weights[index];
+        scales[index][2] = keyframes[index]->scale[2] * weights[index];
+
+        // accumulates the keyframe translation
+        translate[0] += keyframes[index]->translate[0] * weights[index];
+        translate[1] += keyframes[index]->translate[1] * weights[index];
+        translate[2] += keyframes[index]->translate[2] * weights[index];
+    }
+
+    // starts the vertex index
+    unsigned int index = 0;
+
+#ifdef MARIACHI_ANIMATION_SSE
+    // creates the folded scales and translation vectors
+    __m128 scaleVectors[ANIMATION_MAXIMUM_BLEND_KEYFRAMES];
+    __m128 translateVector = _mm_setr_ps(translate[0], translate[1], translate[2], 0.0f);
+
+    // iterates over all the keyframes
+    for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+        // creates the keyframe folded scale vector
+        scaleVectors[keyframeIndex] = _mm_setr_ps(scales[keyframeIndex][0], scales[keyframeIndex][1], scales[keyframeIndex][2], 0.0f);
+    }
+
+    // iterates over all the vertices but the last (the four
+    // coordinates store overlaps the next vertex)
+    for(; index + 1 < numberVertices; index++) {
+        // retrieves the offset of the quantized vertex
+        unsigned int offset = vertexIndexes[index] * QUANTIZED_SHORT_VERTEX_SIZE;
+
+        // starts the coordinates with the translation
+        __m128 coordinates = translateVector;
+
+        // iterates over all the keyframes
+        for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+            // loads the quantized vertex (four shorts) and widens it to
+            // floats (sign extending the shorts)
+            __m128i vertex = _mm_loadl_epi64((__m128i *) &keyframes[keyframeIndex]->vertices[offset]);
+            __m128 vertexFloat = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(vertex, vertex), 16));
+
+            // accumulates the scaled vertex
+            coordinates = _mm_add_ps(coordinates, _mm_mul_ps(vertexFloat, scaleVectors[keyframeIndex]));
+        }
+
+        // stores the coordinates (the fourth value is overwritten
+        // by the next vertex)
+        _mm_storeu_ps(&vertexList[index * 3], coordinates);
+    }
+#endif
+
+    // iterates over all the remaining vertices
+    for(; index < numberVertices; index++) {
+        // retrieves the offset of the quantized vertex
+        unsigned int offset = vertexIndexes[index] * QUANTIZED_SHORT_VERTEX_SIZE;
+
+        // starts the coordinates with the translation
+        float coordinates[3] = { translate[0], translate[1], translate[2] };
+
+        // iterates over all the keyframes
+        for(unsigned int keyframeIndex = 0; keyframeIndex < numberKeyframes; keyframeIndex++) {
+            // retrieves the quantized vertex
+            const short *vertex = (const short *) &keyframes[keyframeIndex]->vertices[offset];
+
+            // accumulates the scaled vertex
+            coordinates[0] += vertex[0] * scales[keyframeIndex][0];
+            coordinates[1] += vertex[1] * scales[keyframeIndex][1];
+            coordinates[2] += vertex[2] * scales[keyframeIndex][2];
+        }
+
+        // sets the coordinates in the vertex list
+        vertexList[index * 3] = coordinates[0];
+        vertexList[index * 3 + 1] = coordinates[1];
+        vertexList[index * 3 + 2] = coordinates[2];
+    }
+}
+
+/**
+ * Blends the given tags (weighted sum of the origins and of
+ * the axis), the blended axis are not orthonormalized.
+ *
+ * @param tags The tags to be blended.
+ * @param weights The weight of each of the tags (the sum
+ * of the weights should be one).
+ * @param numberKeyframes The number of tags to be blended.
+ * @param tag The tag to be set with the blended values.
+ */
+void AnimationUtil::blendTags(const KeyframeTag_t **tags, const float *weights, unsigned int numberKeyframes, KeyframeTag_t &tag) {
+    // resets the tag
+    memset(&tag, 0, sizeof(KeyframeTag_t));
+
+    // iterates over all the keyframes
+    for(unsigned int index = 0; index < numberKeyframes; index++) {
+        // retrieves the keyframe tag and weight
+        const KeyframeTag_t *keyframeTag = tags[index];
+        float weight = weights[index];
+
+        // accumulates the weighted origin
+        tag.origin.x += keyframeTag->origin.x * weight;
+        tag.origin.y += keyframeTag->origin.y * weight;
+        tag.origin.z += keyframeTag->origin.z * weight;
+
+        // iterates over all the axis
+        for(unsigned int axisIndex = 0; axisIndex < 3; axisIndex++) {
+            // accumulates the weighted axis
+            tag.axis[axisIndex].x += keyframeTag->axis[axisIndex].x * weight;
+            tag.axis[axisIndex].y += keyframeTag->axis[axisIndex].y * weight;
+            tag.axis[axisIndex].z += keyframeTag->axis[axisIndex].z * weight;
+        }
+    }
+}
+
+/**
+ * Generates the clips from the names of the keyframes, the clip
+ * name is the keyframe name without the trailing digits, separators
+ * and quotes (eg: run1, run2 and "run"_3 are in the run clip) and the
+ * consecutive keyframes with the same clip name are in the same clip.
+ *
+ * @param keyframeNamesList The list of names of the keyframes.
+ * @param clipsList The list to be filled with the clips.
+ */
+void AnimationUtil::generateClips(const std::vector<std::string> &keyframeNamesList, std::vector<AnimationClip_t> &clipsList) {
+    // clears the clips list
+    clipsList.clear();
+
+    // iterates over all the keyframe names
+    for(unsigned int index = 0; index < keyframeNamesList.size(); index++) {
+        // retrieves the keyframe name
+        const std::string &keyframeName = keyframeNamesList[index];
+
+        // retrieves the clip name limits (without the trailing digits
+        // and separators and the surrounding quotes)
+        std::string::size_type clipNameStart = keyframeName.find_first_not_of("\"");
+        std::string::size_type clipNameEnd = keyframeName.find_last_not_of("0123456789_-. \"");
+
+        // retrieves the clip name
+        std::string clipName = clipNameStart == std::string::npos || clipNameEnd == std::string::npos || clipNameEnd < clipNameStart ? std::string() : keyframeName.substr(clipNameStart, clipNameEnd - clipNameStart + 1);
+
+        // in case the keyframe continues the last clip
+        if(!clipsList.empty() && clipsList.back().name == clipName) {
+            // increments the last clip count
+            clipsList.back().count++;
+
+            // continues the loop
+            continue;
+        }
+
+        // creates the clip starting in the keyframe
+        AnimationClip_t clip;
+        clip.name = clipName;
+        clip.start = index;
+        clip.count = 1;
+
+        // adds the clip to the clips list
+        clipsList.push_back(clip);
+    }
+}
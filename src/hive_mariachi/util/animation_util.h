@@ -0,0 +1,53 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../structures/keyframe.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MARIACHI_ANIMATION_SSE true
+#endif
+
+/**
+ * The maximum number of keyframes blended together
+ * (two clips interpolated between two keyframes).
+ */
+#define ANIMATION_MAXIMUM_BLEND_KEYFRAMES 4
+
+namespace mariachi {
+    namespace util {
+        class AnimationUtil {
+            private:
+
+            public:
+                static void blendKeyframes(const structures::QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, const unsigned int *vertexIndexes, unsigned int numberVertices, float *vertexList);
+                static void blendShortKeyframes(const structures::QuantizedKeyframe_t **keyframes, const float *weights, unsigned int numberKeyframes, const unsigned int *vertexIndexes, unsigned int numberVertices, float *vertexList);
+                static void blendTags(const structures::KeyframeTag_t **tags, const float *weights, unsigned int numberKeyframes, structures::KeyframeTag_t &tag);
+                static void generateClips(const std::vector<std::string> &keyframeNamesList, std::vector<structures::AnimationClip_t> &clipsList);
+        };
+    }
+}
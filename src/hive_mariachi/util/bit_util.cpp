@@ -368,7 +368,7 @@ void BitStream::seekRead(int relativePosition) {
             // calculates the size delta
             int sizeDelta = numberExtraBytes - (this->readBufferSize - this->readBufferPointer);
 
-            if(sizeDelta > 0) {
+            if(sizeDelta >= 0) {
                 // updates the stream position
                 this->stream->seekg(sizeDelta, std::fstream::cur);
 
@@ -388,7 +388,7 @@ void BitStream::seekRead(int relativePosition) {
 
             if(sizeDelta > 0) {
                 // updates the stream position
-                this->stream->seekg((sizeDelta + this->readBufferSize) * -1, std::fstream::cur);
+                this->stream->seekg((sizeDelta + (int) this->readBufferSize) * -1, std::fstream::cur);
 
                 // flushes the read
                 this->_flushRead();
@@ -74,3 +74,95 @@ bool BoxUtil::overlaps(const Box3d_t &box1, const Box3d_t &box2) {
 bool BoxUtil::containsPoint(const Box3d_t &box, const Coordinate3d_t &point) {
     return point.x >= box.x1 && point.y >= box.y1 && point.z >= box.z1 && point.x <= box.x2 && point.y <= box.y2 && point.z <= box.z2;
 }
+
+/**
+ * Determines if the specified box contains the provided (inner) box.
+ */
+bool BoxUtil::containsBox(const Box3d_t &box, const Box3d_t &innerBox) {
+    return innerBox.x1 >= box.x1 && innerBox.y1 >= box.y1 && innerBox.z1 >= box.z1 && innerBox.x2 <= box.x2 && innerBox.y2 <= box.y2 && innerBox.z2 <= box.z2;
+}
+
+/**
+ * Tests two boxes for intersection (sharing at least a point).
+ */
+bool BoxUtil::intersects(const Box3d_t &box1, const Box3d_t &box2) {
+    return box1.x1 <= box2.x2 && box1.x2 >= box2.x1 && box1.y1 <= box2.y2 && box1.y2 >= box2.y1 && box1.z1 <= box2.z2 && box1.z2 >= box2.z1;
+}
+
+/**
+ * Retrieves the squared distance from the provided point to the box
+ * (zero in case the point is inside the box).
+ */
+float BoxUtil::getSquaredDistance(const Box3d_t &box, const Coordinate3d_t &point) {
+    // computes the distance components (outside the box)
+    float distanceX = point.x < box.x1 ? box.x1 - point.x : (point.x > box.x2 ? point.x - box.x2 : 0.0f);
+    float distanceY = point.y < box.y1 ? box.y1 - point.y : (point.y > box.y2 ? point.y - box.y2 : 0.0f);
+    float distanceZ = point.z < box.z1 ? box.z1 - point.z : (point.z > box.z2 ? point.z - box.z2 : 0.0f);
+
+    // returns the squared distance
+    return distanceX * distanceX + distanceY * distanceY + distanceZ * distanceZ;
+}
+
+/**
+ * Tests the box for intersection with the provided ray (slab test),
+ * the distance is the (ray parameter) distance to the entry point.
+ *
+ * @param box The box to be tested.
+ * @param origin The origin of the ray.
+ * @param inverseDirection The inverse of the ray direction (per component).
+ * @param maximumDistance The maximum distance along the ray.
+ * @param distance The distance to the entry point (zero in case the origin is inside).
+ * @return If the ray intersects the box (within the maximum distance).
+ */
+bool BoxUtil::intersectsRay(const Box3d_t &box, const Coordinate3d_t &origin, const Coordinate3d_t &inverseDirection, float maximumDistance, float &distance) {
+    // computes the distances to the x slab planes
+    float x1 = (box.x1 - origin.x) * inverseDirection.x;
+    float x2 = (box.x2 - origin.x) * inverseDirection.x;
+
+    // computes the distances to the y slab planes
+    float y1 = (box.y1 - origin.y) * inverseDirection.y;
+    float y2 = (box.y2 - origin.y) * inverseDirection.y;
+
+    // computes the distances to the z slab planes
+    float z1 = (box.z1 - origin.z) * inverseDirection.z;
+    float z2 = (box.z2 - origin.z) * inverseDirection.z;
+
+    // in case the ray is parallel to a slab and starts in one of its
+    // planes (not a number distance) the slab does not constrain the ray
+    if(x1 != x1 || x2 != x2) { x1 = -FLT_MAX; x2 = FLT_MAX; }
+    if(y1 != y1 || y2 != y2) { y1 = -FLT_MAX; y2 = FLT_MAX; }
+    if(z1 != z1 || z2 != z2) { z1 = -FLT_MAX; z2 = FLT_MAX; }
+
+    // computes the entry distance (the largest of the near distances)
+    float entryDistance = x1 < x2 ? x1 : x2;
+    entryDistance = (y1 < y2 ? y1 : y2) > entryDistance ? (y1 < y2 ? y1 : y2) : entryDistance;
+    entryDistance = (z1 < z2 ? z1 : z2) > entryDistance ? (z1 < z2 ? z1 : z2) : entryDistance;
+
+    // computes the exit distance (the smallest of the far distances)
+    float exitDistance = x1 > x2 ? x1 : x2;
+    exitDistance = (y1 > y2 ? y1 : y2) < exitDistance ? (y1 > y2 ? y1 : y2) : exitDistance;
+    exitDistance = (z1 > z2 ? z1 : z2) < exitDistance ? (z1 > z2 ? z1 : z2) : exitDistance;
+
+    // clamps the entry distance to the origin
+    entryDistance = entryDistance > 0.0f ? entryDistance : 0.0f;
+
+    // sets the distance
+    distance = entryDistance;
+
+    // returns if the ray enters the box before leaving it
+    // (within the maximum distance)
+    return entryDistance <= exitDistance && entryDistance <= maximumDistance;
+}
+
+/**
+ * Merges the other box into the specified box, expanding
+ * the box to bound both boxes.
+ */
+void BoxUtil::mergeBox(Box3d_t &box, const Box3d_t &otherBox) {
+    box.x1 = otherBox.x1 < box.x1 ? otherBox.x1 : box.x1;
+    box.y1 = otherBox.y1 < box.y1 ? otherBox.y1 : box.y1;
+    box.z1 = otherBox.z1 < box.z1 ? otherBox.z1 : box.z1;
+    box.x2 = otherBox.x2 > box.x2 ? otherBox.x2 : box.x2;
+    box.y2 = otherBox.y2 > box.y2 ? otherBox.y2 : box.y2;
+    box.z2 = otherBox.z2 > box.z2 ? otherBox.z2 : box.z2;
+}
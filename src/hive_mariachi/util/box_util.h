@@ -38,6 +38,11 @@ namespace mariachi {
                 static structures::Box3d_t createBox(float x1, float y1, float z1, float x2, float y2, float z2);
                 static bool overlaps(const structures::Box3d_t &box1, const structures::Box3d_t &box2);
                 static bool containsPoint(const structures::Box3d_t &box, const structures::Coordinate3d_t &point);
+                static bool containsBox(const structures::Box3d_t &box, const structures::Box3d_t &innerBox);
+                static bool intersects(const structures::Box3d_t &box1, const structures::Box3d_t &box2);
+                static float getSquaredDistance(const structures::Box3d_t &box, const structures::Coordinate3d_t &point);
+                static bool intersectsRay(const structures::Box3d_t &box, const structures::Coordinate3d_t &origin, const structures::Coordinate3d_t &inverseDirection, float maximumDistance, float &distance);
+                static void mergeBox(structures::Box3d_t &box, const structures::Box3d_t &otherBox);
         };
     }
 }
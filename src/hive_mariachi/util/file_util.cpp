@@ -0,0 +1,148 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "file_util.h"
+
+using namespace mariachi::util;
+
+/**
+ * Maps the file in the given path (read only) in memory, the
+ * contents are read on demand (as the pages are accessed) and
+ * remain valid until the file is unmapped.
+ *
+ * @param filePath The path to the file to be mapped.
+ * @param mappedFile The mapped file structure to be set.
+ * @return If the file was mapped (the file exists and is not empty).
+ */
+bool FileUtil::mapFile(const std::string &filePath, MappedFile_t &mappedFile) {
+    // resets the mapped file
+    mappedFile.contents = NULL;
+    mappedFile.size = 0;
+
+#ifdef MARIACHI_PLATFORM_WIN32
+    // opens the file (for sequential reading)
+    HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    // in case the opening of the file fails
+    if(fileHandle == INVALID_HANDLE_VALUE) {
+        // returns false
+        return false;
+    }
+
+    // retrieves the size of the file
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        // closes the file and returns false
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    // creates the file mapping and maps the file
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *contents = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    // closes the mapping and the file handles (the
+    // view keeps the file mapped)
+    if(mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    CloseHandle(fileHandle);
+
+    // in case the mapping of the file fails
+    if(!contents) {
+        // returns false
+        return false;
+    }
+
+    // sets the mapped file
+    mappedFile.contents = (char *) contents;
+    mappedFile.size = (size_t) fileSize.QuadPart;
+#elif MARIACHI_PLATFORM_UNIX
+    // opens the file
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+    // in case the opening of the file fails
+    if(fileDescriptor == -1) {
+        // returns false
+        return false;
+    }
+
+    // retrieves the size of the file
+    struct stat fileStatus;
+    if(fstat(fileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0) {
+        // closes the file and returns false
+        close(fileDescriptor);
+        return false;
+    }
+
+    // maps the file (private and read only)
+    void *contents = mmap(NULL, (size_t) fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    // closes the file (the mapping keeps the file mapped)
+    close(fileDescriptor);
+
+    // in case the mapping of the file fails
+    if(contents == MAP_FAILED) {
+        // returns false
+        return false;
+    }
+
+    // sets the mapped file
+    mappedFile.contents = (char *) contents;
+    mappedFile.size = (size_t) fileStatus.st_size;
+#endif
+
+    // returns true
+    return true;
+}
+
+/**
+ * Unmaps the given (mapped) file, the contents
+ * are no longer valid.
+ *
+ * @param mappedFile The mapped file to be unmapped.
+ */
+void FileUtil::unmapFile(MappedFile_t &mappedFile) {
+    // in case the file is not mapped
+    if(!mappedFile.contents) {
+        // returns immediately
+        return;
+    }
+
+#ifdef MARIACHI_PLATFORM_WIN32
+    // unmaps the file view
+    UnmapViewOfFile(mappedFile.contents);
+#elif MARIACHI_PLATFORM_UNIX
+    // unmaps the file
+    munmap(mappedFile.contents, mappedFile.size);
+#endif
+
+    // resets the mapped file
+    mappedFile.contents = NULL;
+    mappedFile.size = 0;
+}
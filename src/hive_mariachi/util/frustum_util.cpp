@@ -0,0 +1,206 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "matrix_util.h"
+#include "frustum_util.h"
+
+#ifdef MARIACHI_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace mariachi::util;
+using namespace mariachi::structures;
+
+/**
+ * Creates the frustum (in world coordinates) for the given
+ * perspective and camera transforms, the camera transforms
+ * are applied as in the render adapters (rotation followed by
+ * the inverse translation).
+ * The planes are extracted from the combined projection and
+ * view matrix (not normalized).
+ *
+ * @param fieldOfView The vertical field of view (in degrees).
+ * @param aspectRatio The aspect ratio of the view port.
+ * @param nearDistance The distance to the near plane.
+ * @param farDistance The distance to the far plane.
+ * @param position The position of the camera.
+ * @param rotation The rotation of the camera.
+ * @return The frustum for the given perspective and camera.
+ */
+Frustum3d_t FrustumUtil::createFrustum(float fieldOfView, float aspectRatio, float nearDistance, float farDistance, const Coordinate3d_t &position, const Rotation3d_t &rotation) {
+    // creates the rotation matrix of the camera
+    float rotationMatrix[3][3];
+    MatrixUtil::createRotationMatrix(rotation, rotationMatrix);
+
+    // creates the view matrix (rotation and inverse translation)
+    float viewMatrix[4][4];
+    for(unsigned int row = 0; row < 3; row++) {
+        viewMatrix[row][0] = rotationMatrix[row][0];
+        viewMatrix[row][1] = rotationMatrix[row][1];
+        viewMatrix[row][2] = rotationMatrix[row][2];
+        viewMatrix[row][3] = -(rotationMatrix[row][0] * position.x + rotationMatrix[row][1] * position.y + rotationMatrix[row][2] * position.z);
+    }
+    viewMatrix[3][0] = 0.0f;
+    viewMatrix[3][1] = 0.0f;
+    viewMatrix[3][2] = 0.0f;
+    viewMatrix[3][3] = 1.0f;
+
+    // calculates the perspective factor
+    float factor = 1.0f / (float) tan(fieldOfView * M_PI / 360.0);
+
+    // calculates the projection depth values
+    float depthScale = (farDistance + nearDistance) / (nearDistance - farDistance);
+    float depthOffset = 2.0f * farDistance * nearDistance / (nearDistance - farDistance);
+
+    // creates the combined matrix rows (projection times view)
+    float rows[4][4];
+    for(unsigned int column = 0; column < 4; column++) {
+        rows[0][column] = factor / aspectRatio * viewMatrix[0][column];
+        rows[1][column] = factor * viewMatrix[1][column];
+        rows[2][column] = depthScale * viewMatrix[2][column] + depthOffset * viewMatrix[3][column];
+        rows[3][column] = -viewMatrix[2][column];
+    }
+
+    // allocates the frustum
+    Frustum3d_t frustum;
+
+    // extracts the planes from the combined matrix rows
+    // (left, right, bottom, top, near and far)
+    for(unsigned int index = 0; index < FRUSTUM_PLANES; index++) {
+        // retrieves the row and the sign of the plane
+        float *row = rows[index / 2];
+        float sign = index % 2 ? -1.0f : 1.0f;
+
+        // sets the plane coefficients
+        frustum.planes[index].a = rows[3][0] + sign * row[0];
+        frustum.planes[index].b = rows[3][1] + sign * row[1];
+        frustum.planes[index].c = rows[3][2] + sign * row[2];
+        frustum.planes[index].d = rows[3][3] + sign * row[3];
+    }
+
+    // returns the frustum
+    return frustum;
+}
+
+/**
+ * Tests if the given box is (at least partially) inside the frustum,
+ * the test is conservative (some boxes outside the frustum near the
+ * corners may be considered inside).
+ *
+ * @param frustum The frustum to be used in the test.
+ * @param box The box to be tested.
+ * @return If the box is (at least partially) inside the frustum.
+ */
+bool FrustumUtil::containsBox(const Frustum3d_t &frustum, const Box3d_t &box) {
+    // iterates over all the planes
+    for(unsigned int index = 0; index < FRUSTUM_PLANES; index++) {
+        // retrieves the plane
+        const Plane3d_t &plane = frustum.planes[index];
+
+        // retrieves the box corner further along the plane normal
+        float x = plane.a >= 0.0f ? box.x2 : box.x1;
+        float y = plane.b >= 0.0f ? box.y2 : box.y1;
+        float z = plane.c >= 0.0f ? box.z2 : box.z1;
+
+        // in case the corner is in the negative side of the plane
+        if(plane.a * x + plane.b * y + plane.c * z + plane.d < 0.0f) {
+            // returns false (the box is outside)
+            return false;
+        }
+    }
+
+    // returns true
+    return true;
+}
+
+/**
+ * Culls the given boxes against the frustum, the boxes are given
+ * in structure of arrays form and are tested in batches (using sse
+ * when available).
+ *
+ * @param frustum The frustum to be used in the test.
+ * @param minimumX The minimum x values of the boxes.
+ * @param minimumY The minimum y values of the boxes.
+ * @param minimumZ The minimum z values of the boxes.
+ * @param maximumX The maximum x values of the boxes.
+ * @param maximumY The maximum y values of the boxes.
+ * @param maximumZ The maximum z values of the boxes.
+ * @param numberBoxes The number of boxes to be tested.
+ * @param visibleList The list to be filled with the visible flag
+ * of each box.
+ */
+void FrustumUtil::cullBoxes(const Frustum3d_t &frustum, const float *minimumX, const float *minimumY, const float *minimumZ, const float *maximumX, const float *maximumY, const float *maximumZ, unsigned int numberBoxes, unsigned char *visibleList) {
+    // starts the box index
+    unsigned int index = 0;
+
+#ifdef MARIACHI_FRUSTUM_SSE
+    // creates the zero vector
+    __m128 zero = _mm_setzero_ps();
+
+    // iterates over all the complete batches of boxes
+    for(; index + FRUSTUM_CULL_BATCH_SIZE <= numberBoxes; index += FRUSTUM_CULL_BATCH_SIZE) {
+        // starts the outside mask
+        __m128 outside = zero;
+
+        // iterates over all the planes
+        for(unsigned int planeIndex = 0; planeIndex < FRUSTUM_PLANES; planeIndex++) {
+            // retrieves the plane
+            const Plane3d_t &plane = frustum.planes[planeIndex];
+
+            // loads the box corners further along the plane normal
+            __m128 x = _mm_loadu_ps(plane.a >= 0.0f ? &maximumX[index] : &minimumX[index]);
+            __m128 y = _mm_loadu_ps(plane.b >= 0.0f ? &maximumY[index] : &minimumY[index]);
+            __m128 z = _mm_loadu_ps(plane.c >= 0.0f ? &maximumZ[index] : &minimumZ[index]);
+
+            // calculates the distances of the corners to the plane
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.a)), _mm_mul_ps(y, _mm_set1_ps(plane.b))), _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.c)), _mm_set1_ps(plane.d)));
+
+            // accumulates the corners in the negative side of the plane
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+
+        // retrieves the outside mask bits
+        int outsideMask = _mm_movemask_ps(outside);
+
+        // sets the visible flags of the boxes
+        visibleList[index] = !(outsideMask & 0x1);
+        visibleList[index + 1] = !(outsideMask & 0x2);
+        visibleList[index + 2] = !(outsideMask & 0x4);
+        visibleList[index + 3] = !(outsideMask & 0x8);
+    }
+#endif
+
+    // iterates over all the remaining boxes
+    for(; index < numberBoxes; index++) {
+        // creates the box
+        Box3d_t box = { minimumX[index], minimumY[index], minimumZ[index], maximumX[index], maximumY[index], maximumZ[index] };
+
+        // sets the visible flag of the box
+        visibleList[index] = FrustumUtil::containsBox(frustum, box);
+    }
+}
@@ -0,0 +1,55 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../structures/box.h"
+#include "../structures/frustum.h"
+#include "../structures/position.h"
+#include "../structures/rotation.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MARIACHI_FRUSTUM_SSE true
+#endif
+
+/**
+ * The number of boxes tested in each iteration
+ * of the culling kernel.
+ */
+#define FRUSTUM_CULL_BATCH_SIZE 4
+
+namespace mariachi {
+    namespace util {
+        class FrustumUtil {
+            private:
+
+            public:
+                static structures::Frustum3d_t createFrustum(float fieldOfView, float aspectRatio, float nearDistance, float farDistance, const structures::Coordinate3d_t &position, const structures::Rotation3d_t &rotation);
+                static bool containsBox(const structures::Frustum3d_t &frustum, const structures::Box3d_t &box);
+                static void cullBoxes(const structures::Frustum3d_t &frustum, const float *minimumX, const float *minimumY, const float *minimumZ, const float *maximumX, const float *maximumY, const float *maximumZ, unsigned int numberBoxes, unsigned char *visibleList);
+        };
+    }
+}
@@ -0,0 +1,279 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "matrix_util.h"
+
+using namespace mariachi::util;
+using namespace mariachi::structures;
+
+const Matrix4d_t MatrixUtil::IDENTITY_MATRIX = { {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+} };
+
+/**
+ * Creates the 3x3 rotation matrix (row major) for the given
+ * rotation (angle in degrees around an axis), as in gl rotate.
+ *
+ * @param rotation The rotation to create the matrix.
+ * @param matrix The matrix to be filled with the rotation.
+ */
+void MatrixUtil::createRotationMatrix(const Rotation3d_t &rotation, float matrix[3][3]) {
+    // calculates the length of the rotation axis
+    float length = (float) sqrt(rotation.x * rotation.x + rotation.y * rotation.y + rotation.z * rotation.z);
+
+    // in case the rotation axis is not valid or there is no rotation
+    if(length == 0.0f || rotation.angle == 0.0f) {
+        // sets the identity matrix
+        for(unsigned int row = 0; row < 3; row++) {
+            matrix[row][0] = row == 0 ? 1.0f : 0.0f;
+            matrix[row][1] = row == 1 ? 1.0f : 0.0f;
+            matrix[row][2] = row == 2 ? 1.0f : 0.0f;
+        }
+
+        // returns immediately
+        return;
+    }
+
+    // normalizes the rotation axis
+    float x = rotation.x / length;
+    float y = rotation.y / length;
+    float z = rotation.z / length;
+
+    // calculates the sine and cosine of the angle (in degrees)
+    float sine = (float) sin(rotation.angle * M_PI / 180.0);
+    float cosine = (float) cos(rotation.angle * M_PI / 180.0);
+    float inverseCosine = 1.0f - cosine;
+
+    // sets the rotation matrix (as in gl rotate)
+    matrix[0][0] = x * x * inverseCosine + cosine;
+    matrix[0][1] = x * y * inverseCosine - z * sine;
+    matrix[0][2] = x * z * inverseCosine + y * sine;
+    matrix[1][0] = y * x * inverseCosine + z * sine;
+    matrix[1][1] = y * y * inverseCosine + cosine;
+    matrix[1][2] = y * z * inverseCosine - x * sine;
+    matrix[2][0] = z * x * inverseCosine - y * sine;
+    matrix[2][1] = z * y * inverseCosine + x * sine;
+    matrix[2][2] = z * z * inverseCosine + cosine;
+}
+
+/**
+ * Creates the rotation (angle in degrees around an axis) for the
+ * given 3x3 rotation matrix (row major), the inverse of the rotation
+ * matrix creation.
+ * The rotation is computed through the (normalized) quaternion of
+ * the matrix, so nearly orthonormal matrices are also valid.
+ *
+ * @param matrix The rotation matrix to create the rotation.
+ * @return The created rotation.
+ * @see EuclideanSpace - http://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToQuaternion/index.htm
+ */
+Rotation3d_t MatrixUtil::createRotation(const float matrix[3][3]) {
+    // allocates the quaternion values
+    float w, x, y, z;
+
+    // calculates the trace of the matrix
+    float trace = matrix[0][0] + matrix[1][1] + matrix[2][2];
+
+    // in case the trace is positive
+    if(trace > 0.0f) {
+        float s = (float) sqrt(trace + 1.0f) * 2.0f;
+        w = 0.25f * s;
+        x = (matrix[2][1] - matrix[1][2]) / s;
+        y = (matrix[0][2] - matrix[2][0]) / s;
+        z = (matrix[1][0] - matrix[0][1]) / s;
+    }
+    // in case the first diagonal value is the largest
+    else if(matrix[0][0] > matrix[1][1] && matrix[0][0] > matrix[2][2]) {
+        float s = (float) sqrt(1.0f + matrix[0][0] - matrix[1][1] - matrix[2][2]) * 2.0f;
+        w = (matrix[2][1] - matrix[1][2]) / s;
+        x = 0.25f * s;
+        y = (matrix[0][1] + matrix[1][0]) / s;
+        z = (matrix[0][2] + matrix[2][0]) / s;
+    }
+    // in case the second diagonal value is the largest
+    else if(matrix[1][1] > matrix[2][2]) {
+        float s = (float) sqrt(1.0f + matrix[1][1] - matrix[0][0] - matrix[2][2]) * 2.0f;
+        w = (matrix[0][2] - matrix[2][0]) / s;
+        x = (matrix[0][1] + matrix[1][0]) / s;
+        y = 0.25f * s;
+        z = (matrix[1][2] + matrix[2][1]) / s;
+    }
+    // in case the third diagonal value is the largest
+    else {
+        float s = (float) sqrt(1.0f + matrix[2][2] - matrix[0][0] - matrix[1][1]) * 2.0f;
+        w = (matrix[1][0] - matrix[0][1]) / s;
+        x = (matrix[0][2] + matrix[2][0]) / s;
+        y = (matrix[1][2] + matrix[2][1]) / s;
+        z = 0.25f * s;
+    }
+
+    // calculates the length of the quaternion and the
+    // length of the rotation vector
+    float length = (float) sqrt(w * w + x * x + y * y + z * z);
+    float vectorLength = (float) sqrt(x * x + y * y + z * z);
+
+    // in case there is no rotation (invalid matrix
+    // or identity)
+    if(length == 0.0f || vectorLength == 0.0f) {
+        // returns the empty rotation
+        Rotation3d_t rotation = { 0.0f, 1.0f, 0.0f, 0.0f };
+        return rotation;
+    }
+
+    // calculates the angle of the rotation (clamping the
+    // normalized w value)
+    float normalizedW = w / length;
+    normalizedW = normalizedW > 1.0f ? 1.0f : normalizedW < -1.0f ? -1.0f : normalizedW;
+    float angle = (float) (2.0 * acos(normalizedW) * 180.0 / M_PI);
+
+    // creates the rotation with the normalized axis
+    Rotation3d_t rotation = { angle, x / vectorLength, y / vectorLength, z / vectorLength };
+
+    // returns the rotation
+    return rotation;
+}
+
+/**
+ * Creates the transform matrix for the given position, rotation
+ * and scale, the transform is equivalent to a translate followed
+ * by a scale and a rotate in opengl.
+ *
+ * @param position The position (translation) of the transform.
+ * @param rotation The rotation of the transform.
+ * @param scale The scale of the transform.
+ * @return The created transform matrix.
+ */
+Matrix4d_t MatrixUtil::createTransform(const Coordinate3d_t &position, const Rotation3d_t &rotation, const Coordinate3d_t &scale) {
+    // creates the rotation matrix
+    float rotationMatrix[3][3];
+    MatrixUtil::createRotationMatrix(rotation, rotationMatrix);
+
+    // retrieves the scale values
+    float scaleValues[3] = { scale.x, scale.y, scale.z };
+
+    // allocates the transform matrix
+    Matrix4d_t transform;
+
+    // iterates over all the columns of the rotation
+    for(unsigned int column = 0; column < 3; column++) {
+        // sets the scaled rotation column
+        transform.values[column * 4] = scaleValues[0] * rotationMatrix[0][column];
+        transform.values[column * 4 + 1] = scaleValues[1] * rotationMatrix[1][column];
+        transform.values[column * 4 + 2] = scaleValues[2] * rotationMatrix[2][column];
+        transform.values[column * 4 + 3] = 0.0f;
+    }
+
+    // sets the translation column
+    transform.values[12] = position.x;
+    transform.values[13] = position.y;
+    transform.values[14] = position.z;
+    transform.values[15] = 1.0f;
+
+    // returns the transform matrix
+    return transform;
+}
+
+/**
+ * Multiplies the given matrices (matrix1 * matrix2), the
+ * resulting transform applies the second matrix first.
+ *
+ * @param matrix1 The first (left) matrix.
+ * @param matrix2 The second (right) matrix.
+ * @return The result of the multiplication.
+ */
+Matrix4d_t MatrixUtil::multiply(const Matrix4d_t &matrix1, const Matrix4d_t &matrix2) {
+    // allocates the result matrix
+    Matrix4d_t result;
+
+    // iterates over all the columns and rows
+    for(unsigned int column = 0; column < 4; column++) {
+        for(unsigned int row = 0; row < 4; row++) {
+            // calculates the value for the column and row
+            result.values[column * 4 + row] = matrix1.values[row] * matrix2.values[column * 4]
+                + matrix1.values[4 + row] * matrix2.values[column * 4 + 1]
+                + matrix1.values[8 + row] * matrix2.values[column * 4 + 2]
+                + matrix1.values[12 + row] * matrix2.values[column * 4 + 3];
+        }
+    }
+
+    // returns the result matrix
+    return result;
+}
+
+/**
+ * Retrieves the translation (position) of the given
+ * transform matrix.
+ *
+ * @param matrix The transform matrix.
+ * @return The translation of the transform matrix.
+ */
+Coordinate3d_t MatrixUtil::getTranslation(const Matrix4d_t &matrix) {
+    // creates the translation
+    Coordinate3d_t translation = { matrix.values[12], matrix.values[13], matrix.values[14] };
+
+    // returns the translation
+    return translation;
+}
+
+/**
+ * Transforms the given (axis aligned) box by the transform matrix,
+ * the resulting box is the axis aligned box that contains the
+ * transformed box.
+ *
+ * @param box The box to be transformed.
+ * @param matrix The transform matrix (affine).
+ * @return The axis aligned box that contains the transformed box.
+ */
+Box3d_t MatrixUtil::transformBox(const Box3d_t &box, const Matrix4d_t &matrix) {
+    // calculates the center and the extents of the box
+    float center[3] = { (box.x1 + box.x2) / 2.0f, (box.y1 + box.y2) / 2.0f, (box.z1 + box.z2) / 2.0f };
+    float extents[3] = { (box.x2 - box.x1) / 2.0f, (box.y2 - box.y1) / 2.0f, (box.z2 - box.z1) / 2.0f };
+
+    // allocates the transformed center and extents
+    float transformedCenter[3];
+    float transformedExtents[3];
+
+    // iterates over all the axis
+    for(unsigned int row = 0; row < 3; row++) {
+        // transforms the center and the extents (using the absolute matrix)
+        transformedCenter[row] = matrix.values[row] * center[0] + matrix.values[4 + row] * center[1] + matrix.values[8 + row] * center[2] + matrix.values[12 + row];
+        transformedExtents[row] = (float) (fabs(matrix.values[row]) * extents[0] + fabs(matrix.values[4 + row]) * extents[1] + fabs(matrix.values[8 + row]) * extents[2]);
+    }
+
+    // creates the transformed box
+    Box3d_t transformedBox = {
+        transformedCenter[0] - transformedExtents[0], transformedCenter[1] - transformedExtents[1], transformedCenter[2] - transformedExtents[2],
+        transformedCenter[0] + transformedExtents[0], transformedCenter[1] + transformedExtents[1], transformedCenter[2] + transformedExtents[2]
+    };
+
+    // returns the transformed box
+    return transformedBox;
+}
@@ -0,0 +1,50 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../structures/box.h"
+#include "../structures/matrix.h"
+#include "../structures/position.h"
+#include "../structures/rotation.h"
+
+namespace mariachi {
+    namespace util {
+        class MatrixUtil {
+            private:
+
+            public:
+                static const structures::Matrix4d_t IDENTITY_MATRIX;
+
+                static void createRotationMatrix(const structures::Rotation3d_t &rotation, float matrix[3][3]);
+                static structures::Rotation3d_t createRotation(const float matrix[3][3]);
+                static structures::Matrix4d_t createTransform(const structures::Coordinate3d_t &position, const structures::Rotation3d_t &rotation, const structures::Coordinate3d_t &scale);
+                static structures::Matrix4d_t multiply(const structures::Matrix4d_t &matrix1, const structures::Matrix4d_t &matrix2);
+                static structures::Coordinate3d_t getTranslation(const structures::Matrix4d_t &matrix);
+                static structures::Box3d_t transformBox(const structures::Box3d_t &box, const structures::Matrix4d_t &matrix);
+        };
+    }
+}
@@ -0,0 +1,705 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#include "stdafx.h"
+
+#include "mesh_util.h"
+
+using namespace mariachi::util;
+using namespace mariachi::structures;
+
+ATOMIC_VALUE MeshUtil::meshGeneration = 0;
+
+/**
+ * Creates a new (unique) mesh generation, to be set in a
+ * mesh when it is created (the generation zero is never
+ * created).
+ *
+ * @return The new mesh generation.
+ */
+unsigned long MeshUtil::createGeneration() {
+    return (unsigned long) ATOMIC_INCREMENT(MeshUtil::meshGeneration);
+}
+
+/**
+ * Generates the (triangle list) indexes for the given range of
+ * vertices of a triangle list, strip or fan, the winding of the
+ * strip triangles is kept (alternating the vertex order).
+ *
+ * @param type The type of primitive of the vertices.
+ * @param numberVertices The number of vertices in the range.
+ * @param vertexOffset The index of the first vertex of the range.
+ * @param indexesList The list to be appended with the indexes
+ * (three per triangle).
+ */
+void MeshUtil::generateTriangles(MeshType_t type, unsigned int numberVertices, unsigned int vertexOffset, std::vector<unsigned int> &indexesList) {
+    // switches over the primitive type
+    switch(type) {
+        case TRIANGLE_STRIP:
+            // iterates over all the strip triangles
+            for(unsigned int index = 2; index < numberVertices; index++) {
+                // adds the triangle (swapping the first two vertices
+                // of the odd triangles to keep the winding)
+                indexesList.push_back(vertexOffset + (index % 2 ? index - 1 : index - 2));
+                indexesList.push_back(vertexOffset + (index % 2 ? index - 2 : index - 1));
+                indexesList.push_back(vertexOffset + index);
+            }
+
+            break;
+        case TRIANGLE_FAN:
+            // iterates over all the fan triangles
+            for(unsigned int index = 2; index < numberVertices; index++) {
+                // adds the triangle (around the first vertex)
+                indexesList.push_back(vertexOffset);
+                indexesList.push_back(vertexOffset + index - 1);
+                indexesList.push_back(vertexOffset + index);
+            }
+
+            break;
+        default:
+            // iterates over all the (complete) triangles
+            for(unsigned int index = 0; index + 2 < numberVertices; index += 3) {
+                // adds the triangle
+                indexesList.push_back(vertexOffset + index);
+                indexesList.push_back(vertexOffset + index + 1);
+                indexesList.push_back(vertexOffset + index + 2);
+            }
+
+            break;
+    }
+}
+
+/**
+ * Welds the (bitwise) equal vertices, creating the map of each
+ * of the vertices to the welded vertex, the welded vertices are
+ * numbered in the order of their first occurrence.
+ *
+ * @param vertexList The list of vertices (attributes of each vertex).
+ * @param vertexSize The number of values (attributes) of each vertex.
+ * @param numberVertices The number of vertices.
+ * @param remapList The list to be filled with the welded vertex
+ * of each of the vertices.
+ * @return The number of welded (unique) vertices.
+ */
+unsigned int MeshUtil::weldVertices(const float *vertexList, unsigned int vertexSize, unsigned int numberVertices, unsigned int *remapList) {
+    // creates the list of vertices sorted by value (the equal
+    // vertices are adjacent)
+    std::vector<unsigned int> sortedList(numberVertices);
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        sortedList[index] = index;
+    }
+    std::sort(sortedList.begin(), sortedList.end(), MeshVertexCompare(vertexList, vertexSize));
+
+    // allocates the list of the first occurrence of each vertex
+    std::vector<unsigned int> firstList(numberVertices);
+
+    // iterates over all the sorted vertices (in groups of equal vertices)
+    for(unsigned int index = 0; index < numberVertices;) {
+        // starts the group with the vertex (as the first occurrence)
+        unsigned int groupEnd = index + 1;
+        unsigned int first = sortedList[index];
+
+        // iterates while the next vertex is equal to the group vertex
+        while(groupEnd < numberVertices && !memcmp(&vertexList[sortedList[index] * vertexSize], &vertexList[sortedList[groupEnd] * vertexSize], vertexSize * sizeof(float))) {
+            // updates the first occurrence of the group
+            first = sortedList[groupEnd] < first ? sortedList[groupEnd] : first;
+            groupEnd++;
+        }
+
+        // sets the first occurrence for all the group vertices
+        for(; index < groupEnd; index++) {
+            firstList[sortedList[index]] = first;
+        }
+    }
+
+    // starts the number of welded vertices
+    unsigned int numberWeldedVertices = 0;
+
+    // iterates over all the vertices (in order)
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        // sets the welded vertex (a new one for the first occurrence,
+        // otherwise the one of the first occurrence)
+        remapList[index] = firstList[index] == index ? numberWeldedVertices++ : remapList[firstList[index]];
+    }
+
+    // returns the number of welded vertices
+    return numberWeldedVertices;
+}
+
+/**
+ * Reorders the triangles to improve the hit rate of the (post
+ * transform) vertex cache, using the linear speed vertex cache
+ * optimization (the vertices are scored by their position in a
+ * modeled lru cache and by their remaining triangles and the best
+ * scored triangle is added in each step).
+ *
+ * @param indexList The triangle indexes to be reordered (in place).
+ * @param numberIndexes The number of indexes (three per triangle).
+ * @param numberVertices The number of vertices referenced by the indexes.
+ * @see Tom Forsyth - http://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ */
+void MeshUtil::optimizeVertexCache(unsigned int *indexList, unsigned int numberIndexes, unsigned int numberVertices) {
+    // calculates the number of triangles
+    unsigned int numberTriangles = numberIndexes / 3;
+
+    // in case there are no triangles
+    if(!numberTriangles) {
+        // returns immediately
+        return;
+    }
+
+    // counts the triangles of each of the vertices
+    std::vector<unsigned int> remainingList(numberVertices, 0);
+    for(unsigned int index = 0; index < numberTriangles * 3; index++) {
+        remainingList[indexList[index]]++;
+    }
+
+    // calculates the offset of the triangles of each of the vertices
+    std::vector<unsigned int> offsetsList(numberVertices + 1, 0);
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        offsetsList[index + 1] = offsetsList[index] + remainingList[index];
+    }
+
+    // creates the (adjacency) list of triangles of each of the vertices
+    std::vector<unsigned int> adjacencyList(numberTriangles * 3);
+    std::vector<unsigned int> fillList(offsetsList.begin(), offsetsList.end() - 1);
+    for(unsigned int index = 0; index < numberTriangles * 3; index++) {
+        adjacencyList[fillList[indexList[index]]++] = index / 3;
+    }
+
+    // calculates the initial scores of the vertices (not in the cache)
+    std::vector<int> cachePositionsList(numberVertices, -1);
+    std::vector<float> vertexScoresList(numberVertices);
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        vertexScoresList[index] = MeshUtil::getVertexScore(-1, remainingList[index]);
+    }
+
+    // calculates the initial scores of the triangles (retrieving
+    // the best scored triangle)
+    std::vector<float> triangleScoresList(numberTriangles);
+    std::vector<unsigned char> addedList(numberTriangles, 0);
+    int bestTriangle = 0;
+    for(unsigned int index = 0; index < numberTriangles; index++) {
+        triangleScoresList[index] = vertexScoresList[indexList[index * 3]] + vertexScoresList[indexList[index * 3 + 1]] + vertexScoresList[indexList[index * 3 + 2]];
+        bestTriangle = triangleScoresList[index] > triangleScoresList[bestTriangle] ? index : bestTriangle;
+    }
+
+    // allocates the reordered indexes list
+    std::vector<unsigned int> reorderedList(numberTriangles * 3);
+
+    // allocates the cache (with space for the vertices of
+    // a new triangle) and the next cache
+    unsigned int cache[MESH_UTIL_CACHE_SIZE + 3];
+    unsigned int nextCache[MESH_UTIL_CACHE_SIZE + 3];
+    unsigned int cacheSize = 0;
+
+    // starts the position of the scan for not added triangles
+    unsigned int scanPosition = 0;
+
+    // iterates over all the triangles to be added
+    for(unsigned int triangleIndex = 0; triangleIndex < numberTriangles; triangleIndex++) {
+        // in case there is no best triangle (no triangles
+        // in the cache vertices)
+        if(bestTriangle < 0) {
+            // scans for the next not added triangle
+            while(addedList[scanPosition]) {
+                scanPosition++;
+            }
+
+            // sets the triangle as the best one
+            bestTriangle = scanPosition;
+        }
+
+        // retrieves the vertices of the best triangle
+        unsigned int *triangle = &indexList[bestTriangle * 3];
+
+        // adds the triangle to the reordered indexes list
+        addedList[bestTriangle] = 1;
+        reorderedList[triangleIndex * 3] = triangle[0];
+        reorderedList[triangleIndex * 3 + 1] = triangle[1];
+        reorderedList[triangleIndex * 3 + 2] = triangle[2];
+
+        // starts the next cache size
+        unsigned int nextCacheSize = 0;
+
+        // iterates over all the triangle vertices
+        for(unsigned int index = 0; index < 3; index++) {
+            // retrieves the vertex
+            unsigned int vertex = triangle[index];
+
+            // in case the vertex is repeated (degenerate triangle)
+            if(std::find(nextCache, nextCache + nextCacheSize, vertex) != nextCache + nextCacheSize) {
+                // continues the loop
+                continue;
+            }
+
+            // retrieves the vertex triangles (the remaining ones)
+            unsigned int *triangles = &adjacencyList[offsetsList[vertex]];
+            unsigned int &remaining = remainingList[vertex];
+
+            // removes the triangle from the remaining vertex triangles
+            // (swapping it with the last remaining triangle)
+            unsigned int *position = std::find(triangles, triangles + remaining, (unsigned int) bestTriangle);
+            *position = triangles[remaining - 1];
+            triangles[remaining - 1] = bestTriangle;
+            remaining--;
+
+            // adds the vertex to the front of the next cache
+            nextCache[nextCacheSize++] = vertex;
+        }
+
+        // retrieves the number of (distinct) triangle vertices
+        unsigned int triangleSize = nextCacheSize;
+
+        // iterates over all the cache vertices
+        for(unsigned int index = 0; index < cacheSize; index++) {
+            // in case the vertex is not in the triangle
+            if(std::find(nextCache, nextCache + triangleSize, cache[index]) == nextCache + triangleSize) {
+                // adds the vertex to the next cache (moving it back)
+                nextCache[nextCacheSize++] = cache[index];
+            }
+        }
+
+        // unsets the best triangle
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+
+        // iterates over all the next cache vertices (including the
+        // ones removed from the cache)
+        for(unsigned int index = 0; index < nextCacheSize; index++) {
+            // retrieves the vertex
+            unsigned int vertex = nextCache[index];
+
+            // updates the vertex cache position (removing it from the
+            // cache in case it's beyond the cache size) and score
+            cachePositionsList[vertex] = index < MESH_UTIL_CACHE_SIZE ? index : -1;
+            vertexScoresList[vertex] = MeshUtil::getVertexScore(cachePositionsList[vertex], remainingList[vertex]);
+        }
+
+        // iterates over all the next cache vertices
+        for(unsigned int index = 0; index < nextCacheSize; index++) {
+            // retrieves the vertex and its remaining triangles
+            unsigned int vertex = nextCache[index];
+            unsigned int *triangles = &adjacencyList[offsetsList[vertex]];
+
+            // iterates over all the remaining triangles of the vertex
+            for(unsigned int adjacencyIndex = 0; adjacencyIndex < remainingList[vertex]; adjacencyIndex++) {
+                // retrieves the triangle
+                unsigned int adjacentTriangle = triangles[adjacencyIndex];
+
+                // in case the triangle is already added (repeated
+                // vertex of a degenerate triangle)
+                if(addedList[adjacentTriangle]) {
+                    // continues the loop
+                    continue;
+                }
+
+                // retrieves the triangle vertices
+                unsigned int *adjacentVertices = &indexList[adjacentTriangle * 3];
+
+                // updates the triangle score
+                float score = vertexScoresList[adjacentVertices[0]] + vertexScoresList[adjacentVertices[1]] + vertexScoresList[adjacentVertices[2]];
+                triangleScoresList[adjacentTriangle] = score;
+
+                // in case the triangle is the best one
+                if(score > bestScore) {
+                    // sets the triangle as the best one
+                    bestTriangle = adjacentTriangle;
+                    bestScore = score;
+                }
+            }
+        }
+
+        // sets the next cache as the cache (removing the vertices
+        // beyond the cache size)
+        cacheSize = nextCacheSize < MESH_UTIL_CACHE_SIZE ? nextCacheSize : MESH_UTIL_CACHE_SIZE;
+        memcpy(cache, nextCache, cacheSize * sizeof(unsigned int));
+    }
+
+    // copies the reordered indexes into the index list
+    memcpy(indexList, &reorderedList[0], numberTriangles * 3 * sizeof(unsigned int));
+}
+
+/**
+ * Reorders the vertices in the order of their first use by the
+ * indexes (improving the locality of the vertex fetches), the
+ * indexes are renumbered and the not referenced vertices are
+ * moved to the end.
+ *
+ * @param indexList The indexes to be renumbered (in place).
+ * @param numberIndexes The number of indexes.
+ * @param numberVertices The number of vertices.
+ * @param remapList The list to be filled with the new position
+ * of each of the vertices.
+ * @return The number of vertices referenced by the indexes.
+ */
+unsigned int MeshUtil::optimizeVertexFetch(unsigned int *indexList, unsigned int numberIndexes, unsigned int numberVertices, unsigned int *remapList) {
+    // invalidates the new position of all the vertices
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        remapList[index] = MESH_UTIL_INVALID_INDEX;
+    }
+
+    // starts the number of referenced vertices
+    unsigned int numberReferencedVertices = 0;
+
+    // iterates over all the indexes
+    for(unsigned int index = 0; index < numberIndexes; index++) {
+        // retrieves the new position of the vertex
+        unsigned int &position = remapList[indexList[index]];
+
+        // in case the vertex is not yet positioned
+        if(position == MESH_UTIL_INVALID_INDEX) {
+            // sets the vertex in the next position
+            position = numberReferencedVertices++;
+        }
+
+        // renumbers the index
+        indexList[index] = position;
+    }
+
+    // sets the not referenced vertices at the end
+    unsigned int position = numberReferencedVertices;
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        if(remapList[index] == MESH_UTIL_INVALID_INDEX) {
+            remapList[index] = position++;
+        }
+    }
+
+    // returns the number of referenced vertices
+    return numberReferencedVertices;
+}
+
+/**
+ * Copies the vertices into their new position, in case
+ * more than one vertex is remapped to the same position
+ * the last of them is kept (they are equal when welded).
+ *
+ * @param vertexList The list of vertices (attributes of each vertex).
+ * @param vertexSize The number of values (attributes) of each vertex.
+ * @param numberVertices The number of vertices.
+ * @param remapList The new position of each of the vertices.
+ * @param remappedVertexList The list to be filled with the vertices.
+ */
+void MeshUtil::remapVertices(const float *vertexList, unsigned int vertexSize, unsigned int numberVertices, const unsigned int *remapList, float *remappedVertexList) {
+    // iterates over all the vertices
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        // copies the vertex into the new position
+        memcpy(&remappedVertexList[remapList[index] * vertexSize], &vertexList[index * vertexSize], vertexSize * sizeof(float));
+    }
+}
+
+/**
+ * Indexes the given (triangle list) mesh, welding the equal vertices,
+ * removing the degenerate triangles and optimizing the order of the
+ * triangles (vertex cache) and of the vertices (vertex fetch).
+ *
+ * @param vertexList The list of vertices (attributes of each vertex),
+ * replaced by the list of unique vertices.
+ * @param vertexSize The number of values (attributes) of each vertex.
+ * @param indexesList The triangle indexes of the vertices, replaced
+ * by the indexes of the unique vertices.
+ */
+void MeshUtil::indexMesh(std::vector<float> &vertexList, unsigned int vertexSize, std::vector<unsigned int> &indexesList) {
+    // retrieves the number of vertices
+    unsigned int numberVertices = vertexList.size() / vertexSize;
+
+    // in case there are no vertices
+    if(!numberVertices) {
+        // clears the indexes and returns immediately
+        indexesList.clear();
+        return;
+    }
+
+    // welds the equal vertices
+    std::vector<unsigned int> remapList(numberVertices);
+    unsigned int numberWeldedVertices = MeshUtil::weldVertices(&vertexList[0], vertexSize, numberVertices, &remapList[0]);
+
+    // starts the number of (not degenerate) indexes
+    unsigned int numberIndexes = 0;
+
+    // iterates over all the triangles
+    for(unsigned int index = 0; index + 2 < indexesList.size(); index += 3) {
+        // retrieves the welded vertices of the triangle
+        unsigned int first = remapList[indexesList[index]];
+        unsigned int second = remapList[indexesList[index + 1]];
+        unsigned int third = remapList[indexesList[index + 2]];
+
+        // in case the triangle is degenerate
+        if(first == second || second == third || first == third) {
+            // continues the loop
+            continue;
+        }
+
+        // sets the welded triangle
+        indexesList[numberIndexes++] = first;
+        indexesList[numberIndexes++] = second;
+        indexesList[numberIndexes++] = third;
+    }
+
+    // removes the degenerate triangles
+    indexesList.resize(numberIndexes);
+
+    // creates the list of welded vertices
+    std::vector<float> weldedVertexList(numberWeldedVertices * vertexSize);
+    MeshUtil::remapVertices(&vertexList[0], vertexSize, numberVertices, &remapList[0], &weldedVertexList[0]);
+
+    // in case there are triangles
+    if(numberIndexes) {
+        // optimizes the order of the triangles and of the vertices
+        MeshUtil::optimizeVertexCache(&indexesList[0], numberIndexes, numberWeldedVertices);
+        numberVertices = MeshUtil::optimizeVertexFetch(&indexesList[0], numberIndexes, numberWeldedVertices, &remapList[0]);
+    } else {
+        // sets the number of vertices (none referenced)
+        numberVertices = 0;
+    }
+
+    // sets the (referenced) vertices in their new position
+    vertexList.resize(numberWeldedVertices * vertexSize);
+    if(numberWeldedVertices) {
+        MeshUtil::remapVertices(&weldedVertexList[0], vertexSize, numberWeldedVertices, &remapList[0], &vertexList[0]);
+    }
+
+    // removes the not referenced vertices
+    vertexList.resize(numberVertices * vertexSize);
+}
+
+/**
+ * Retrieves the (smallest) type of indexes able to reference
+ * the given number of vertices.
+ *
+ * @param numberVertices The number of vertices.
+ * @return The type of indexes.
+ */
+MeshIndexType_t MeshUtil::getIndexType(unsigned int numberVertices) {
+    return numberVertices <= MESH_UTIL_MAXIMUM_SHORT_VERTICES ? SHORT_INDEX : INT_INDEX;
+}
+
+/**
+ * Retrieves the size (in bytes) of an index of the given type.
+ *
+ * @param indexType The type of index.
+ * @return The size of an index.
+ */
+unsigned int MeshUtil::getIndexSize(MeshIndexType_t indexType) {
+    return indexType == SHORT_INDEX ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+/**
+ * Sets the indexes in the target list, converting them
+ * to the given type of indexes.
+ *
+ * @param indexList The indexes to be set.
+ * @param numberIndexes The number of indexes.
+ * @param indexType The type of the indexes of the target list.
+ * @param targetIndexList The target list of indexes.
+ */
+void MeshUtil::setIndexes(const unsigned int *indexList, unsigned int numberIndexes, MeshIndexType_t indexType, void *targetIndexList) {
+    // in case the indexes are 32 bit
+    if(indexType == INT_INDEX) {
+        // copies the indexes and returns immediately
+        memcpy(targetIndexList, indexList, numberIndexes * sizeof(unsigned int));
+        return;
+    }
+
+    // retrieves the target list (16 bit)
+    unsigned short *shortIndexList = (unsigned short *) targetIndexList;
+
+    // iterates over all the indexes
+    for(unsigned int index = 0; index < numberIndexes; index++) {
+        // converts the index
+        shortIndexList[index] = (unsigned short) indexList[index];
+    }
+}
+
+/**
+ * Creates an indexed (triangle list) mesh from the given meshes,
+ * the created mesh is allocated in a single block (with the vertices
+ * and the indexes) and must be released with free.
+ *
+ * @param meshList The list of (not indexed) meshes, the positions
+ * of the meshes are ignored.
+ * @return The created indexed mesh.
+ */
+Mesh_t *MeshUtil::createIndexedMesh(std::vector<Mesh_t *> &meshList) {
+    // allocates the vertices (coordinates and texture coordinates)
+    // and the indexes lists
+    std::vector<float> vertexList;
+    std::vector<unsigned int> indexesList;
+
+    // iterates over all the meshes
+    for(unsigned int index = 0; index < meshList.size(); index++) {
+        // retrieves the mesh
+        Mesh_t *mesh = meshList[index];
+
+        // generates the triangles of the mesh vertices
+        MeshUtil::generateTriangles(mesh->type, mesh->numberVertices, vertexList.size() / 5, indexesList);
+
+        // iterates over all the mesh vertices
+        for(unsigned int vertexIndex = 0; vertexIndex < mesh->numberVertices; vertexIndex++) {
+            // adds the vertex coordinates and texture coordinates
+            vertexList.insert(vertexList.end(), &mesh->vertexList[vertexIndex * 3], &mesh->vertexList[vertexIndex * 3 + 3]);
+            vertexList.push_back(mesh->textureVertexList ? mesh->textureVertexList[vertexIndex * 2] : 0.0f);
+            vertexList.push_back(mesh->textureVertexList ? mesh->textureVertexList[vertexIndex * 2 + 1] : 0.0f);
+        }
+    }
+
+    // indexes the vertices
+    MeshUtil::indexMesh(vertexList, 5, indexesList);
+
+    // retrieves the number of vertices and indexes and the index type
+    unsigned int numberVertices = vertexList.size() / 5;
+    unsigned int numberIndexes = indexesList.size();
+    MeshIndexType_t indexType = MeshUtil::getIndexType(numberVertices);
+
+    // allocates the mesh with the vertices and the indexes
+    Mesh_t *mesh = (Mesh_t *) malloc(sizeof(Mesh_t) + numberVertices * 5 * sizeof(float) + numberIndexes * MeshUtil::getIndexSize(indexType));
+
+    // sets the mesh attributes
+    mesh->type = TRIANGLE;
+    mesh->position.x = 0.0f;
+    mesh->position.y = 0.0f;
+    mesh->position.z = 0.0f;
+    mesh->numberVertices = numberVertices;
+    mesh->vertexList = (float *) (mesh + 1);
+    mesh->textureVertexList = mesh->vertexList + numberVertices * 3;
+    mesh->dynamic = false;
+    mesh->numberIndexes = numberIndexes;
+    mesh->indexType = indexType;
+    mesh->indexList = mesh->textureVertexList + numberVertices * 2;
+    mesh->generation = MeshUtil::createGeneration();
+
+    // iterates over all the vertices
+    for(unsigned int index = 0; index < numberVertices; index++) {
+        // sets the vertex coordinates and texture coordinates
+        memcpy(&mesh->vertexList[index * 3], &vertexList[index * 5], 3 * sizeof(float));
+        memcpy(&mesh->textureVertexList[index * 2], &vertexList[index * 5 + 3], 2 * sizeof(float));
+    }
+
+    // sets the indexes
+    if(numberIndexes) {
+        MeshUtil::setIndexes(&indexesList[0], numberIndexes, indexType, mesh->indexList);
+    }
+
+    // returns the mesh
+    return mesh;
+}
+
+/**
+ * Calculates the average cache miss ratio (number of transformed
+ * vertices per triangle) of the given indexes, simulating a fifo
+ * (post transform) vertex cache.
+ *
+ * @param indexList The triangle indexes.
+ * @param numberIndexes The number of indexes.
+ * @param cacheSize The size of the simulated vertex cache.
+ * @return The average cache miss ratio.
+ */
+float MeshUtil::getCacheMissRatio(const unsigned int *indexList, unsigned int numberIndexes, unsigned int cacheSize) {
+    // in case there are no triangles
+    if(numberIndexes < 3) {
+        // returns zero
+        return 0.0f;
+    }
+
+    // allocates the (fifo) cache, as a ring of vertices
+    std::vector<unsigned int> cache(cacheSize, MESH_UTIL_INVALID_INDEX);
+    unsigned int cachePosition = 0;
+
+    // starts the number of misses
+    unsigned int numberMisses = 0;
+
+    // iterates over all the indexes
+    for(unsigned int index = 0; index < numberIndexes; index++) {
+        // in case the vertex is in the cache
+        if(std::find(cache.begin(), cache.end(), indexList[index]) != cache.end()) {
+            // continues the loop
+            continue;
+        }
+
+        // adds the vertex to the cache (replacing the oldest one)
+        cache[cachePosition] = indexList[index];
+        cachePosition = (cachePosition + 1) % cacheSize;
+
+        // increments the number of misses
+        numberMisses++;
+    }
+
+    // returns the average cache miss ratio
+    return (float) numberMisses / (float) (numberIndexes / 3);
+}
+
+inline float MeshUtil::getVertexScore(int cachePosition, unsigned int remainingTriangles) {
+    // in case the vertex has no remaining triangles
+    if(!remainingTriangles) {
+        // returns the minimum score
+        return -1.0f;
+    }
+
+    // starts the score
+    float score = 0.0f;
+
+    // in case the vertex is in the cache
+    if(cachePosition >= 0) {
+        // in case the vertex is from the last triangle
+        if(cachePosition < 3) {
+            // sets the last triangle score (fixed so that
+            // the triangles are not biased by their order)
+            score = MESH_UTIL_LAST_TRIANGLE_SCORE;
+        } else {
+            // sets the score decaying with the cache position
+            score = powf(1.0f - (float) (cachePosition - 3) / (float) (MESH_UTIL_CACHE_SIZE - 3), MESH_UTIL_CACHE_DECAY_POWER);
+        }
+    }
+
+    // boosts the score of the vertices with few remaining
+    // triangles (removing the lone vertices)
+    score += MESH_UTIL_VALENCE_BOOST_SCALE * powf((float) remainingTriangles, -MESH_UTIL_VALENCE_BOOST_POWER);
+
+    // returns the score
+    return score;
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param vertexList The list of vertices (attributes of each vertex).
+ * @param vertexSize The number of values (attributes) of each vertex.
+ */
+MeshVertexCompare::MeshVertexCompare(const float *vertexList, unsigned int vertexSize) {
+    this->vertexList = vertexList;
+    this->vertexSize = vertexSize;
+}
+
+/**
+ * Compares the vertices (bitwise), used to sort the vertices.
+ *
+ * @param firstIndex The index of the first vertex.
+ * @param secondIndex The index of the second vertex.
+ * @return If the first vertex is less than the second one.
+ */
+bool MeshVertexCompare::operator()(unsigned int firstIndex, unsigned int secondIndex) const {
+    return memcmp(&this->vertexList[firstIndex * this->vertexSize], &this->vertexList[secondIndex * this->vertexSize], this->vertexSize * sizeof(float)) < 0;
+}
@@ -0,0 +1,107 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+
+#pragma once
+
+#include "../system/thread.h"
+#include "../structures/mesh.h"
+
+/**
+ * The size of the (lru) vertex cache used to score
+ * the vertices in the vertex cache optimization.
+ */
+#define MESH_UTIL_CACHE_SIZE 32
+
+/**
+ * The decay power of the score of the vertices
+ * in the vertex cache (by position).
+ */
+#define MESH_UTIL_CACHE_DECAY_POWER 1.5f
+
+/**
+ * The score of the vertices of the last triangle
+ * (the first three positions of the vertex cache).
+ */
+#define MESH_UTIL_LAST_TRIANGLE_SCORE 0.75f
+
+/**
+ * The scale of the score boost of the vertices with
+ * few remaining triangles.
+ */
+#define MESH_UTIL_VALENCE_BOOST_SCALE 2.0f
+
+/**
+ * The power of the score boost of the vertices with
+ * few remaining triangles.
+ */
+#define MESH_UTIL_VALENCE_BOOST_POWER 0.5f
+
+/**
+ * The maximum number of vertices that may be
+ * referenced with 16 bit indexes.
+ */
+#define MESH_UTIL_MAXIMUM_SHORT_VERTICES 65536
+
+/**
+ * The value used to represent an invalid
+ * (not yet set) index.
+ */
+#define MESH_UTIL_INVALID_INDEX 0xffffffff
+
+namespace mariachi {
+    namespace util {
+        class MeshUtil {
+            private:
+                static ATOMIC_VALUE meshGeneration;
+
+                static inline float getVertexScore(int cachePosition, unsigned int remainingTriangles);
+
+            public:
+                static unsigned long createGeneration();
+                static void generateTriangles(structures::MeshType_t type, unsigned int numberVertices, unsigned int vertexOffset, std::vector<unsigned int> &indexesList);
+                static unsigned int weldVertices(const float *vertexList, unsigned int vertexSize, unsigned int numberVertices, unsigned int *remapList);
+                static void optimizeVertexCache(unsigned int *indexList, unsigned int numberIndexes, unsigned int numberVertices);
+                static unsigned int optimizeVertexFetch(unsigned int *indexList, unsigned int numberIndexes, unsigned int numberVertices, unsigned int *remapList);
+                static void remapVertices(const float *vertexList, unsigned int vertexSize, unsigned int numberVertices, const unsigned int *remapList, float *remappedVertexList);
+                static void indexMesh(std::vector<float> &vertexList, unsigned int vertexSize, std::vector<unsigned int> &indexesList);
+                static structures::MeshIndexType_t getIndexType(unsigned int numberVertices);
+                static unsigned int getIndexSize(structures::MeshIndexType_t indexType);
+                static void setIndexes(const unsigned int *indexList, unsigned int numberIndexes, structures::MeshIndexType_t indexType, void *targetIndexList);
+                static structures::Mesh_t *createIndexedMesh(std::vector<structures::Mesh_t *> &meshList);
+                static float getCacheMissRatio(const unsigned int *indexList, unsigned int numberIndexes, unsigned int cacheSize);
+        };
+
+        class MeshVertexCompare {
+            private:
+                const float *vertexList;
+                unsigned int vertexSize;
+
+            public:
+                MeshVertexCompare(const float *vertexList, unsigned int vertexSize);
+                bool operator()(unsigned int firstIndex, unsigned int secondIndex) const;
+        };
+    }
+}
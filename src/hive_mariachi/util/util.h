@@ -25,10 +25,15 @@
 
 #pragma once
 
+#include "animation_util.h"
 #include "bit_util.h"
 #include "box_util.h"
 #include "byte_util.h"
 #include "cpu_util.h"
+#include "file_util.h"
+#include "frustum_util.h"
 #include "geometry_util.h"
+#include "matrix_util.h"
+#include "mesh_util.h"
 #include "string_util.h"
 #include "vector_util.h"
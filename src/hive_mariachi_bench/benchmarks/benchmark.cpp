@@ -0,0 +1,621 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#include "../../hive_mariachi/mariachi.h"
+
+#include "benchmark.h"
+
+using namespace mariachi;
+using namespace mariachi::bench;
+using namespace mariachi::debugging;
+using namespace mariachi::algorithms;
+using namespace mariachi::nodes;
+using namespace mariachi::exceptions;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+Benchmark::Benchmark() {
+    this->initOptions();
+}
+
+/**
+ * Destructor of the class.
+ */
+Benchmark::~Benchmark() {
+}
+
+inline void Benchmark::initOptions() {
+    this->options.nodes = DEFAULT_BENCHMARK_NODES;
+    this->options.actors = DEFAULT_BENCHMARK_ACTORS;
+    this->options.bodies = DEFAULT_BENCHMARK_BODIES;
+    this->options.frames = DEFAULT_BENCHMARK_FRAMES;
+    this->options.transformStore = DEFAULT_BENCHMARK_TRANSFORM_STORE;
+    this->options.outputPath = DEFAULT_BENCHMARK_OUTPUT;
+}
+
+/**
+ * Parses the command line arguments into the benchmark options,
+ * the options are --nodes, --actors, --bodies, --frames, --transform-store
+ * and --output.
+ *
+ * @param argc The number of arguments.
+ * @param argv The value of the arguments.
+ */
+void Benchmark::parseArguments(int argc, char **argv) {
+    // iterates over all the arguments (option and value pairs)
+    for(int index = 1; index + 1 < argc; index += 2) {
+        // retrieves the option and the value
+        std::string option = argv[index];
+        char *value = argv[index + 1];
+
+        // sets the option with the value
+        if(option == "--nodes") {
+            this->options.nodes = atoi(value);
+        } else if(option == "--actors") {
+            this->options.actors = atoi(value);
+        } else if(option == "--bodies") {
+            this->options.bodies = atoi(value);
+        } else if(option == "--frames") {
+            this->options.frames = atoi(value);
+        } else if(option == "--transform-store") {
+            this->options.transformStore = atoi(value) != 0;
+        } else if(option == "--output") {
+            this->options.outputPath = value;
+        } else {
+            // throws a runtime exception
+            throw RuntimeException("Invalid benchmark option: " + option);
+        }
+    }
+}
+
+/**
+ * Runs all the micro benchmarks, the random generator is
+ * reset before each benchmark (repeatable runs).
+ */
+void Benchmark::run() {
+    // runs the oct tree benchmark
+    srand(BENCHMARK_SEED);
+    this->runOctTree();
+
+    // runs the hashing benchmark
+    srand(BENCHMARK_SEED);
+    this->runHashing();
+
+    // runs the compression benchmark
+    srand(BENCHMARK_SEED);
+    this->runCompression();
+
+    // runs the json benchmark
+    srand(BENCHMARK_SEED);
+    this->runJson();
+
+    // runs the path finding benchmark
+    srand(BENCHMARK_SEED);
+    this->runPathFinding();
+
+    // runs the transform store benchmark
+    srand(BENCHMARK_SEED);
+    this->runTransformStore();
+}
+
+/**
+ * Writes the micro benchmark results to the output file,
+ * one json object per line (truncating the file).
+ */
+void Benchmark::writeResults() {
+    // opens the output file
+    std::fstream outputFile(this->options.outputPath.c_str(), std::fstream::out | std::fstream::trunc);
+
+    // in case the opening of the file fails
+    if(outputFile.fail()) {
+        // throws a runtime exception
+        throw RuntimeException("Problem while opening file: " + this->options.outputPath);
+    }
+
+    // iterates over all the results
+    for(unsigned int index = 0; index < this->resultsList.size(); index++) {
+        // retrieves the result
+        BenchmarkResult_t &result = this->resultsList[index];
+
+        // writes the result line
+        outputFile << std::fixed << "{\"name\":\"" << result.name << "\",\"iterations\":" << result.iterations;
+        outputFile << ",\"total_ms\":" << result.time * 1000.0 << ",\"average_us\":" << result.time * 1000000.0 / result.iterations << "}" << std::endl;
+    }
+
+    // closes the output file
+    outputFile.close();
+}
+
+/**
+ * Writes the engine run results (frame rate and the profiler
+ * statistics) to the output file, appending to the micro
+ * benchmark results.
+ *
+ * @param profiler The profiler with the engine timers.
+ * @param frames The number of frames run.
+ * @param time The time taken by the frames (in seconds).
+ */
+void Benchmark::writeProfilerResults(Profiler *profiler, unsigned int frames, double time) {
+    // opens the output file
+    std::fstream outputFile(this->options.outputPath.c_str(), std::fstream::out | std::fstream::app);
+
+    // in case the opening of the file fails
+    if(outputFile.fail()) {
+        // throws a runtime exception
+        throw RuntimeException("Problem while opening file: " + this->options.outputPath);
+    }
+
+    // writes the engine frames line
+    outputFile << std::fixed << "{\"name\":\"engine/frames\",\"frames\":" << frames << ",\"nodes\":" << this->options.nodes;
+    outputFile << ",\"actors\":" << this->options.actors << ",\"bodies\":" << this->options.bodies << ",\"transform_store\":" << this->options.transformStore;
+    outputFile << ",\"total_ms\":" << time * 1000.0 << ",\"frames_per_second\":" << frames / time << "}" << std::endl;
+
+    // in case the profiler is available
+    if(profiler) {
+        // retrieves the statistics map
+        std::map<std::string, ProfilerStatistics_t> statisticsMap;
+        profiler->getStatisticsMap(statisticsMap);
+
+        // retrieves the statistics map iterator
+        std::map<std::string, ProfilerStatistics_t>::iterator statisticsMapIterator = statisticsMap.begin();
+
+        // iterates over all the statistics
+        while(statisticsMapIterator != statisticsMap.end()) {
+            // retrieves the statistics
+            ProfilerStatistics_t &statistics = statisticsMapIterator->second;
+
+            // writes the statistics line (in milliseconds)
+            outputFile << "{\"name\":\"" << statisticsMapIterator->first << "\",\"count\":" << statistics.count;
+            outputFile << ",\"minimum_ms\":" << statistics.minimum << ",\"average_ms\":" << statistics.average;
+            outputFile << ",\"p99_ms\":" << statistics.percentile99 << ",\"maximum_ms\":" << statistics.maximum << "}" << std::endl;
+
+            // increments the statistics map iterator
+            statisticsMapIterator++;
+        }
+    }
+
+    // closes the output file
+    outputFile.close();
+}
+
+/**
+ * Retrieves the benchmark options.
+ *
+ * @return The benchmark options.
+ */
+BenchmarkOptions_t &Benchmark::getOptions() {
+    return this->options;
+}
+
+/**
+ * Retrieves the micro benchmark results list.
+ *
+ * @return The micro benchmark results list.
+ */
+std::vector<BenchmarkResult_t> &Benchmark::getResultsList() {
+    return this->resultsList;
+}
+
+inline double Benchmark::getTime() {
+    // allocates the time
+    double time;
+
+    // retrieves the monotonic time
+    MONOTONIC_CLOCK(time);
+
+    // returns the time
+    return time;
+}
+
+inline void Benchmark::addResult(const std::string &name, unsigned int iterations, double startTime, double endTime) {
+    // creates the result
+    BenchmarkResult_t result = { name, iterations, endTime - startTime };
+
+    // adds the result to the results list
+    this->resultsList.push_back(result);
+
+    // prints the result
+    std::cout << std::left << std::setw(32) << name << std::right << std::setw(10) << iterations << std::fixed << std::setprecision(3) << std::setw(12) << result.time * 1000.0 << " ms" << std::endl;
+}
+
+inline void Benchmark::generateData(unsigned char *buffer, unsigned int size) {
+    // iterates over all the buffer bytes
+    for(unsigned int index = 0; index < size; index++) {
+        // sets a skewed random byte (compressible data)
+        buffer[index] = (unsigned char) ('a' + (rand() % 16) * (rand() % 16) / 16);
+    }
+}
+
+void Benchmark::runOctTree() {
+    // creates the oct tree
+    OctTree octTree(1024.0f, 1024.0f, 1024.0f);
+
+    // allocates the element boxes
+    Box3d_t *elementBoxes = new Box3d_t[BENCHMARK_OCT_TREE_ELEMENTS];
+
+    // iterates over all the elements
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_ELEMENTS; index++) {
+        // sets a random element box
+        Box3d_t &elementBox = elementBoxes[index];
+        elementBox.x1 = (float) (rand() % 900) + 50.0f;
+        elementBox.y1 = (float) (rand() % 900) + 50.0f;
+        elementBox.z1 = (float) (rand() % 900) + 50.0f;
+        elementBox.x2 = elementBox.x1 + (float) (rand() % 8) + 1.0f;
+        elementBox.y2 = elementBox.y1 + (float) (rand() % 8) + 1.0f;
+        elementBox.z2 = elementBox.z1 + (float) (rand() % 8) + 1.0f;
+    }
+
+    // inserts all the elements
+    double startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_ELEMENTS; index++) {
+        octTree.insertElementBox((void *) &elementBoxes[index], &elementBoxes[index]);
+    }
+    this->addResult("oct_tree/insert", BENCHMARK_OCT_TREE_ELEMENTS, startTime, this->getTime());
+
+    // runs the box queries
+    unsigned int elementsCount = 0;
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Box3d_t queryBox;
+        queryBox.x1 = (float) (rand() % 900) + 50.0f;
+        queryBox.y1 = (float) (rand() % 900) + 50.0f;
+        queryBox.z1 = (float) (rand() % 900) + 50.0f;
+        queryBox.x2 = queryBox.x1 + 64.0f;
+        queryBox.y2 = queryBox.y1 + 64.0f;
+        queryBox.z2 = queryBox.z1 + 64.0f;
+        elementsCount += octTree.getBoxElements(&queryBox).size();
+    }
+    this->addResult("oct_tree/query", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // allocates the (reused) query buffers
+    std::vector<void *> elements;
+    std::vector<OctTreeHit_t> hits;
+
+    // runs the sphere queries
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Coordinate3d_t center = { (float) (rand() % 1024), (float) (rand() % 1024), (float) (rand() % 1024) };
+        elements.clear();
+        octTree.getSphereElements(center, 32.0f, elements);
+        elementsCount += elements.size();
+    }
+    this->addResult("oct_tree/sphere", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // runs the ray queries (picking)
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Coordinate3d_t origin = { (float) (rand() % 1024), (float) (rand() % 1024), 0.0f };
+        Coordinate3d_t direction = { 0.0f, 0.0f, 1.0f };
+        hits.clear();
+        octTree.getRayElements(origin, direction, 1024.0f, hits);
+        elementsCount += hits.size();
+    }
+    this->addResult("oct_tree/ray", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // runs the nearest elements queries
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Coordinate3d_t point = { (float) (rand() % 1024), (float) (rand() % 1024), (float) (rand() % 1024) };
+        hits.clear();
+        octTree.getNearestElements(point, 8, 1024.0f, hits);
+        elementsCount += hits.size();
+    }
+    this->addResult("oct_tree/nearest", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // creates the element pointers (for the bulk build)
+    std::vector<void *> elementPointers(BENCHMARK_OCT_TREE_ELEMENTS);
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_ELEMENTS; index++) {
+        elementPointers[index] = (void *) &elementBoxes[index];
+    }
+
+    // builds the linear oct tree (static elements)
+    LinearOctTree linearOctTree;
+    startTime = this->getTime();
+    linearOctTree.build(&elementPointers[0], elementBoxes, BENCHMARK_OCT_TREE_ELEMENTS);
+    this->addResult("oct_tree/linear_build", BENCHMARK_OCT_TREE_ELEMENTS, startTime, this->getTime());
+
+    // runs the box queries over the linear oct tree
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Box3d_t queryBox;
+        queryBox.x1 = (float) (rand() % 900) + 50.0f;
+        queryBox.y1 = (float) (rand() % 900) + 50.0f;
+        queryBox.z1 = (float) (rand() % 900) + 50.0f;
+        queryBox.x2 = queryBox.x1 + 64.0f;
+        queryBox.y2 = queryBox.y1 + 64.0f;
+        queryBox.z2 = queryBox.z1 + 64.0f;
+        elements.clear();
+        linearOctTree.getBoxElements(&queryBox, elements);
+        elementsCount += elements.size();
+    }
+    this->addResult("oct_tree/linear_query", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // starts a job scheduler (for the parallel build and batches)
+    tasks::JobScheduler jobScheduler;
+    jobScheduler.start(NULL);
+
+    // builds the linear oct tree in parallel
+    startTime = this->getTime();
+    linearOctTree.build(&elementPointers[0], elementBoxes, BENCHMARK_OCT_TREE_ELEMENTS, &jobScheduler);
+    this->addResult("oct_tree/linear_build_parallel", BENCHMARK_OCT_TREE_ELEMENTS, startTime, this->getTime());
+
+    // creates the query boxes of the batch
+    std::vector<Box3d_t> queryBoxes(BENCHMARK_OCT_TREE_QUERIES);
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_QUERIES; index++) {
+        Box3d_t &queryBox = queryBoxes[index];
+        queryBox.x1 = (float) (rand() % 900) + 50.0f;
+        queryBox.y1 = (float) (rand() % 900) + 50.0f;
+        queryBox.z1 = (float) (rand() % 900) + 50.0f;
+        queryBox.x2 = queryBox.x1 + 64.0f;
+        queryBox.y2 = queryBox.y1 + 64.0f;
+        queryBox.z2 = queryBox.z1 + 64.0f;
+    }
+
+    // runs the box queries as a (parallel) batch
+    LinearOctTreeBatch_t batch;
+    startTime = this->getTime();
+    linearOctTree.getBoxElementsBatch(&queryBoxes[0], BENCHMARK_OCT_TREE_QUERIES, batch, &jobScheduler);
+    this->addResult("oct_tree/linear_batch", BENCHMARK_OCT_TREE_QUERIES, startTime, this->getTime());
+
+    // stops the job scheduler
+    jobScheduler.stop(NULL);
+
+    // moves all the elements (as dynamic objects in a frame)
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_ELEMENTS; index++) {
+        Box3d_t &elementBox = elementBoxes[index];
+        float offset = (index & 1) ? 0.5f : -0.5f;
+        elementBox.x1 += offset;
+        elementBox.x2 += offset;
+        octTree.updateElementBox((void *) &elementBox, &elementBox);
+    }
+    octTree.rebalance();
+    this->addResult("oct_tree/update", BENCHMARK_OCT_TREE_ELEMENTS, startTime, this->getTime());
+
+    // removes all the elements
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_OCT_TREE_ELEMENTS; index++) {
+        octTree.removeElement((void *) &elementBoxes[index]);
+    }
+    octTree.rebalance();
+    this->addResult("oct_tree/remove", BENCHMARK_OCT_TREE_ELEMENTS, startTime, this->getTime());
+
+    // deletes the element boxes
+    delete[] elementBoxes;
+}
+
+void Benchmark::runHashing() {
+    // allocates and generates the data buffer
+    unsigned char *buffer = new unsigned char[BENCHMARK_DATA_SIZE];
+    this->generateData(buffer, BENCHMARK_DATA_SIZE);
+
+    // runs the md5 passes
+    double startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_HASHING_PASSES; index++) {
+        Md5 md5;
+        md5.update(buffer, BENCHMARK_DATA_SIZE);
+        md5.finalize();
+    }
+    this->addResult("hashing/md5", BENCHMARK_HASHING_PASSES, startTime, this->getTime());
+
+    // runs the crc32 passes
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_HASHING_PASSES; index++) {
+        Crc32 crc32;
+        crc32.update(buffer, BENCHMARK_DATA_SIZE);
+        crc32.finalize();
+    }
+    this->addResult("hashing/crc32", BENCHMARK_HASHING_PASSES, startTime, this->getTime());
+
+    // deletes the data buffer
+    delete[] buffer;
+}
+
+void Benchmark::runCompression() {
+    // creates the temporary file paths
+    std::string dataPath = this->options.outputPath + ".data";
+    std::string encodedPath = this->options.outputPath + ".encoded";
+    std::string decodedPath = this->options.outputPath + ".decoded";
+
+    // allocates and generates the data buffer
+    unsigned char *buffer = new unsigned char[BENCHMARK_DATA_SIZE];
+    this->generateData(buffer, BENCHMARK_DATA_SIZE);
+
+    // writes the data file
+    std::fstream dataFile(dataPath.c_str(), std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    dataFile.write((char *) buffer, BENCHMARK_DATA_SIZE);
+    dataFile.close();
+
+    // deletes the data buffer
+    delete[] buffer;
+
+    // runs the encode passes
+    double startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_COMPRESSION_PASSES; index++) {
+        Huffman huffman;
+        huffman.encode(dataPath, encodedPath);
+    }
+    this->addResult("compression/huffman_encode", BENCHMARK_COMPRESSION_PASSES, startTime, this->getTime());
+
+    // runs the decode passes
+    startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_COMPRESSION_PASSES; index++) {
+        Huffman huffman;
+        huffman.decode(encodedPath, decodedPath);
+    }
+    this->addResult("compression/huffman_decode", BENCHMARK_COMPRESSION_PASSES, startTime, this->getTime());
+
+    // removes the temporary files
+    remove(dataPath.c_str());
+    remove(encodedPath.c_str());
+    remove(decodedPath.c_str());
+}
+
+void Benchmark::runJson() {
+    // creates the document stream
+    std::stringstream documentStream;
+
+    // writes the document elements
+    documentStream << "[";
+    for(unsigned int index = 0; index < BENCHMARK_JSON_ELEMENTS; index++) {
+        documentStream << (index ? "," : "") << "{\"name\":\"node_" << index << "\",\"position\":[" << rand() % 100 << "," << rand() % 100 << "," << rand() % 100 << "],\"visible\":true}";
+    }
+    documentStream << "]";
+
+    // retrieves the document
+    std::string document = documentStream.str();
+
+    // runs the parse passes
+    double startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_JSON_PASSES; index++) {
+        Json::Reader reader;
+        Json::Value root;
+        reader.parse(document, root, false);
+    }
+    this->addResult("serialization/json_parse", BENCHMARK_JSON_PASSES, startTime, this->getTime());
+}
+
+void Benchmark::runPathFinding() {
+    // creates the nodes graph (grid)
+    PathNodesGraph nodesGraph;
+
+    // iterates over all the grid cells
+    for(unsigned int y = 0; y < BENCHMARK_GRID_SIZE; y++) {
+        for(unsigned int x = 0; x < BENCHMARK_GRID_SIZE; x++) {
+            // creates the path node
+            PathNode_t *pathNode = new PathNode_t();
+            pathNode->value = NULL;
+            pathNode->neighboursMap = new std::map<unsigned int, float>();
+
+            // adds the horizontal and vertical neighbours (random costs)
+            if(x > 0) { (*pathNode->neighboursMap)[y * BENCHMARK_GRID_SIZE + x - 1] = 1.0f + (float) (rand() % 4); }
+            if(x < BENCHMARK_GRID_SIZE - 1) { (*pathNode->neighboursMap)[y * BENCHMARK_GRID_SIZE + x + 1] = 1.0f + (float) (rand() % 4); }
+            if(y > 0) { (*pathNode->neighboursMap)[(y - 1) * BENCHMARK_GRID_SIZE + x] = 1.0f + (float) (rand() % 4); }
+            if(y < BENCHMARK_GRID_SIZE - 1) { (*pathNode->neighboursMap)[(y + 1) * BENCHMARK_GRID_SIZE + x] = 1.0f + (float) (rand() % 4); }
+
+            // sets the path node in the nodes graph
+            nodesGraph[y * BENCHMARK_GRID_SIZE + x] = pathNode;
+        }
+    }
+
+    // creates the a star path finder
+    AStar aStar(&nodesGraph);
+
+    // runs the path finding passes (corner to corner)
+    double startTime = this->getTime();
+    for(unsigned int index = 0; index < BENCHMARK_PATH_FINDING_PASSES; index++) {
+        Path_t *path = aStar.findPath(0, BENCHMARK_GRID_SIZE * BENCHMARK_GRID_SIZE - 1);
+
+        // in case the path was found
+        if(path) {
+            // releases the path
+            free(path->pathNodes);
+            free(path);
+        }
+    }
+    this->addResult("path_finding/a_star", BENCHMARK_PATH_FINDING_PASSES, startTime, this->getTime());
+
+    // retrieves the nodes graph iterator
+    PathNodesGraph::iterator nodesGraphIterator = nodesGraph.begin();
+
+    // iterates over all the path nodes
+    while(nodesGraphIterator != nodesGraph.end()) {
+        // deletes the path node
+        delete nodesGraphIterator->second->neighboursMap;
+        delete nodesGraphIterator->second;
+
+        // increments the nodes graph iterator
+        nodesGraphIterator++;
+    }
+}
+
+/**
+ * Writes the positions of the nodes directly in the transform
+ * store (by handle, as the physics write back) and updates the
+ * transforms, checking that the world transforms of the nodes
+ * follow the written positions.
+ */
+void Benchmark::runTransformStore() {
+    // creates the transform store and the scene (root) node
+    TransformStore transformStore(BENCHMARK_TRANSFORM_STORE_NODES);
+    SceneNode sceneNode;
+
+    // allocates the nodes list
+    std::vector<CubeNode *> nodesList;
+
+    // iterates over all the nodes
+    for(unsigned int index = 0; index < BENCHMARK_TRANSFORM_STORE_NODES; index++) {
+        // creates the node (in the transform store)
+        CubeNode *node = new CubeNode();
+        node->setTransformStore(&transformStore);
+
+        // adds the node to the scene and to the nodes list
+        sceneNode.addChild(node);
+        nodesList.push_back(node);
+    }
+
+    // updates the (initial) transforms
+    transformStore.updateTransforms();
+    sceneNode.updateTransforms();
+
+    // runs the write back passes
+    double startTime = this->getTime();
+    for(unsigned int pass = 0; pass < BENCHMARK_TRANSFORM_STORE_PASSES; pass++) {
+        for(unsigned int index = 0; index < BENCHMARK_TRANSFORM_STORE_NODES; index++) {
+            Coordinate3d_t position = { (float) index, (float) pass, 0.0f };
+            transformStore.setPosition(nodesList[index]->getTransformHandle(), position);
+        }
+        transformStore.updateTransforms();
+        sceneNode.updateTransforms();
+    }
+    this->addResult("transform_store/write_back", BENCHMARK_TRANSFORM_STORE_NODES * BENCHMARK_TRANSFORM_STORE_PASSES, startTime, this->getTime());
+
+    // allocates the invalid nodes count
+    unsigned int invalidCount = 0;
+
+    // iterates over all the nodes
+    for(unsigned int index = 0; index < BENCHMARK_TRANSFORM_STORE_NODES; index++) {
+        // retrieves the (world) transform of the node
+        Matrix4d_t &transform = nodesList[index]->getTransform();
+
+        // in case the translation is not the last written position
+        if(transform.values[12] != (float) index || transform.values[13] != (float) (BENCHMARK_TRANSFORM_STORE_PASSES - 1)) {
+            // increments the invalid nodes count
+            invalidCount++;
+        }
+
+        // removes the node from the scene and deletes it
+        sceneNode.removeChild(nodesList[index]);
+        delete nodesList[index];
+    }
+
+    // in case there are invalid nodes
+    if(invalidCount) {
+        // throws a runtime exception
+        throw RuntimeException("Transform store positions not propagated to the world transforms");
+    }
+}
@@ -0,0 +1,167 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+/**
+ * The seed used in the random generator, fixed
+ * so that the runs are repeatable.
+ */
+#define BENCHMARK_SEED 1234
+
+/**
+ * The default number of synthetic nodes
+ * added to the scene.
+ */
+#define DEFAULT_BENCHMARK_NODES 1024
+
+/**
+ * The default number of animated (md2) actors
+ * added to the scene.
+ */
+#define DEFAULT_BENCHMARK_ACTORS 16
+
+/**
+ * The default number of physical bodies
+ * added to the physics world.
+ */
+#define DEFAULT_BENCHMARK_BODIES 256
+
+/**
+ * If the transforms of the synthetic nodes are kept
+ * in a transform store (by default).
+ */
+#define DEFAULT_BENCHMARK_TRANSFORM_STORE false
+
+/**
+ * The default number of engine frames to
+ * be run.
+ */
+#define DEFAULT_BENCHMARK_FRAMES 600
+
+/**
+ * The default path to the results file
+ * (json lines).
+ */
+#define DEFAULT_BENCHMARK_OUTPUT "bench_results.json"
+
+/**
+ * The size of the data buffer used in the
+ * hashing and compression benchmarks.
+ */
+#define BENCHMARK_DATA_SIZE 1048576
+
+/**
+ * The number of passes over the data buffer
+ * in the hashing benchmarks.
+ */
+#define BENCHMARK_HASHING_PASSES 16
+
+/**
+ * The number of encode and decode passes in
+ * the compression benchmarks.
+ */
+#define BENCHMARK_COMPRESSION_PASSES 4
+
+/**
+ * The number of elements in the json document
+ * and the number of parse passes.
+ */
+#define BENCHMARK_JSON_ELEMENTS 1024
+#define BENCHMARK_JSON_PASSES 64
+
+/**
+ * The number of elements inserted in the oct tree
+ * and the number of box queries.
+ */
+#define BENCHMARK_OCT_TREE_ELEMENTS 16384
+#define BENCHMARK_OCT_TREE_QUERIES 4096
+
+/**
+ * The size of the side of the path finding grid
+ * and the number of path finding passes.
+ */
+#define BENCHMARK_GRID_SIZE 48
+#define BENCHMARK_PATH_FINDING_PASSES 16
+
+/**
+ * The number of nodes in the transform store and the
+ * number of write back passes (the world transforms are
+ * checked after the passes).
+ */
+#define BENCHMARK_TRANSFORM_STORE_NODES 4096
+#define BENCHMARK_TRANSFORM_STORE_PASSES 64
+
+namespace mariachi {
+    namespace bench {
+        typedef struct BenchmarkOptions_t {
+            unsigned int nodes;
+            unsigned int actors;
+            unsigned int bodies;
+            unsigned int frames;
+            bool transformStore;
+            std::string outputPath;
+        } BenchmarkOptions;
+
+        typedef struct BenchmarkResult_t {
+            std::string name;
+            unsigned int iterations;
+            double time;
+        } BenchmarkResult;
+
+        /**
+         * Headless benchmark for the engine core, runs a set of
+         * micro benchmarks over the engine algorithms and structures
+         * and writes the results (and the profiler statistics of the
+         * engine run) as json lines.
+         */
+        class Benchmark {
+            private:
+                BenchmarkOptions_t options;
+                std::vector<BenchmarkResult_t> resultsList;
+
+                inline void initOptions();
+                inline double getTime();
+                inline void addResult(const std::string &name, unsigned int iterations, double startTime, double endTime);
+                inline void generateData(unsigned char *buffer, unsigned int size);
+                void runOctTree();
+                void runHashing();
+                void runCompression();
+                void runJson();
+                void runPathFinding();
+                void runTransformStore();
+
+            public:
+                Benchmark();
+                ~Benchmark();
+                void parseArguments(int argc, char **argv);
+                void run();
+                void writeResults();
+                void writeProfilerResults(debugging::Profiler *profiler, unsigned int frames, double time);
+                BenchmarkOptions_t &getOptions();
+                std::vector<BenchmarkResult_t> &getResultsList();
+        };
+    }
+}
@@ -0,0 +1,296 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#include "../../hive_mariachi/mariachi.h"
+
+#include "bench_stage.h"
+
+using namespace mariachi;
+using namespace mariachi::bench;
+using namespace mariachi::nodes;
+using namespace mariachi::stages;
+using namespace mariachi::physics;
+using namespace mariachi::importers;
+using namespace mariachi::structures;
+
+/**
+ * Constructor of the class.
+ */
+BenchStage::BenchStage() : Stage() {
+    this->initResources();
+    this->initBenchmark(NULL);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The engine to be used in the stage.
+ */
+BenchStage::BenchStage(Engine *engine) : Stage(engine) {
+    this->initResources();
+    this->initBenchmark(NULL);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The engine to be used in the stage.
+ * @param name The name of the stage.
+ */
+BenchStage::BenchStage(Engine *engine, const std::string &name) : Stage(engine, name) {
+    this->initResources();
+    this->initBenchmark(NULL);
+}
+
+/**
+ * Constructor of the class.
+ *
+ * @param engine The engine to be used in the stage.
+ * @param name The name of the stage.
+ * @param benchmark The benchmark with the options and the results.
+ */
+BenchStage::BenchStage(Engine *engine, const std::string &name, Benchmark *benchmark) : Stage(engine, name) {
+    this->initResources();
+    this->initBenchmark(benchmark);
+}
+
+/**
+ * Destructor of the class.
+ */
+BenchStage::~BenchStage() {
+}
+
+inline void BenchStage::initResources() {
+    this->addWrite(SCENE_GRAPH_RESOURCE);
+    this->addWrite(PHYSICS_STATE_RESOURCE);
+}
+
+inline void BenchStage::initBenchmark(Benchmark *benchmark) {
+    this->benchmark = benchmark;
+    this->frameCount = 0;
+    this->startTime = 0.0;
+    this->finished = false;
+}
+
+void BenchStage::start(void *arguments) {
+    Stage::start(arguments);
+
+    // resets the random generator (repeatable scene)
+    srand(BENCHMARK_SEED);
+
+    // retrieves the render
+    SceneNode *render = this->engine->getRender();
+
+    // creates the synthetic nodes, the actors and the bodies
+    this->createNodes(render);
+    this->createActors(render);
+    this->createBodies(render);
+
+    // prints an info message
+    this->info("Bench stage started successfully");
+}
+
+void BenchStage::stop(void *arguments) {
+    Stage::stop(arguments);
+}
+
+void BenchStage::update(void *arguments) {
+    Stage::update(arguments);
+
+    // in case the benchmark is finished
+    if(this->finished) {
+        // returns immediately
+        return;
+    }
+
+    // in case it's the first frame
+    if(this->frameCount == 0) {
+        // sets the start time
+        MONOTONIC_CLOCK(this->startTime);
+    }
+
+    // retrieves the active physics engine
+    PhysicsEngine *physicsEngine = this->engine->getActivePhysicsEngine();
+
+    // in case the physics engine is available
+    if(physicsEngine) {
+        // steps the physics simulation (fixed timestep)
+        physicsEngine->update((float) this->engine->getTimestep());
+    }
+
+    // retrieves the transform store
+    TransformStore *transformStore = this->engine->getTransformStore();
+
+    // iterates over all the synthetic nodes
+    for(unsigned int index = 0; index < this->nodesList.size(); index++) {
+        // retrieves the node
+        CubeNode *node = this->nodesList[index];
+
+        // moves the node (scene changes in every frame)
+        Coordinate3d_t position = node->getPosition();
+        position.y += (this->frameCount & 1) ? 0.1f : -0.1f;
+
+        // in case the node transform is in the transform store
+        if(transformStore && node->getTransformHandle() != TRANSFORM_STORE_INVALID_HANDLE) {
+            // writes the position directly in the store (the
+            // store marks the node in its transforms update)
+            transformStore->setPosition(node->getTransformHandle(), position);
+        } else {
+            // sets the position in the node
+            node->setPosition(position);
+        }
+    }
+
+    // increments the frame count
+    this->frameCount++;
+
+    // in case the frames are not complete
+    if(!this->benchmark || this->frameCount < this->benchmark->getOptions().frames) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the end time
+    double endTime;
+    MONOTONIC_CLOCK(endTime);
+
+    // writes the engine run results
+    this->benchmark->writeProfilerResults(this->engine->getProfiler(), this->frameCount, endTime - this->startTime);
+
+    // sets the finished flag
+    this->finished = true;
+
+    // prints an info message
+    this->info("Bench finished, results written to " + this->benchmark->getOptions().outputPath);
+
+    // stops the engine
+    this->engine->stop(NULL);
+}
+
+inline void BenchStage::createNodes(SceneNode *render) {
+    // retrieves the number of nodes
+    unsigned int nodes = this->benchmark ? this->benchmark->getOptions().nodes : DEFAULT_BENCHMARK_NODES;
+
+    // retrieves the transform store flag
+    bool transformStoreEnabled = this->benchmark ? this->benchmark->getOptions().transformStore : DEFAULT_BENCHMARK_TRANSFORM_STORE;
+
+    // creates the transform store (in case it's enabled) and
+    // sets it in the engine (updated by the render stage)
+    TransformStore *transformStore = transformStoreEnabled ? new TransformStore(nodes) : NULL;
+    this->engine->setTransformStore(transformStore);
+
+    // iterates over all the nodes
+    for(unsigned int index = 0; index < nodes; index++) {
+        // creates the node (in the transform store) with a random position
+        CubeNode *node = new CubeNode();
+        node->setTransformStore(transformStore);
+        node->setPosition((float) (rand() % 200) - 100.0f, (float) (rand() % 200) - 100.0f, (float) (rand() % 200) - 100.0f);
+
+        // adds the node to the render and to the nodes list
+        render->addChild(node);
+        this->nodesList.push_back(node);
+    }
+}
+
+inline void BenchStage::createActors(SceneNode *render) {
+    // retrieves the number of actors
+    unsigned int actors = this->benchmark ? this->benchmark->getOptions().actors : DEFAULT_BENCHMARK_ACTORS;
+
+    // iterates over all the actors
+    for(unsigned int index = 0; index < actors; index++) {
+        // creates the importer
+        Md2Importer *importer = new Md2Importer();
+
+        // generates the model and the keyframe animation
+        importer->generateModel(this->engine->getAbsolutePath("models/windmill.md2"));
+        importer->generateAnimation();
+
+        // retrieves the actor node and sets a random position
+        ActorNode *actorNode = importer->getActorNode();
+        actorNode->setPosition((float) (rand() % 200) - 100.0f, 0.0f, (float) (rand() % 200) - 100.0f);
+
+        // loops the stand clip (advanced by the animation stage)
+        actorNode->loop("stand");
+
+        // adds the actor node to the render and to the actors list
+        render->addChild(actorNode);
+        this->actorsList.push_back(actorNode);
+    }
+}
+
+inline void BenchStage::createBodies(SceneNode *render) {
+    // retrieves the active physics engine
+    PhysicsEngine *physicsEngine = this->engine->getActivePhysicsEngine();
+
+    // in case there is no physics engine
+    if(!physicsEngine) {
+        // returns immediately
+        return;
+    }
+
+    // retrieves the number of bodies
+    unsigned int bodies = this->benchmark ? this->benchmark->getOptions().bodies : DEFAULT_BENCHMARK_BODIES;
+
+    // creates the arguments map (collision with every group)
+    std::map<std::string, void *> argumentsMap;
+    argumentsMap["collision_filter_group"] = (void *) 0x1;
+    argumentsMap["collision_filter_mask"] = (void *) 0xffff;
+
+    // iterates over all the bodies (plus the static ground)
+    for(unsigned int index = 0; index <= bodies; index++) {
+        // the first body is the ground (static)
+        bool ground = index == 0;
+
+        // creates the physical node
+        PhysicalNode *physicalNode = new PhysicalNode();
+        physicalNode->setMass(ground ? 0.0f : 1.0f);
+
+        // sets the ground or a random position above it
+        if(ground) {
+            physicalNode->setPosition(0.0f, -1.0f, 0.0f);
+        } else {
+            physicalNode->setPosition((float) (rand() % 40) - 20.0f, 2.0f + (float) (rand() % 80), (float) (rand() % 40) - 20.0f);
+        }
+
+        // creates the cube solid
+        CubeSolid *cubeSolid = physicsEngine->createCubeSolid();
+        Box3d_t boundingBox = { 0.0f, 0.0f, 0.0f, ground ? 200.0f : 0.5f, ground ? 1.0f : 0.5f, ground ? 200.0f : 0.5f };
+        cubeSolid->setBoundingBox(boundingBox);
+
+        // creates the collision node
+        CollisionNode *collisionNode = new CollisionNode();
+        collisionNode->setCollisionSolid(cubeSolid);
+        collisionNode->setContactResponseEnabled(true);
+
+        // adds the collision node to the physical node
+        physicalNode->addChild(collisionNode);
+
+        // registers the collision in the physics engine
+        physicsEngine->registerCollision(collisionNode, &argumentsMap);
+
+        // adds the physical node to the render
+        render->addChild(physicalNode);
+    }
+}
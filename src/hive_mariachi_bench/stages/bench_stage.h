@@ -0,0 +1,64 @@
+// Hive Mariachi Engine
+// Copyright (C) 2008 Hive Solutions Lda.
+//
+// This file is part of Hive Mariachi Engine.
+//
+// Hive Mariachi Engine is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Hive Mariachi Engine is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hive Mariachi Engine. If not, see <http://www.gnu.org/licenses/>.
+
+// __author__    = Joo Magalhes <joamag@hive.pt>
+// __version__   = 1.0.0
+// __revision__  = $LastChangedRevision$
+// __date__      = $LastChangedDate$
+// __copyright__ = Copyright (c) 2008 Hive Solutions Lda.
+// __license__   = GNU General Public License (GPL), Version 3
+
+#pragma once
+
+#include "../benchmarks/benchmark.h"
+
+namespace mariachi {
+    namespace bench {
+        /**
+         * Stage that populates the scene with synthetic nodes,
+         * animated actors and physical bodies and runs the engine
+         * for a fixed number of frames, writing the profiler
+         * statistics at the end.
+         */
+        class BenchStage : public stages::Stage {
+            private:
+                Benchmark *benchmark;
+                unsigned int frameCount;
+                double startTime;
+                bool finished;
+                std::vector<nodes::CubeNode *> nodesList;
+                std::vector<nodes::ActorNode *> actorsList;
+
+                inline void initResources();
+                inline void initBenchmark(Benchmark *benchmark);
+                inline void createNodes(nodes::SceneNode *render);
+                inline void createActors(nodes::SceneNode *render);
+                inline void createBodies(nodes::SceneNode *render);
+
+            public:
+                BenchStage();
+                BenchStage(Engine *engine);
+                BenchStage(Engine *engine, const std::string &name);
+                BenchStage(Engine *engine, const std::string &name, Benchmark *benchmark);
+                ~BenchStage();
+                void start(void *arguments);
+                void stop(void *arguments);
+                void update(void *arguments);
+        };
+    }
+}
@@ -49,14 +49,12 @@ int main(int argc, char** argv) {
         // adds the runner stage to the engine
         engine.addStage(&runnerStage);
 
-        // sets the runner stage as dependent of
-        // render, this ensures that sync is made
-        // (in case sync is active)
+        // sets the render stage as dependent of the runner
+        // stage, this ensures the render information is
+        // updated after the runner (already implied by the
+        // resources declared by both stages)
         //engine.addStageDependency("render", "runner");
 
-        // sets the size of the fifo uses to maintain sync
-        //runnerStage.setFifoSize(1);
-
         // starts the engine
         engine.start(NULL);
     } catch(Exception exception) {
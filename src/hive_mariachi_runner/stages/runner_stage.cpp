@@ -44,49 +44,43 @@ float posz = 0.0;
 unsigned int counter = 0;
 
 RunnerStage::RunnerStage() : Stage() {
+    this->initResources();
 }
 
 RunnerStage::RunnerStage(Engine *engine) : Stage(engine) {
+    this->initResources();
 }
 
 RunnerStage::RunnerStage(Engine *engine, const std::string &name) : Stage(engine, name) {
+    this->initResources();
 }
 
 RunnerStage::~RunnerStage() {
 }
 
+inline void RunnerStage::initResources() {
+    this->addRead(INPUT_STATE_RESOURCE);
+    this->addWrite(SCENE_GRAPH_RESOURCE);
+}
+
 void RunnerStage::start(void *arguments) {
     Stage::start(arguments);
 
-    // creates the importer
-    Md3Importer *importer3 = new Md3Importer();
-
-    // generates the model
-    importer3->generateModel(engine->getAbsolutePath("models/mariachi_animated.md3"));
-
-
-
-
-
-
     // creates the importer
     Md2Importer *importer = new Md2Importer();
 
     // generates the model
     importer->generateModel(engine->getAbsolutePath("models/windmill.md2"));
 
-    // generates the vertex list
-    importer->generateVertexList();
-
-    // generates the mesh list
-    importer->generateMeshList();
-
-    // generates the frame list
-    importer->generateFrameList();
+    // generates the keyframe animation
+    importer->generateAnimation();
 
     // retrieves the actor node
     ActorNode *actorNode = importer->getActorNode();
 
+    // loops the stand clip (advanced by the animation stage)
+    actorNode->loop("stand");
+
 
 
 /*
@@ -261,9 +255,6 @@ void RunnerStage::stop(void *arguments) {
 void RunnerStage::update(void *arguments) {
     Stage::update(arguments);
 
-    // updates the frame in the model
-    ((ActorNode *)gModelNode)->updateFrame();
-
     // increments the angle value
     posx += 5.0f;
 
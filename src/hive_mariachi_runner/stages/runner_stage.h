@@ -34,6 +34,7 @@ namespace mariachi {
         */
         class RunnerStage : public stages::Stage {
             private:
+                inline void initResources();
 
             public:
                 RunnerStage();